@@ -0,0 +1,241 @@
+// aoViewportGuideAnnotationsBench.cpp (v0.3.1)
+// Gate annotations: times a playback run (only the frame changes) through the
+// cached text (re-format what changed, re-layout when a string changed) against
+// formatting every string and laying them out every frame. Checks that only
+// changed values re-format, that the laid out glyphs spell the corner strings,
+// and that the rasterized layout matches the atlas pixel for pixel (text over
+// its shadow), which is what the burn-in writes. Exits with 1 on any failure.
+//
+//   ao_guide_bench_annotations [--frames N] [--scale N]
+
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideRaster.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    char glyphChar(int u, int v)
+    {
+        for (int c = 0x21; c < 0x7f; ++c)
+        {
+            int gu = 0, gv = 0;
+            if (glyphOrigin((char)c, gu, gv) && gu == u && gv == v) return (char)c;
+        }
+        return '?';
+    }
+
+    volatile size_t gSink = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 20000;
+    int scale  = 2;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            scale = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--scale N]\n", argv[0]);
+            return 2;
+        }
+    }
+    frames = (std::max)(1, frames);
+    scale  = (std::max)(1, (std::min)(scale, 8));
+
+    uint64_t failures = 0;
+    const GateRect gate{ 40.0, 30.0, 1240.0, 705.0 };
+
+    AnnotationValues v;
+    v.camera      = "shotCam";
+    v.focalLength = 35.0;
+    v.frame       = 1001.0;
+    v.width       = 1920;
+    v.height      = 1080;
+    v.aspect      = 1920.0 / 1080.0;
+
+    // only what changed re-formats
+    {
+        AnnotationText text;
+        bool ok = text.update(v, kAnnotateAll) && text.formatCount() == 5;
+        ok = ok && !text.update(v, kAnnotateAll) && text.formatCount() == 5;
+
+        AnnotationValues next = v;
+        next.frame = 1002.0;
+        ok = ok && text.update(next, kAnnotateAll) && text.formatCount() == 6;
+
+        next.focalLength = 35.00001; // below the printed precision: formatted, same string
+        const uint64_t version = text.version();
+        ok = ok && !text.update(next, kAnnotateAll) && text.formatCount() == 7 && text.version() == version;
+
+        ok = ok && text.corner(kCornerTopLeft) == "shotCam  35mm" &&
+             text.corner(kCornerTopRight) == "1920x1080  1.78:1" &&
+             text.corner(kCornerBottomRight) == "1002";
+
+        ok = ok && text.update(next, kAnnotateFrame) && text.corner(kCornerTopLeft).empty() &&
+             text.corner(kCornerTopRight).empty() && text.corner(kCornerBottomRight) == "1002";
+        if (!ok) { std::fprintf(stderr, "annotation text did not re-format as expected\n"); ++failures; }
+    }
+
+    // glyphs spell the corner strings, in order
+    AnnotationText text;
+    AnnotationLayout layout;
+    text.update(v, kAnnotateAll);
+    layoutAnnotations(text, gate, scale, layout);
+    {
+        std::string spelled;
+        for (const GlyphQuad& g : layout.glyphs) spelled += glyphChar(g.u, g.v);
+        std::string expect;
+        for (int c = 0; c < kCornerCount; ++c)
+        {
+            for (char ch : text.corner(c))
+                if (ch != ' ') expect += ch;
+        }
+        if (spelled != expect)
+        {
+            std::fprintf(stderr, "layout spells \"%s\", expected \"%s\"\n", spelled.c_str(), expect.c_str());
+            ++failures;
+        }
+        for (const GlyphQuad& g : layout.glyphs)
+        {
+            if (g.x < gate.left || g.x + kGlyphWidth * scale > gate.right ||
+                g.y - scale < gate.bottom || g.y + kGlyphHeight * scale > gate.top)
+            {
+                std::fprintf(stderr, "glyph outside the gate at %d, %d\n", g.x, g.y);
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    // rasterized layout == atlas blown up by scale (shadow first, then text)
+    uint64_t pixelErrors = 0;
+    {
+        const int width = 1280, height = 720;
+        std::vector<float> image((size_t)width * height * 4, 0.0f);
+        RasterTarget target;
+        target.row0      = image.data();
+        target.rowStride = (ptrdiff_t)width * 4;
+        target.width     = width;
+        target.height    = height;
+
+        GuideRasterizer raster;
+        const Rgba color{ 1.0f, 0.5f, 0.25f, 1.0f };
+        rasterizeAnnotations(raster, target, layout, color);
+
+        // expected alpha per pixel: text 1, shadow 0.75, nothing 0
+        std::vector<uint8_t> expect((size_t)width * height, 0);
+        const GlyphAtlas& atlas = glyphAtlas();
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (const GlyphQuad& g : layout.glyphs)
+            {
+                for (int ty = 0; ty < kGlyphHeight; ++ty)
+                {
+                    for (int tx = 0; tx < kGlyphWidth; ++tx)
+                    {
+                        if (!atlas.coverage[(g.v + ty) * kGlyphAtlasWidth + g.u + tx]) continue;
+                        for (int py = 0; py < scale; ++py)
+                        {
+                            for (int px = 0; px < scale; ++px)
+                            {
+                                const int x = g.x + tx * scale + px + (pass == 0 ? scale : 0);
+                                const int y = g.y + (kGlyphHeight - 1 - ty) * scale + py - (pass == 0 ? scale : 0);
+                                expect[(size_t)y * width + x] = (uint8_t)(pass + 1);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        const Rgba shadow = annotationShadowColor(color);
+        for (size_t i = 0; i < expect.size(); ++i)
+        {
+            const float* p = image.data() + i * 4;
+            float want[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            if (expect[i] == 1) { want[0] = shadow.r; want[1] = shadow.g; want[2] = shadow.b; want[3] = shadow.a; }
+            if (expect[i] == 2) { want[0] = color.r;  want[1] = color.g;  want[2] = color.b;  want[3] = 1.0f; }
+            for (int c = 0; c < 4; ++c)
+            {
+                if (std::fabs(p[c] - want[c]) > 1e-6f) { ++pixelErrors; break; }
+            }
+        }
+        if (pixelErrors) std::fprintf(stderr, "%llu pixels differ from the atlas\n", (unsigned long long)pixelErrors);
+        failures += pixelErrors;
+    }
+
+    // playback: the frame changes every frame, everything else holds
+    AnnotationText cached;
+    AnnotationLayout cachedLayout;
+    uint64_t layoutVersion = ~0ull;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+    {
+        v.frame = 1001.0 + f;
+        cached.update(v, kAnnotateAll);
+        if (cached.version() != layoutVersion)
+        {
+            layoutAnnotations(cached, gate, scale, cachedLayout);
+            layoutVersion = cached.version();
+        }
+        gSink += cachedLayout.glyphs.size();
+    }
+    const double cachedUs = msSince(t0) * 1000.0 / frames;
+    const double formatsPerFrame = (double)cached.formatCount() / frames;
+
+    // still frame (tumbling): nothing changes
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+    {
+        cached.update(v, kAnnotateAll);
+        if (cached.version() != layoutVersion)
+        {
+            layoutAnnotations(cached, gate, scale, cachedLayout);
+            layoutVersion = cached.version();
+        }
+        gSink += cachedLayout.glyphs.size();
+    }
+    const double stillUs = msSince(t0) * 1000.0 / frames;
+
+    // what a per-frame path does: fresh strings for every value, then the layout
+    AnnotationLayout everyLayout;
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+    {
+        v.frame = 1001.0 + f;
+        AnnotationText fresh;
+        fresh.update(v, kAnnotateAll);
+        layoutAnnotations(fresh, gate, scale, everyLayout);
+        gSink += everyLayout.glyphs.size();
+    }
+    const double everyUs = msSince(t0) * 1000.0 / frames;
+
+    std::printf("frames %d, scale %d, %zu glyphs\n", frames, scale, layout.glyphs.size());
+    std::printf("  format + layout every frame  %10.3f us\n", everyUs);
+    std::printf("  cached, playing              %10.3f us (%.2f fields formatted / frame)\n", cachedUs, formatsPerFrame);
+    std::printf("  cached, still                %10.3f us\n", stillUs);
+    std::printf("  pixel errors                 %10llu\n", (unsigned long long)pixelErrors);
+    std::printf("  failures                     %10llu\n", (unsigned long long)failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+// aoViewportGuideBindingsBench.cpp (v0.3.1)
+// Shot/camera binding lookup: a sequencer of N overlapping shots is indexed by
+// ShotIntervalIndex, then timed for playback (cursor lookups), random scrubbing
+// (binary search), single shot edits (incremental re-flatten) against a full
+// rebuild, and buildBindingState() per time change. Every lookup is checked
+// against a brute force scan of the shots; exits with 1 on a mismatch.
+//
+//   ao_guide_bench_bindings [--shots N] [--variants N] [--cameras N]
+
+#include "aoViewportGuideBindings.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    struct TestShot
+    {
+        double      start;
+        double      end; // inclusive
+        VariantMask variants;
+    };
+
+    VariantMask bruteForce(const std::vector<TestShot>& shots, double t)
+    {
+        VariantMask m = 0;
+        for (const TestShot& s : shots)
+        {
+            if (s.start <= t && t < s.end + 1.0) m |= s.variants;
+        }
+        return m;
+    }
+
+    // back-to-back shots of 20-120 frames on track 1, every 8th also overlapped by
+    // an insert on track 2
+    std::vector<TestShot> makeShots(int count, int variants, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<int> length(20, 120);
+        std::uniform_int_distribution<int> variant(1, variants - 1);
+
+        std::vector<TestShot> shots;
+        double t = 1.0;
+        for (int i = 0; i < count; ++i)
+        {
+            const double len = (double)length(rng);
+            if (i % 8 == 7)
+                shots.push_back(TestShot{ t - len * 0.5, t - len * 0.25, VariantMask(1) << variant(rng) });
+            else
+            {
+                shots.push_back(TestShot{ t, t + len - 1.0, VariantMask(1) << variant(rng) });
+                t += len;
+            }
+        }
+        return shots;
+    }
+
+    template <class F>
+    double nsPer(int n, F&& f)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        f();
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)n;
+    }
+
+    volatile uint64_t gSink = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int shotCount = 5000;
+    int variants = 32;
+    int cameras = 48;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--shots") == 0 && i + 1 < argc)
+            shotCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--variants") == 0 && i + 1 < argc)
+            variants = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--cameras") == 0 && i + 1 < argc)
+            cameras = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--shots N] [--variants N] [--cameras N]\n", argv[0]);
+            return 2;
+        }
+    }
+    shotCount = (std::max)(1, shotCount);
+    variants  = (std::max)(2, (std::min)(variants, kMaxSettingsVariants));
+    cameras   = (std::max)(0, (std::min)(cameras, kMaxBoundCameras));
+
+    std::mt19937 rng(7);
+    std::vector<TestShot> shots = makeShots(shotCount, variants, rng);
+    const double tEnd = shots.back().end + 50.0;
+
+    ShotIntervalIndex index;
+    const double buildNs = nsPer(1, [&]
+    {
+        for (size_t i = 0; i < shots.size(); ++i)
+            index.setShot(i, shots[i].start, shots[i].end, shots[i].variants);
+    });
+
+    uint64_t mismatches = 0;
+    auto check = [&](double t, VariantMask got)
+    {
+        if (got != bruteForce(shots, t)) ++mismatches;
+    };
+
+    // playback at 1/4 frame steps, one cursor
+    const int playbackSteps = (int)(tEnd * 4.0);
+    size_t cursor = 0;
+    const double playbackNs = nsPer(playbackSteps, [&]
+    {
+        for (int i = 0; i < playbackSteps; ++i)
+            gSink += index.lookup((double)i * 0.25, cursor);
+    });
+
+    std::uniform_real_distribution<double> anyTime(-10.0, tEnd);
+    std::vector<double> randomTimes(100000);
+    for (double& t : randomTimes) t = anyTime(rng);
+    const double randomNs = nsPer((int)randomTimes.size(), [&]
+    {
+        for (double t : randomTimes) gSink += index.lookup(t);
+    });
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double t = anyTime(rng);
+        check(t, index.lookup(t));
+        check(t, index.lookup(t, cursor));
+    }
+
+    // editing: slip one shot by a few frames (trim in the sequencer)
+    std::uniform_int_distribution<size_t> anyShot(0, shots.size() - 1);
+    std::uniform_int_distribution<int>    slip(-6, 6);
+    const int edits = 2000;
+    const double editNs = nsPer(edits, [&]
+    {
+        for (int i = 0; i < edits; ++i)
+        {
+            const size_t s = anyShot(rng);
+            const double d = (double)slip(rng);
+            shots[s].start += d;
+            shots[s].end   += d;
+            index.setShot(s, shots[s].start, shots[s].end, shots[s].variants);
+        }
+    });
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double t = anyTime(rng);
+        check(t, index.lookup(t));
+    }
+
+    ShotIntervalIndex rebuilt;
+    const double rebuildNs = nsPer(1, [&]
+    {
+        for (size_t i = 0; i < shots.size(); ++i)
+            rebuilt.setShot(i, shots[i].start, shots[i].end, shots[i].variants);
+    });
+    if (rebuilt.segmentCount() != index.segmentCount()) ++mismatches;
+
+    // remove every other shot again
+    for (size_t i = 0; i < shots.size(); i += 2)
+    {
+        index.removeShot(i);
+        shots[i].variants = 0;
+    }
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double t = anyTime(rng);
+        check(t, index.lookup(t));
+    }
+
+    // camera table per time change
+    VariantBindings bindings;
+    for (int v = 1; v < variants; ++v)
+        bindings.shotBound |= VariantMask(1) << v;
+    for (int c = 0; c < cameras; ++c)
+    {
+        const int v = 1 + c % (variants - 1);
+        bindings.cameras[0x9E3779B97F4A7C15ull * (uint64_t)(c + 1)] |= VariantMask(1) << v;
+        bindings.cameraBound |= VariantMask(1) << v;
+    }
+    BindingState state;
+    const int stateBuilds = 20000;
+    const double stateNs = nsPer(stateBuilds, [&]
+    {
+        for (int i = 0; i < stateBuilds; ++i)
+        {
+            buildBindingState(bindings, index.lookup((double)i, cursor), state);
+            gSink += (uint64_t)resolveSettingsVariant(state, 0x9E3779B97F4A7C15ull);
+        }
+    });
+
+    std::printf("shots %d, variants %d, cameras %d, segments %zu\n",
+                shotCount, variants, cameras, index.segmentCount());
+    std::printf("  build              %12.1f us\n", buildNs * 1.0e-3);
+    std::printf("  playback lookup    %12.1f ns\n", playbackNs);
+    std::printf("  random lookup      %12.1f ns\n", randomNs);
+    std::printf("  shot edit          %12.1f ns\n", editNs);
+    std::printf("  full rebuild       %12.1f us\n", rebuildNs * 1.0e-3);
+    std::printf("  binding state      %12.1f ns\n", stateNs);
+    std::printf("  mismatches         %12llu\n", (unsigned long long)mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
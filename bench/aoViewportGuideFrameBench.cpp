@@ -0,0 +1,365 @@
+// aoViewportGuideFrameBench.cpp (v0.3.1)
+// Per-frame cost of the HUD overlay path: settings snapshot, gate fitting and
+// drawGuideOverlay() for every guideType, with 1/4/16 panels at several
+// resolutions, with and without a ten-layer guide stack. Builds against the stand-in SDK in bench/standin (no Maya).
+//
+//   ao_guide_bench [--frames N] [--json out.json|-]
+
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideGateFit.h"
+#include "aoViewportGuideHudDraw.h"
+#include "aoViewportGuideSettingsData.h"
+#include "aoViewportGuideSnapshotBuffer.h"
+
+#include <maya/MFrameContext.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// allocation counter
+
+static std::atomic<uint64_t> gAllocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept              { std::free(p); }
+void operator delete[](void* p) noexcept            { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept   { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    // Named plug values looked up on every read, standing in for MPlug access
+    // on aoViewportGuideSettings1 / defaultResolution / the camera shape.
+    class StandInDG
+    {
+    public:
+        void set(const char* plug, double v)
+        {
+            for (Plug& p : mPlugs)
+            {
+                if (std::strcmp(p.name, plug) == 0) { p.value = v; return; }
+            }
+            mPlugs.push_back(Plug{ plug, v });
+        }
+
+        double get(const char* plug) const
+        {
+            for (const Plug& p : mPlugs)
+            {
+                if (std::strcmp(p.name, plug) == 0) return p.value;
+            }
+            return 0.0;
+        }
+
+        float getf(const char* plug) const { return (float)get(plug); }
+        bool  getb(const char* plug) const { return get(plug) != 0.0; }
+        int   geti(const char* plug) const { return (int)get(plug); }
+
+    private:
+        struct Plug
+        {
+            const char* name;
+            double      value;
+        };
+        std::vector<Plug> mPlugs;
+    };
+
+    void setupScene(StandInDG& dg, int guideType)
+    {
+        dg.set("settings.enable", 1);
+        dg.set("settings.followResolutionGate", 1);
+        dg.set("settings.guideType", guideType);
+        dg.set("settings.drawBackend", kDrawBackendHud);
+        dg.set("settings.lineOpacity", 1.0);
+        dg.set("settings.lineThickness", 2.0);
+        dg.set("settings.lineColorR", 0.0);
+        dg.set("settings.lineColorG", 1.0);
+        dg.set("settings.lineColorB", 0.0);
+        dg.set("settings.gateBorderEnable", 1);
+        dg.set("settings.gateBorderOpacity", 1.0);
+        dg.set("settings.gateBorderThickness", 2.0);
+        dg.set("settings.gateBorderColorR", 1.0);
+        dg.set("settings.gateBorderColorG", 1.0);
+        dg.set("settings.gateBorderColorB", 1.0);
+        dg.set("settings.maskEnable", 1);
+        dg.set("settings.maskOpacity", 0.5);
+
+        dg.set("defaultResolution.width", 2048);
+        dg.set("defaultResolution.height", 858);
+        dg.set("camera.overscan", 1.1);
+        dg.set("camera.filmFit", kFilmFitOverscan);
+    }
+
+    // mirrors AoViewportGuideSettings::read()
+    SettingsData readSettings(const StandInDG& dg)
+    {
+        SettingsData s;
+        s.enable               = dg.getb("settings.enable");
+        s.followResolutionGate = dg.getb("settings.followResolutionGate");
+        s.guideType            = dg.geti("settings.guideType");
+        s.drawBackend          = dg.geti("settings.drawBackend");
+        s.lineOpacity          = dg.getf("settings.lineOpacity");
+        s.lineThickness        = dg.getf("settings.lineThickness");
+        s.lineColor            = Rgba{ dg.getf("settings.lineColorR"), dg.getf("settings.lineColorG"), dg.getf("settings.lineColorB"), 1.0f };
+        s.gateBorderEnable     = dg.getb("settings.gateBorderEnable");
+        s.gateBorderOpacity    = dg.getf("settings.gateBorderOpacity");
+        s.gateBorderThickness  = dg.getf("settings.gateBorderThickness");
+        s.gateBorderColor      = Rgba{ dg.getf("settings.gateBorderColorR"), dg.getf("settings.gateBorderColorG"), dg.getf("settings.gateBorderColorB"), 1.0f };
+        s.maskEnable           = dg.getb("settings.maskEnable");
+        s.maskOpacity          = dg.getf("settings.maskOpacity");
+        sanitizeSettings(s);
+        return s;
+    }
+
+    // grids, safe areas and an aspect mask; the lines share two styles.
+    // Built once: the plugin reads layers from plugs, not from these strings.
+    const GuideLayerStack& benchLayers()
+    {
+        static const GuideLayerStack stack = []
+        {
+            const char* specs[] = {
+                "grid columns=4 rows=4", "grid columns=8 rows=8", "grid columns=16 rows=9", "grid columns=2000 rows=2",
+                "safe action=90 title=80", "safe action=95 title=0", "thirds", "cross",
+                "circle color=1,1,0", "mask ratio=2.39 opacity=0.8",
+            };
+            GuideLayerStack st = {};
+            for (const char* spec : specs) parseGuideLayer(st, spec);
+            sanitizeGuideLayers(st);
+            return st;
+        }();
+        return stack;
+    }
+
+    // mirrors computeGateRect(): defaultResolution + camera plugs, then fitGateRect()
+    GateRect gateFromDG(const StandInDG& dg, bool followResolutionGate, int vpX, int vpY, int vpW, int vpH)
+    {
+        GateParams params;
+        if (followResolutionGate)
+        {
+            const int h = dg.geti("defaultResolution.height");
+            if (h > 0) params.resolutionAspect = (double)dg.geti("defaultResolution.width") / (double)h;
+        }
+        params.overscan = dg.get("camera.overscan");
+        params.filmFit  = dg.geti("camera.filmFit");
+        return fitGateRect(params, vpX, vpY, vpW, vpH);
+    }
+
+    struct Panel
+    {
+        MHWRender::MFrameContext context;
+        HudDrawState draw;
+    };
+
+    std::vector<Panel> makePanels(int count, int width, int height)
+    {
+        int cols = 1;
+        while (cols * cols < count) ++cols;
+        const int rows = (count + cols - 1) / cols;
+
+        std::vector<Panel> panels;
+        panels.reserve((size_t)count);
+        for (int i = 0; i < count; ++i)
+        {
+            const int c = i % cols;
+            const int r = i / cols;
+            const int x0 = width * c / cols,  x1 = width * (c + 1) / cols;
+            const int y0 = height * r / rows, y1 = height * (r + 1) / rows;
+            panels.push_back(Panel{ MHWRender::MFrameContext(x0, y0, x1 - x0, y1 - y0), HudDrawState() });
+        }
+        return panels;
+    }
+
+    enum Scenario
+    {
+        kSteady  = 0, // nothing changes between frames
+        kEditing = 1, // a settings attribute changes every frame (slider drag)
+        kLayers  = 2, // editing, with ten guide layers in two styles
+    };
+
+    struct Result
+    {
+        const char* scenario;
+        const char* guide;
+        int    panels;
+        int    width;
+        int    height;
+        double nsPerFrame;
+        double allocsPerFrame;
+        double primsPerFrame;
+    };
+
+    Result run(Scenario scenario, int guideType, int panelCount, int width, int height, int frames)
+    {
+        static const char* kScenarioNames[] = { "steady", "editing", "layers" };
+        static const char* kGuideNames[]    = { "thirds", "cross", "circle", "phi", "spiral" };
+
+        StandInDG dg;
+        setupScene(dg, guideType);
+
+        // mirrors AoViewportGuideSettings::publish() / snapshot()
+        struct Published
+        {
+            PackedSettings packed;
+            uint64_t       hash;
+            uint64_t       shapeHash;
+        };
+        SnapshotBuffer<Published> settings;
+        auto publish = [&]()
+        {
+            Published next;
+            SettingsData s = readSettings(dg);
+            if (scenario == kLayers) s.layers = benchLayers();
+            next.packed = packSettings(s);
+            if (settings.generation() != 0 && settings.read().data.packed == next.packed) return;
+            next.hash = hashSettings(next.packed);
+            next.shapeHash = hashSettingsShape(next.packed);
+            settings.publish(next);
+        };
+        publish();
+
+        std::vector<Panel> panels = makePanels(panelCount, width, height);
+        MHWRender::MUIDrawManager dm;
+
+        size_t prims = 0;
+        int frame = 0;
+        auto drawFrame = [&]()
+        {
+            // slider drag: the attribute callback publishes a new value every frame
+            if (scenario != kSteady)
+            {
+                dg.set("settings.lineOpacity", 0.5 + 0.25 * (double)(++frame & 1));
+                publish();
+            }
+
+            dm.beginFrame();
+            for (Panel& panel : panels)
+            {
+                const Published snap = settings.read().data;
+                const SettingsData s = unpackSettings(snap.packed);
+                if (!s.enable) continue;
+
+                int vpX=0, vpY=0, vpW=0, vpH=0;
+                panel.context.getViewportDimensions(vpX, vpY, vpW, vpH);
+                if (vpW < 10 || vpH < 10) continue;
+
+                const GateRect gate = gateFromDG(dg, s.followResolutionGate, vpX, vpY, vpW, vpH);
+                drawGuideOverlay(dm, s, snap.shapeHash, gate, panel.draw);
+            }
+            prims += dm.primitiveCount();
+        };
+
+        for (int i = 0; i < 50; ++i) drawFrame(); // warm-up: buffers reach steady-state size
+
+        prims = 0;
+        const uint64_t allocs0 = gAllocations.load();
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) drawFrame();
+        const auto t1 = std::chrono::steady_clock::now();
+        const uint64_t allocs1 = gAllocations.load();
+
+        Result r;
+        r.scenario       = kScenarioNames[scenario];
+        r.guide          = kGuideNames[guideType];
+        r.panels         = panelCount;
+        r.width          = width;
+        r.height         = height;
+        r.nsPerFrame     = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)frames;
+        r.allocsPerFrame = (double)(allocs1 - allocs0) / (double)frames;
+        r.primsPerFrame  = (double)prims / (double)frames;
+        return r;
+    }
+
+    void writeJson(std::FILE* f, int frames, const std::vector<Result>& results)
+    {
+        std::fprintf(f, "{\n  \"version\": \"%s\",\n  \"frames\": %d,\n  \"results\": [\n", kVersion, frames);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(f,
+                "    {\"scenario\": \"%s\", \"guide\": \"%s\", \"panels\": %d, \"width\": %d, \"height\": %d, "
+                "\"ns_per_frame\": %.1f, \"allocs_per_frame\": %.3f, \"prims_per_frame\": %.1f}%s\n",
+                r.scenario, r.guide, r.panels, r.width, r.height,
+                r.nsPerFrame, r.allocsPerFrame, r.primsPerFrame,
+                (i + 1 < results.size()) ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 2000;
+    const char* jsonPath = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--json out.json|-]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    const int panelCounts[] = { 1, 4, 16 };
+    const int resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+    std::vector<Result> results;
+    for (int scenario = kSteady; scenario <= kLayers; ++scenario)
+        for (int guideType = kGuideThirds; guideType <= kGuideGoldenSpiral; ++guideType)
+            for (int panels : panelCounts)
+                for (const auto& res : resolutions)
+                    results.push_back(run((Scenario)scenario, guideType, panels, res[0], res[1], frames));
+
+    const bool jsonToStdout = jsonPath && std::strcmp(jsonPath, "-") == 0;
+    if (!jsonToStdout)
+    {
+        std::printf("%-8s %-7s %6s %11s %12s %12s %12s\n",
+                    "scenario", "guide", "panels", "resolution", "ns/frame", "allocs/frame", "prims/frame");
+        for (const Result& r : results)
+        {
+            char res[32];
+            std::snprintf(res, sizeof(res), "%dx%d", r.width, r.height);
+            std::printf("%-8s %-7s %6d %11s %12.1f %12.3f %12.1f\n",
+                        r.scenario, r.guide, r.panels, res, r.nsPerFrame, r.allocsPerFrame, r.primsPerFrame);
+        }
+    }
+
+    if (jsonPath)
+    {
+        std::FILE* f = jsonToStdout ? stdout : std::fopen(jsonPath, "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "cannot write %s\n", jsonPath);
+            return 1;
+        }
+        writeJson(f, frames, results);
+        if (!jsonToStdout) std::fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// aoViewportGuideLineBatchBench.cpp (v0.3.1)
+// Primitive count and CPU time per frame: one line2d per segment (old HUD path)
+// vs. one kLines batch per style. Maya-free; the draw manager is a stand-in that
+// copies vertices into one UI primitive per call, like MUIDrawManager does.
+//
+//   ao_guide_bench_lines [--frames N]
+
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    struct StandInDrawManager
+    {
+        struct Primitive
+        {
+            std::vector<Point2>   points;
+            std::vector<uint32_t> indices;
+        };
+
+        std::vector<Primitive> primitives;
+
+        void beginFrame() { primitives.clear(); }
+
+        void line2d(const Point2& a, const Point2& b)
+        {
+            primitives.emplace_back();
+            primitives.back().points = { a, b };
+        }
+
+        void mesh2dLines(const std::vector<Point2>& points, const std::vector<uint32_t>& indices)
+        {
+            primitives.emplace_back();
+            primitives.back().points  = points;
+            primitives.back().indices = indices;
+        }
+    };
+
+    // baseline: the pre-batching addUIDrawables() loop
+    void drawLegacy(StandInDrawManager& dm, int guideType, const GateRect& gate)
+    {
+        dm.line2d({ gate.left,  gate.bottom }, { gate.right, gate.bottom });
+        dm.line2d({ gate.right, gate.bottom }, { gate.right, gate.top });
+        dm.line2d({ gate.right, gate.top },    { gate.left,  gate.top });
+        dm.line2d({ gate.left,  gate.top },    { gate.left,  gate.bottom });
+
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+
+        if (guideType == 0)
+        {
+            const double x1 = gate.left + w / 3.0;
+            const double x2 = gate.left + w * 2.0 / 3.0;
+            const double y1 = gate.bottom + h / 3.0;
+            const double y2 = gate.bottom + h * 2.0 / 3.0;
+
+            dm.line2d({ x1, gate.bottom }, { x1, gate.top });
+            dm.line2d({ x2, gate.bottom }, { x2, gate.top });
+            dm.line2d({ gate.left, y1 },   { gate.right, y1 });
+            dm.line2d({ gate.left, y2 },   { gate.right, y2 });
+        }
+        else if (guideType == 1)
+        {
+            const double cx = gate.left + w * 0.5;
+            const double cy = gate.bottom + h * 0.5;
+
+            dm.line2d({ cx, gate.bottom }, { cx, gate.top });
+            dm.line2d({ gate.left, cy },   { gate.right, cy });
+        }
+        else
+        {
+            const double cx = gate.left + w * 0.5;
+            const double cy = gate.bottom + h * 0.5;
+            const double r  = (w < h ? w : h) * 0.5;
+
+            const int seg = 96;
+            for (int i = 0; i < seg; ++i)
+            {
+                const double a0 = (2.0 * 3.141592653589793) * (double)i / (double)seg;
+                const double a1 = (2.0 * 3.141592653589793) * (double)(i + 1) / (double)seg;
+
+                dm.line2d({ cx + std::cos(a0) * r, cy + std::sin(a0) * r },
+                          { cx + std::cos(a1) * r, cy + std::sin(a1) * r });
+            }
+        }
+    }
+
+    struct BatchedState
+    {
+        LineBatch border;
+        LineBatch guide;
+    };
+
+    void drawBatched(StandInDrawManager& dm, BatchedState& st, int guideType, const GateRect& gate)
+    {
+        st.border.clear();
+        appendGateBorder(gate, st.border);
+        dm.mesh2dLines(st.border.points, st.border.indices);
+
+        st.guide.clear();
+        appendGuide(guideType, gate, kCurveTolerancePx, st.guide);
+        dm.mesh2dLines(st.guide.points, st.guide.indices);
+    }
+
+    template <class Fn>
+    double nsPerFrame(int frames, StandInDrawManager& dm, Fn&& drawFrame)
+    {
+        for (int i = 0; i < 100; ++i) { dm.beginFrame(); drawFrame(); } // warm-up
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+        {
+            dm.beginFrame();
+            drawFrame();
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)frames;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 20000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            frames = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] (N > 0)\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const GateRect gate{ 120.0, 40.0, 1800.0, 1040.0 };
+    const char* names[] = { "thirds", "cross", "circle" };
+
+    std::printf("%-8s %-8s %10s %12s\n", "guide", "path", "prims", "ns/frame");
+
+    for (int guideType = 0; guideType < 3; ++guideType)
+    {
+        StandInDrawManager dm;
+
+        const double legacyNs = nsPerFrame(frames, dm, [&] { drawLegacy(dm, guideType, gate); });
+        const size_t legacyPrims = dm.primitives.size();
+
+        BatchedState st;
+        const double batchedNs = nsPerFrame(frames, dm, [&] { drawBatched(dm, st, guideType, gate); });
+        const size_t batchedPrims = dm.primitives.size();
+
+        std::printf("%-8s %-8s %10zu %12.1f\n", names[guideType], "line2d",  legacyPrims,  legacyNs);
+        std::printf("%-8s %-8s %10zu %12.1f\n", names[guideType], "batched", batchedPrims, batchedNs);
+    }
+
+    std::printf("\ncircle segments at %.2f px tolerance\n", kCurveTolerancePx);
+    const double radii[] = { 50.0, 100.0, 270.0, 540.0, 1080.0, 2160.0 };
+    for (double r : radii)
+        std::printf("  r = %6.0f px -> %4d\n", r, circleSegmentsForLod(selectCircleLod(r, kCurveTolerancePx)));
+
+    return 0;
+}
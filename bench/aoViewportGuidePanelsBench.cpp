@@ -0,0 +1,326 @@
+// aoViewportGuidePanelsBench.cpp (v0.3.1)
+// Geometry shared between panels: several panels with gates of one size draw a
+// heavy overlay (golden spiral, dense grid, circle, safe area and aspect mask
+// layers) through drawGuideOverlay(). Checks that they share one cache entry
+// (one build, no lookups in steady state, a moved gate only moves points), that
+// every panel's primitives match the geometry built directly at its own gate
+// (to 1/16 px), that panels holding an evicted entry keep drawing it, and that
+// threads drawing their own panels concurrently all get correct geometry. Then
+// times a shape edit (new geometry every frame) with the shared cache against
+// every panel rebuilding its own. Exits with 1 on any failure. Builds against
+// the stand-in SDK in bench/standin.
+//
+//   ao_guide_bench_panels [--frames N] [--panels N] [--threads N]
+
+#include "aoViewportGuideGeometryCache.h"
+#include "aoViewportGuideHudDraw.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideStats.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    SettingsData heavySettings()
+    {
+        SettingsData s;
+        s.guideType        = kGuideGoldenSpiral;
+        s.maskEnable       = true;
+        s.gateBorderEnable = true;
+        parseGuideLayer(s.layers, "grid columns=48 rows=27 opacity=0.3");
+        parseGuideLayer(s.layers, "circle thickness=2");
+        parseGuideLayer(s.layers, "safe action=90 title=80");
+        parseGuideLayer(s.layers, "mask ratio=2.39 opacity=0.5");
+        sanitizeSettings(s);
+        return s;
+    }
+
+    uint64_t shapeHashOf(const SettingsData& s) { return hashSettingsShape(packSettings(s)); }
+
+    // What drawGuideOverlay() submits, built at gate itself: the batches in draw
+    // order, skipping the ones it skips.
+    struct Reference
+    {
+        std::vector<IndexedBatch> batches;
+    };
+
+    Reference buildReference(const SettingsData& s, const GateRect& gate, int level)
+    {
+        const QualityLevelParams& q = qualityLevelParams(level);
+        TriangleBatch mask;
+        LineBatch border, guide;
+        if (s.maskEnable && s.maskOpacity > 0.0001f)
+            appendGateMask(gate, mask);
+        if (s.gateBorderEnable && s.gateBorderOpacity > 0.0001f)
+            appendGateBorder(gate, border);
+        appendGuide(s.guideType, gate, q.tolerancePx, guide,
+                    goldenOrientation(s.goldenRotation, s.goldenFlipH, s.goldenFlipV));
+
+        GuideLayerDraw layers;
+        buildGuideLayerDraw(s.layers, gate, q.tolerancePx, layers, q.minGridSpacingPx);
+
+        Reference r;
+        auto add = [&](const IndexedBatch& b)
+        {
+            if (b.points.size() >= 2 && b.indices.size() >= 2) r.batches.push_back(b);
+        };
+        if (s.maskEnable && s.maskOpacity > 0.0001f) add(mask);
+        if (s.gateBorderEnable && s.gateBorderOpacity > 0.0001f) add(border);
+        add(guide);
+        for (size_t g = 0; g < layers.fillCount; ++g)
+        {
+            TriangleBatch fill;
+            for (const GateRect& rc : layers.fills[g].rects)
+                fill.addRect(rc.left, rc.bottom, rc.right, rc.top);
+            add(fill);
+        }
+        for (size_t g = 0; g < layers.lineCount; ++g)
+            add(layers.lines[g].batch);
+        return r;
+    }
+
+    // Largest distance of a submitted point from the reference; < 0 when the
+    // primitive count, a point count or an index differs.
+    double compare(const MHWRender::MUIDrawManager& dm, const Reference& ref)
+    {
+        if (dm.primitiveCount() != ref.batches.size()) return -1.0;
+        double err = 0.0;
+        for (size_t i = 0; i < ref.batches.size(); ++i)
+        {
+            const MHWRender::MUIDrawManager::RecordedPrimitive& p = dm.primitive(i);
+            const IndexedBatch& b = ref.batches[i];
+            if (p.points.size() != b.points.size() || p.indices.size() != b.indices.size()) return -1.0;
+            for (size_t k = 0; k < b.indices.size(); ++k)
+            {
+                if (p.indices[k] != b.indices[k]) return -1.0;
+            }
+            for (size_t k = 0; k < b.points.size(); ++k)
+            {
+                err = (std::max)(err, std::fabs(p.points[k].x - b.points[k].x));
+                err = (std::max)(err, std::fabs(p.points[k].y - b.points[k].y));
+            }
+        }
+        return err;
+    }
+
+    // 1/16 px from quantizing the gate size, plus rounding
+    static constexpr double kMaxErrorPx = 1.0 / 16.0 + 1.0e-6;
+
+    bool checkPanel(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t shapeHash,
+                    const GateRect& gate, HudDrawState& st, int level, const char* what)
+    {
+        dm.beginFrame();
+        drawGuideOverlay(dm, s, shapeHash, gate, st, true, level);
+        const double err = compare(dm, buildReference(s, gate, level));
+        if (err < 0.0 || err > kMaxErrorPx)
+        {
+            std::fprintf(stderr, "%s: gate %.3f,%.3f %.3fx%.3f differs from its own build (%s)\n", what,
+                         gate.left, gate.bottom, gate.right - gate.left, gate.top - gate.bottom,
+                         err < 0.0 ? "topology" : "position");
+            return false;
+        }
+        return true;
+    }
+
+    GateRect gateAt(double left, double bottom, double w, double h)
+    {
+        return GateRect{ left, bottom, left + w, bottom + h };
+    }
+
+    bool sameStats(const GuideGeometryCacheStats& a, const GuideGeometryCacheStats& b)
+    {
+        return a.hits == b.hits && a.misses == b.misses && a.evictions == b.evictions;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 200;
+    int panelCount = 16;
+    int threadCount = 4;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--panels") == 0 && i + 1 < argc)
+            panelCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--panels N] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+    frames      = (std::max)(1, frames);
+    panelCount  = (std::max)(2, panelCount);
+    threadCount = (std::max)(1, threadCount);
+
+    uint64_t failures = 0;
+    const SettingsData s = heavySettings();
+    const uint64_t shapeHash = shapeHashOf(s);
+    MHWRender::MUIDrawManager dm;
+
+    // four panels of one gate size share one build; steady state does no lookup
+    {
+        resetGuideGeometryCache();
+        const double w = 911.25, h = 512.5;
+        const GateRect gates[4] = { gateAt(13.37, 7.5, w, h), gateAt(960.0, 7.5, w, h),
+                                    gateAt(13.37, 540.25, w, h), gateAt(960.0, 540.25, w, h) };
+        HudDrawState st[4];
+        bool ok = true;
+        for (int i = 0; i < 4; ++i)
+            ok = checkPanel(dm, s, shapeHash, gates[i], st[i], kQualityFull, "shared") && ok;
+
+        GuideGeometryCacheStats stats = guideGeometryCacheStats();
+        if (stats.misses != 1 || stats.hits != 3)
+        {
+            std::fprintf(stderr, "four equal panels: %llu builds, %llu hits (want 1, 3)\n",
+                         (unsigned long long)stats.misses, (unsigned long long)stats.hits);
+            ok = false;
+        }
+        if (st[0].geometry != st[3].geometry) { std::fprintf(stderr, "panels hold different entries\n"); ok = false; }
+
+        // redraw, then move a panel without resizing it: no lookup either way
+        for (int i = 0; i < 4; ++i)
+            ok = checkPanel(dm, s, shapeHash, gates[i], st[i], kQualityFull, "redraw") && ok;
+        ok = checkPanel(dm, s, shapeHash, gateAt(101.5, 33.0, w, h), st[2], kQualityFull, "moved") && ok;
+        if (!sameStats(stats, guideGeometryCacheStats()))
+        {
+            std::fprintf(stderr, "steady state or a moved gate went to the cache\n");
+            ok = false;
+        }
+
+        // another quality level is another entry
+        ok = checkPanel(dm, s, shapeHash, gates[0], st[0], kQualityLevelCount - 1, "coarse") && ok;
+        if (guideGeometryCacheStats().misses != 2) { std::fprintf(stderr, "quality level shared an entry\n"); ok = false; }
+        if (!ok) ++failures;
+    }
+
+    // LRU: more sizes than entries; a panel holding an evicted entry still draws it
+    uint64_t evictions = 0;
+    {
+        resetGuideGeometryCache();
+        bool ok = true;
+        HudDrawState held;
+        const GateRect first = gateAt(20.0, 20.0, 400.0, 225.0);
+        ok = checkPanel(dm, s, shapeHash, first, held, kQualityFull, "held") && ok;
+
+        HudDrawState other;
+        for (int i = 1; i <= 40; ++i)
+            ok = checkPanel(dm, s, shapeHash, gateAt(0.0, 0.0, 400.0 + i, 225.0), other, kQualityFull, "sizes") && ok;
+
+        evictions = guideGeometryCacheStats().evictions;
+        if (evictions == 0) { std::fprintf(stderr, "40 sizes evicted nothing\n"); ok = false; }
+        ok = checkPanel(dm, s, shapeHash, gateAt(60.0, 20.0, 400.0, 225.0), held, kQualityFull, "evicted") && ok;
+        if (!ok) ++failures;
+    }
+
+    // concurrent draw callbacks: every thread draws its own panels over a set of
+    // sizes larger than the cache, so entries are built, shared and evicted under it
+    uint64_t threadErrors = 0;
+    {
+        resetGuideGeometryCache();
+        static constexpr int kSizes = 24;
+        std::vector<Reference> refs;
+        std::vector<GateRect>  gates;
+        for (int k = 0; k < kSizes; ++k)
+        {
+            gates.push_back(gateAt(10.0 * k + 0.5, 5.0 * k, 300.0 + 16.0 * k, 200.0 + 9.0 * k));
+            refs.push_back(buildReference(s, gates.back(), kQualityFull));
+        }
+
+        std::atomic<uint64_t> errors{ 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                MHWRender::MUIDrawManager tdm;
+                HudDrawState panels[2];
+                for (int f = 0; f < 400; ++f)
+                {
+                    for (int p = 0; p < 2; ++p)
+                    {
+                        const int k = (f * 7 + t * 5 + p * 11) % kSizes;
+                        tdm.beginFrame();
+                        drawGuideOverlay(tdm, s, shapeHash, gates[k], panels[p], true, kQualityFull);
+                        const double err = compare(tdm, refs[k]);
+                        if (err < 0.0 || err > kMaxErrorPx) errors.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (std::thread& th : threads) th.join();
+
+        threadErrors = errors.load();
+        const GuideGeometryCacheStats stats = guideGeometryCacheStats();
+        if (threadErrors)
+        {
+            std::fprintf(stderr, "%llu concurrent draws differ from their own build\n", (unsigned long long)threadErrors);
+            ++failures;
+        }
+        if (stats.misses < (uint64_t)kSizes) { std::fprintf(stderr, "fewer builds than sizes\n"); ++failures; }
+    }
+
+    // shape edit while the panels draw: new geometry every frame, built once and
+    // shared, or built by every panel
+    int cols = 1;
+    while (cols * cols < panelCount) ++cols;
+    const int rows = (panelCount + cols - 1) / cols;
+    const double pw = 3840.0 / cols, ph = 2160.0 / rows;
+    std::vector<GateRect> layout;
+    for (int i = 0; i < panelCount; ++i)
+        layout.push_back(gateAt(pw * (i % cols) + 8.0, ph * (i / cols) + 8.0, pw - 16.0, (pw - 16.0) * 9.0 / 16.0));
+
+    auto timeEdit = [&](bool shared) -> double
+    {
+        resetGuideGeometryCache();
+        std::vector<HudDrawState> panels((size_t)panelCount);
+        SettingsData edited = s;
+        const uint64_t t0 = statsNow();
+        for (int f = 0; f < frames; ++f)
+        {
+            // dragging the grid opacity slider: a new shape hash every frame
+            edited.layers.opacity[0] = 0.3f + 0.0001f * (float)(f % 1000);
+            const uint64_t hash = shapeHashOf(edited);
+            dm.beginFrame();
+            for (size_t p = 0; p < panels.size(); ++p)
+            {
+                if (!shared) resetGuideGeometryCache();
+                drawGuideOverlay(dm, edited, hash, layout[p], panels[p], true, kQualityFull);
+            }
+        }
+        return (double)(statsNow() - t0) / frames;
+    };
+    const double perPanelNs = timeEdit(false);
+    const double sharedNs   = timeEdit(true);
+    const GuideGeometryCacheStats editStats = guideGeometryCacheStats();
+    if (editStats.misses != (uint64_t)frames)
+    {
+        std::fprintf(stderr, "shape edit: %llu builds over %d frames\n", (unsigned long long)editStats.misses, frames);
+        ++failures;
+    }
+
+    std::printf("%d panels of %.0fx%.0f, %d frames, %d threads\n", panelCount, pw - 16.0, (pw - 16.0) * 9.0 / 16.0,
+                frames, threadCount);
+    std::printf("  shape edit, every panel builds  %10.1f us/frame\n", perPanelNs * 1.0e-3);
+    std::printf("  shape edit, shared build        %10.1f us/frame (%.1fx)\n", sharedNs * 1.0e-3,
+                sharedNs > 0.0 ? perPanelNs / sharedNs : 0.0);
+    std::printf("  evictions (40 sizes)            %10llu\n", (unsigned long long)evictions);
+    std::printf("  concurrent draw errors          %10llu\n", (unsigned long long)threadErrors);
+    std::printf("  failures                        %10llu\n", (unsigned long long)failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// aoViewportGuidePipelineCheck.cpp (v0.3.1)
+// Checks planPipeline() against a stand-in renderer: Maya's standard operation
+// lists (full, without HUD, without present, empty, too long) are run through
+// every combination of pipeline, background and shader pass. The renderer
+// executes each plan, records the operation names in order and counts target
+// clears. Prints the sequences and plan time, and exits with 1 on the first
+// wrong order, missing or duplicated operation, or extra clear.
+//
+//   ao_guide_check_pipeline [--verbose]
+
+#include "aoViewportGuidePipeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    struct StandInOperation
+    {
+        std::string       name;
+        StandardOperation kind;
+        bool              clears; // Maya's background operation clears the targets
+    };
+
+    std::vector<StandInOperation> mayaStandard()
+    {
+        return {
+            { "Background",     kStandardOther,   true  },
+            { "Select",         kStandardOther,   false },
+            { "ShadowPrepass",  kStandardOther,   false },
+            { "Opaque",         kStandardOther,   false },
+            { "Transparent",    kStandardOther,   false },
+            { "PostOperations", kStandardOther,   false },
+            { "HUD",            kStandardHud,     false },
+            { "Present",        kStandardPresent, false },
+        };
+    }
+
+    // Executes a plan the way the override hands it to Maya.
+    struct StandInRenderer
+    {
+        std::vector<std::string> sequence;
+        int clears = 0;
+
+        void run(const PipelinePlan& plan, const std::vector<StandInOperation>& standard)
+        {
+            static const char* kGuideNames[] = { "aoScene", "aoQuad", "aoHud", "aoPresent" };
+
+            sequence.clear();
+            clears = 0;
+            for (int i = 0; i < plan.count; ++i)
+            {
+                const PipelineStep& step = plan.steps[i];
+                if (step.guide == kGuideOpNone)
+                {
+                    const StandInOperation& op = standard[(size_t)step.standard];
+                    sequence.push_back(op.name);
+                    clears += op.clears;
+                }
+                else
+                {
+                    sequence.push_back(kGuideNames[step.guide]);
+                    clears += step.guide == kGuideOpScene;
+                }
+            }
+        }
+
+        std::string text() const
+        {
+            std::string out;
+            for (const std::string& s : sequence) out += (out.empty() ? "" : " ") + s;
+            return out;
+        }
+    };
+
+    std::vector<std::string> expected(const std::vector<StandInOperation>& standard, bool useStandard, bool quad)
+    {
+        std::vector<std::string> out;
+        if (!useStandard)
+        {
+            out.push_back("aoScene");
+            if (quad) out.push_back("aoQuad");
+            out.push_back("aoHud");
+            out.push_back("aoPresent");
+            return out;
+        }
+
+        bool hasHud = false, hasPresent = false;
+        for (const StandInOperation& op : standard)
+        {
+            hasHud     |= op.kind == kStandardHud;
+            hasPresent |= op.kind == kStandardPresent;
+        }
+
+        bool placed = false;
+        for (const StandInOperation& op : standard)
+        {
+            const bool anchor = hasHud ? op.kind == kStandardHud : op.kind == kStandardPresent;
+            if (anchor && !placed)
+            {
+                if (quad) out.push_back("aoQuad");
+                out.push_back("aoHud");
+                placed = true;
+            }
+            if (op.kind != kStandardHud) out.push_back(op.name);
+        }
+        if (!placed)
+        {
+            if (quad) out.push_back("aoQuad");
+            out.push_back("aoHud");
+        }
+        return out;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--verbose") == 0)
+            verbose = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    struct Case
+    {
+        const char*                   name;
+        std::vector<StandInOperation> ops;
+    };
+    std::vector<Case> cases;
+    cases.push_back({ "standard", mayaStandard() });
+    {
+        std::vector<StandInOperation> ops = mayaStandard();
+        ops.erase(ops.begin() + 6); // HUD
+        cases.push_back({ "no HUD", ops });
+        ops.pop_back();             // Present
+        cases.push_back({ "no HUD, no present", ops });
+    }
+    cases.push_back({ "unavailable", {} });
+    {
+        std::vector<StandInOperation> ops = mayaStandard();
+        while ((int)ops.size() + 2 <= kMaxPipelineSteps)
+            ops.insert(ops.begin() + 4, StandInOperation{ "Extra", kStandardOther, false });
+        cases.push_back({ "too long", ops });
+    }
+
+    int failures = 0;
+    StandInRenderer renderer;
+    PipelinePlan plan;
+    for (const Case& c : cases)
+    {
+        std::vector<StandardOperation> kinds;
+        for (const StandInOperation& op : c.ops) kinds.push_back(op.kind);
+
+        for (int mask = 0; mask < 8; ++mask)
+        {
+            PipelineInput in;
+            in.standardPipeline = (mask & 1) != 0;
+            in.bgEnable         = (mask & 2) != 0;
+            in.quadPass         = (mask & 4) != 0;
+            in.standard         = kinds.empty() ? nullptr : kinds.data();
+            in.standardCount    = (int)kinds.size();
+
+            planPipeline(in, plan);
+            renderer.run(plan, c.ops);
+
+            const bool useStandard = in.standardPipeline && !in.bgEnable && !c.ops.empty() &&
+                                     (int)c.ops.size() + 2 <= kMaxPipelineSteps;
+            const std::vector<std::string> want = expected(c.ops, useStandard, in.quadPass);
+            const bool ok = plan.usesStandard == useStandard && renderer.sequence == want && renderer.clears == 1;
+            failures += !ok;
+
+            if (!ok || verbose)
+            {
+                std::printf("%s %-20s pipeline=%s bg=%d quad=%d clears=%d: %s\n", ok ? "  ok" : "FAIL", c.name,
+                            in.standardPipeline ? "standard" : "replace", in.bgEnable, in.quadPass,
+                            renderer.clears, renderer.text().c_str());
+            }
+        }
+    }
+
+    // once per panel per frame
+    std::vector<StandardOperation> kinds;
+    for (const StandInOperation& op : mayaStandard()) kinds.push_back(op.kind);
+    PipelineInput in;
+    in.standardPipeline = true;
+    in.quadPass         = true;
+    in.standard         = kinds.data();
+    in.standardCount    = (int)kinds.size();
+
+    const int iterations = 1000000;
+    uint64_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        in.bgEnable = (i & 255) == 0;
+        planPipeline(in, plan);
+        sink += (uint64_t)plan.count;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    std::printf("cases %zu x 8, failures %d\n", cases.size(), failures);
+    std::printf("  planPipeline       %8.1f ns (%llu steps)\n",
+                std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations,
+                (unsigned long long)sink);
+    return failures == 0 ? 0 : 1;
+}
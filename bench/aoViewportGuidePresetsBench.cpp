@@ -0,0 +1,262 @@
+// aoViewportGuidePresetsBench.cpp (v0.3.1)
+// Preset libraries: writes a JSON library of random presets (savePreset() for the
+// first few, then the rest in one go), then times opening it with and without the
+// compiled cache and looking presets up by name. Every preset must come back
+// bit exact from both the JSON and the cache, a cache with a damaged bucket
+// table must fall back to the JSON, and a damaged record must come back within
+// the attribute ranges; exits with 1 when one does not.
+//
+//   ao_guide_bench_presets [--presets N] [--dir path]
+
+#include "aoViewportGuidePresets.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    SettingsData randomSettings(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_int_distribution<int> pick(0, 1000);
+
+        SettingsData s;
+        s.guideType     = pick(rng) % 5;
+        s.goldenRotation = pick(rng) % 4;
+        s.goldenFlipH   = pick(rng) % 2 != 0;
+        s.lineOpacity   = unit(rng);
+        s.lineThickness = 0.5f + unit(rng) * 8.0f;
+        s.lineColor     = Rgba{ unit(rng), unit(rng), unit(rng), 1.0f };
+        s.maskEnable    = pick(rng) % 2 != 0;
+        s.maskOpacity   = unit(rng);
+
+        const int layers = pick(rng) % 5;
+        for (int i = 0; i < layers; ++i)
+        {
+            const int l = addGuideLayer(s.layers, pick(rng) % kLayerTypeCount);
+            s.layers.columns[l] = (uint16_t)(1 + pick(rng) % 12);
+            s.layers.opacity[l] = unit(rng);
+            s.layers.colorG[l]  = unit(rng);
+        }
+        sanitizeSettings(s);
+        return s;
+    }
+
+    template <class F>
+    double msFor(F&& f)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        f();
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+
+    volatile uint64_t gSink = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int count = 2000;
+    std::string dir = (std::filesystem::temp_directory_path() / "ao_guide_bench_presets").string();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--presets") == 0 && i + 1 < argc)
+            count = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+            dir = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--presets N] [--dir path]\n", argv[0]);
+            return 2;
+        }
+    }
+    count = (std::max)(4, count);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    const std::string path = (std::filesystem::path(dir) / "presets.json").string();
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(presetCachePath(path), ec);
+
+    std::mt19937 rng(5);
+    std::vector<std::string> names;
+    std::vector<PackedSettings> expected;
+    for (int i = 0; i < count; ++i)
+    {
+        names.push_back("preset " + std::to_string(i));
+        expected.push_back(packSettings(randomSettings(rng)));
+    }
+
+    // the first few through savePreset() (append, then replace), the rest at once
+    std::string error;
+    const int saved = 3;
+    for (int i = 0; i < saved; ++i)
+    {
+        if (!savePreset(path, names[i], unpackSettings(packSettings(SettingsData())), error) ||
+            !savePreset(path, names[i], unpackSettings(expected[i]), error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+    uint64_t mismatches = 0;
+    {
+        PresetLibrary lib;
+        PackedSettings p;
+        if (!lib.open(path, error) || !lib.fromCache() || lib.size() != (size_t)saved) ++mismatches;
+        for (int i = 0; i < saved; ++i)
+        {
+            const int at = lib.find(names[i]);
+            if (at != i || !lib.settings((size_t)at, p, error) || p != expected[i]) ++mismatches;
+        }
+    }
+    {
+        std::string json = "{\n  \"presets\": [\n";
+        for (int i = 0; i < count; ++i)
+        {
+            if (i) json += ",\n";
+            json += formatPresetJson(names[i], unpackSettings(expected[i]));
+        }
+        json += "\n  ]\n}\n";
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << json;
+    }
+    std::filesystem::remove(presetCachePath(path), ec);
+
+    auto check = [&](const PresetLibrary& lib)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            PackedSettings p;
+            const int at = lib.find(names[i]);
+            if (at < 0 || !lib.settings((size_t)at, p, error) || p != expected[i]) ++mismatches;
+        }
+        if (lib.find("no such preset") >= 0) ++mismatches;
+    };
+
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    // JSON only: the open scans names, each preset parses on first use
+    PresetLibrary lib;
+    const double jsonOpenMs = msFor([&] { if (!lib.open(path, error)) std::fprintf(stderr, "%s\n", error.c_str()); });
+    const bool jsonFromCache = lib.fromCache();
+    const double jsonFirstMs = msFor([&]
+    {
+        PackedSettings p;
+        for (int i : order) { lib.settings((size_t)lib.find(names[i]), p, error); gSink += p.guideType; }
+    });
+    check(lib);
+    lib.close();
+
+    // compiled cache: one mapping, one record per lookup
+    const double compileMs = msFor([&] { if (!compilePresetCache(path, error)) std::fprintf(stderr, "%s\n", error.c_str()); });
+    const double cacheOpenMs = msFor([&] { lib.open(path, error); });
+    const bool cacheFromCache = lib.fromCache();
+    const int passes = 20;
+    const double cacheLookupMs = msFor([&]
+    {
+        PackedSettings p;
+        for (int pass = 0; pass < passes; ++pass)
+            for (int i : order) { lib.settings((size_t)lib.find(names[i]), p, error); gSink += p.guideType; }
+    });
+    check(lib);
+    lib.close();
+
+    // damaged bucket table, stamp still current: no bucket empty (find() would
+    // never stop), then a slot past the entries. Header fields at their offsets in
+    // the cache layout (bucketCount at 12, bucketsOffset at 48).
+    {
+        const std::string cachePath = presetCachePath(path);
+        std::string original;
+        {
+            std::ifstream in(cachePath, std::ios::binary);
+            original.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        uint32_t bucketCount = 0;
+        uint64_t bucketsOffset = 0;
+        std::memcpy(&bucketCount, original.data() + 12, sizeof(bucketCount));
+        std::memcpy(&bucketsOffset, original.data() + 48, sizeof(bucketsOffset));
+
+        for (int damage = 0; damage < 2; ++damage)
+        {
+            std::string damaged = original;
+            char* buckets = &damaged[bucketsOffset];
+            for (uint32_t b = 0; b < bucketCount; ++b)
+            {
+                uint32_t slot = 0;
+                std::memcpy(&slot, buckets + b * sizeof(slot), sizeof(slot));
+                if (damage == 0 && slot == 0) slot = 1;
+                if (damage == 1 && b == 0) slot = (uint32_t)count + 1;
+                std::memcpy(buckets + b * sizeof(slot), &slot, sizeof(slot));
+            }
+            std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << damaged;
+
+            lib.open(path, error);
+            if (lib.fromCache()) ++mismatches;
+            check(lib);
+            lib.close();
+        }
+
+        // damaged record (recordsOffset at 56): a layer count past the arrays and
+        // enums past their ranges come back sanitized, the other records as written
+        uint64_t recordsOffset = 0;
+        std::memcpy(&recordsOffset, original.data() + 56, sizeof(recordsOffset));
+        {
+            std::string damaged = original;
+            char* record = &damaged[recordsOffset];
+            record[offsetof(PackedSettings, layers) + offsetof(GuideLayerStack, count)] = (char)255;
+            record[offsetof(PackedSettings, guideType)]   = (char)200;
+            record[offsetof(PackedSettings, drawBackend)] = (char)9;
+            std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << damaged;
+
+            lib.open(path, error);
+            if (!lib.fromCache()) ++mismatches;
+            PackedSettings p;
+            if (!lib.settings(0, p, error) || p.layers.count > kMaxGuideLayers ||
+                p.guideType > kGuideGoldenSpiral || p.drawBackend > kDrawBackendShader)
+                ++mismatches;
+            for (int i = 0; i < count; ++i)
+            {
+                const int at = lib.find(names[i]);
+                if (at == 0) continue;
+                if (at < 0 || !lib.settings((size_t)at, p, error) || p != expected[i]) ++mismatches;
+            }
+            lib.close();
+        }
+        std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << original;
+    }
+
+    // a newer JSON makes the cache stale
+    {
+        std::ofstream(path, std::ios::binary | std::ios::app) << "\n";
+        lib.open(path, error);
+        if (lib.fromCache()) ++mismatches;
+        lib.close();
+    }
+
+    const double bytes = (double)std::filesystem::file_size(path, ec);
+    std::printf("presets %d (%.0f KiB JSON, %.0f KiB cache)\n", count, bytes / 1024.0,
+                (double)std::filesystem::file_size(presetCachePath(path), ec) / 1024.0);
+    std::printf("  JSON open (index)    %10.3f ms%s\n", jsonOpenMs, jsonFromCache ? " (cache!)" : "");
+    std::printf("  JSON first use       %10.3f us/preset\n", 1000.0 * jsonFirstMs / count);
+    std::printf("  compile cache        %10.3f ms\n", compileMs);
+    std::printf("  cache open           %10.3f ms%s\n", cacheOpenMs, cacheFromCache ? "" : " (no cache!)");
+    std::printf("  cache lookup         %10.3f us/preset\n", 1000.0 * cacheLookupMs / ((double)count * passes));
+    std::printf("  mismatches           %10llu\n", (unsigned long long)mismatches);
+
+    return mismatches == 0 && !jsonFromCache && cacheFromCache ? 0 : 1;
+}
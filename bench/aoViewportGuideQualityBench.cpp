@@ -0,0 +1,153 @@
+// aoViewportGuideQualityBench.cpp (v0.3.1)
+// Adaptive overlay quality: a heavy overlay (golden spiral, dense grid, circle
+// and safe area layers, wide lines) is drawn through drawGuideOverlay() while the
+// gate changes every frame (zooming a 2D pan/zoom camera, so every frame
+// rebuilds). Reports the cost and submitted points of each quality level, then
+// drives QualityGovernor through idle / interactive / idle phases with a budget
+// under the full quality cost. Exits with 1 when the governor passes the floor,
+// never steps down while over budget, or is not back at full quality on the
+// first idle frame. Builds against the stand-in SDK in bench/standin.
+//
+//   ao_guide_bench_quality [--frames N] [--width W] [--height H]
+
+#include "aoViewportGuideHudDraw.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    SettingsData heavySettings()
+    {
+        SettingsData s;
+        s.guideType     = kGuideGoldenSpiral;
+        s.lineThickness = 6.0f;
+        s.maskEnable    = true;
+        parseGuideLayer(s.layers, "grid columns=192 rows=108 opacity=0.3");
+        parseGuideLayer(s.layers, "circle thickness=4");
+        parseGuideLayer(s.layers, "safe action=90 title=80 thickness=3");
+        sanitizeSettings(s);
+        return s;
+    }
+
+    GateRect gateAt(int frame, int width, int height)
+    {
+        // zooming in and out: a different gate every frame
+        const double k = 0.8 + 0.15 * (double)(frame % 64) / 63.0;
+        const double w = width * k, h = w * 9.0 / 16.0;
+        const double cx = width * 0.5, cy = height * 0.5;
+        return GateRect{ cx - w * 0.5, cy - h * 0.5, cx + w * 0.5, cy + h * 0.5 };
+    }
+
+    struct FrameResult
+    {
+        uint64_t ns;
+        size_t   points;
+        float    maxWidth;
+    };
+
+    FrameResult drawFrame(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t shapeHash,
+                          const GateRect& gate, HudDrawState& st, int level)
+    {
+        dm.beginFrame();
+        const uint64_t t0 = statsNow();
+        drawGuideOverlay(dm, s, shapeHash, gate, st, true, level);
+        const uint64_t ns = statsNow() - t0;
+
+        FrameResult r{ ns, 0, 0.0f };
+        for (size_t i = 0; i < dm.primitiveCount(); ++i)
+        {
+            r.points  += dm.primitive(i).points.size();
+            r.maxWidth = (std::max)(r.maxWidth, dm.primitive(i).lineWidth);
+        }
+        return r;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 300;
+    int width = 3840, height = 2160;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+            width = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc)
+            height = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--width W] [--height H]\n", argv[0]);
+            return 2;
+        }
+    }
+    frames = (std::max)(60, frames);
+
+    const SettingsData s = heavySettings();
+    const uint64_t shapeHash = hashSettingsShape(packSettings(s));
+    MHWRender::MUIDrawManager dm;
+
+    // fixed levels
+    double levelNs[kQualityLevelCount] = {};
+    std::printf("%dx%d, %d frames, gate changing every frame\n", width, height, frames);
+    for (int level = 0; level < kQualityLevelCount; ++level)
+    {
+        HudDrawState st;
+        uint64_t total = 0;
+        size_t points = 0;
+        float maxWidth = 0.0f;
+        for (int f = 0; f < frames; ++f)
+        {
+            const FrameResult r = drawFrame(dm, s, shapeHash, gateAt(f, width, height), st, level);
+            total += r.ns;
+            points = r.points;
+            maxWidth = r.maxWidth;
+        }
+        levelNs[level] = (double)total / frames;
+        std::printf("  level %d  %10.1f us/frame  %7zu points  width <= %.0f\n",
+                    level, levelNs[level] * 1.0e-3, points, maxWidth);
+    }
+
+    // governor: idle, interacting with a budget at 40% of full quality, idle again
+    const double budgetNs = 0.4 * levelNs[kQualityFull];
+    int failures = 0;
+    for (int floorLevel = kQualityFull; floorLevel < kQualityLevelCount; ++floorLevel)
+    {
+        QualityGovernor governor;
+        HudDrawState st;
+        int maxLevel = 0;
+        uint64_t interactNs = 0, savedNs = 0;
+        const int idle = 30, interact = frames;
+
+        for (int f = 0; f < idle + interact + 1; ++f)
+        {
+            const bool interacting = f >= idle && f < idle + interact;
+            const int level = governor.beginFrame(true, floorLevel, budgetNs, interacting);
+            const FrameResult r = drawFrame(dm, s, shapeHash, gateAt(f, width, height), st, level);
+            const uint64_t saved = governor.endFrame(r.ns);
+
+            maxLevel = (std::max)(maxLevel, level);
+            if (interacting) { interactNs += r.ns; savedNs += saved; }
+            if (level > floorLevel) ++failures;
+            if (!interacting && level != kQualityFull) ++failures;
+        }
+
+        // over budget at full quality: any floor below full must have been used
+        if (floorLevel > kQualityFull && maxLevel == kQualityFull) ++failures;
+
+        std::printf("  floor %d  interactive %8.1f us/frame (budget %.1f)  deepest level %d  saved %8.1f us/frame\n",
+                    floorLevel, (double)interactNs / interact * 1.0e-3, budgetNs * 1.0e-3, maxLevel,
+                    (double)savedNs / interact * 1.0e-3);
+    }
+
+    std::printf("  failures %d\n", failures);
+    return failures == 0 ? 0 : 1;
+}
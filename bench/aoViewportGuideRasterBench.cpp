@@ -0,0 +1,222 @@
+// aoViewportGuideRasterBench.cpp (v0.3.1)
+// Throughput of the CPU guide rasterizer (megapixels/s) per kernel ISA against
+// the per-pixel field (shadeGuidePixel), and the largest channel difference
+// between the two. Maya-free.
+//
+//   ao_guide_bench_raster [--frames N] [--json out.json|-]
+
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideField.h"
+#include "aoViewportGuideGateFit.h"
+#include "aoViewportGuideRaster.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    struct Result
+    {
+        const char* path;
+        const char* guide;
+        int    width;
+        int    height;
+        float  lineWidth;
+        double megapixelsPerSecond;
+        double maxDiff;
+    };
+
+    GuideFieldParams makeParams(int guideType, float lineWidth, int width, int height)
+    {
+        SettingsData s;
+        s.guideType           = guideType;
+        s.lineThickness       = lineWidth;
+        s.lineOpacity         = 0.8f;
+        s.lineColor           = Rgba{ 0.0f, 1.0f, 0.0f, 1.0f };
+        s.gateBorderEnable    = true;
+        s.gateBorderOpacity   = 1.0f;
+        s.gateBorderThickness = 2.0f;
+        s.maskEnable          = true;
+        s.maskOpacity         = 0.5f;
+        sanitizeSettings(s);
+
+        GateParams gp;
+        gp.resolutionAspect = 2.39;
+        return makeGuideFieldParams(s, fitGateRect(gp, 0, 0, width, height));
+    }
+
+    // composites the per-pixel field like the pre-rasterizer burn-in did
+    void compositeField(const GuideFieldParams& p, int width, int height, float* rgba)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            float* row = rgba + (size_t)y * (size_t)width * 4;
+            for (int x = 0; x < width; ++x)
+            {
+                const Rgba c = shadeGuidePixel(p, (float)x + 0.5f, (float)y + 0.5f);
+                if (c.a <= 0.0f) continue;
+
+                float* d = row + (size_t)x * 4;
+                const float k = 1.0f - c.a;
+                d[0] = c.r * c.a + d[0] * k;
+                d[1] = c.g * c.a + d[1] * k;
+                d[2] = c.b * c.a + d[2] * k;
+                d[3] = c.a + d[3] * k;
+            }
+        }
+    }
+
+    void clearImage(std::vector<float>& rgba)
+    {
+        for (size_t i = 0; i < rgba.size(); i += 4)
+        {
+            rgba[i + 0] = 0.2f;
+            rgba[i + 1] = 0.2f;
+            rgba[i + 2] = 0.2f;
+            rgba[i + 3] = 1.0f;
+        }
+    }
+
+    double maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        double m = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const double d = std::fabs((double)a[i] - (double)b[i]);
+            if (d > m) m = d;
+        }
+        return m;
+    }
+
+    template <class Fn>
+    double megapixelsPerSecond(int frames, int width, int height, std::vector<float>& image, Fn&& drawFrame)
+    {
+        clearImage(image);
+        drawFrame(); // warm-up: coverage buffer reaches its size
+
+        double seconds = 0.0;
+        for (int i = 0; i < frames; ++i)
+        {
+            clearImage(image);
+            const auto t0 = std::chrono::steady_clock::now();
+            drawFrame();
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+        return (double)width * (double)height * (double)frames / seconds * 1.0e-6;
+    }
+
+    void writeJson(std::FILE* f, int frames, const std::vector<Result>& results)
+    {
+        std::fprintf(f, "{\n  \"version\": \"%s\",\n  \"frames\": %d,\n  \"best_isa\": \"%s\",\n  \"results\": [\n",
+                     kVersion, frames, rasterIsaName(rasterBestIsa()));
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(f,
+                "    {\"path\": \"%s\", \"guide\": \"%s\", \"width\": %d, \"height\": %d, \"line_width\": %.1f, "
+                "\"mpix_per_s\": %.1f, \"max_diff\": %.4f}%s\n",
+                r.path, r.guide, r.width, r.height, r.lineWidth, r.megapixelsPerSecond, r.maxDiff,
+                (i + 1 < results.size()) ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 20;
+    const char* jsonPath = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--json out.json|-]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    static const char* kGuideNames[] = { "thirds", "cross", "circle", "phi" };
+    const int resolutions[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    const float lineWidths[] = { 2.0f, 8.0f };
+
+    std::vector<Result> results;
+    for (const auto& res : resolutions)
+    {
+        const int width = res[0], height = res[1];
+        std::vector<float> reference((size_t)width * (size_t)height * 4);
+        std::vector<float> image(reference.size());
+
+        RasterTarget target;
+        target.row0      = image.data();
+        target.rowStride = (ptrdiff_t)width * 4;
+        target.width     = width;
+        target.height    = height;
+
+        for (int guideType = kGuideThirds; guideType <= kGuidePhiGrid; ++guideType)
+            for (float lineWidth : lineWidths)
+            {
+                const GuideFieldParams p = makeParams(guideType, lineWidth, width, height);
+
+                const double fieldMps = megapixelsPerSecond(frames, width, height, reference, [&]
+                {
+                    compositeField(p, width, height, reference.data());
+                });
+                results.push_back(Result{ "field", kGuideNames[guideType], width, height, lineWidth, fieldMps, 0.0 });
+
+                for (int isa = kRasterScalar; isa <= (int)rasterBestIsa(); ++isa)
+                {
+                    setRasterIsa((RasterIsa)isa);
+                    if ((int)rasterIsa() != isa) continue;
+
+                    GuideRasterizer raster;
+                    const double mps = megapixelsPerSecond(frames, width, height, image, [&]
+                    {
+                        rasterizeGuides(raster, target, p);
+                    });
+                    results.push_back(Result{ rasterIsaName((RasterIsa)isa), kGuideNames[guideType],
+                                              width, height, lineWidth, mps, maxDifference(image, reference) });
+                }
+                setRasterIsa(rasterBestIsa());
+            }
+    }
+
+    const bool jsonToStdout = jsonPath && std::strcmp(jsonPath, "-") == 0;
+    if (!jsonToStdout)
+    {
+        std::printf("best isa: %s\n", rasterIsaName(rasterBestIsa()));
+        std::printf("%-7s %-7s %11s %6s %12s %9s\n", "path", "guide", "resolution", "width", "Mpix/s", "max diff");
+        for (const Result& r : results)
+        {
+            char res[32];
+            std::snprintf(res, sizeof(res), "%dx%d", r.width, r.height);
+            std::printf("%-7s %-7s %11s %6.1f %12.1f %9.4f\n",
+                        r.path, r.guide, res, r.lineWidth, r.megapixelsPerSecond, r.maxDiff);
+        }
+    }
+
+    if (jsonPath)
+    {
+        std::FILE* f = jsonToStdout ? stdout : std::fopen(jsonPath, "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "cannot write %s\n", jsonPath);
+            return 1;
+        }
+        writeJson(f, frames, results);
+        if (!jsonToStdout) std::fclose(f);
+    }
+    return 0;
+}
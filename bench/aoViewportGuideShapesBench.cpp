@@ -0,0 +1,286 @@
+// aoViewportGuideShapesBench.cpp (v0.3.1)
+// User guide shapes: writes a directory of generated shape files, then times
+// loading it with compiling (no caches) against mapping the compiled caches,
+// and drawing a shape from its program against parsing it every frame. Checks
+// that mapped programs match a fresh compile, that a rect lands on the gate
+// where it should, and hot reloading: one file is rewritten while a reader
+// thread keeps drawing; only that file's program may change and the reader
+// must never miss a shape. Exits with 1 on any failure.
+//
+//   ao_guide_bench_shapes [--files N] [--paths N] [--frames N]
+
+#include "aoViewportGuideShapes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace AoViewportGuide;
+
+namespace
+{
+    std::string shapeJson(const std::string& name, int paths, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        char buf[256];
+        std::string out = "{ \"name\": \"" + name + "\",\n  \"paths\": [";
+        for (int i = 0; i < paths; ++i)
+        {
+            std::snprintf(buf, sizeof(buf), "%s\n    \"M %.4f %.4f L %.4f %.4f C %.4f %.4f %.4f %.4f %.4f %.4f q %.4f %.4f %.4f %.4f Z\"",
+                          i ? "," : "", unit(rng), unit(rng), unit(rng), unit(rng), unit(rng), unit(rng),
+                          unit(rng), unit(rng), unit(rng), unit(rng), 0.1 * unit(rng), 0.1 * unit(rng),
+                          0.1 * unit(rng), 0.1 * unit(rng));
+            out += buf;
+        }
+        out += "],\n  \"rects\": [[0.25, 0.25, 0.75, 0.75]],\n"
+               "  \"ellipses\": [[0.5, 0.5, 0.1, 0.15]],\n"
+               "  \"extractions\": [2.39] }\n";
+        return out;
+    }
+
+    bool writeText(const fs::path& path, const std::string& text)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+        return (bool)out;
+    }
+
+    std::string readText(const fs::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void removeCaches(const fs::path& dir)
+    {
+        std::error_code ec;
+        for (const fs::directory_entry& e : fs::directory_iterator(dir, ec))
+        {
+            if (e.path().extension() == ".bin") fs::remove(e.path(), ec);
+        }
+    }
+
+    double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    volatile size_t gSink = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int files = 64;
+    int paths = 64;
+    int frames = 2000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--files") == 0 && i + 1 < argc)
+            files = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--paths") == 0 && i + 1 < argc)
+            paths = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--files N] [--paths N] [--frames N]\n", argv[0]);
+            return 2;
+        }
+    }
+    files  = (std::max)(2, (std::min)(files, kMaxGuideShapes));
+    paths  = (std::max)(1, paths);
+    frames = (std::max)(1, frames);
+
+    std::error_code ec;
+    const fs::path dir = fs::temp_directory_path(ec) /
+        ("ao_guide_shapes_" + std::to_string((unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(dir, ec);
+    if (ec) { std::fprintf(stderr, "cannot create %s\n", dir.string().c_str()); return 2; }
+
+    std::mt19937 rng(23);
+    for (int i = 0; i < files; ++i)
+    {
+        const std::string name = "shape" + std::to_string(i);
+        if (!writeText(dir / (name + ".json"), shapeJson(name, paths, rng)))
+        {
+            std::fprintf(stderr, "cannot write %s\n", dir.string().c_str());
+            return 2;
+        }
+    }
+
+    uint64_t failures = 0;
+    std::string error;
+    ShapeLibrary library;
+
+    // load: compile everything (and write the caches), then map the caches
+    removeCaches(dir);
+    auto t0 = std::chrono::steady_clock::now();
+    if (!library.setSearchPath(dir.string(), error)) { std::fprintf(stderr, "%s\n", error.c_str()); ++failures; }
+    const double compileMs = msSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    if (!library.setSearchPath(dir.string(), error)) { std::fprintf(stderr, "%s\n", error.c_str()); ++failures; }
+    const double mapMs = msSince(t0);
+
+    size_t mapped = 0, ops = 0;
+    for (const ShapeLibrary::Entry& e : library.entries())
+    {
+        mapped += e.fromCache;
+        ops += e.opCount;
+    }
+    if ((int)library.entries().size() != files) ++failures;
+
+    // every mapped program matches a fresh compile
+    uint64_t mismatches = 0;
+    for (int i = 0; i < files; ++i)
+    {
+        const std::string name = "shape" + std::to_string(i);
+        const std::string text = readText(dir / (name + ".json"));
+        ShapeCode code;
+        const std::shared_ptr<const ShapeProgram> p = library.find(guideShapeId(name));
+        if (!p || !compileShape(text.data(), text.size(), code, error) ||
+            p->opCount() != code.ops.size() || p->pointCount() * 2 != code.points.size() ||
+            std::memcmp(p->ops(), code.ops.data(), code.ops.size()) != 0 ||
+            std::memcmp(p->points(), code.points.data(), code.points.size() * sizeof(float)) != 0)
+            ++mismatches;
+    }
+    failures += mismatches;
+
+    // a rect lands on the gate: (0.25, 0.25)-(0.75, 0.75) of a 1000 x 500 gate at (100, 50)
+    {
+        const char rect[] = "{ \"rects\": [[0.25, 0.25, 0.75, 0.75]] }";
+        const fs::path path = dir / "rect.json";
+        writeText(path, rect);
+        ShapeProgram p;
+        LineBatch out;
+        if (p.load(path.string(), error))
+        {
+            appendShape(p, GateRect{ 100.0, 50.0, 1100.0, 550.0 }, 0.25, out);
+            const Point2 expect[4] = { { 350.0, 425.0 }, { 850.0, 425.0 }, { 850.0, 175.0 }, { 350.0, 175.0 } };
+            bool ok = out.points.size() == 4 && out.segmentCount() == 4 && p.name() == "rect";
+            for (int k = 0; ok && k < 4; ++k)
+                ok = out.points[k].x == expect[k].x && out.points[k].y == expect[k].y;
+            if (!ok) { std::fprintf(stderr, "rect shape placed wrong\n"); ++failures; }
+        }
+        else
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            ++failures;
+        }
+        fs::remove(path, ec);
+        fs::remove(shapeCachePath(path.string()), ec);
+    }
+
+    // per frame: transform the program vs parse + transform (moving gate)
+    const std::string name0 = "shape0";
+    const std::string text0 = readText(dir / (name0 + ".json"));
+    const std::shared_ptr<const ShapeProgram> shape0 = library.find(guideShapeId(name0));
+    LineBatch lines;
+    size_t segments = 0;
+
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames && shape0; ++f)
+    {
+        lines.clear();
+        appendShape(*shape0, GateRect{ (double)(f % 7), 0.0, 1920.0, 1080.0 }, 0.25, lines);
+        gSink += lines.points.size();
+    }
+    const double transformUs = msSince(t0) * 1000.0 / frames;
+    segments = lines.segmentCount();
+
+    ShapeCode scratch;
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+    {
+        compileShape(text0.data(), text0.size(), scratch, error);
+        gSink += scratch.ops.size();
+    }
+    const double parseUs = msSince(t0) * 1000.0 / frames;
+
+    // hot reload: rewrite one file while a reader keeps drawing every shape
+    library.startWatching();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // watches in place
+
+    std::vector<std::shared_ptr<const ShapeProgram>> before;
+    for (int i = 0; i < files; ++i) before.push_back(library.find(guideShapeId("shape" + std::to_string(i))));
+
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> missed{ 0 }, reads{ 0 };
+    std::thread reader([&]
+    {
+        LineBatch out;
+        while (!stop.load())
+        {
+            for (int i = 0; i < files; ++i)
+            {
+                const std::shared_ptr<const ShapeProgram> p = library.find(guideShapeId("shape" + std::to_string(i)));
+                if (!p) { ++missed; continue; }
+                out.clear();
+                appendShape(*p, GateRect{ 0.0, 0.0, 1920.0, 1080.0 }, 0.5, out);
+                ++reads;
+            }
+        }
+    });
+
+    const int changed = files / 2;
+    const std::string changedName = "shape" + std::to_string(changed);
+    const uint64_t generation = library.generation();
+    t0 = std::chrono::steady_clock::now();
+    {
+        // written to the side and renamed over, as editors save
+        const fs::path tmp = dir / (changedName + ".json.part");
+        writeText(tmp, "{ \"name\": \"" + changedName + "\", \"lines\": [[0, 0.5, 1, 0.5]] }");
+        fs::rename(tmp, dir / (changedName + ".json"), ec);
+    }
+
+    std::shared_ptr<const ShapeProgram> after;
+    while (msSince(t0) < 5000.0)
+    {
+        after = library.find(guideShapeId(changedName));
+        if (library.generation() != generation && after && after->opCount() == 2) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double reloadMs = msSince(t0);
+    const bool reloaded = after && after->opCount() == 2;
+    if (!reloaded) { std::fprintf(stderr, "changed shape was not reloaded\n"); ++failures; }
+
+    stop.store(true);
+    reader.join();
+    library.stopWatching();
+    failures += missed.load();
+
+    // only the changed file was recompiled
+    size_t recompiled = 0;
+    for (int i = 0; i < files; ++i)
+    {
+        if (library.find(guideShapeId("shape" + std::to_string(i))) != before[i]) ++recompiled;
+    }
+    if (recompiled != 1) { std::fprintf(stderr, "%zu programs swapped, expected 1\n", recompiled); ++failures; }
+
+    fs::remove_all(dir, ec);
+
+    std::printf("files %d, paths per file %d, frames %d\n", files, paths, frames);
+    std::printf("  load, compiling    %12.2f ms (%d files, %zu ops)\n", compileMs, files, ops);
+    std::printf("  load, mapped       %12.2f ms (%zu from cache)\n", mapMs, mapped);
+    std::printf("  parse per frame    %12.2f us\n", parseUs);
+    std::printf("  transform / frame  %12.2f us (%zu segments)\n", transformUs, segments);
+    std::printf("  hot reload         %12.2f ms (%zu recompiled, %llu reader draws)\n",
+                reloadMs, recompiled, (unsigned long long)reads.load());
+    std::printf("  mismatches         %12llu\n", (unsigned long long)mismatches);
+    std::printf("  missed reads       %12llu\n", (unsigned long long)missed.load());
+    std::printf("  failures           %12llu\n", (unsigned long long)failures);
+
+    return failures == 0 ? 0 : 1;
+}
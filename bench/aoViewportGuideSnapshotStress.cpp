@@ -0,0 +1,189 @@
+// aoViewportGuideSnapshotStress.cpp (v0.3.1)
+// Stress test of the settings SnapshotBuffer with what the plugin publishes
+// (packed settings and their hashes, as in AoViewportGuideSettings). First
+// checks the single-threaded contract (empty buffer, generations, latest value
+// read back), then writer threads publish values whose fields are all derived
+// from one counter while reader threads check every snapshot for torn fields
+// and generations going backwards. Prints reads/s and retries, and exits with
+// 1 on the first inconsistency.
+//
+//   ao_guide_stress_snapshot [--writers N] [--readers N] [--seconds S]
+
+#include "aoViewportGuideSettingsData.h"
+#include "aoViewportGuideSnapshotBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    // mirrors PublishedSettings in aoViewportGuideSettings.cpp
+    struct Published
+    {
+        PackedSettings packed;
+        uint64_t       hash;
+        uint64_t       shapeHash;
+    };
+
+    // Every 32-bit word of the packed layout (no padding) carries k, so a read
+    // mixing two publishes differs somewhere.
+    Published makeValue(uint32_t k)
+    {
+        static constexpr size_t kWords = sizeof(PackedSettings) / sizeof(uint32_t);
+        uint32_t words[kWords];
+        std::fill(words, words + kWords, k);
+
+        Published p;
+        std::memcpy(&p.packed, words, sizeof(PackedSettings));
+        p.hash      = (uint64_t)k * 0x9E3779B97F4A7C15ull;
+        p.shapeHash = ~p.hash;
+        return p;
+    }
+
+    // k of makeValue(k)
+    uint32_t valueOf(const Published& p)
+    {
+        uint32_t k = 0;
+        std::memcpy(&k, &p.packed, sizeof(k));
+        return k;
+    }
+
+    bool consistent(const Published& p)
+    {
+        const Published expected = makeValue(valueOf(p));
+        return p.packed == expected.packed && p.hash == expected.hash && p.shapeHash == expected.shapeHash;
+    }
+
+    // What the settings cache relies on without any concurrency: nothing published
+    // reads generation 0 and a zero value, every publish makes a new generation
+    // current, and reads return the last value until the next publish.
+    bool checkSequential()
+    {
+        SnapshotBuffer<Published> buffer;
+
+        const SnapshotBuffer<Published>::Snapshot empty = buffer.read();
+        if (empty.generation != 0 || buffer.generation() != 0 || valueOf(empty.data) != 0)
+        {
+            std::fprintf(stderr, "empty buffer: generation %llu, value %u\n",
+                         (unsigned long long)empty.generation, valueOf(empty.data));
+            return false;
+        }
+
+        uint64_t last = 0;
+        for (uint32_t k = 1; k <= 10; ++k)
+        {
+            const uint64_t gen = buffer.publish(makeValue(k));
+            if (gen <= last || buffer.generation() != gen)
+            {
+                std::fprintf(stderr, "publish %u: generation %llu after %llu\n",
+                             k, (unsigned long long)gen, (unsigned long long)last);
+                return false;
+            }
+            last = gen;
+
+            // more reads than slots: reading never advances or consumes anything
+            for (int r = 0; r < 4; ++r)
+            {
+                const SnapshotBuffer<Published>::Snapshot snap = buffer.read();
+                if (snap.generation != gen || valueOf(snap.data) != k || !consistent(snap.data))
+                {
+                    std::fprintf(stderr, "publish %u: read generation %llu, value %u\n",
+                                 k, (unsigned long long)snap.generation, valueOf(snap.data));
+                    return false;
+                }
+            }
+        }
+
+        if (buffer.publishes() != 10 || buffer.reads() != 41 || buffer.retries() != 0)
+        {
+            std::fprintf(stderr, "counters: %llu publishes, %llu reads, %llu retries\n",
+                         (unsigned long long)buffer.publishes(), (unsigned long long)buffer.reads(),
+                         (unsigned long long)buffer.retries());
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int writers = 2;
+    int readers = (std::max)(2, (int)std::thread::hardware_concurrency() - 2);
+    double seconds = 2.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--writers") == 0 && i + 1 < argc)
+            writers = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--readers") == 0 && i + 1 < argc)
+            readers = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = std::atof(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--writers N] [--readers N] [--seconds S]\n", argv[0]);
+            return 2;
+        }
+    }
+    writers = (std::max)(1, writers);
+    readers = (std::max)(1, readers);
+
+    if (!checkSequential()) return 1;
+    std::printf("sequential: ok\n");
+
+    SnapshotBuffer<Published> buffer;
+    buffer.publish(makeValue(0));
+
+    std::atomic<bool>     stop{ false };
+    std::atomic<uint32_t> counter{ 1 };
+    std::atomic<uint64_t> torn{ 0 };
+    std::atomic<uint64_t> backwards{ 0 };
+    std::atomic<uint64_t> reads{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w)
+    {
+        threads.emplace_back([&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+                buffer.publish(makeValue(counter.fetch_add(1, std::memory_order_relaxed)));
+        });
+    }
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&]
+        {
+            uint64_t last = 0, n = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const SnapshotBuffer<Published>::Snapshot snap = buffer.read();
+                if (!consistent(snap.data)) torn.fetch_add(1, std::memory_order_relaxed);
+                if (snap.generation < last) backwards.fetch_add(1, std::memory_order_relaxed);
+                last = snap.generation;
+                ++n;
+            }
+            reads.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (std::thread& t : threads) t.join();
+
+    std::printf("writers %d, readers %d, %.1f s\n", writers, readers, seconds);
+    std::printf("  publishes   %12llu\n", (unsigned long long)buffer.publishes());
+    std::printf("  reads       %12llu (%.1f M/s)\n", (unsigned long long)reads.load(), (double)reads.load() / seconds * 1.0e-6);
+    std::printf("  retries     %12llu\n", (unsigned long long)buffer.retries());
+    std::printf("  torn        %12llu\n", (unsigned long long)torn.load());
+    std::printf("  backwards   %12llu\n", (unsigned long long)backwards.load());
+
+    return (torn.load() == 0 && backwards.load() == 0) ? 0 : 1;
+}
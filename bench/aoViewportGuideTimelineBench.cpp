@@ -0,0 +1,224 @@
+// aoViewportGuideTimelineBench.cpp (v0.3.1)
+// Bake for playback: settings animated by keyed curves (opacity, color, a stepped
+// guide type) are baked over the playback range into a SettingsTimeline, then
+// timed for playback lookups against packing and hashing every frame. Random key
+// edits check that changedKeyRange() covers every frame whose value changed and
+// report how much of the range gets baked again; exits with 1 when a changed
+// frame was missed.
+//
+//   ao_guide_bench_timeline [--frames N] [--keys N] [--edits N]
+
+#include "aoViewportGuideTimeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    // linear between keys, constant outside: like a hermite curve, a value only
+    // depends on the two keys around it
+    double evaluate(const CurveKeys& c, double t)
+    {
+        const std::vector<CurveKey>& k = c.keys;
+        if (k.empty()) return 0.0;
+        if (t <= k.front().time) return k.front().value;
+        if (t >= k.back().time) return k.back().value;
+
+        const auto it = std::upper_bound(k.begin(), k.end(), t,
+                                         [](double x, const CurveKey& key) { return x < key.time; });
+        const CurveKey& a = *(it - 1);
+        const CurveKey& b = *it;
+        const double u = (t - a.time) / (b.time - a.time);
+        return a.value + (b.value - a.value) * u;
+    }
+
+    CurveKey key(double time, double value)
+    {
+        return CurveKey{ time, value, 1.0, 0.0, 1.0, 0.0, 0, 0 };
+    }
+
+    CurveKeys makeCurve(int frames, int keys, double lo, double hi, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<double> value(lo, hi);
+        CurveKeys c;
+        for (int i = 0; i < keys; ++i)
+            c.keys.push_back(key(1.0 + (double)(frames - 1) * i / (double)(keys - 1), value(rng)));
+        return c;
+    }
+
+    void sortKeys(CurveKeys& c)
+    {
+        std::sort(c.keys.begin(), c.keys.end(), [](const CurveKey& a, const CurveKey& b) { return a.time < b.time; });
+        c.keys.erase(std::unique(c.keys.begin(), c.keys.end(),
+                                 [](const CurveKey& a, const CurveKey& b) { return a.time == b.time; }),
+                     c.keys.end());
+    }
+
+    struct Animation
+    {
+        CurveKeys opacity;
+        CurveKeys red;
+        CurveKeys guide; // stepped: whole values
+    };
+
+    PackedSettings settingsAt(const Animation& anim, int frame)
+    {
+        SettingsData s;
+        s.maskEnable  = true;
+        s.lineOpacity = (float)evaluate(anim.opacity, frame);
+        s.lineColor.r = (float)evaluate(anim.red, frame);
+        s.guideType   = (int)std::floor(evaluate(anim.guide, frame));
+        sanitizeSettings(s);
+        return packSettings(s);
+    }
+
+    template <class F>
+    double nsPer(size_t n, F&& f)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        f();
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)n;
+    }
+
+    volatile uint64_t gSink = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 2400;
+    int keys = 40;
+    int edits = 500;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--keys") == 0 && i + 1 < argc)
+            keys = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--edits") == 0 && i + 1 < argc)
+            edits = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--frames N] [--keys N] [--edits N]\n", argv[0]);
+            return 2;
+        }
+    }
+    frames = (std::max)(2, frames);
+    keys   = (std::max)(2, (std::min)(keys, frames));
+    edits  = (std::max)(0, edits);
+
+    std::mt19937 rng(11);
+    Animation anim;
+    anim.opacity = makeCurve(frames, keys, 0.2, 1.0, rng);
+    anim.red     = makeCurve(frames, (std::max)(2, keys / 4), 0.0, 1.0, rng);
+    anim.guide   = makeCurve(frames, (std::max)(2, keys / 8), 0.0, 4.99, rng);
+
+    // baking
+    SettingsTimeline timeline;
+    timeline.reset(1, frames);
+    const double bakeNs = nsPer((size_t)frames, [&]
+    {
+        for (int f = 1; f <= frames; ++f)
+            timeline.store(f, settingsAt(anim, f));
+    });
+
+    // playback: baked lookup vs pack + hash of live values (the DG reads come on top)
+    std::vector<PackedSettings> live(frames);
+    for (int f = 1; f <= frames; ++f) live[f - 1] = settingsAt(anim, f);
+
+    const int passes = 20;
+    const double lookupNs = nsPer((size_t)frames * passes, [&]
+    {
+        for (int p = 0; p < passes; ++p)
+            for (int f = 1; f <= frames; ++f)
+                gSink += timeline.find(f)->hash;
+    });
+    const double liveNs = nsPer((size_t)frames * passes, [&]
+    {
+        for (int p = 0; p < passes; ++p)
+            for (int f = 1; f <= frames; ++f)
+                gSink += hashSettings(live[f - 1]) ^ hashSettingsShape(live[f - 1]);
+    });
+
+    // geometry rebuilds: the overlay rebuilds on a shape change, restyles on a hash change
+    size_t hashChanges = 0, shapeChanges = 0;
+    for (int f = 2; f <= frames; ++f)
+    {
+        const TimelineEntry* a = timeline.find(f - 1);
+        const TimelineEntry* b = timeline.find(f);
+        hashChanges  += a->hash != b->hash;
+        shapeChanges += a->shapeHash != b->shapeHash;
+    }
+
+    // key edits: move, revalue, insert and delete keys; re-bake only what changed
+    uint64_t missed = 0;
+    size_t rebaked = 0;
+    std::uniform_int_distribution<int> kind(0, 3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> valueBefore(frames + 1), valueAfter(frames + 1);
+    for (int e = 0; e < edits; ++e)
+    {
+        CurveKeys& curve = (e % 3 == 2) ? anim.red : anim.opacity;
+        const CurveKeys before = curve;
+        for (int f = 1; f <= frames; ++f) valueBefore[f] = evaluate(curve, f);
+
+        const size_t i = (size_t)(unit(rng) * (double)curve.keys.size()) % curve.keys.size();
+        switch (kind(rng))
+        {
+        case 0: curve.keys[i].value = unit(rng); break;
+        case 1: curve.keys[i].time += std::round(unit(rng) * 16.0 - 8.0); break;
+        case 2: curve.keys.push_back(key(std::round(1.0 + unit(rng) * (frames - 1)), unit(rng))); break;
+        default: if (curve.keys.size() > 2) curve.keys.erase(curve.keys.begin() + (std::ptrdiff_t)i); break;
+        }
+        sortKeys(curve);
+
+        double lo = 0.0, hi = 0.0;
+        const bool changed = changedKeyRange(before, curve, lo, hi);
+        const int flo = std::isinf(lo) ? 1 : (std::max)(1, (int)std::floor(lo));
+        const int fhi = std::isinf(hi) ? frames : (std::min)(frames, (int)std::ceil(hi));
+
+        for (int f = 1; f <= frames; ++f)
+        {
+            valueAfter[f] = evaluate(curve, f);
+            if (valueAfter[f] != valueBefore[f] && (!changed || f < flo || f > fhi)) ++missed;
+        }
+
+        if (!changed) continue;
+        timeline.invalidate(flo, fhi);
+        int f = 0;
+        while (timeline.nextMissing(flo, f))
+        {
+            timeline.store(f, settingsAt(anim, f));
+            ++rebaked;
+        }
+    }
+
+    // the incrementally re-baked timeline must match a full bake
+    for (int f = 1; f <= frames; ++f)
+    {
+        if (timeline.find(f)->packed != settingsAt(anim, f)) ++missed;
+    }
+
+    std::printf("frames %d, keys %d, edits %d\n", frames, keys, edits);
+    std::printf("  bake               %12.1f ns/frame\n", bakeNs);
+    std::printf("  baked lookup       %12.1f ns/frame\n", lookupNs);
+    std::printf("  pack + hash        %12.1f ns/frame\n", liveNs);
+    std::printf("  entries            %12zu (%zu KiB)\n", timeline.entryCount(), timeline.memoryBytes() / 1024);
+    std::printf("  restyles           %12zu\n", hashChanges);
+    std::printf("  geometry rebuilds  %12zu\n", shapeChanges);
+    std::printf("  re-baked per edit  %12.1f frames (%.1f%%)\n",
+                edits ? (double)rebaked / edits : 0.0,
+                edits ? 100.0 * (double)rebaked / ((double)edits * frames) : 0.0);
+    std::printf("  missed frames      %12llu\n", (unsigned long long)missed);
+
+    return missed == 0 ? 0 : 1;
+}
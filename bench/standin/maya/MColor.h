@@ -0,0 +1,16 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+
+class MColor
+{
+public:
+    MColor() = default;
+    MColor(float r_, float g_, float b_, float a_ = 1.0f) : r(r_), g(g_), b(b_), a(a_) {}
+
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 1.0f;
+};
+
+class MColorArray;
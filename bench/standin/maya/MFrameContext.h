@@ -0,0 +1,19 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+
+namespace MHWRender
+{
+    class MFrameContext
+    {
+    public:
+        MFrameContext(int x, int y, int w, int h) : mX(x), mY(y), mW(w), mH(h) {}
+
+        void getViewportDimensions(int& x, int& y, int& w, int& h) const
+        {
+            x = mX; y = mY; w = mW; h = mH;
+        }
+
+    private:
+        int mX, mY, mW, mH;
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+
+class MPoint
+{
+public:
+    MPoint() = default;
+    MPoint(double x_, double y_, double z_ = 0.0, double w_ = 1.0) : x(x_), y(y_), z(z_), w(w_) {}
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double w = 1.0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+
+#include "MPoint.h"
+
+#include <vector>
+
+class MPointArray
+{
+public:
+    unsigned int length() const { return (unsigned int)mData.size(); }
+    void setLength(unsigned int n) { mData.resize(n); }
+
+    void set(unsigned int i, double x, double y, double z = 0.0, double w = 1.0)
+    {
+        mData[i] = MPoint(x, y, z, w);
+    }
+
+    const MPoint& operator[](unsigned int i) const { return mData[i]; }
+
+private:
+    std::vector<MPoint> mData;
+};
@@ -0,0 +1,71 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+// Records one primitive per draw call and copies its vertices, like the real
+// draw manager does. Primitive storage is recycled across frames so that the
+// allocation counts in the bench belong to the overlay code, not to the stand-in.
+
+#include "MColor.h"
+#include "MPointArray.h"
+#include "MUintArray.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace MHWRender
+{
+    class MUIDrawManager
+    {
+    public:
+        enum Primitive { kPoints, kLines, kLineStrip, kClosedLine, kTriangles, kTriStrip };
+
+        struct RecordedPrimitive
+        {
+            Primitive           mode = kLines;
+            MColor              color;
+            float               lineWidth = 1.0f;
+            std::vector<MPoint> points;
+            std::vector<unsigned int> indices;
+        };
+
+        void beginFrame() { mCount = 0; mDrawables = 0; }
+
+        void beginDrawable() { ++mDrawables; }
+        void endDrawable() {}
+
+        void setColor(const MColor& c) { mColor = c; }
+        void setLineWidth(float w)     { mLineWidth = w; }
+
+        void mesh2d(Primitive mode, const MPointArray& points,
+                    const MColorArray* colors = nullptr,
+                    const MUintArray* indices = nullptr,
+                    const MPointArray* texcoords = nullptr)
+        {
+            (void)colors; (void)texcoords;
+
+            if (mCount == mPrims.size()) mPrims.emplace_back();
+            RecordedPrimitive& p = mPrims[mCount++];
+            p.mode      = mode;
+            p.color     = mColor;
+            p.lineWidth = mLineWidth;
+
+            p.points.resize(points.length());
+            for (unsigned int i = 0; i < points.length(); ++i)
+                p.points[i] = points[i];
+
+            p.indices.resize(indices ? indices->length() : 0);
+            for (size_t i = 0; i < p.indices.size(); ++i)
+                p.indices[i] = (*indices)[(unsigned int)i];
+        }
+
+        size_t primitiveCount() const { return mCount; }
+        size_t drawableCount() const  { return mDrawables; }
+        const RecordedPrimitive& primitive(size_t i) const { return mPrims[i]; }
+
+    private:
+        std::vector<RecordedPrimitive> mPrims;
+        size_t mCount     = 0;
+        size_t mDrawables = 0;
+        MColor mColor;
+        float  mLineWidth = 1.0f;
+    };
+}
@@ -0,0 +1,17 @@
+#pragma once
+// Stand-in for the Maya SDK header of the same name (bench only).
+
+#include <vector>
+
+class MUintArray
+{
+public:
+    unsigned int length() const { return (unsigned int)mData.size(); }
+    void setLength(unsigned int n) { mData.resize(n); }
+
+    unsigned int&       operator[](unsigned int i)       { return mData[i]; }
+    const unsigned int& operator[](unsigned int i) const { return mData[i]; }
+
+private:
+    std::vector<unsigned int> mData;
+};
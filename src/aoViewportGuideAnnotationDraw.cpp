@@ -0,0 +1,219 @@
+// aoViewportGuideAnnotationDraw.cpp (v0.3.1)
+
+#include "aoViewportGuideAnnotationDraw.h"
+#include "aoViewportGuideGate.h"
+
+#include <maya/MAnimControl.h>
+#include <maya/MColor.h>
+#include <maya/MStateManager.h>
+#include <maya/MTextureManager.h>
+#include <maya/MViewport2Renderer.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    static MHWRender::MTexture* gAtlas = nullptr;
+    static bool                 gAtlasFailed = false;
+
+    static MHWRender::MTextureManager* textureManager()
+    {
+        MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+        return r ? r->getTextureManager() : nullptr;
+    }
+
+    // White, glyph coverage in alpha; rows are uploaded bottom-up so v = 0 is the
+    // atlas' bottom row.
+    static MHWRender::MTexture* atlasTexture()
+    {
+        if (gAtlas || gAtlasFailed) return gAtlas;
+
+        MHWRender::MTextureManager* tm = textureManager();
+        if (!tm) return nullptr;
+
+        const GlyphAtlas& atlas = glyphAtlas();
+        std::vector<uint8_t> rgba((size_t)kGlyphAtlasWidth * kGlyphAtlasHeight * 4, 255);
+        for (int y = 0; y < kGlyphAtlasHeight; ++y)
+        {
+            const uint8_t* src = atlas.coverage + (size_t)(kGlyphAtlasHeight - 1 - y) * kGlyphAtlasWidth;
+            uint8_t* dst = rgba.data() + (size_t)y * kGlyphAtlasWidth * 4;
+            for (int x = 0; x < kGlyphAtlasWidth; ++x)
+                dst[x * 4 + 3] = src[x];
+        }
+
+        MHWRender::MTextureDescription desc;
+        desc.setToDefault2DTexture();
+        desc.fWidth         = kGlyphAtlasWidth;
+        desc.fHeight        = kGlyphAtlasHeight;
+        desc.fDepth         = 1;
+        desc.fBytesPerRow   = kGlyphAtlasWidth * 4;
+        desc.fBytesPerSlice = kGlyphAtlasWidth * 4 * kGlyphAtlasHeight;
+        desc.fMipmaps       = 1;
+        desc.fArraySlices   = 1;
+        desc.fFormat        = MHWRender::kR8G8B8A8_UNORM;
+        desc.fTextureType   = MHWRender::kImage2D;
+        desc.fEnvMapType    = MHWRender::kEnvNone;
+
+        gAtlas = tm->acquireTexture(MString("aoViewportGuideGlyphAtlas"), desc, rgba.data(), false);
+        gAtlasFailed = (gAtlas == nullptr);
+        return gAtlas;
+    }
+
+    void releaseAnnotationAtlas()
+    {
+        MHWRender::MTextureManager* tm = textureManager();
+        if (gAtlas && tm) tm->releaseTexture(gAtlas);
+        gAtlas = nullptr;
+        gAtlasFailed = false;
+    }
+
+    static inline bool sameGate(const GateRect& a, const GateRect& b)
+    {
+        return a.left == b.left && a.bottom == b.bottom && a.right == b.right && a.top == b.top;
+    }
+
+    static inline bool sameColor(const Rgba& a, const Rgba& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    static void readValues(const SettingsData& s, uint64_t cameraKey, const GateRect& gate, AnnotationDrawState& st)
+    {
+        AnnotationValues& v = st.values;
+        const unsigned int fields = s.annotations;
+
+        // published on the main thread; only looked up when it or the camera changed
+        const uint64_t cameraGeneration = cameraAnnotationGeneration();
+        if (!(fields & (kAnnotateCamera | kAnnotateFocalLength)))
+            st.cameraGeneration = 0; // looked up again once shown
+        else if (st.cameraKey != cameraKey || st.cameraGeneration != cameraGeneration)
+        {
+            if (!cameraAnnotation(cameraKey, v.camera, v.focalLength))
+            {
+                v.camera.clear();
+                v.focalLength = 0.0;
+            }
+            st.cameraKey = cameraKey;
+            st.cameraGeneration = cameraGeneration;
+        }
+
+        int w = 0, h = 0;
+        const bool resolution = (fields & (kAnnotateResolution | kAnnotateAspect)) && defaultResolution(w, h);
+        v.width  = resolution ? w : 0;
+        v.height = resolution ? h : 0;
+
+        // the aspect the gate was fitted to
+        if (s.followResolutionGate && resolution)
+            v.aspect = (double)w / (double)h;
+        else if (gate.top > gate.bottom)
+            v.aspect = (gate.right - gate.left) / (gate.top - gate.bottom);
+        else
+            v.aspect = 0.0;
+
+        if (fields & kAnnotateFrame)
+            v.frame = MAnimControl::currentTime().value();
+    }
+
+    // Two quads per glyph (shadow, then text), in one index buffer.
+    static void fillMesh(AnnotationDrawState& st)
+    {
+        const std::vector<GlyphQuad>& glyphs = st.layout.glyphs;
+        const int s = st.layout.scale;
+        const unsigned int quads = (unsigned int)glyphs.size() * 2;
+
+        st.points.setLength(quads * 4);
+        st.texcoords.setLength(quads * 4);
+        st.indices.setLength(quads * 6);
+
+        const double w = (double)kGlyphWidth * s;
+        const double h = (double)kGlyphHeight * s;
+        unsigned int q = 0;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const int dx = pass == 0 ? s : 0;
+            const int dy = pass == 0 ? -s : 0;
+            for (const GlyphQuad& g : glyphs)
+            {
+                const double x0 = (double)(g.x + dx), y0 = (double)(g.y + dy);
+                const double u0 = (double)g.u / kGlyphAtlasWidth;
+                const double u1 = (double)(g.u + kGlyphWidth) / kGlyphAtlasWidth;
+                const double vt = (double)(kGlyphAtlasHeight - g.v) / kGlyphAtlasHeight;
+                const double vb = (double)(kGlyphAtlasHeight - g.v - kGlyphHeight) / kGlyphAtlasHeight;
+
+                const unsigned int p = q * 4;
+                st.points.set(p + 0, x0,     y0);
+                st.points.set(p + 1, x0 + w, y0);
+                st.points.set(p + 2, x0 + w, y0 + h);
+                st.points.set(p + 3, x0,     y0 + h);
+                st.texcoords.set(p + 0, u0, vb);
+                st.texcoords.set(p + 1, u1, vb);
+                st.texcoords.set(p + 2, u1, vt);
+                st.texcoords.set(p + 3, u0, vt);
+
+                const unsigned int i = q * 6;
+                st.indices[i + 0] = p + 0;
+                st.indices[i + 1] = p + 1;
+                st.indices[i + 2] = p + 2;
+                st.indices[i + 3] = p + 0;
+                st.indices[i + 4] = p + 2;
+                st.indices[i + 5] = p + 3;
+                ++q;
+            }
+        }
+    }
+
+    static void fillColors(AnnotationDrawState& st)
+    {
+        const unsigned int n = st.points.length();
+        const Rgba shadow = annotationShadowColor(st.color);
+        const MColor shadowColor(shadow.r, shadow.g, shadow.b, shadow.a);
+        const MColor textColor(st.color.r, st.color.g, st.color.b, st.color.a);
+
+        st.colors.setLength(n);
+        for (unsigned int i = 0; i < n; ++i)
+            st.colors.set(i < n / 2 ? shadowColor : textColor, i);
+    }
+
+    unsigned int drawAnnotations(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t cameraKey,
+                                 const GateRect& gate, AnnotationDrawState& st)
+    {
+        if (!s.annotations || s.annotationOpacity <= 0.0f) return 0;
+
+        readValues(s, cameraKey, gate, st);
+        st.text.update(st.values, s.annotations);
+
+        const bool relayout = !st.valid || st.textVersion != st.text.version() ||
+                              !sameGate(st.gate, gate) || st.scale != s.annotationScale;
+        if (relayout)
+        {
+            layoutAnnotations(st.text, gate, s.annotationScale, st.layout);
+            fillMesh(st);
+            st.textVersion = st.text.version();
+            st.gate  = gate;
+            st.scale = s.annotationScale;
+        }
+
+        const Rgba color{ s.annotationColor.r, s.annotationColor.g, s.annotationColor.b, s.annotationOpacity };
+        if (relayout || !sameColor(st.color, color))
+        {
+            st.color = color;
+            fillColors(st);
+        }
+        st.valid = true;
+
+        if (st.layout.glyphs.empty()) return 0;
+        MHWRender::MTexture* atlas = atlasTexture();
+        if (!atlas) return 0;
+
+        // point sampled at whole pixels: every texel lands on a scale x scale block
+        dm.beginDrawable();
+        dm.setTexture(atlas);
+        dm.setTextureSampler(MHWRender::MSamplerState::kMinMagMipPoint, MHWRender::MSamplerState::kTexClamp);
+        dm.setTextureMask(MHWRender::MBlendState::kRGBAChannels);
+        dm.mesh2d(MHWRender::MUIDrawManager::kTriangles, st.points, &st.colors, &st.indices, &st.texcoords);
+        dm.setTexture(nullptr);
+        dm.endDrawable();
+        return 1;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+// aoViewportGuideAnnotationDraw.h (v0.3.1)
+// Viewport side of the annotations: the glyph atlas as a VP2 texture and the
+// whole layout (shadows, then text) submitted as one textured mesh.
+
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <maya/MColorArray.h>
+#include <maya/MPointArray.h>
+#include <maya/MUIDrawManager.h>
+#include <maya/MUintArray.h>
+
+namespace AoViewportGuide
+{
+    // Per panel: cached strings, their layout and the mesh arrays. The layout is
+    // only redone when the text, gate or scale changed, the vertex colors when
+    // the color did.
+    struct AnnotationDrawState
+    {
+        AnnotationValues values;
+        AnnotationText   text;
+        AnnotationLayout layout;
+
+        MPointArray points;
+        MPointArray texcoords;
+        MColorArray colors;
+        MUintArray  indices;
+
+        bool     valid = false;
+        uint64_t cameraKey = 0;        // camera values as of cameraAnnotationGeneration()
+        uint64_t cameraGeneration = 0; // 0: not looked up
+        uint64_t textVersion = 0;
+        GateRect gate;
+        int      scale = 0;
+        Rgba     color;
+    };
+
+    // Draws the values s.annotations shows inside gate: camera name and focal length
+    // as published for cameraKey (trackFrameCamera()), defaultResolution and the
+    // current frame. Reads no plugs. Returns the number of primitives.
+    unsigned int drawAnnotations(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t cameraKey,
+                                 const GateRect& gate, AnnotationDrawState& st);
+
+    // Drops the atlas texture (plugin unload / renderer change).
+    void releaseAnnotationAtlas();
+}
@@ -0,0 +1,258 @@
+// aoViewportGuideAnnotations.cpp (v0.3.1)
+
+#include "aoViewportGuideAnnotations.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace AoViewportGuide
+{
+    // Classic 5x7 font, 0x20..0x7e: five columns per glyph, bit 0 the top row.
+    static const uint8_t kFont5x7[95][5] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 }, // ' ' ! "
+        { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, // # $ %
+        { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, { 0x00, 0x1C, 0x22, 0x41, 0x00 }, // & ' (
+        { 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // ) * +
+        { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x60, 0x60, 0x00, 0x00 }, // , - .
+        { 0x20, 0x10, 0x08, 0x04, 0x02 }, { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // / 0 1
+        { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // 2 3 4
+        { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 5 6 7
+        { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x36, 0x36, 0x00, 0x00 }, // 8 9 :
+        { 0x00, 0x56, 0x36, 0x00, 0x00 }, { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, // ; < =
+        { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, { 0x32, 0x49, 0x79, 0x41, 0x3E }, // > ? @
+        { 0x7E, 0x11, 0x11, 0x11, 0x7E }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // A B C
+        { 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 }, // D E F
+        { 0x3E, 0x41, 0x49, 0x49, 0x7A }, { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // G H I
+        { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, { 0x7F, 0x40, 0x40, 0x40, 0x40 }, // J K L
+        { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // M N O
+        { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 }, // P Q R
+        { 0x46, 0x49, 0x49, 0x49, 0x31 }, { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // S T U
+        { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, { 0x63, 0x14, 0x08, 0x14, 0x63 }, // V W X
+        { 0x07, 0x08, 0x70, 0x08, 0x07 }, { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x00 }, // Y Z [
+        { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7F, 0x00 }, { 0x04, 0x02, 0x01, 0x02, 0x04 }, // \ ] ^
+        { 0x40, 0x40, 0x40, 0x40, 0x40 }, { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, // _ ` a
+        { 0x7F, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, { 0x38, 0x44, 0x44, 0x48, 0x7F }, // b c d
+        { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x08, 0x7E, 0x09, 0x01, 0x02 }, { 0x0C, 0x52, 0x52, 0x52, 0x3E }, // e f g
+        { 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, { 0x20, 0x40, 0x44, 0x3D, 0x00 }, // h i j
+        { 0x7F, 0x10, 0x28, 0x44, 0x00 }, { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x18, 0x04, 0x78 }, // k l m
+        { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, { 0x7C, 0x14, 0x14, 0x14, 0x08 }, // n o p
+        { 0x08, 0x14, 0x14, 0x18, 0x7C }, { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 }, // q r s
+        { 0x04, 0x3F, 0x44, 0x40, 0x20 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, { 0x1C, 0x20, 0x40, 0x20, 0x1C }, // t u v
+        { 0x3C, 0x40, 0x30, 0x40, 0x3C }, { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0C, 0x50, 0x50, 0x50, 0x3C }, // w x y
+        { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, { 0x00, 0x00, 0x7F, 0x00, 0x00 }, // z { |
+        { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x10, 0x08, 0x08, 0x10, 0x08 },                                   // } ~
+    };
+
+    static const int kAtlasColumns = kGlyphAtlasWidth / kGlyphCell;
+    static_assert((95 + kAtlasColumns - 1) / kAtlasColumns * kGlyphCell <= kGlyphAtlasHeight, "atlas too small");
+
+    static const struct { unsigned int bit; const char* name; } kFieldNames[] = {
+        { kAnnotateCamera,      "camera" },
+        { kAnnotateFocalLength, "focal" },
+        { kAnnotateResolution,  "resolution" },
+        { kAnnotateAspect,      "aspect" },
+        { kAnnotateFrame,       "frame" },
+    };
+
+    bool parseAnnotationFields(const std::string& text, unsigned int& fields)
+    {
+        if (text == "all")  { fields = kAnnotateAll; return true; }
+        if (text == "none") { fields = 0; return true; }
+
+        unsigned int out = 0;
+        size_t pos = 0;
+        while (pos <= text.size())
+        {
+            size_t end = text.find(',', pos);
+            if (end == std::string::npos) end = text.size();
+            const std::string name = text.substr(pos, end - pos);
+
+            bool known = false;
+            for (const auto& f : kFieldNames)
+            {
+                if (name == f.name) { out |= f.bit; known = true; break; }
+            }
+            if (!known && !name.empty()) return false;
+            pos = end + 1;
+        }
+        fields = out;
+        return true;
+    }
+
+    std::string formatAnnotationFields(unsigned int fields)
+    {
+        if ((fields & kAnnotateAll) == kAnnotateAll) return "all";
+
+        std::string out;
+        for (const auto& f : kFieldNames)
+        {
+            if (!(fields & f.bit)) continue;
+            if (!out.empty()) out += ',';
+            out += f.name;
+        }
+        return out.empty() ? "none" : out;
+    }
+
+    const GlyphAtlas& glyphAtlas()
+    {
+        static const GlyphAtlas atlas = []
+        {
+            GlyphAtlas a;
+            std::memset(a.coverage, 0, sizeof(a.coverage));
+            for (int g = 0; g < 95; ++g)
+            {
+                const int u = (g % kAtlasColumns) * kGlyphCell + 1;
+                const int v = (g / kAtlasColumns) * kGlyphCell + 1;
+                for (int col = 0; col < kGlyphWidth; ++col)
+                {
+                    for (int row = 0; row < kGlyphHeight; ++row)
+                    {
+                        if (kFont5x7[g][col] & (1u << row))
+                            a.coverage[(v + row) * kGlyphAtlasWidth + u + col] = 255;
+                    }
+                }
+            }
+            return a;
+        }();
+        return atlas;
+    }
+
+    bool glyphOrigin(char c, int& u, int& v)
+    {
+        const int g = (int)(unsigned char)c - 0x20;
+        if (g <= 0 || g >= 95) return false; // space has no pixels
+        u = (g % kAtlasColumns) * kGlyphCell + 1;
+        v = (g / kAtlasColumns) * kGlyphCell + 1;
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // AnnotationText
+
+    static void join(std::string& out, const std::string& a, const std::string& b)
+    {
+        out = a;
+        if (!a.empty() && !b.empty()) out += "  ";
+        out += b;
+    }
+
+    bool AnnotationText::update(const AnnotationValues& v, unsigned int fields)
+    {
+        enum { kCamera, kFocal, kResolution, kAspect, kFrame };
+
+        const bool all = !mValid || fields != mFields;
+        bool dirty[kFieldCount] = {
+            all || v.camera != mValues.camera,
+            all || v.focalLength != mValues.focalLength,
+            all || v.width != mValues.width || v.height != mValues.height,
+            all || v.aspect != mValues.aspect,
+            all || v.frame != mValues.frame,
+        };
+
+        char buf[64];
+        for (int f = 0; f < kFieldCount; ++f)
+        {
+            if (!dirty[f]) continue;
+            ++mFormatCount;
+
+            std::string& out = mField[f];
+            if (!(fields & (1u << f)))
+            {
+                dirty[f] = !out.empty();
+                out.clear();
+                continue;
+            }
+
+            buf[0] = '\0';
+            switch (f)
+            {
+            case kCamera:
+                if (out == v.camera) dirty[f] = false;
+                else                 out = v.camera;
+                continue;
+            case kFocal:
+                if (v.focalLength > 0.0) std::snprintf(buf, sizeof(buf), "%.4gmm", v.focalLength);
+                break;
+            case kResolution:
+                if (v.width > 0 && v.height > 0) std::snprintf(buf, sizeof(buf), "%dx%d", v.width, v.height);
+                break;
+            case kAspect:
+                if (v.aspect > 0.0) std::snprintf(buf, sizeof(buf), "%.2f:1", v.aspect);
+                break;
+            case kFrame:
+                if (v.frame == std::floor(v.frame)) std::snprintf(buf, sizeof(buf), "%.0f", v.frame);
+                else                                std::snprintf(buf, sizeof(buf), "%.2f", v.frame);
+                break;
+            }
+
+            // values that change below the printed precision keep their string
+            if (out == buf) dirty[f] = false;
+            else            out.assign(buf);
+        }
+
+        mValues = v;
+        mFields = fields;
+        mValid  = true;
+
+        bool changed = false;
+        if (dirty[kCamera] || dirty[kFocal])
+        {
+            join(mCorner[kCornerTopLeft], mField[kCamera], mField[kFocal]);
+            changed = true;
+        }
+        if (dirty[kResolution] || dirty[kAspect])
+        {
+            join(mCorner[kCornerTopRight], mField[kResolution], mField[kAspect]);
+            changed = true;
+        }
+        if (dirty[kFrame])
+        {
+            mCorner[kCornerBottomRight] = mField[kFrame];
+            changed = true;
+        }
+        if (changed) ++mVersion;
+        return changed;
+    }
+
+    // ---------------------------------------------------------------------
+    // layout
+
+    static void layoutLine(const std::string& line, int x, int y, int scale, AnnotationLayout& out)
+    {
+        for (char c : line)
+        {
+            int u = 0, v = 0;
+            if (glyphOrigin(c, u, v)) out.glyphs.push_back(GlyphQuad{ x, y, u, v });
+            x += kGlyphAdvance * scale;
+        }
+    }
+
+    static int lineWidth(const std::string& line, int scale)
+    {
+        return line.empty() ? 0 : ((int)line.size() * kGlyphAdvance - (kGlyphAdvance - kGlyphWidth)) * scale;
+    }
+
+    void layoutAnnotations(const AnnotationText& text, const GateRect& gate, int scale, AnnotationLayout& out)
+    {
+        out.clear();
+        out.scale = scale < 1 ? 1 : scale;
+        const int s = out.scale;
+
+        // whole pixels inside the gate; the shadow hangs one texel below the text
+        const int margin = 4 * s;
+        const int left   = (int)std::ceil(gate.left) + margin;
+        const int right  = (int)std::floor(gate.right) - margin;
+        const int bottom = (int)std::ceil(gate.bottom) + margin + s;
+        const int top    = (int)std::floor(gate.top) - margin;
+        const int glyphH = kGlyphHeight * s;
+
+        const std::string& tl = text.corner(kCornerTopLeft);
+        const std::string& tr = text.corner(kCornerTopRight);
+        const std::string& br = text.corner(kCornerBottomRight);
+
+        layoutLine(tl, left, top - glyphH, s, out);
+        layoutLine(tr, right - lineWidth(tr, s), top - glyphH, s, out);
+        layoutLine(br, right - lineWidth(br, s), bottom, s, out);
+    }
+}
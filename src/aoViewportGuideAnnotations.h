@@ -0,0 +1,126 @@
+#pragma once
+// aoViewportGuideAnnotations.h (v0.3.1)
+// Text at the gate corners (no Maya types): camera and focal length top left,
+// resolution and gate aspect top right, frame bottom right. Values are formatted
+// into cached strings that are only rebuilt when a value changes; the strings are
+// laid out as glyph quads over a prebuilt atlas (a built-in 5x7 pixel font), so
+// the viewport draws all of the text as one textured mesh and the burn-in
+// rasterizes the same quads from the same atlas.
+
+#include "aoViewportGuideTypes.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    enum AnnotationField : uint8_t
+    {
+        kAnnotateCamera      = 1 << 0,
+        kAnnotateFocalLength = 1 << 1,
+        kAnnotateResolution  = 1 << 2,
+        kAnnotateAspect      = 1 << 3,
+        kAnnotateFrame       = 1 << 4,
+        kAnnotateAll         = 0x1f,
+    };
+
+    // "camera,focal,resolution,aspect,frame" (any subset), "all" or "none".
+    bool        parseAnnotationFields(const std::string& text, unsigned int& fields);
+    std::string formatAnnotationFields(unsigned int fields);
+
+    // Printable ASCII (0x20..0x7e) in 16 columns of 8 x 8 texel cells, each glyph
+    // 5 x 7 texels at (1, 1) of its cell so point sampling never reaches a
+    // neighbour. Coverage bytes, first row at the top.
+    static constexpr int kGlyphAtlasWidth  = 128;
+    static constexpr int kGlyphAtlasHeight = 64;
+    static constexpr int kGlyphCell        = 8;
+    static constexpr int kGlyphWidth       = 5;
+    static constexpr int kGlyphHeight      = 7;
+    static constexpr int kGlyphAdvance     = 6; // texels
+
+    struct GlyphAtlas
+    {
+        uint8_t coverage[kGlyphAtlasWidth * kGlyphAtlasHeight];
+    };
+
+    // Built on first use.
+    const GlyphAtlas& glyphAtlas();
+
+    // Atlas texel of the glyph's top-left corner; false for characters without one
+    // (space and anything outside printable ASCII).
+    bool glyphOrigin(char c, int& u, int& v);
+
+    struct AnnotationValues
+    {
+        std::string camera;            // empty: not shown
+        double      focalLength = 0.0; // mm; <= 0: not shown
+        double      frame       = 0.0;
+        int         width  = 0;        // resolution; <= 0: not shown
+        int         height = 0;
+        double      aspect = 0.0;      // gate aspect; <= 0: not shown
+    };
+
+    enum AnnotationCorner
+    {
+        kCornerTopLeft     = 0,
+        kCornerTopRight    = 1,
+        kCornerBottomRight = 2,
+        kCornerCount
+    };
+
+    // The formatted strings of one view. update() compares every value with the
+    // last one and formats only what changed ("35mm", "1920x1080", "2.39:1", "1001").
+    class AnnotationText
+    {
+    public:
+        // True when a corner string changed.
+        bool update(const AnnotationValues& values, unsigned int fields);
+
+        const std::string& corner(int c) const { return mCorner[c]; }
+
+        // Bumped whenever a corner string changes, so layouts know to rebuild.
+        uint64_t version() const { return mVersion; }
+
+        // Fields formatted so far (for benchmarks).
+        uint64_t formatCount() const { return mFormatCount; }
+
+    private:
+        enum { kFieldCount = 5 };
+
+        AnnotationValues mValues;
+        unsigned int     mFields = 0;
+        bool             mValid = false;
+        std::string      mField[kFieldCount];
+        std::string      mCorner[kCornerCount];
+        uint64_t         mVersion = 0;
+        uint64_t         mFormatCount = 0;
+    };
+
+    // One glyph: (x, y) is the bottom-left pixel of its kGlyphWidth x kGlyphHeight
+    // box at layout scale, (u, v) the atlas texel of the glyph's top-left corner.
+    struct GlyphQuad
+    {
+        int x, y;
+        int u, v;
+    };
+
+    struct AnnotationLayout
+    {
+        std::vector<GlyphQuad> glyphs;
+        int scale = 1; // pixels per atlas texel
+
+        void clear() { glyphs.clear(); }
+    };
+
+    // Corner strings inside gate (viewport pixels, y up), 4 texels from its edges,
+    // on whole pixels at an integer scale so the atlas maps 1:1 onto pixel blocks.
+    void layoutAnnotations(const AnnotationText& text, const GateRect& gate, int scale, AnnotationLayout& out);
+
+    // Every glyph is drawn twice: first offset by one texel right and down in this
+    // color, then in the text color.
+    inline Rgba annotationShadowColor(const Rgba& text)
+    {
+        return Rgba{ 0.0f, 0.0f, 0.0f, text.a * 0.75f };
+    }
+}
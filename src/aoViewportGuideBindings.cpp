@@ -0,0 +1,243 @@
+// aoViewportGuideBindings.cpp (v0.3.1)
+
+#include "aoViewportGuideBindings.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace AoViewportGuide
+{
+    void ShotIntervalIndex::clear()
+    {
+        mShots.clear();
+        mSegments.clear();
+        mShotStart.clear();
+        mMaxLength = 0.0;
+    }
+
+    size_t ShotIntervalIndex::findSegment(double time) const
+    {
+        const auto it = std::upper_bound(mSegments.begin(), mSegments.end(), time,
+                                         [](double t, const Segment& s) { return t < s.start; });
+        if (it == mSegments.begin()) return mSegments.size();
+        return (size_t)(it - mSegments.begin()) - 1;
+    }
+
+    VariantMask ShotIntervalIndex::lookup(double time) const
+    {
+        const size_t i = findSegment(time);
+        if (i >= mSegments.size()) return 0;
+        return time < mSegments[i].end ? mSegments[i].variants : 0;
+    }
+
+    VariantMask ShotIntervalIndex::lookup(double time, size_t& cursor) const
+    {
+        const size_t n = mSegments.size();
+        if (n == 0) { cursor = 0; return 0; }
+
+        // cursor holds when segment cursor starts at or before time and the next one after it
+        auto holds = [&](size_t i)
+        {
+            if (i >= n) return time < mSegments[0].start;
+            return mSegments[i].start <= time && (i + 1 == n || time < mSegments[i + 1].start);
+        };
+
+        if (!holds(cursor))
+        {
+            const size_t next = cursor >= n ? 0 : cursor + 1;
+            cursor = (next < n && holds(next)) ? next : findSegment(time);
+        }
+
+        if (cursor >= n) return 0;
+        return time < mSegments[cursor].end ? mSegments[cursor].variants : 0;
+    }
+
+    void ShotIntervalIndex::eraseShot(uint64_t id, double& start, double& end)
+    {
+        const auto found = mShotStart.find(id);
+        if (found == mShotStart.end()) return;
+
+        auto it = std::lower_bound(mShots.begin(), mShots.end(), found->second,
+                                   [](const Shot& s, double t) { return s.start < t; });
+        for (; it != mShots.end() && it->start == found->second; ++it)
+        {
+            if (it->id != id) continue;
+            start = it->start;
+            end   = it->end;
+            mShots.erase(it);
+            break;
+        }
+        mShotStart.erase(found);
+    }
+
+    void ShotIntervalIndex::setShot(uint64_t id, double start, double end, VariantMask variants)
+    {
+        double oldStart = 0.0, oldEnd = 0.0;
+        eraseShot(id, oldStart, oldEnd);
+        const bool moved = oldEnd > oldStart;
+
+        // shot nodes include their end frame
+        end += 1.0;
+        const bool placed = end > start && variants != 0;
+        if (placed)
+        {
+            const auto at = std::upper_bound(mShots.begin(), mShots.end(), start,
+                                             [](double t, const Shot& s) { return t < s.start; });
+            mShots.insert(at, Shot{ id, start, end, variants });
+            mShotStart[id] = start;
+            mMaxLength = (std::max)(mMaxLength, end - start);
+        }
+
+        if (moved && placed && (start < oldEnd && oldStart < end))
+            reflatten((std::min)(start, oldStart), (std::max)(end, oldEnd));
+        else
+        {
+            if (moved)  reflatten(oldStart, oldEnd);
+            if (placed) reflatten(start, end);
+        }
+    }
+
+    void ShotIntervalIndex::removeShot(uint64_t id)
+    {
+        double start = 0.0, end = 0.0;
+        eraseShot(id, start, end);
+        if (end > start) reflatten(start, end);
+    }
+
+    void ShotIntervalIndex::reflatten(double lo, double hi)
+    {
+        // shots that can overlap [lo, hi): none starts before lo - mMaxLength
+        const auto first = std::lower_bound(mShots.begin(), mShots.end(), lo - mMaxLength,
+                                            [](const Shot& s, double t) { return s.start < t; });
+        const auto last  = std::lower_bound(first, mShots.end(), hi,
+                                            [](const Shot& s, double t) { return s.start < t; });
+
+        std::vector<double>& cuts = mScratch;
+        cuts.clear();
+        cuts.push_back(lo);
+        cuts.push_back(hi);
+        for (auto it = first; it != last; ++it)
+        {
+            if (it->end <= lo) continue;
+            if (it->start > lo) cuts.push_back(it->start);
+            if (it->end < hi)   cuts.push_back(it->end);
+        }
+        std::sort(cuts.begin(), cuts.end());
+        cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+        std::vector<Segment> span;
+        for (size_t c = 0; c + 1 < cuts.size(); ++c)
+        {
+            const double a = cuts[c], b = cuts[c + 1];
+            VariantMask mask = 0;
+            for (auto it = first; it != last; ++it)
+            {
+                if (it->start <= a && b <= it->end) mask |= it->variants;
+            }
+            if (mask == 0) continue;
+
+            if (!span.empty() && span.back().end == a && span.back().variants == mask)
+                span.back().end = b;
+            else
+                span.push_back(Segment{ a, b, mask });
+        }
+
+        // replace the old segments over [lo, hi), keeping the parts outside of it
+        auto from = std::lower_bound(mSegments.begin(), mSegments.end(), lo,
+                                     [](const Segment& s, double t) { return s.end <= t; });
+        auto to   = std::lower_bound(from, mSegments.end(), hi,
+                                     [](const Segment& s, double t) { return s.start < t; });
+
+        if (from != to)
+        {
+            const Segment head = *from;
+            const Segment tail = *(to - 1);
+            if (head.start < lo) span.insert(span.begin(), Segment{ head.start, lo, head.variants });
+            if (tail.end > hi)   span.push_back(Segment{ hi, tail.end, tail.variants });
+        }
+
+        const size_t at = (size_t)(from - mSegments.begin());
+        mSegments.erase(from, to);
+        mSegments.insert(mSegments.begin() + (std::ptrdiff_t)at, span.begin(), span.end());
+
+        // join touching segments with equal masks around the edit, so repeated edits
+        // do not fragment the index
+        size_t i = at > 0 ? at - 1 : 0;
+        size_t stop = (std::min)(at + span.size() + 1, mSegments.size());
+        while (i + 1 < stop)
+        {
+            Segment& a = mSegments[i];
+            const Segment& b = mSegments[i + 1];
+            if (a.end == b.start && a.variants == b.variants)
+            {
+                a.end = b.end;
+                mSegments.erase(mSegments.begin() + (std::ptrdiff_t)(i + 1));
+                --stop;
+            }
+            else
+                ++i;
+        }
+    }
+
+    // ---------------------------------------------------------------------
+
+    static inline int lowestVariant(VariantMask m)
+    {
+        int i = 0;
+        while (!(m & 1)) { m >>= 1; ++i; }
+        return i;
+    }
+
+    int pickSettingsVariant(VariantMask candidates, VariantMask cameraBound, VariantMask shotBound)
+    {
+        const VariantMask classes[3] = {
+            candidates & cameraBound & shotBound,
+            candidates & shotBound & ~cameraBound,
+            candidates & cameraBound & ~shotBound,
+        };
+        for (VariantMask m : classes)
+        {
+            if (m) return lowestVariant(m);
+        }
+        return 0;
+    }
+
+    void buildBindingState(const VariantBindings& bindings, VariantMask shotMask, BindingState& out)
+    {
+        std::memset(&out, 0, sizeof(out));
+
+        // time-independent variants are always in the running
+        const VariantMask active = shotMask | ~bindings.shotBound;
+        const int other = pickSettingsVariant(active & ~bindings.cameraBound, bindings.cameraBound, bindings.shotBound);
+        out.otherCameras = (uint8_t)other;
+
+        // only cameras that resolve differently need an entry
+        std::pair<uint64_t, uint8_t> entries[kMaxBoundCameras];
+        uint32_t count = 0;
+        for (const auto& cam : bindings.cameras)
+        {
+            const VariantMask candidates = active & (cam.second | ~bindings.cameraBound);
+            const int v = pickSettingsVariant(candidates, bindings.cameraBound, bindings.shotBound);
+            if (v == other || count == kMaxBoundCameras) continue;
+            entries[count++] = std::make_pair(cam.first, (uint8_t)v);
+        }
+        std::sort(entries, entries + count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            out.cameraKeys[i]     = entries[i].first;
+            out.cameraVariants[i] = entries[i].second;
+        }
+        out.cameraCount = count;
+    }
+
+    int resolveSettingsVariant(const BindingState& state, uint64_t cameraKey)
+    {
+        const uint64_t* end = state.cameraKeys + state.cameraCount;
+        const uint64_t* it = std::lower_bound(state.cameraKeys, end, cameraKey);
+        if (it != end && *it == cameraKey)
+            return state.cameraVariants[it - state.cameraKeys];
+        return state.otherCameras;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+// aoViewportGuideBindings.h (v0.3.1)
+// Settings overrides bound to cameras and shot time ranges (no Maya types).
+// Every settings node in use is a variant (0 = the default node). The main
+// thread keeps the shot ranges in a ShotIntervalIndex and, whenever the time or
+// a binding changes, publishes a BindingState: the variant each bound camera
+// resolves to at the current time. Draw callbacks only look their camera up.
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    static constexpr int kMaxSettingsVariants = 64; // bit i of a VariantMask = variant i
+    static constexpr int kMaxBoundCameras     = 64;
+
+    typedef uint64_t VariantMask;
+
+    // Shot ranges flattened into sorted, disjoint segments, each holding the mask
+    // of the variants whose shots cover it. Editing one shot only re-flattens the
+    // span it covered before and after the edit.
+    class ShotIntervalIndex
+    {
+    public:
+        // Adds shot id, or moves it, to frames [start, end] (inclusive, as on shot
+        // nodes). An empty range removes it.
+        void setShot(uint64_t id, double start, double end, VariantMask variants);
+        void removeShot(uint64_t id);
+        void clear();
+
+        // Variants whose shots cover time; 0 outside every shot. O(log n).
+        VariantMask lookup(double time) const;
+
+        // Same, starting from the segment found by the previous call: O(1) while time
+        // stays in that segment or moves on to the next one (playback, scrubbing).
+        VariantMask lookup(double time, size_t& cursor) const;
+
+        size_t shotCount() const    { return mShots.size(); }
+        size_t segmentCount() const { return mSegments.size(); }
+
+    private:
+        struct Shot
+        {
+            uint64_t    id;
+            double      start; // [start, end)
+            double      end;
+            VariantMask variants;
+        };
+
+        struct Segment
+        {
+            double      start; // [start, end)
+            double      end;
+            VariantMask variants;
+        };
+
+        // last segment starting at or before time, mSegments.size() when none
+        size_t findSegment(double time) const;
+        void   eraseShot(uint64_t id, double& start, double& end);
+        void   reflatten(double lo, double hi);
+
+        std::vector<Shot>    mShots;    // sorted by start
+        std::vector<Segment> mSegments; // sorted, disjoint, no empty masks
+        std::unordered_map<uint64_t, double> mShotStart; // id -> start, to find it in mShots
+        double mMaxLength = 0.0; // longest shot so far; bounds the overlap search
+        std::vector<double> mScratch;
+    };
+
+    // What each settings node is bound to, rebuilt when bindings change.
+    struct VariantBindings
+    {
+        VariantMask cameraBound = 0; // variants with camera bindings
+        VariantMask shotBound   = 0; // variants with shot bindings
+        std::unordered_map<uint64_t, VariantMask> cameras; // camera key -> variants bound to it
+
+        void clear() { cameraBound = 0; shotBound = 0; cameras.clear(); }
+    };
+
+    // Most specific of the candidates: bound to camera and shot, then shot only, then
+    // camera only (lowest variant within a class); 0 when none is left.
+    int pickSettingsVariant(VariantMask candidates, VariantMask cameraBound, VariantMask shotBound);
+
+    // Resolved variants for the current time. Trivially copyable, for SnapshotBuffer;
+    // cameras past kMaxBoundCameras fall back to otherCameras.
+    struct BindingState
+    {
+        uint64_t cameraKeys[kMaxBoundCameras];     // sorted, [0, cameraCount)
+        uint8_t  cameraVariants[kMaxBoundCameras];
+        uint32_t cameraCount;
+        uint8_t  otherCameras;                     // variant of every camera not in the table
+        uint8_t  reserved[3];
+    };
+
+    // shotMask: ShotIntervalIndex::lookup() at the current time.
+    void buildBindingState(const VariantBindings& bindings, VariantMask shotMask, BindingState& out);
+
+    // Binary search of the camera table.
+    int resolveSettingsVariant(const BindingState& state, uint64_t cameraKey);
+}
@@ -0,0 +1,229 @@
+// aoViewportGuideBurnIn.cpp (v0.3.1)
+
+#include "aoViewportGuideBurnIn.h"
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideField.h"
+#include "aoViewportGuideRaster.h"
+#include "aoViewportGuideThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace AoViewportGuide
+{
+    static double burnInAspect(const BurnInOptions& options, int width, int height)
+    {
+        if (options.gate.resolutionAspect <= 0.0 || !options.settings.followResolutionGate)
+            return (double)width / (double)height;
+        return options.gate.resolutionAspect;
+    }
+
+    static GuideFieldParams burnInParams(const BurnInOptions& options, int width, int height)
+    {
+        GateParams gp = options.gate;
+        gp.resolutionAspect = burnInAspect(options, width, height);
+
+        GuideFieldParams p = makeGuideFieldParams(options.settings, fitGateRect(gp, 0, 0, width, height));
+        if (!options.settings.enable)
+        {
+            p.lineColor.a   = 0.0f;
+            p.borderColor.a = 0.0f;
+            p.maskColor.a   = 0.0f;
+        }
+        return p;
+    }
+
+    // Trailing digits of the file name ("shot.1001.exr" -> 1001); 0 when there are none.
+    static double frameFromPath(const std::string& path)
+    {
+        const std::string stem = fs::path(path).stem().string();
+        size_t begin = stem.size();
+        while (begin > 0 && std::isdigit((unsigned char)stem[begin - 1])) --begin;
+        return begin < stem.size() ? std::atof(stem.c_str() + begin) : 0.0;
+    }
+
+    // Annotations as the viewport lays them out over a gate of the image's size.
+    static void layoutBurnInText(const BurnInOptions& options, const std::string& inputPath,
+                                 const ImageSpec& spec, const GateRect& gate, AnnotationLayout& out)
+    {
+        // frame workers go through a sequence in order: usually only the frame re-formats
+        thread_local AnnotationText text;
+
+        AnnotationValues v;
+        v.camera      = options.camera;
+        v.focalLength = options.focalLength;
+        v.frame       = frameFromPath(inputPath);
+        v.width       = spec.width;
+        v.height      = spec.height;
+        v.aspect      = burnInAspect(options, spec.width, spec.height);
+        text.update(v, options.settings.annotations);
+        layoutAnnotations(text, gate, options.settings.annotationScale, out);
+    }
+
+    // Straight-alpha "over" of the guides onto rows [0, rows) of a band whose first
+    // row is image row topRow. Band rows run top to bottom and the guides bottom to
+    // top, so the target walks the band backwards.
+    static void compositeTile(const GuideFieldParams& p, const GuideLayerDraw& layers,
+                              const AnnotationLayout& text, const Rgba& textColor, float* band,
+                              int width, int height, int topRow, int rows, int x0, int x1)
+    {
+        thread_local GuideRasterizer raster; // coverage buffer reused across tiles
+
+        RasterTarget target;
+        target.row0      = band + ((size_t)(rows - 1) * (size_t)width + (size_t)x0) * 4;
+        target.rowStride = -(ptrdiff_t)width * 4;
+        target.x0        = x0;
+        target.y0        = height - topRow - rows;
+        target.width     = x1 - x0;
+        target.height    = rows;
+        rasterizeGuides(raster, target, p);
+        rasterizeGuideLayers(raster, target, layers);
+        rasterizeAnnotations(raster, target, text, textColor);
+    }
+
+    static bool burnInFrameWithPool(const std::string& inputPath, const std::string& outputPath,
+                                    const BurnInOptions& options, ThreadPool& pool, std::string& error)
+    {
+        std::unique_ptr<ImageReader> reader = ImageReader::open(inputPath, error);
+        if (!reader) return false;
+
+        const ImageSpec spec = reader->spec();
+        ImageFormat format = options.outputFormat;
+        if (format == kImageUnknown) format = imageFormatFromPath(outputPath);
+
+        const std::string tmpPath = outputPath + ".tmp";
+        {
+            std::unique_ptr<ImageWriter> writer = ImageWriter::create(tmpPath, format, spec, error);
+            if (!writer) return false;
+
+            const GuideFieldParams params = burnInParams(options, spec.width, spec.height);
+
+            GuideLayerDraw layers;
+            if (options.settings.enable)
+                buildGuideLayerDraw(options.settings.layers, params.gate, kCurveTolerancePx, layers);
+
+            AnnotationLayout text;
+            if (options.settings.enable && options.settings.annotations)
+                layoutBurnInText(options, inputPath, spec, params.gate, text);
+            const Rgba& c = options.settings.annotationColor;
+            const Rgba textColor{ c.r, c.g, c.b, options.settings.annotationOpacity };
+
+            const int bandRows  = (std::max)(1, options.bandRows);
+            const int tileWidth = (std::max)(16, options.tileWidth);
+            const int tiles     = (spec.width + tileWidth - 1) / tileWidth;
+
+            std::vector<float> band((size_t)spec.width * (size_t)bandRows * 4);
+
+            for (int top = 0; top < spec.height; top += bandRows)
+            {
+                const int rows = (std::min)(bandRows, spec.height - top);
+                if (!reader->readRows(rows, band.data(), error)) break;
+
+                pool.parallelFor(tiles, [&](int t)
+                {
+                    const int x0 = t * tileWidth;
+                    const int x1 = (std::min)(spec.width, x0 + tileWidth);
+                    compositeTile(params, layers, text, textColor, band.data(),
+                                  spec.width, spec.height, top, rows, x0, x1);
+                });
+
+                if (!writer->writeRows(rows, band.data(), error)) break;
+            }
+
+            if (!error.empty() || !writer->finish(error))
+            {
+                writer.reset();
+                std::error_code ec;
+                fs::remove(tmpPath, ec);
+                error = inputPath + ": " + error;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tmpPath, outputPath, ec);
+        if (ec)
+        {
+            fs::remove(tmpPath, ec);
+            error = "cannot rename to " + outputPath;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<std::string> listBurnInFrames(const std::string& dir)
+    {
+        std::vector<std::string> frames;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+        {
+            if (!it->is_regular_file(ec)) continue;
+            const std::string path = it->path().string();
+            if (imageFormatAvailable(imageFormatFromPath(path)))
+                frames.push_back(path);
+        }
+        std::sort(frames.begin(), frames.end());
+        return frames;
+    }
+
+    bool burnInFrame(const std::string& inputPath, const std::string& outputPath,
+                     const BurnInOptions& options, std::string& error)
+    {
+        ThreadPool pool((unsigned int)(std::max)(0, options.threads));
+        return burnInFrameWithPool(inputPath, outputPath, options, pool, error);
+    }
+
+    BurnInReport burnInDirectory(const std::string& inputDir, const std::string& outputDir,
+                                 const BurnInOptions& options)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+
+        BurnInReport report;
+        const std::vector<std::string> inputs = listBurnInFrames(inputDir);
+        report.frames = (int)inputs.size();
+
+        std::error_code ec;
+        fs::create_directories(outputDir, ec);
+
+        ThreadPool tilePool((unsigned int)(std::max)(0, options.threads));
+        int inFlight = options.framesInFlight;
+        if (inFlight <= 0) inFlight = (std::min)((int)tilePool.size(), 4);
+        ThreadPool framePool((unsigned int)(std::max)(1, inFlight));
+
+        std::mutex reportMutex;
+        std::atomic<int> done{ 0 };
+
+        framePool.parallelFor((int)inputs.size(), [&](int i)
+        {
+            const fs::path in(inputs[(size_t)i]);
+            fs::path out = fs::path(outputDir) / in.filename();
+            if (options.outputFormat != kImageUnknown)
+                out.replace_extension(imageFormatExtension(options.outputFormat));
+
+            std::string error;
+            const bool ok = burnInFrameWithPool(in.string(), out.string(), options, tilePool, error);
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if (!ok)
+            {
+                ++report.failed;
+                report.errors.push_back(error);
+            }
+            const int n = ++done;
+            if (options.progress) options.progress(n, report.frames);
+        });
+
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return report;
+    }
+}
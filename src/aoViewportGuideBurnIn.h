@@ -0,0 +1,60 @@
+#pragma once
+// aoViewportGuideBurnIn.h (v0.3.1)
+// Headless burn-in of the guides onto image sequences (no Maya types).
+// Frames stream through in row bands (read -> composite -> write); several
+// frames are in flight and each band is split into tiles over a thread pool,
+// so memory stays at roughly framesInFlight * band size.
+
+#include "aoViewportGuideGateFit.h"
+#include "aoViewportGuideImageIO.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    struct BurnInOptions
+    {
+        SettingsData settings;
+
+        // resolutionAspect <= 0: the gate takes the image aspect (the image is the render)
+        GateParams gate;
+
+        // annotation values that are not in the image; the frame is the number at
+        // the end of the file name, the resolution the image size
+        std::string camera;
+        double      focalLength = 0.0;
+
+        ImageFormat outputFormat = kImageUnknown; // kImageUnknown: same as each input
+
+        int threads        = 0;   // compositing threads; 0 = hardware concurrency
+        int framesInFlight = 0;   // 0 = min(threads, 4)
+        int bandRows       = 64;
+        int tileWidth      = 256;
+
+        // called after each frame with (done, total); may come from any thread, never concurrently
+        std::function<void(int, int)> progress;
+    };
+
+    struct BurnInReport
+    {
+        int    frames = 0;
+        int    failed = 0;
+        double seconds = 0.0;
+        std::vector<std::string> errors;
+    };
+
+    // Readable images (by extension) in dir, sorted by name.
+    std::vector<std::string> listBurnInFrames(const std::string& dir);
+
+    // Composites one image. The output is written to a temporary name and renamed
+    // when complete, so outputPath may be inputPath.
+    bool burnInFrame(const std::string& inputPath, const std::string& outputPath,
+                     const BurnInOptions& options, std::string& error);
+
+    // Every frame of inputDir into outputDir (same file names, extension of outputFormat).
+    BurnInReport burnInDirectory(const std::string& inputDir, const std::string& outputDir,
+                                 const BurnInOptions& options);
+}
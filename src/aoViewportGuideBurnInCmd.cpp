@@ -0,0 +1,111 @@
+// aoViewportGuideBurnInCmd.cpp (v0.3.1)
+
+#include "aoViewportGuideBurnInCmd.h"
+#include "aoViewportGuideBurnIn.h"
+#include "aoViewportGuideGate.h"
+#include "aoViewportGuideSettings.h"
+
+#include <maya/M3dView.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MDagPath.h>
+#include <maya/MSelectionList.h>
+#include <maya/MString.h>
+
+namespace AoViewportGuide
+{
+    static const char* kInputFlag        = "-i";
+    static const char* kInputFlagLong    = "-input";
+    static const char* kOutputFlag       = "-o";
+    static const char* kOutputFlagLong   = "-output";
+    static const char* kFormatFlag       = "-f";
+    static const char* kFormatFlagLong   = "-format";
+    static const char* kThreadsFlag      = "-t";
+    static const char* kThreadsFlagLong  = "-threads";
+    static const char* kCameraFlag       = "-c";
+    static const char* kCameraFlagLong   = "-camera";
+
+    const char* AoViewportGuideBurnInCmd::commandName = "aoViewportGuideBurnIn";
+
+    void* AoViewportGuideBurnInCmd::creator()
+    {
+        return new AoViewportGuideBurnInCmd();
+    }
+
+    MSyntax AoViewportGuideBurnInCmd::newSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag(kInputFlag,   kInputFlagLong,   MSyntax::kString);
+        syntax.addFlag(kOutputFlag,  kOutputFlagLong,  MSyntax::kString);
+        syntax.addFlag(kFormatFlag,  kFormatFlagLong,  MSyntax::kString);
+        syntax.addFlag(kThreadsFlag, kThreadsFlagLong, MSyntax::kLong);
+        syntax.addFlag(kCameraFlag,  kCameraFlagLong,  MSyntax::kString);
+        return syntax;
+    }
+
+    MStatus AoViewportGuideBurnInCmd::doIt(const MArgList& args)
+    {
+        MStatus stat;
+        MArgDatabase db(syntax(), args, &stat);
+        if (!stat) return stat;
+
+        MString input, output;
+        if (!db.isFlagSet(kInputFlag) || !db.isFlagSet(kOutputFlag))
+        {
+            displayError("[ao_viewport_guide] -input and -output are required");
+            return MS::kFailure;
+        }
+        db.getFlagArgument(kInputFlag, 0, input);
+        db.getFlagArgument(kOutputFlag, 0, output);
+
+        BurnInOptions options;
+        options.settings = AoViewportGuideSettings::read();
+
+        if (db.isFlagSet(kFormatFlag))
+        {
+            MString name;
+            db.getFlagArgument(kFormatFlag, 0, name);
+            options.outputFormat = imageFormatFromName(name.asChar());
+            if (!imageFormatAvailable(options.outputFormat))
+            {
+                displayError(MString("[ao_viewport_guide] output format not available: ") + name);
+                return MS::kFailure;
+            }
+        }
+        if (db.isFlagSet(kThreadsFlag))
+            db.getFlagArgument(kThreadsFlag, 0, options.threads);
+
+        // camera annotations: the given camera, else the active view's
+        MDagPath camera;
+        if (db.isFlagSet(kCameraFlag))
+        {
+            MString name;
+            db.getFlagArgument(kCameraFlag, 0, name);
+            MSelectionList sl;
+            if (sl.add(name) != MS::kSuccess || sl.getDagPath(0, camera) != MS::kSuccess)
+            {
+                displayError(MString("[ao_viewport_guide] no such camera: ") + name);
+                return MS::kFailure;
+            }
+        }
+        else
+            M3dView::active3dView().getCamera(camera);
+        if (camera.isValid())
+            annotationCamera(camera, options.camera, options.focalLength);
+
+        const BurnInReport report = burnInDirectory(input.asChar(), output.asChar(), options);
+        for (const std::string& e : report.errors)
+            displayWarning(MString("[ao_viewport_guide] ") + e.c_str());
+
+        MString msg("[ao_viewport_guide] burn-in: ");
+        msg += report.frames - report.failed;
+        msg += " / ";
+        msg += report.frames;
+        msg += " frame(s) in ";
+        msg += report.seconds;
+        msg += " s";
+        displayInfo(msg);
+
+        setResult(report.frames - report.failed);
+        return (report.frames > 0 && report.failed == 0) ? MS::kSuccess : MS::kFailure;
+    }
+}
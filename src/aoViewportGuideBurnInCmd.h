@@ -0,0 +1,22 @@
+#pragma once
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+
+namespace AoViewportGuide
+{
+    // aoViewportGuideBurnIn -input dir -output dir [-format ppm|png|exr] [-threads n]
+    // Burns the guides of the active settings node into every frame of -input.
+    // The gate fills each image (the frames are the render). Returns the number
+    // of frames written.
+    class AoViewportGuideBurnInCmd : public MPxCommand
+    {
+    public:
+        static const char* commandName;
+
+        static void*   creator();
+        static MSyntax newSyntax();
+
+        MStatus doIt(const MArgList& args) override;
+        bool isUndoable() const override { return false; }
+    };
+}
@@ -11,6 +11,9 @@ namespace AoViewportGuide
     static constexpr const char* kSettingsNodeTypeName = "aoViewportGuideSettings";
     static constexpr const char* kSettingsNodeName     = "aoViewportGuideSettings1";
 
+    // max chord error (pixels) for tessellated guides
+    static constexpr double kCurveTolerancePx = 0.25;
+
     inline float clampf(float v, float lo, float hi)
     {
         return (std::max)(lo, (std::min)(hi, v));
@@ -0,0 +1,151 @@
+// aoViewportGuideField.cpp (v0.3.1)
+// Mirrors PS_Guides in aoViewportGuide.ogsfx (float math, same operation order).
+
+#include "aoViewportGuideField.h"
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <cmath>
+
+namespace AoViewportGuide
+{
+    namespace
+    {
+        inline float segDist(float px, float py, float ax, float ay, float bx, float by)
+        {
+            const float pax = px - ax, pay = py - ay;
+            const float bax = bx - ax, bay = by - ay;
+            const float h = clampf((pax * bax + pay * bay) / (bax * bax + bay * bay), 0.0f, 1.0f);
+            const float dx = pax - bax * h, dy = pay - bay * h;
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        // signed distance to an axis aligned box (negative inside)
+        inline float boxDist(float px, float py, float cx, float cy, float hx, float hy)
+        {
+            const float qx = std::fabs(px - cx) - hx;
+            const float qy = std::fabs(py - cy) - hy;
+            const float ox = (std::max)(qx, 0.0f), oy = (std::max)(qy, 0.0f);
+            return std::sqrt(ox * ox + oy * oy) + (std::min)((std::max)(qx, qy), 0.0f);
+        }
+
+        inline float lineCoverage(float d, float width)
+        {
+            return clampf(0.5f * width + 0.5f - d, 0.0f, 1.0f);
+        }
+
+        // premultiplied "over"
+        inline void over(float acc[4], const Rgba& c, float a)
+        {
+            acc[0] = c.r * a + acc[0] * (1.0f - a);
+            acc[1] = c.g * a + acc[1] * (1.0f - a);
+            acc[2] = c.b * a + acc[2] * (1.0f - a);
+            acc[3] = a       + acc[3] * (1.0f - a);
+        }
+
+        float guideDist(int guideType, float px, float py,
+                        float l, float b, float r, float t)
+        {
+            const float w = r - l;
+            const float h = t - b;
+
+            if (guideType == 0 || guideType == 3)
+            {
+                // thirds, or phi grid at 1/phi^2 and 1/phi
+                const float k1 = guideType == 0 ? 1.0f / 3.0f : 0.381966f;
+                const float k2 = guideType == 0 ? 2.0f / 3.0f : 0.618034f;
+                const float x1 = l + w * k1;
+                const float x2 = l + w * k2;
+                const float y1 = b + h * k1;
+                const float y2 = b + h * k2;
+
+                float d = segDist(px, py, x1, b, x1, t);
+                d = (std::min)(d, segDist(px, py, x2, b, x2, t));
+                d = (std::min)(d, segDist(px, py, l, y1, r, y1));
+                d = (std::min)(d, segDist(px, py, l, y2, r, y2));
+                return d;
+            }
+            if (guideType == 1)
+            {
+                const float cx = l + w * 0.5f;
+                const float cy = b + h * 0.5f;
+                return (std::min)(segDist(px, py, cx, b, cx, t), segDist(px, py, l, cy, r, cy));
+            }
+            if (guideType == 4)
+                return 1.0e9f; // golden spiral is not in the shader (the HUD draws it instead)
+
+            const float cx = l + w * 0.5f;
+            const float cy = b + h * 0.5f;
+            const float rad = (std::min)(w, h) * 0.5f;
+            const float dx = px - cx, dy = py - cy;
+            return std::fabs(std::sqrt(dx * dx + dy * dy) - rad);
+        }
+    }
+
+    Rgba shadeGuidePixel(const GuideFieldParams& p, float px, float py)
+    {
+        const float l = (float)p.gate.left,  b = (float)p.gate.bottom;
+        const float r = (float)p.gate.right, t = (float)p.gate.top;
+
+        const float cx = (l + r) * 0.5f, cy = (b + t) * 0.5f;
+        const float hx = (r - l) * 0.5f, hy = (t - b) * 0.5f;
+        const float box = boxDist(px, py, cx, cy, hx, hy);
+
+        float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        if (p.maskColor.a > 0.0f)
+            over(acc, p.maskColor, p.maskColor.a * clampf(box + 0.5f, 0.0f, 1.0f));
+
+        if (p.borderColor.a > 0.0f)
+            over(acc, p.borderColor, p.borderColor.a * lineCoverage(std::fabs(box), p.borderWidth));
+
+        if (p.lineColor.a > 0.0f)
+            over(acc, p.lineColor, p.lineColor.a * lineCoverage(guideDist(p.guideType, px, py, l, b, r, t), p.lineWidth));
+
+        Rgba out;
+        out.a = acc[3];
+        if (acc[3] > 0.0f)
+        {
+            out.r = acc[0] / acc[3];
+            out.g = acc[1] / acc[3];
+            out.b = acc[2] / acc[3];
+        }
+        return out;
+    }
+
+    void renderGuideField(const GuideFieldParams& p, int x0, int y0, int width, int height, float* rgba)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            const float py = (float)(y0 + y) + 0.5f;
+            float* row = rgba + (size_t)y * (size_t)width * 4;
+            for (int x = 0; x < width; ++x)
+            {
+                const Rgba c = shadeGuidePixel(p, (float)(x0 + x) + 0.5f, py);
+                row[x * 4 + 0] = c.r;
+                row[x * 4 + 1] = c.g;
+                row[x * 4 + 2] = c.b;
+                row[x * 4 + 3] = c.a;
+            }
+        }
+    }
+
+    static inline Rgba withAlpha(const Rgba& c, float alpha)
+    {
+        return Rgba{ c.r, c.g, c.b, clampf(alpha, 0.0f, 1.0f) };
+    }
+
+    GuideFieldParams makeGuideFieldParams(const SettingsData& s, const GateRect& gate)
+    {
+        GuideFieldParams p;
+        p.gate        = gate;
+        p.guideType   = s.guideType;
+        p.goldenOrientation = goldenOrientation(s.goldenRotation, s.goldenFlipH, s.goldenFlipV);
+        p.lineColor   = withAlpha(s.lineColor, s.lineOpacity);
+        p.lineWidth   = s.lineThickness;
+        p.borderColor = withAlpha(s.gateBorderColor, s.gateBorderEnable ? s.gateBorderOpacity : 0.0f);
+        p.borderWidth = s.gateBorderThickness;
+        p.maskColor   = withAlpha(s.maskColor, s.maskEnable ? s.maskOpacity : 0.0f);
+        return p;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+// aoViewportGuideField.h (v0.3.1)
+// CPU reference of resources/shaders/aoViewportGuide.ogsfx: guides evaluated
+// per pixel from distance functions with 1 px anti-aliased coverage. Keep the
+// two in sync; this one is what output gets checked against without a GPU.
+
+#include "aoViewportGuideSettingsData.h"
+#include "aoViewportGuideTypes.h"
+
+namespace AoViewportGuide
+{
+    struct GuideFieldParams
+    {
+        GateRect gate;
+
+        int   guideType   = 0;  // 0 Thirds, 1 Cross, 2 Circle, 3 Phi Grid (4 Golden Spiral: rasterizer only)
+        int   goldenOrientation = 0;
+        Rgba  lineColor;        // a = opacity, 0 hides the guide
+        float lineWidth   = 2.0f;
+
+        Rgba  borderColor;      // a = opacity, 0 hides the border
+        float borderWidth = 2.0f;
+
+        Rgba  maskColor;        // a = opacity outside the gate, 0 disables
+    };
+
+    // Settings colors with their opacity as alpha; disabled border/mask get alpha 0.
+    GuideFieldParams makeGuideFieldParams(const SettingsData& s, const GateRect& gate);
+
+    // Color at pixel position (px, py) in viewport coordinates; pixel centers are at +0.5.
+    Rgba shadeGuidePixel(const GuideFieldParams& p, float px, float py);
+
+    // Evaluates a width x height block whose bottom-left pixel is (x0, y0).
+    // rgba holds width*height*4 floats, first row = bottom row.
+    void renderGuideField(const GuideFieldParams& p, int x0, int y0, int width, int height, float* rgba);
+}
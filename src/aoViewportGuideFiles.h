@@ -0,0 +1,49 @@
+#pragma once
+// aoViewportGuideFiles.h (v0.3.1)
+// File helpers shared by the preset and shape libraries: the stamp a compiled
+// cache records of its source, and writes that readers never see half done.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace AoViewportGuide
+{
+    // Size and modification time of path; a cache is current while both match.
+    inline bool fileStamp(const std::string& path, uint64_t& size, int64_t& time)
+    {
+        std::error_code ec;
+        size = (uint64_t)std::filesystem::file_size(path, ec);
+        if (ec) return false;
+        const std::filesystem::file_time_type t = std::filesystem::last_write_time(path, ec);
+        if (ec) return false;
+        time = (int64_t)t.time_since_epoch().count();
+        return true;
+    }
+
+    // Writes <path>.tmp and renames it over path, so a reader (or a mapping)
+    // sees the old file or the new one.
+    inline bool writeFileAtomic(const std::string& path, const void* data, size_t size, std::string& error)
+    {
+        const std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) { error = "cannot write " + tmpPath; return false; }
+            out.write(static_cast<const char*>(data), (std::streamsize)size);
+            if (!out) { error = "cannot write " + tmpPath; return false; }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            error = "cannot rename to " + path;
+            return false;
+        }
+        return true;
+    }
+}
@@ -1,6 +1,7 @@
 ﻿// aoViewportGuideGate.cpp (v0.3.1)
 
 #include "aoViewportGuideGate.h"
+#include "aoViewportGuideSettings.h"
 
 #include <maya/MSelectionList.h>
 #include <maya/MFnDependencyNode.h>
@@ -8,113 +9,429 @@
 #include <maya/MStatus.h>
 #include <maya/MDagPath.h>
 #include <maya/MFnCamera.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MNodeMessage.h>
+#include <maya/MSceneMessage.h>
+#include <maya/MCallbackIdArray.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace AoViewportGuide
 {
-    static bool getDefaultResolutionAspect(double& outAspect)
+    struct GateCacheEntry
     {
-        outAspect = 1.0;
+        MString  panel;
+        MDagPath camera;
+        int      vpX = 0, vpY = 0, vpW = 0, vpH = 0;
+        bool     followResolutionGate = true;
+        uint64_t generation = 0;
+        GateRect rect;
+    };
+
+    struct CameraWatch
+    {
+        MObjectHandle camera;             // shape
+        MCallbackId   callbackId = 0;     // dirty plugs of the shape
+        MCallbackId   nameCallbackId = 0; // renames of the transform
+    };
+
+    // what annotations show of a watched camera, published for the draw callbacks
+    struct CameraInfo
+    {
+        uint64_t    key = 0; // AoViewportGuideSettings::cameraBindingKey()
+        std::string name;
+        double      focalLength = 0.0;
+    };
+
+    static std::mutex                  gGateMutex; // gGateEntries
+    static std::vector<GateCacheEntry> gGateEntries;
+    static std::vector<CameraWatch>    gCameraWatches;
+
+    static std::mutex              gCameraInfoMutex;
+    static std::vector<CameraInfo> gCameraInfo;
+    static std::atomic<uint64_t>   gCameraInfoGeneration{ 1 };
+    static std::atomic<bool>       gCameraInfoStale{ true }; // set by the watches, cleared by trackFrameCamera()
+
+    // bumped whenever something the gate depends on gets dirty
+    static std::atomic<uint64_t> gGateGeneration{ 1 };
+
+    // defaultResolution width << 32 | height, as of gResolutionGeneration
+    static std::atomic<uint64_t> gResolution{ 0 };
+    static std::atomic<uint64_t> gResolutionGeneration{ 0 };
+
+    static std::atomic<uint64_t> gGateHits{ 0 };
+    static std::atomic<uint64_t> gGateMisses{ 0 };
+
+    static MObjectHandle    gDefaultResolution;
+    static MCallbackIdArray gDefaultResolutionCallbackIds;
+    static MCallbackIdArray gSceneCallbackIds;
+
+    static MObject gAttrWidth;
+    static MObject gAttrHeight;
+    static MObject gAttrDeviceAspectRatio;
+    static MObject gAttrOverscan;
+    static MObject gAttrFilmFit;
+    static MObject gAttrFocalLength;
+
+    static void resolutionDirtyPlugCB(MObject&, MPlug& plug, void*)
+    {
+        const MObject attr = plug.attribute();
+        if (attr == gAttrWidth || attr == gAttrHeight || attr == gAttrDeviceAspectRatio)
+            ++gGateGeneration;
+    }
+
+    static void cameraDirtyPlugCB(MObject&, MPlug& plug, void*)
+    {
+        // tumbling dirties centerOfInterest etc. on the shape; only gate inputs count
+        const MObject attr = plug.attribute();
+        if (attr == gAttrOverscan || attr == gAttrFilmFit)
+            ++gGateGeneration;
+        else if (attr == gAttrFocalLength)
+            gCameraInfoStale = true; // animated: dirtied by every time change
+    }
+
+    static void cameraRenamedCB(MObject&, const MString&, void*)
+    {
+        gCameraInfoStale = true;
+    }
+
+    static void clearDefaultResolution()
+    {
+        if (gDefaultResolutionCallbackIds.length() > 0)
+        {
+            MMessage::removeCallbacks(gDefaultResolutionCallbackIds);
+            gDefaultResolutionCallbackIds.clear();
+        }
+        gDefaultResolution = MObjectHandle();
+    }
+
+    static void clearCameraWatches()
+    {
+        for (const CameraWatch& w : gCameraWatches)
+        {
+            MMessage::removeCallback(w.callbackId);
+            if (w.nameCallbackId) MMessage::removeCallback(w.nameCallbackId);
+        }
+        gCameraWatches.clear();
+        gCameraInfoStale = true;
+    }
+
+    static bool getDefaultResolutionNode(MObject& outObj)
+    {
+        if (gDefaultResolution.isValid())
+        {
+            outObj = gDefaultResolution.object();
+            return true;
+        }
+
+        clearDefaultResolution();
 
         MSelectionList sl;
         if (sl.add("defaultResolution") != MS::kSuccess) return false;
+        if (sl.getDependNode(0, outObj) != MS::kSuccess) return false;
+
+        MFnDependencyNode fn(outObj);
+        gAttrWidth             = fn.attribute("width");
+        gAttrHeight            = fn.attribute("height");
+        gAttrDeviceAspectRatio = fn.attribute("deviceAspectRatio");
+
+        gDefaultResolution = MObjectHandle(outObj);
+        gDefaultResolutionCallbackIds.append(
+            MNodeMessage::addNodeDirtyPlugCallback(outObj, resolutionDirtyPlugCB, nullptr));
+        return true;
+    }
+
+    static void watchCamera(const MDagPath& camPath)
+    {
+        MDagPath shape = camPath;
+        if (shape.hasFn(MFn::kTransform)) shape.extendToShape();
+        MObject camObj = shape.node();
+        if (camObj.isNull()) return;
+
+        for (size_t i = 0; i < gCameraWatches.size(); )
+        {
+            if (gCameraWatches[i].camera.isValid())
+            {
+                if (gCameraWatches[i].camera.objectRef() == camObj) return;
+                ++i;
+                continue;
+            }
+            MMessage::removeCallback(gCameraWatches[i].callbackId);
+            if (gCameraWatches[i].nameCallbackId) MMessage::removeCallback(gCameraWatches[i].nameCallbackId);
+            gCameraWatches.erase(gCameraWatches.begin() + (std::ptrdiff_t)i);
+        }
+
+        if (gAttrOverscan.isNull())
+        {
+            MFnDependencyNode fn(camObj);
+            gAttrOverscan    = fn.attribute("overscan");
+            gAttrFilmFit     = fn.attribute("filmFit");
+            gAttrFocalLength = fn.attribute("focalLength");
+        }
+
+        CameraWatch w;
+        w.camera     = MObjectHandle(camObj);
+        w.callbackId = MNodeMessage::addNodeDirtyPlugCallback(camObj, cameraDirtyPlugCB, nullptr);
+
+        MDagPath transform = shape;
+        transform.pop();
+        MObject transformObj = transform.node();
+        if (!transformObj.isNull())
+            w.nameCallbackId = MNodeMessage::addNameChangedCallback(transformObj, cameraRenamedCB, nullptr);
+
+        gCameraWatches.push_back(w);
+        gCameraInfoStale = true;
+    }
+
+    // Re-reads every watched camera and swaps the published table.
+    static void refreshCameraInfo()
+    {
+        gCameraInfoStale = false; // before reading, so a change made meanwhile refreshes again
+        std::vector<CameraInfo> info;
+        info.reserve(gCameraWatches.size());
+        for (const CameraWatch& w : gCameraWatches)
+        {
+            if (!w.camera.isValid()) continue;
+
+            MDagPath path;
+            if (MDagPath::getAPathTo(w.camera.object(), path) != MS::kSuccess) continue;
+
+            CameraInfo c;
+            c.key = AoViewportGuideSettings::cameraBindingKey(path);
+            if (annotationCamera(path, c.name, c.focalLength))
+                info.push_back(std::move(c));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(gCameraInfoMutex);
+            gCameraInfo.swap(info);
+        }
+        ++gCameraInfoGeneration;
+    }
+
+    static bool readDefaultResolution()
+    {
+        const uint64_t generation = gGateGeneration.load();
 
         MObject nodeObj;
-        if (sl.getDependNode(0, nodeObj) != MS::kSuccess) return false;
+        if (!getDefaultResolutionNode(nodeObj)) return false;
 
-        MFnDependencyNode fn(nodeObj);
-        MPlug wPlug = fn.findPlug("width", true);
-        MPlug hPlug = fn.findPlug("height", true);
+        MPlug wPlug(nodeObj, gAttrWidth);
+        MPlug hPlug(nodeObj, gAttrHeight);
         if (wPlug.isNull() || hPlug.isNull()) return false;
 
-        const int w = wPlug.asInt();
-        const int h = hPlug.asInt();
-        if (h <= 0) return false;
+        const uint32_t w = (uint32_t)wPlug.asInt();
+        const uint32_t h = (uint32_t)hPlug.asInt();
+        gResolution.store((uint64_t)w << 32 | h);
+        gResolutionGeneration.store(generation);
+        return true;
+    }
+
+    // main thread: re-reads defaultResolution once it got dirty
+    static void refreshDefaultResolution()
+    {
+        if (gResolutionGeneration.load() != gGateGeneration.load())
+            readDefaultResolution();
+    }
+
+    bool defaultResolution(int& width, int& height)
+    {
+        // width and height in one word: never a pair from two different reads
+        const uint64_t r = gResolution.load();
+        width  = (int)(uint32_t)(r >> 32);
+        height = (int)(uint32_t)r;
+        return width > 0 && height > 0;
+    }
+
+    static bool getDefaultResolutionAspect(double& outAspect)
+    {
+        outAspect = 1.0;
+        refreshDefaultResolution();
+
+        int w = 0, h = 0;
+        if (!defaultResolution(w, h)) return false;
 
         outAspect = (double)w / (double)h;
         return true;
     }
 
-    struct CameraGateParams
+    bool annotationCamera(const MDagPath& camera, std::string& name, double& focalLength)
     {
-        bool   ok = false;
-        double overscan = 1.0;
-        int    filmFit = 3; // 0 Fill, 1 Horizontal, 2 Vertical, 3 Overscan
-    };
+        MDagPath shape = camera;
+        if (shape.hasFn(MFn::kTransform)) shape.extendToShape();
+
+        MStatus stat;
+        MFnCamera fnCam(shape, &stat);
+        if (!stat) return false;
+        focalLength = fnCam.focalLength();
+
+        MDagPath transform = shape;
+        transform.pop();
+        name = transform.partialPathName().asChar();
+        return true;
+    }
 
-    static CameraGateParams getCameraGateParams(const MHWRender::MFrameContext& frameContext)
+    GateRect computeGateRect(const MHWRender::MFrameContext& frameContext,
+                             int vpX, int vpY, int vpW, int vpH,
+                             bool followResolutionGate)
     {
-        CameraGateParams p;
+        GateParams params;
+
+        double ar = 1.0;
+        if (followResolutionGate && getDefaultResolutionAspect(ar))
+            params.resolutionAspect = ar;
 
         MStatus stat;
         MDagPath camPath = frameContext.getCurrentCameraPath(&stat);
-        if (!stat) return p;
+        if (stat)
+        {
+            MFnCamera fnCam(camPath, &stat);
+            if (stat)
+            {
+                params.overscan = fnCam.overscan();
+                params.filmFit  = (int)fnCam.filmFit();
+            }
+        }
 
-        MFnCamera fnCam(camPath, &stat);
-        if (!stat) return p;
+        return fitGateRect(params, vpX, vpY, vpW, vpH);
+    }
 
-        p.ok = true;
-        p.overscan = fnCam.overscan();
-        p.filmFit  = (int)fnCam.filmFit();
-        return p;
+    uint64_t frameCameraKey(const MHWRender::MFrameContext& frameContext)
+    {
+        MStatus stat;
+        const MDagPath camPath = frameContext.getCurrentCameraPath(&stat);
+        return stat ? AoViewportGuideSettings::cameraBindingKey(camPath) : 0;
     }
 
-    GateRect computeGateRect(const MHWRender::MFrameContext& frameContext,
-                             int vpX, int vpY, int vpW, int vpH,
-                             bool followResolutionGate)
+    uint64_t trackFrameCamera(const MHWRender::MFrameContext& frameContext)
+    {
+        refreshDefaultResolution();
+
+        MStatus stat;
+        const MDagPath camPath = frameContext.getCurrentCameraPath(&stat);
+        if (!stat) return 0;
+
+        watchCamera(camPath);
+        if (gCameraInfoStale) refreshCameraInfo();
+        return AoViewportGuideSettings::cameraBindingKey(camPath);
+    }
+
+    bool cameraAnnotation(uint64_t cameraKey, std::string& name, double& focalLength)
     {
-        GateRect g;
-        if (vpW <= 0 || vpH <= 0) return g;
+        std::lock_guard<std::mutex> lock(gCameraInfoMutex);
+        for (const CameraInfo& c : gCameraInfo)
+        {
+            if (c.key != cameraKey) continue;
+            name        = c.name;
+            focalLength = c.focalLength;
+            return true;
+        }
+        return false;
+    }
 
-        const double viewW  = (double)vpW;
-        const double viewH  = (double)vpH;
-        const double viewAR = viewW / viewH;
+    uint64_t cameraAnnotationGeneration()
+    {
+        return gCameraInfoGeneration.load();
+    }
 
-        double gateAR = viewAR;
-        if (followResolutionGate)
+    GateRect computeGateRectCached(const MString& panelName,
+                                   const MHWRender::MFrameContext& frameContext,
+                                   int vpX, int vpY, int vpW, int vpH,
+                                   bool followResolutionGate)
+    {
+        MStatus stat;
+        const MDagPath camPath = frameContext.getCurrentCameraPath(&stat);
+
+        std::lock_guard<std::mutex> lock(gGateMutex);
+        GateCacheEntry* entry = nullptr;
+        for (GateCacheEntry& e : gGateEntries)
         {
-            double ar = 1.0;
-            if (getDefaultResolutionAspect(ar))
-                gateAR = ar;
+            if (e.panel == panelName) { entry = &e; break; }
         }
 
-        const CameraGateParams camP = getCameraGateParams(frameContext);
-        const double overscan = (camP.ok && camP.overscan > 0.0001) ? camP.overscan : 1.0;
-        const int filmFit = camP.ok ? camP.filmFit : 3;
+        if (entry &&
+            entry->generation == gGateGeneration &&
+            entry->vpX == vpX && entry->vpY == vpY &&
+            entry->vpW == vpW && entry->vpH == vpH &&
+            entry->followResolutionGate == followResolutionGate &&
+            entry->camera == camPath)
+        {
+            ++gGateHits;
+            return entry->rect;
+        }
 
-        double rectW = viewW;
-        double rectH = viewH;
+        ++gGateMisses;
 
-        switch (filmFit)
+        if (!entry)
         {
-        case 1: // Horizontal
-            rectW = viewW;
-            rectH = rectW / gateAR;
-            break;
-        case 2: // Vertical
-            rectH = viewH;
-            rectW = rectH * gateAR;
-            break;
-        case 0: // Fill
-            if (viewAR >= gateAR) { rectW = viewW; rectH = rectW / gateAR; }
-            else                  { rectH = viewH; rectW = rectH * gateAR; }
-            break;
-        case 3: // Overscan
-        default:
-            if (viewAR >= gateAR) { rectH = viewH; rectW = rectH * gateAR; }
-            else                  { rectW = viewW; rectH = rectW / gateAR; }
-            break;
+            gGateEntries.emplace_back();
+            entry = &gGateEntries.back();
+            entry->panel = panelName;
         }
 
-        rectW /= overscan;
-        rectH /= overscan;
+        if (stat)
+            watchCamera(camPath);
+
+        entry->camera = camPath;
+        entry->vpX = vpX; entry->vpY = vpY;
+        entry->vpW = vpW; entry->vpH = vpH;
+        entry->followResolutionGate = followResolutionGate;
+        entry->rect = computeGateRect(frameContext, vpX, vpY, vpW, vpH, followResolutionGate);
+        entry->generation = gGateGeneration;
+        return entry->rect;
+    }
+
+    GateCacheStats gateCacheStats()
+    {
+        GateCacheStats stats;
+        stats.hits   = gGateHits.load();
+        stats.misses = gGateMisses.load();
+        return stats;
+    }
+
+    void resetGateCacheStats()
+    {
+        gGateHits   = 0;
+        gGateMisses = 0;
+    }
 
-        const double rectX = (viewW - rectW) * 0.5;
-        const double rectY = (viewH - rectH) * 0.5;
+    static void clearGateEntries()
+    {
+        std::lock_guard<std::mutex> lock(gGateMutex);
+        gGateEntries.clear();
+    }
+
+    static void sceneChangedCB(void*)
+    {
+        clearCameraWatches();
+        clearDefaultResolution();
+        clearGateEntries();
+        ++gGateGeneration;
+    }
+
+    void installGateCallbacks()
+    {
+        if (gSceneCallbackIds.length() > 0)
+            return;
+
+        gSceneCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterNew,  sceneChangedCB, nullptr));
+        gSceneCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterOpen, sceneChangedCB, nullptr));
+    }
+
+    void removeGateCallbacks()
+    {
+        if (gSceneCallbackIds.length() > 0)
+        {
+            MMessage::removeCallbacks(gSceneCallbackIds);
+            gSceneCallbackIds.clear();
+        }
+        clearCameraWatches();
+        clearDefaultResolution();
+        clearGateEntries();
 
-        g.left   = (double)vpX + rectX;
-        g.bottom = (double)vpY + rectY;
-        g.right  = g.left + rectW;
-        g.top    = g.bottom + rectH;
-        return g;
+        std::lock_guard<std::mutex> lock(gCameraInfoMutex);
+        gCameraInfo.clear();
     }
 }
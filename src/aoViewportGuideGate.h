@@ -1,17 +1,64 @@
 #pragma once
+#include "aoViewportGuideTypes.h"
+#include "aoViewportGuideGateFit.h"
+
+#include <maya/MDagPath.h>
 #include <maya/MFrameContext.h>
+#include <maya/MString.h>
+
+#include <cstdint>
+#include <string>
 
 namespace AoViewportGuide
 {
-    struct GateRect
-    {
-        double left   = 0.0;
-        double bottom = 0.0;
-        double right  = 0.0;
-        double top    = 0.0;
-    };
-
+    // Reads defaultResolution and the current camera into GateParams, then fitGateRect().
     GateRect computeGateRect(const MHWRender::MFrameContext& frameContext,
                              int vpX, int vpY, int vpW, int vpH,
                              bool followResolutionGate);
+
+    // Per-panel cache keyed on (camera path, viewport, followResolutionGate).
+    // Entries are dropped when the camera's overscan/filmFit or
+    // defaultResolution width/height/deviceAspectRatio get dirty. A miss reads
+    // the DG and watches the camera: main thread only (the render override's
+    // setup(), the subscene's update()); the HUD draws the gate setup() resolved.
+    GateRect computeGateRectCached(const MString& panelName,
+                                   const MHWRender::MFrameContext& frameContext,
+                                   int vpX, int vpY, int vpW, int vpH,
+                                   bool followResolutionGate);
+
+    // AoViewportGuideSettings::cameraBindingKey() of the camera being drawn; 0 when
+    // there is none.
+    uint64_t frameCameraKey(const MHWRender::MFrameContext& frameContext);
+
+    // frameCameraKey() for the render override's setup() (main thread): also watches
+    // the camera and re-reads what the draw callbacks show of it (cameraAnnotation(),
+    // defaultResolution()) once it got dirty, so they never read the DG.
+    uint64_t trackFrameCamera(const MHWRender::MFrameContext& frameContext);
+
+    // defaultResolution width / height as last read by trackFrameCamera() or a gate
+    // computation (main thread, once they got dirty). Never reads the DG itself, so
+    // draw callbacks can call it; false before the first read.
+    bool defaultResolution(int& width, int& height);
+
+    // Transform name and focal length of a camera (shape or transform path), as
+    // annotations show them. Reads the DG: main thread only.
+    bool annotationCamera(const MDagPath& camera, std::string& name, double& focalLength);
+
+    // annotationCamera() of a watched camera by cameraBindingKey(), as published by
+    // the last trackFrameCamera(); false for cameras not seen there. The generation
+    // changes whenever anything published changes.
+    bool     cameraAnnotation(uint64_t cameraKey, std::string& name, double& focalLength);
+    uint64_t cameraAnnotationGeneration();
+
+    struct GateCacheStats
+    {
+        uint64_t hits   = 0;
+        uint64_t misses = 0;
+    };
+
+    GateCacheStats gateCacheStats();
+    void resetGateCacheStats();
+
+    void installGateCallbacks();
+    void removeGateCallbacks();
 }
@@ -0,0 +1,55 @@
+// aoViewportGuideGateFit.cpp (v0.3.1)
+
+#include "aoViewportGuideGateFit.h"
+
+namespace AoViewportGuide
+{
+    GateRect fitGateRect(const GateParams& params, int vpX, int vpY, int vpW, int vpH)
+    {
+        GateRect g;
+        if (vpW <= 0 || vpH <= 0) return g;
+
+        const double viewW  = (double)vpW;
+        const double viewH  = (double)vpH;
+        const double viewAR = viewW / viewH;
+
+        const double gateAR   = (params.resolutionAspect > 0.0) ? params.resolutionAspect : viewAR;
+        const double overscan = (params.overscan > 0.0001) ? params.overscan : 1.0;
+
+        double rectW = viewW;
+        double rectH = viewH;
+
+        switch (params.filmFit)
+        {
+        case kFilmFitHorizontal:
+            rectW = viewW;
+            rectH = rectW / gateAR;
+            break;
+        case kFilmFitVertical:
+            rectH = viewH;
+            rectW = rectH * gateAR;
+            break;
+        case kFilmFitFill:
+            if (viewAR >= gateAR) { rectW = viewW; rectH = rectW / gateAR; }
+            else                  { rectH = viewH; rectW = rectH * gateAR; }
+            break;
+        case kFilmFitOverscan:
+        default:
+            if (viewAR >= gateAR) { rectH = viewH; rectW = rectH * gateAR; }
+            else                  { rectW = viewW; rectH = rectW / gateAR; }
+            break;
+        }
+
+        rectW /= overscan;
+        rectH /= overscan;
+
+        const double rectX = (viewW - rectW) * 0.5;
+        const double rectY = (viewH - rectH) * 0.5;
+
+        g.left   = (double)vpX + rectX;
+        g.bottom = (double)vpY + rectY;
+        g.right  = g.left + rectW;
+        g.top    = g.bottom + rectH;
+        return g;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+// aoViewportGuideGateFit.h (v0.3.1)
+// Resolution gate fitting inside a viewport (no Maya types).
+
+#include "aoViewportGuideTypes.h"
+
+namespace AoViewportGuide
+{
+    // values of MFnCamera::FilmFit
+    enum FilmFit
+    {
+        kFilmFitFill       = 0,
+        kFilmFitHorizontal = 1,
+        kFilmFitVertical   = 2,
+        kFilmFitOverscan   = 3,
+    };
+
+    struct GateParams
+    {
+        // width / height of defaultResolution; <= 0 means "use the viewport aspect"
+        double resolutionAspect = 0.0;
+        double overscan = 1.0;
+        int    filmFit  = kFilmFitOverscan;
+    };
+
+    // Gate rectangle in viewport pixels (origin at vpX, vpY), centred like Maya's resolution gate.
+    GateRect fitGateRect(const GateParams& params, int vpX, int vpY, int vpW, int vpH);
+}
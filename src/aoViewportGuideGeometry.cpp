@@ -0,0 +1,101 @@
+// aoViewportGuideGeometry.cpp (v0.3.1)
+
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideTessellation.h"
+#include "aoViewportGuideSettingsData.h"
+
+namespace AoViewportGuide
+{
+    void appendGateBorder(const GateRect& gate, LineBatch& out)
+    {
+        const uint32_t base = out.addPoint(gate.left, gate.bottom);
+        out.addPoint(gate.right, gate.bottom);
+        out.addPoint(gate.right, gate.top);
+        out.addPoint(gate.left,  gate.top);
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            out.indices.push_back(base + i);
+            out.indices.push_back(base + (i + 1) % 4);
+        }
+    }
+
+    void appendGateMask(const GateRect& gate, TriangleBatch& out)
+    {
+        static constexpr double kFar = 1.0e5;
+
+        out.addRect(gate.left - kFar, gate.bottom - kFar, gate.left,         gate.top + kFar);
+        out.addRect(gate.right,       gate.bottom - kFar, gate.right + kFar, gate.top + kFar);
+        out.addRect(gate.left,        gate.bottom - kFar, gate.right,        gate.bottom);
+        out.addRect(gate.left,        gate.top,           gate.right,        gate.top + kFar);
+    }
+
+    void appendThirds(const GateRect& gate, LineBatch& out)
+    {
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+
+        const double x1 = gate.left + w / 3.0;
+        const double x2 = gate.left + w * 2.0 / 3.0;
+        const double y1 = gate.bottom + h / 3.0;
+        const double y2 = gate.bottom + h * 2.0 / 3.0;
+
+        out.addSegment(x1, gate.bottom, x1, gate.top);
+        out.addSegment(x2, gate.bottom, x2, gate.top);
+        out.addSegment(gate.left, y1,   gate.right, y1);
+        out.addSegment(gate.left, y2,   gate.right, y2);
+    }
+
+    void appendCross(const GateRect& gate, LineBatch& out)
+    {
+        const double cx = (gate.left + gate.right) * 0.5;
+        const double cy = (gate.bottom + gate.top) * 0.5;
+
+        out.addSegment(cx, gate.bottom, cx, gate.top);
+        out.addSegment(gate.left, cy,   gate.right, cy);
+    }
+
+    void appendCircleGuide(const GateRect& gate, double tolerancePx, LineBatch& out)
+    {
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+
+        const double cx = gate.left + w * 0.5;
+        const double cy = gate.bottom + h * 0.5;
+        const double r  = (w < h ? w : h) * 0.5;
+
+        appendCircle(cx, cy, r, tolerancePx, out);
+    }
+
+    void appendPhiGrid(const GateRect& gate, LineBatch& out)
+    {
+        static constexpr double kMinor = 0.38196601125010515; // 1 / phi^2
+        static constexpr double kMajor = 0.61803398874989485; // 1 / phi
+
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+
+        const double x1 = gate.left + w * kMinor;
+        const double x2 = gate.left + w * kMajor;
+        const double y1 = gate.bottom + h * kMinor;
+        const double y2 = gate.bottom + h * kMajor;
+
+        out.addSegment(x1, gate.bottom, x1, gate.top);
+        out.addSegment(x2, gate.bottom, x2, gate.top);
+        out.addSegment(gate.left, y1,   gate.right, y1);
+        out.addSegment(gate.left, y2,   gate.right, y2);
+    }
+
+    void appendGuide(int guideType, const GateRect& gate, double tolerancePx, LineBatch& out,
+                     int goldenOrientation)
+    {
+        switch (guideType)
+        {
+        case kGuideThirds:       appendThirds(gate, out); break;
+        case kGuideCross:        appendCross(gate, out);  break;
+        case kGuidePhiGrid:      appendPhiGrid(gate, out); break;
+        case kGuideGoldenSpiral: appendGoldenSpiral(gate, goldenOrientation, tolerancePx, out); break;
+        default:                 appendCircleGuide(gate, tolerancePx, out); break;
+        }
+    }
+}
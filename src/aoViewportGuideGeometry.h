@@ -0,0 +1,78 @@
+#pragma once
+// aoViewportGuideGeometry.h (v0.3.1)
+// Guide line generation into reusable buffers (no Maya types).
+
+#include "aoViewportGuideTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    // Points plus an index list into them. clear() keeps the capacity so
+    // steady-state frames do not allocate.
+    struct IndexedBatch
+    {
+        std::vector<Point2>   points;
+        std::vector<uint32_t> indices;
+
+        void clear() { points.clear(); indices.clear(); }
+
+        uint32_t addPoint(double x, double y)
+        {
+            points.push_back(Point2{ x, y });
+            return (uint32_t)(points.size() - 1);
+        }
+    };
+
+    // Index pairs, submitted as one kLines primitive. Polylines share their vertices.
+    struct LineBatch : IndexedBatch
+    {
+        size_t segmentCount() const { return indices.size() / 2; }
+
+        void addSegment(double x0, double y0, double x1, double y1)
+        {
+            const uint32_t a = addPoint(x0, y0);
+            const uint32_t b = addPoint(x1, y1);
+            indices.push_back(a);
+            indices.push_back(b);
+        }
+    };
+
+    // Index triples, submitted as one kTriangles primitive.
+    struct TriangleBatch : IndexedBatch
+    {
+        size_t triangleCount() const { return indices.size() / 3; }
+
+        void addRect(double x0, double y0, double x1, double y1)
+        {
+            const uint32_t a = addPoint(x0, y0);
+            const uint32_t b = addPoint(x1, y0);
+            const uint32_t c = addPoint(x1, y1);
+            const uint32_t d = addPoint(x0, y1);
+            indices.insert(indices.end(), { a, b, c, a, c, d });
+        }
+    };
+
+    void appendGateBorder(const GateRect& gate, LineBatch& out);
+
+    // Frame around the gate reaching far past any viewport; the viewport clips it,
+    // so the geometry does not depend on the viewport size.
+    void appendGateMask(const GateRect& gate, TriangleBatch& out);
+
+    void appendThirds(const GateRect& gate, LineBatch& out);
+    void appendCross(const GateRect& gate, LineBatch& out);
+
+    // largest circle centred in the gate
+    void appendCircleGuide(const GateRect& gate, double tolerancePx, LineBatch& out);
+
+    // lines at 1/phi^2 and 1/phi of the gate on both axes
+    void appendPhiGrid(const GateRect& gate, LineBatch& out);
+
+    // guideType: 0 Thirds, 1 Cross, 2 Circle, 3 Phi Grid, 4 Golden Spiral (see GuideType)
+    // tolerancePx: max chord error for curved guides
+    // goldenOrientation: spiral orientation, see goldenOrientation()
+    void appendGuide(int guideType, const GateRect& gate, double tolerancePx, LineBatch& out,
+                     int goldenOrientation = 0);
+}
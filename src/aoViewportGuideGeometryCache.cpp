@@ -0,0 +1,155 @@
+// aoViewportGuideGeometryCache.cpp (v0.3.1)
+
+#include "aoViewportGuideGeometryCache.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideShapes.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <mutex>
+
+namespace AoViewportGuide
+{
+    namespace
+    {
+        // a few distinct panel sizes times a couple of quality levels while tumbling
+        static constexpr int kGeometryCacheSize = 16;
+
+        struct GeometryCacheEntry
+        {
+            std::shared_ptr<const GuideGeometry> geometry;
+            uint64_t lastUse = 0;
+        };
+
+        struct GeometryCache
+        {
+            std::mutex              mutex;
+            GeometryCacheEntry      entries[kGeometryCacheSize];
+            uint64_t                useCounter = 0;
+            GuideGeometryCacheStats stats;
+        };
+
+        GeometryCache& geometryCache()
+        {
+            static GeometryCache c;
+            return c;
+        }
+
+        inline int64_t quantizePx(double v) { return (int64_t)(v * 16.0 + 0.5); }
+
+        // Only the cache key is looked at under the lock.
+        std::shared_ptr<const GuideGeometry> findLocked(GeometryCache& cache, const GuideGeometryKey& key)
+        {
+            for (GeometryCacheEntry& e : cache.entries)
+            {
+                if (e.geometry && e.geometry->key == key)
+                {
+                    e.lastUse = ++cache.useCounter;
+                    return e.geometry;
+                }
+            }
+            return nullptr;
+        }
+
+        void buildGuideGeometry(const SettingsData& s, const GuideGeometryKey& key, GuideGeometry& g)
+        {
+            const QualityLevelParams& q = qualityLevelParams(key.quality);
+
+            GateRect gate;
+            gate.right = (double)key.gateW / 16.0;
+            gate.top   = (double)key.gateH / 16.0;
+
+            g.key = key;
+            if (key.gateW <= 0 || key.gateH <= 0) return;
+
+            if (s.maskEnable && s.maskOpacity > 0.0001f)
+                appendGateMask(gate, g.mask);
+            if (s.gateBorderEnable && s.gateBorderOpacity > 0.0001f)
+                appendGateBorder(gate, g.border);
+            appendGuide(s.guideType, gate, q.tolerancePx, g.guide,
+                        goldenOrientation(s.goldenRotation, s.goldenFlipH, s.goldenFlipV));
+
+            buildGuideLayerDraw(s.layers, gate, q.tolerancePx, g.layers, q.minGridSpacingPx);
+            g.layerFills.resize(g.layers.fillCount);
+            for (size_t i = 0; i < g.layers.fillCount; ++i)
+            {
+                for (const GateRect& r : g.layers.fills[i].rects)
+                    g.layerFills[i].addRect(r.left, r.bottom, r.right, r.top);
+            }
+        }
+    }
+
+    GuideGeometryKey guideGeometryKey(uint64_t shapeHash, const GateRect& gate, int quality)
+    {
+        GuideGeometryKey key;
+        key.shapeHash        = shapeHash;
+        key.shapesGeneration = guideShapes().generation();
+        key.gateW            = quantizePx(gate.right - gate.left);
+        key.gateH            = quantizePx(gate.top - gate.bottom);
+        key.quality          = quality;
+        return key;
+    }
+
+    std::shared_ptr<const GuideGeometry> acquireGuideGeometry(const SettingsData& s, const GuideGeometryKey& key)
+    {
+        GeometryCache& cache = geometryCache();
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (std::shared_ptr<const GuideGeometry> hit = findLocked(cache, key))
+            {
+                ++cache.stats.hits;
+                return hit;
+            }
+        }
+
+        // tessellating a layer stack can take a while; other panels keep drawing
+        std::shared_ptr<GuideGeometry> built = std::make_shared<GuideGeometry>();
+        buildGuideGeometry(s, key, *built);
+
+        std::shared_ptr<const GuideGeometry> evicted; // released after the lock
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (std::shared_ptr<const GuideGeometry> raced = findLocked(cache, key))
+        {
+            ++cache.stats.hits;
+            return raced;
+        }
+
+        ++cache.stats.misses;
+        GeometryCacheEntry* oldest = &cache.entries[0];
+        for (GeometryCacheEntry& e : cache.entries)
+        {
+            if (!e.geometry) { oldest = &e; break; }
+            if (e.lastUse < oldest->lastUse) oldest = &e;
+        }
+        if (oldest->geometry) ++cache.stats.evictions;
+
+        // panels still holding the evicted entry keep drawing it until their key changes
+        evicted = std::move(oldest->geometry);
+        oldest->geometry = built;
+        oldest->lastUse  = ++cache.useCounter;
+        return built;
+    }
+
+    GuideGeometryCacheStats guideGeometryCacheStats()
+    {
+        GeometryCache& cache = geometryCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        return cache.stats;
+    }
+
+    void resetGuideGeometryCache()
+    {
+        GeometryCache& cache = geometryCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        for (GeometryCacheEntry& e : cache.entries)
+            e = GeometryCacheEntry();
+        cache.useCounter = 0;
+        cache.stats = GuideGeometryCacheStats();
+    }
+
+    void resetGuideGeometryCacheStats()
+    {
+        GeometryCache& cache = geometryCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.stats = GuideGeometryCacheStats();
+    }
+}
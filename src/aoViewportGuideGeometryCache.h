@@ -0,0 +1,70 @@
+#pragma once
+// aoViewportGuideGeometryCache.h (v0.3.1)
+// Overlay geometry shared between panels (no Maya types). Mask, border, guide and
+// layer stack are built once per (shape hash, gate size, quality level) in
+// gate-local space, bottom-left corner at the origin, and kept in a small LRU
+// cache; every panel showing a gate of that size draws the same entry moved to
+// its own gate corner. Entries are immutable once published, so draw callbacks
+// can hold and read them concurrently while the cache evicts.
+
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideLayers.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    struct GuideGeometryKey
+    {
+        uint64_t shapeHash = 0;        // hashSettingsShape()
+        uint64_t shapesGeneration = 0; // guideShapes().generation()
+        int64_t  gateW = -1;           // 1/16 px
+        int64_t  gateH = -1;
+        int      quality = 0;          // QualityGovernor level
+    };
+
+    inline bool operator==(const GuideGeometryKey& a, const GuideGeometryKey& b)
+    {
+        return a.shapeHash == b.shapeHash && a.shapesGeneration == b.shapesGeneration &&
+               a.gateW == b.gateW && a.gateH == b.gateH && a.quality == b.quality;
+    }
+
+    inline bool operator!=(const GuideGeometryKey& a, const GuideGeometryKey& b) { return !(a == b); }
+
+    // Key of gate's size; reads the shape library's generation, so a reloaded
+    // shape file misses.
+    GuideGeometryKey guideGeometryKey(uint64_t shapeHash, const GateRect& gate, int quality);
+
+    // Built for the gate { 0, 0, gateW / 16, gateH / 16 }.
+    struct GuideGeometry
+    {
+        GuideGeometryKey key;
+
+        TriangleBatch mask;
+        LineBatch     border;
+        LineBatch     guide;
+
+        // layer stack: lines and colors per style group, fills as one batch per group
+        GuideLayerDraw             layers;
+        std::vector<TriangleBatch> layerFills;
+    };
+
+    // The entry for key, built from s on a miss (outside the cache lock; a second
+    // caller racing on the same key keeps whichever entry was published first).
+    // s must be the settings key.shapeHash was taken from. Never null.
+    std::shared_ptr<const GuideGeometry> acquireGuideGeometry(const SettingsData& s, const GuideGeometryKey& key);
+
+    struct GuideGeometryCacheStats
+    {
+        uint64_t hits      = 0;
+        uint64_t misses    = 0;
+        uint64_t evictions = 0;
+    };
+
+    GuideGeometryCacheStats guideGeometryCacheStats();
+    void                    resetGuideGeometryCache();      // drops the entries and zeroes the counters
+    void                    resetGuideGeometryCacheStats(); // zeroes the counters only
+}
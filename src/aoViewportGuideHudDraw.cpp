@@ -0,0 +1,134 @@
+// aoViewportGuideHudDraw.cpp (v0.3.1)
+
+#include "aoViewportGuideHudDraw.h"
+#include "aoViewportGuideCommon.h"
+
+#include <maya/MColor.h>
+
+#include <algorithm>
+
+namespace AoViewportGuide
+{
+    static inline MColor toMColor(const Rgba& c, float alpha)
+    {
+        return MColor(c.r, c.g, c.b, clampf(alpha, 0.0f, 1.0f));
+    }
+
+    static void fillBuffers(const IndexedBatch& batch, const Point2& origin, HudDrawState::DrawBuffers& buf)
+    {
+        const unsigned int n  = (unsigned int)batch.points.size();
+        const unsigned int ni = (unsigned int)batch.indices.size();
+
+        if (buf.points.length() != n)
+            buf.points.setLength(n);
+        for (unsigned int i = 0; i < n; ++i)
+            buf.points.set(i, origin.x + batch.points[i].x, origin.y + batch.points[i].y);
+
+        if (buf.indices.length() != ni)
+            buf.indices.setLength(ni);
+        for (unsigned int i = 0; i < ni; ++i)
+            buf.indices[i] = batch.indices[i];
+    }
+
+    // same entry, gate moved: the indices stay
+    static void moveBuffers(const IndexedBatch& batch, const Point2& origin, HudDrawState::DrawBuffers& buf)
+    {
+        const unsigned int n = (unsigned int)batch.points.size();
+        for (unsigned int i = 0; i < n; ++i)
+            buf.points.set(i, origin.x + batch.points[i].x, origin.y + batch.points[i].y);
+    }
+
+    static unsigned int submitBuffers(MHWRender::MUIDrawManager& dm, MHWRender::MUIDrawManager::Primitive mode,
+                                      HudDrawState::DrawBuffers& buf)
+    {
+        if (buf.points.length() < 2 || buf.indices.length() < 2) return 0;
+
+        dm.mesh2d(mode, buf.points, nullptr, &buf.indices);
+        return 1;
+    }
+
+    static void fillPanelBuffers(HudDrawState& st, bool refill)
+    {
+        const GuideGeometry& g = *st.geometry;
+        auto fill = refill ? fillBuffers : moveBuffers;
+
+        fill(g.mask,   st.origin, st.maskBuffers);
+        fill(g.border, st.origin, st.borderBuffers);
+        fill(g.guide,  st.origin, st.guideBuffers);
+
+        if (st.layerFillBuffers.size() < g.layers.fillCount)
+            st.layerFillBuffers.resize(g.layers.fillCount);
+        for (size_t i = 0; i < g.layers.fillCount; ++i)
+            fill(g.layerFills[i], st.origin, st.layerFillBuffers[i]);
+
+        if (st.layerLineBuffers.size() < g.layers.lineCount)
+            st.layerLineBuffers.resize(g.layers.lineCount);
+        for (size_t i = 0; i < g.layers.lineCount; ++i)
+            fill(g.layers.lines[i].batch, st.origin, st.layerLineBuffers[i]);
+    }
+
+    unsigned int drawGuideOverlay(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t shapeHash,
+                                  const GateRect& gate, HudDrawState& st, bool drawBase, int qualityLevel)
+    {
+        const QualityLevelParams& q = qualityLevelParams(qualityLevel);
+
+        // unchanged shape and gate size: keep the entry this panel holds (no cache
+        // lookup); otherwise take the one any panel of this size already built. A
+        // reloaded shape file changes the layers without changing the settings.
+        const GuideGeometryKey key = guideGeometryKey(shapeHash, gate, qualityLevel);
+        const Point2 origin{ gate.left, gate.bottom };
+        if (!st.geometry || st.geometry->key != key)
+        {
+            st.geometry = acquireGuideGeometry(s, key);
+            st.origin = origin;
+            fillPanelBuffers(st, true);
+        }
+        else if (st.origin.x != origin.x || st.origin.y != origin.y)
+        {
+            st.origin = origin;
+            fillPanelBuffers(st, false);
+        }
+
+        const GuideLayerDraw& layers = st.geometry->layers;
+        unsigned int prims = 0;
+        dm.beginDrawable();
+
+        if (drawBase)
+        {
+            if (s.maskEnable && s.maskOpacity > 0.0001f)
+            {
+                dm.setColor(toMColor(s.maskColor, s.maskOpacity));
+                prims += submitBuffers(dm, MHWRender::MUIDrawManager::kTriangles, st.maskBuffers);
+            }
+
+            if (s.gateBorderEnable && s.gateBorderOpacity > 0.0001f)
+            {
+                dm.setColor(toMColor(s.gateBorderColor, s.gateBorderOpacity));
+                dm.setLineWidth((std::min)(s.gateBorderThickness, q.maxLineWidth));
+                prims += submitBuffers(dm, MHWRender::MUIDrawManager::kLines, st.borderBuffers);
+            }
+
+            dm.setColor(toMColor(s.lineColor, s.lineOpacity));
+            dm.setLineWidth((std::min)(s.lineThickness, q.maxLineWidth));
+            prims += submitBuffers(dm, MHWRender::MUIDrawManager::kLines, st.guideBuffers);
+        }
+
+        for (size_t g = 0; g < layers.fillCount; ++g)
+        {
+            const Rgba& c = layers.fills[g].color;
+            dm.setColor(toMColor(c, c.a));
+            prims += submitBuffers(dm, MHWRender::MUIDrawManager::kTriangles, st.layerFillBuffers[g]);
+        }
+
+        for (size_t g = 0; g < layers.lineCount; ++g)
+        {
+            const GuideLayerDraw::Lines& l = layers.lines[g];
+            dm.setColor(toMColor(l.color, l.color.a));
+            dm.setLineWidth((std::min)(l.thickness, q.maxLineWidth));
+            prims += submitBuffers(dm, MHWRender::MUIDrawManager::kLines, st.layerLineBuffers[g]);
+        }
+
+        dm.endDrawable();
+        return prims;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+// aoViewportGuideHudDraw.h (v0.3.1)
+// HUD overlay submission (mask, gate border, guide). Only needs MUIDrawManager and
+// the point/index arrays, so bench/ can build it against its stand-in SDK.
+
+#include "aoViewportGuideGeometryCache.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <maya/MPointArray.h>
+#include <maya/MUintArray.h>
+#include <maya/MUIDrawManager.h>
+
+#include <memory>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    // Per-panel buffers: the shared gate-local geometry (GeometryCache) moved to this
+    // panel's gate corner. The arrays keep their length between frames; they are
+    // refilled when the panel picks up another cache entry (shape hash, gate size,
+    // quality level or shape library changed) and only have their points moved
+    // when the gate moved without changing size.
+    struct HudDrawState
+    {
+        struct DrawBuffers
+        {
+            MPointArray points;
+            MUintArray  indices;
+        };
+
+        std::shared_ptr<const GuideGeometry> geometry;
+        Point2                               origin; // gate corner the buffers are moved to
+
+        DrawBuffers maskBuffers;
+        DrawBuffers borderBuffers;
+        DrawBuffers guideBuffers;
+
+        // layer stack, one primitive per style group
+        std::vector<DrawBuffers> layerFillBuffers;
+        std::vector<DrawBuffers> layerLineBuffers;
+    };
+
+    // One drawable: mask (kTriangles), border and guide (kLines), then the layer stack's
+    // fills and lines, one primitive per style. With drawBase false only the layers are
+    // drawn (the base guide comes from another backend). shapeHash is hashSettingsShape()
+    // of s: colors, opacities and widths are applied without touching the geometry.
+    // qualityLevel (QualityGovernor) coarsens curves and grids and caps line widths.
+    // Returns the number of primitives submitted.
+    unsigned int drawGuideOverlay(MHWRender::MUIDrawManager& dm, const SettingsData& s, uint64_t shapeHash,
+                                  const GateRect& gate, HudDrawState& st, bool drawBase = true,
+                                  int qualityLevel = kQualityFull);
+}
@@ -0,0 +1,741 @@
+// aoViewportGuideImageIO.cpp (v0.3.1)
+
+#include "aoViewportGuideImageIO.h"
+#include "aoViewportGuideCommon.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(AO_HAVE_PNG)
+#include <csetjmp>
+#include <png.h>
+#endif
+
+#if defined(AO_HAVE_OPENEXR)
+#include <ImfRgbaFile.h>
+#include <exception>
+#endif
+
+namespace AoViewportGuide
+{
+    static std::string lowerCase(std::string s)
+    {
+        for (char& c : s) c = (char)std::tolower((unsigned char)c);
+        return s;
+    }
+
+    ImageFormat imageFormatFromName(const std::string& name)
+    {
+        const std::string n = lowerCase(name);
+        if (n == "ppm") return kImagePpm;
+        if (n == "png") return kImagePng;
+        if (n == "exr") return kImageExr;
+        return kImageUnknown;
+    }
+
+    ImageFormat imageFormatFromPath(const std::string& path)
+    {
+        const size_t dot = path.find_last_of('.');
+        const size_t sep = path.find_last_of("/\\");
+        if (dot == std::string::npos || (sep != std::string::npos && dot < sep)) return kImageUnknown;
+        return imageFormatFromName(path.substr(dot + 1));
+    }
+
+    const char* imageFormatExtension(ImageFormat format)
+    {
+        switch (format)
+        {
+        case kImagePpm: return ".ppm";
+        case kImagePng: return ".png";
+        case kImageExr: return ".exr";
+        default:        return "";
+        }
+    }
+
+    bool imageFormatAvailable(ImageFormat format)
+    {
+        switch (format)
+        {
+        case kImagePpm: return true;
+#if defined(AO_HAVE_PNG)
+        case kImagePng: return true;
+#endif
+#if defined(AO_HAVE_OPENEXR)
+        case kImageExr: return true;
+#endif
+        default:        return false;
+        }
+    }
+
+    static inline float unitClamp(float v)
+    {
+        return clampf(v, 0.0f, 1.0f);
+    }
+
+    // ---------------------------------------------------------------------
+    // PPM (binary P6, maxval up to 65535)
+
+    class PpmReader : public ImageReader
+    {
+    public:
+        ~PpmReader() override
+        {
+            if (mFile) std::fclose(mFile);
+        }
+
+        bool open(const std::string& path, std::string& error)
+        {
+            mFile = std::fopen(path.c_str(), "rb");
+            if (!mFile) { error = "cannot open " + path; return false; }
+
+            char magic[2] = {};
+            if (std::fread(magic, 1, 2, mFile) != 2 || magic[0] != 'P' || magic[1] != '6')
+            {
+                error = path + ": not a binary PPM (P6)";
+                return false;
+            }
+
+            int values[3] = {};
+            for (int& v : values)
+            {
+                if (!readHeaderInt(v)) { error = path + ": bad PPM header"; return false; }
+            }
+            mMaxVal = values[2];
+            if (values[0] <= 0 || values[1] <= 0 || mMaxVal <= 0 || mMaxVal > 65535)
+            {
+                error = path + ": bad PPM header";
+                return false;
+            }
+
+            mSpec.width    = values[0];
+            mSpec.height   = values[1];
+            mSpec.bitDepth = (mMaxVal > 255) ? 16 : 8;
+            mSpec.hasAlpha = false;
+
+            mRow.resize((size_t)mSpec.width * 3 * (mSpec.bitDepth / 8));
+            return true;
+        }
+
+        bool readRows(int rows, float* rgba, std::string& error) override
+        {
+            const float scale = 1.0f / (float)mMaxVal;
+            const int w = mSpec.width;
+
+            for (int r = 0; r < rows; ++r)
+            {
+                if (std::fread(mRow.data(), 1, mRow.size(), mFile) != mRow.size())
+                {
+                    error = "unexpected end of PPM data";
+                    return false;
+                }
+
+                float* out = rgba + (size_t)r * (size_t)w * 4;
+                if (mSpec.bitDepth == 8)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        out[x * 4 + 0] = (float)mRow[x * 3 + 0] * scale;
+                        out[x * 4 + 1] = (float)mRow[x * 3 + 1] * scale;
+                        out[x * 4 + 2] = (float)mRow[x * 3 + 2] * scale;
+                        out[x * 4 + 3] = 1.0f;
+                    }
+                }
+                else
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            const unsigned char* p = &mRow[(x * 3 + c) * 2];
+                            out[x * 4 + c] = (float)((p[0] << 8) | p[1]) * scale;
+                        }
+                        out[x * 4 + 3] = 1.0f;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        // whitespace and '#' comments between header fields; exactly one whitespace after maxval
+        bool readHeaderInt(int& out)
+        {
+            int c = std::fgetc(mFile);
+            for (;;)
+            {
+                if (c == '#')
+                {
+                    while (c != '\n' && c != EOF) c = std::fgetc(mFile);
+                }
+                else if (std::isspace(c))
+                {
+                    c = std::fgetc(mFile);
+                }
+                else break;
+            }
+            if (!std::isdigit(c)) return false;
+
+            long v = 0;
+            while (std::isdigit(c))
+            {
+                v = v * 10 + (c - '0');
+                if (v > 1000000) return false;
+                c = std::fgetc(mFile);
+            }
+            if (!std::isspace(c)) return false;
+
+            out = (int)v;
+            return true;
+        }
+
+        std::FILE* mFile = nullptr;
+        int mMaxVal = 255;
+        std::vector<unsigned char> mRow;
+    };
+
+    class PpmWriter : public ImageWriter
+    {
+    public:
+        ~PpmWriter() override
+        {
+            if (mFile) std::fclose(mFile);
+        }
+
+        bool create(const std::string& path, const ImageSpec& spec, std::string& error)
+        {
+            mSpec = spec;
+            mFile = std::fopen(path.c_str(), "wb");
+            if (!mFile) { error = "cannot write " + path; return false; }
+
+            const int maxVal = (spec.bitDepth > 8) ? 65535 : 255;
+            std::fprintf(mFile, "P6\n%d %d\n%d\n", spec.width, spec.height, maxVal);
+            mRow.resize((size_t)spec.width * 3 * (spec.bitDepth > 8 ? 2 : 1));
+            return true;
+        }
+
+        bool writeRows(int rows, const float* rgba, std::string& error) override
+        {
+            const int w = mSpec.width;
+            for (int r = 0; r < rows; ++r)
+            {
+                const float* in = rgba + (size_t)r * (size_t)w * 4;
+                if (mSpec.bitDepth > 8)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            const unsigned int v = (unsigned int)(unitClamp(in[x * 4 + c]) * 65535.0f + 0.5f);
+                            mRow[(x * 3 + c) * 2 + 0] = (unsigned char)(v >> 8);
+                            mRow[(x * 3 + c) * 2 + 1] = (unsigned char)(v & 0xff);
+                        }
+                    }
+                }
+                else
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        for (int c = 0; c < 3; ++c)
+                            mRow[x * 3 + c] = (unsigned char)(unitClamp(in[x * 4 + c]) * 255.0f + 0.5f);
+                    }
+                }
+
+                if (std::fwrite(mRow.data(), 1, mRow.size(), mFile) != mRow.size())
+                {
+                    error = "write error";
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool finish(std::string& error) override
+        {
+            const bool ok = (std::fclose(mFile) == 0);
+            mFile = nullptr;
+            if (!ok) error = "write error";
+            return ok;
+        }
+
+    private:
+        std::FILE* mFile = nullptr;
+        ImageSpec  mSpec;
+        std::vector<unsigned char> mRow;
+    };
+
+#if defined(AO_HAVE_PNG)
+    // ---------------------------------------------------------------------
+    // PNG (libpng, row by row; interlaced files are rejected)
+    //
+    // libpng reports errors with longjmp, so every call that can fail goes through
+    // a small function whose frame holds no C++ objects.
+
+    struct PngError
+    {
+        char message[256] = {};
+    };
+
+    static void pngErrorFn(png_structp png, png_const_charp msg)
+    {
+        PngError* err = (PngError*)png_get_error_ptr(png);
+        if (err) std::snprintf(err->message, sizeof(err->message), "%s", msg);
+        png_longjmp(png, 1);
+    }
+
+    static void pngWarningFn(png_structp, png_const_charp)
+    {
+    }
+
+    struct PngHeader
+    {
+        png_uint_32 width = 0;
+        png_uint_32 height = 0;
+        int bitDepth = 0;
+        int channels = 0;
+        int interlace = 0;
+    };
+
+    static bool pngReadHeader(png_structp png, png_infop info, std::FILE* file, PngHeader* out)
+    {
+        if (setjmp(png_jmpbuf(png))) return false;
+
+        png_init_io(png, file);
+        png_set_sig_bytes(png, 8);
+        png_read_info(png, info);
+
+        int bitDepth = 0, colorType = 0;
+        png_get_IHDR(png, info, &out->width, &out->height, &bitDepth, &colorType, &out->interlace, nullptr, nullptr);
+
+        if (colorType == PNG_COLOR_TYPE_PALETTE)
+            png_set_palette_to_rgb(png);
+        if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+            png_set_expand_gray_1_2_4_to_8(png);
+        if (png_get_valid(png, info, PNG_INFO_tRNS))
+            png_set_tRNS_to_alpha(png);
+        if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+            png_set_gray_to_rgb(png);
+
+        png_read_update_info(png, info);
+        out->bitDepth = png_get_bit_depth(png, info);
+        out->channels = png_get_channels(png, info);
+        return true;
+    }
+
+    static bool pngReadRow(png_structp png, png_bytep row)
+    {
+        if (setjmp(png_jmpbuf(png))) return false;
+        png_read_row(png, row, nullptr);
+        return true;
+    }
+
+    class PngReader : public ImageReader
+    {
+    public:
+        ~PngReader() override
+        {
+            if (mPng) png_destroy_read_struct(&mPng, mInfo ? &mInfo : nullptr, nullptr);
+            if (mFile) std::fclose(mFile);
+        }
+
+        bool open(const std::string& path, std::string& error)
+        {
+            mFile = std::fopen(path.c_str(), "rb");
+            if (!mFile) { error = "cannot open " + path; return false; }
+
+            png_byte sig[8] = {};
+            if (std::fread(sig, 1, 8, mFile) != 8 || png_sig_cmp(sig, 0, 8) != 0)
+            {
+                error = path + ": not a PNG file";
+                return false;
+            }
+
+            mPng  = png_create_read_struct(PNG_LIBPNG_VER_STRING, &mError, pngErrorFn, pngWarningFn);
+            mInfo = mPng ? png_create_info_struct(mPng) : nullptr;
+            if (!mPng || !mInfo) { error = "libpng init failed"; return false; }
+
+            PngHeader h;
+            if (!pngReadHeader(mPng, mInfo, mFile, &h))
+            {
+                error = path + ": " + mError.message;
+                return false;
+            }
+            if (h.interlace != PNG_INTERLACE_NONE)
+            {
+                error = path + ": interlaced PNG is not supported";
+                return false;
+            }
+
+            mSpec.width    = (int)h.width;
+            mSpec.height   = (int)h.height;
+            mSpec.bitDepth = h.bitDepth;
+            mSpec.hasAlpha = (h.channels == 4);
+            mChannels      = h.channels;
+
+            mRow.resize((size_t)mSpec.width * (size_t)mChannels * (size_t)(mSpec.bitDepth / 8));
+            return true;
+        }
+
+        bool readRows(int rows, float* rgba, std::string& error) override
+        {
+            const int w = mSpec.width;
+            const int nc = mChannels;
+            const float scale = (mSpec.bitDepth == 16) ? 1.0f / 65535.0f : 1.0f / 255.0f;
+
+            for (int r = 0; r < rows; ++r)
+            {
+                if (!pngReadRow(mPng, mRow.data()))
+                {
+                    error = mError.message;
+                    return false;
+                }
+
+                float* out = rgba + (size_t)r * (size_t)w * 4;
+                for (int x = 0; x < w; ++x)
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        if (c >= nc) { out[x * 4 + c] = 1.0f; continue; }
+                        const size_t i = (size_t)(x * nc + c);
+                        const unsigned int v = (mSpec.bitDepth == 16)
+                            ? (unsigned int)((mRow[i * 2] << 8) | mRow[i * 2 + 1])
+                            : (unsigned int)mRow[i];
+                        out[x * 4 + c] = (float)v * scale;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::FILE*  mFile = nullptr;
+        png_structp mPng  = nullptr;
+        png_infop   mInfo = nullptr;
+        PngError    mError;
+        int         mChannels = 3;
+        std::vector<unsigned char> mRow;
+    };
+
+    static bool pngWriteHeader(png_structp png, png_infop info, std::FILE* file, const ImageSpec* spec)
+    {
+        if (setjmp(png_jmpbuf(png))) return false;
+
+        png_init_io(png, file);
+        png_set_IHDR(png, info, (png_uint_32)spec->width, (png_uint_32)spec->height,
+                     spec->bitDepth > 8 ? 16 : 8,
+                     spec->hasAlpha ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB,
+                     PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(png, info);
+        return true;
+    }
+
+    static bool pngWriteRow(png_structp png, png_bytep row)
+    {
+        if (setjmp(png_jmpbuf(png))) return false;
+        png_write_row(png, row);
+        return true;
+    }
+
+    static bool pngWriteEnd(png_structp png)
+    {
+        if (setjmp(png_jmpbuf(png))) return false;
+        png_write_end(png, nullptr);
+        return true;
+    }
+
+    class PngWriter : public ImageWriter
+    {
+    public:
+        ~PngWriter() override
+        {
+            if (mPng) png_destroy_write_struct(&mPng, mInfo ? &mInfo : nullptr);
+            if (mFile) std::fclose(mFile);
+        }
+
+        bool create(const std::string& path, const ImageSpec& spec, std::string& error)
+        {
+            mSpec = spec;
+            mFile = std::fopen(path.c_str(), "wb");
+            if (!mFile) { error = "cannot write " + path; return false; }
+
+            mPng  = png_create_write_struct(PNG_LIBPNG_VER_STRING, &mError, pngErrorFn, pngWarningFn);
+            mInfo = mPng ? png_create_info_struct(mPng) : nullptr;
+            if (!mPng || !mInfo) { error = "libpng init failed"; return false; }
+
+            if (!pngWriteHeader(mPng, mInfo, mFile, &mSpec))
+            {
+                error = path + ": " + mError.message;
+                return false;
+            }
+
+            mChannels = spec.hasAlpha ? 4 : 3;
+            mRow.resize((size_t)spec.width * (size_t)mChannels * (spec.bitDepth > 8 ? 2 : 1));
+            return true;
+        }
+
+        bool writeRows(int rows, const float* rgba, std::string& error) override
+        {
+            const int w = mSpec.width;
+            const int nc = mChannels;
+
+            for (int r = 0; r < rows; ++r)
+            {
+                const float* in = rgba + (size_t)r * (size_t)w * 4;
+                for (int x = 0; x < w; ++x)
+                {
+                    for (int c = 0; c < nc; ++c)
+                    {
+                        const size_t i = (size_t)(x * nc + c);
+                        if (mSpec.bitDepth > 8)
+                        {
+                            const unsigned int v = (unsigned int)(unitClamp(in[x * 4 + c]) * 65535.0f + 0.5f);
+                            mRow[i * 2 + 0] = (unsigned char)(v >> 8);
+                            mRow[i * 2 + 1] = (unsigned char)(v & 0xff);
+                        }
+                        else
+                        {
+                            mRow[i] = (unsigned char)(unitClamp(in[x * 4 + c]) * 255.0f + 0.5f);
+                        }
+                    }
+                }
+
+                if (!pngWriteRow(mPng, mRow.data()))
+                {
+                    error = mError.message;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool finish(std::string& error) override
+        {
+            if (!pngWriteEnd(mPng))
+            {
+                error = mError.message;
+                return false;
+            }
+            png_destroy_write_struct(&mPng, &mInfo);
+            mPng = nullptr;
+            mInfo = nullptr;
+
+            const bool ok = (std::fclose(mFile) == 0);
+            mFile = nullptr;
+            if (!ok) error = "write error";
+            return ok;
+        }
+
+    private:
+        std::FILE*  mFile = nullptr;
+        png_structp mPng  = nullptr;
+        png_infop   mInfo = nullptr;
+        PngError    mError;
+        ImageSpec   mSpec;
+        int         mChannels = 3;
+        std::vector<unsigned char> mRow;
+    };
+#endif
+
+#if defined(AO_HAVE_OPENEXR)
+    // ---------------------------------------------------------------------
+    // OpenEXR (RGBA interface, scanline ranges). The data window is treated as
+    // the image; written files get a data window = display window at the origin.
+
+    class ExrReader : public ImageReader
+    {
+    public:
+        bool open(const std::string& path, std::string& error)
+        {
+            try
+            {
+                mFile.reset(new Imf::RgbaInputFile(path.c_str()));
+                const Imath::Box2i dw = mFile->dataWindow();
+                mMinX = dw.min.x;
+                mMinY = dw.min.y;
+                mSpec.width    = dw.max.x - dw.min.x + 1;
+                mSpec.height   = dw.max.y - dw.min.y + 1;
+                mSpec.bitDepth = 16;
+                mSpec.hasAlpha = (mFile->channels() & Imf::WRITE_A) != 0;
+            }
+            catch (const std::exception& e)
+            {
+                error = path + ": " + e.what();
+                return false;
+            }
+            return true;
+        }
+
+        bool readRows(int rows, float* rgba, std::string& error) override
+        {
+            const int w = mSpec.width;
+            mPixels.resize((size_t)w * (size_t)rows);
+
+            try
+            {
+                const int y0 = mMinY + mNextRow;
+                Imf::Rgba* base = mPixels.data() - mMinX - (ptrdiff_t)y0 * w;
+                mFile->setFrameBuffer(base, 1, (size_t)w);
+                mFile->readPixels(y0, y0 + rows - 1);
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+                return false;
+            }
+            mNextRow += rows;
+
+            for (size_t i = 0; i < mPixels.size(); ++i)
+            {
+                rgba[i * 4 + 0] = (float)mPixels[i].r;
+                rgba[i * 4 + 1] = (float)mPixels[i].g;
+                rgba[i * 4 + 2] = (float)mPixels[i].b;
+                rgba[i * 4 + 3] = mSpec.hasAlpha ? (float)mPixels[i].a : 1.0f;
+            }
+            return true;
+        }
+
+    private:
+        std::unique_ptr<Imf::RgbaInputFile> mFile;
+        std::vector<Imf::Rgba> mPixels;
+        int mMinX = 0;
+        int mMinY = 0;
+        int mNextRow = 0;
+    };
+
+    class ExrWriter : public ImageWriter
+    {
+    public:
+        bool create(const std::string& path, const ImageSpec& spec, std::string& error)
+        {
+            mSpec = spec;
+            try
+            {
+                mFile.reset(new Imf::RgbaOutputFile(path.c_str(), spec.width, spec.height,
+                                                    spec.hasAlpha ? Imf::WRITE_RGBA : Imf::WRITE_RGB));
+            }
+            catch (const std::exception& e)
+            {
+                error = path + ": " + e.what();
+                return false;
+            }
+            return true;
+        }
+
+        bool writeRows(int rows, const float* rgba, std::string& error) override
+        {
+            const int w = mSpec.width;
+            mPixels.resize((size_t)w * (size_t)rows);
+            for (size_t i = 0; i < mPixels.size(); ++i)
+            {
+                mPixels[i].r = rgba[i * 4 + 0];
+                mPixels[i].g = rgba[i * 4 + 1];
+                mPixels[i].b = rgba[i * 4 + 2];
+                mPixels[i].a = rgba[i * 4 + 3];
+            }
+
+            try
+            {
+                Imf::Rgba* base = mPixels.data() - (ptrdiff_t)mNextRow * w;
+                mFile->setFrameBuffer(base, 1, (size_t)w);
+                mFile->writePixels(rows);
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+                return false;
+            }
+            mNextRow += rows;
+            return true;
+        }
+
+        bool finish(std::string& error) override
+        {
+            try
+            {
+                mFile.reset();
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        std::unique_ptr<Imf::RgbaOutputFile> mFile;
+        std::vector<Imf::Rgba> mPixels;
+        ImageSpec mSpec;
+        int mNextRow = 0;
+    };
+#endif
+
+    // ---------------------------------------------------------------------
+
+    std::unique_ptr<ImageReader> ImageReader::open(const std::string& path, std::string& error)
+    {
+        switch (imageFormatFromPath(path))
+        {
+        case kImagePpm:
+        {
+            std::unique_ptr<PpmReader> r(new PpmReader());
+            if (!r->open(path, error)) return nullptr;
+            return r;
+        }
+#if defined(AO_HAVE_PNG)
+        case kImagePng:
+        {
+            std::unique_ptr<PngReader> r(new PngReader());
+            if (!r->open(path, error)) return nullptr;
+            return r;
+        }
+#endif
+#if defined(AO_HAVE_OPENEXR)
+        case kImageExr:
+        {
+            std::unique_ptr<ExrReader> r(new ExrReader());
+            if (!r->open(path, error)) return nullptr;
+            return r;
+        }
+#endif
+        default:
+            error = path + ": unsupported image format";
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<ImageWriter> ImageWriter::create(const std::string& path, ImageFormat format,
+                                                     const ImageSpec& spec, std::string& error)
+    {
+        switch (format)
+        {
+        case kImagePpm:
+        {
+            std::unique_ptr<PpmWriter> w(new PpmWriter());
+            if (!w->create(path, spec, error)) return nullptr;
+            return w;
+        }
+#if defined(AO_HAVE_PNG)
+        case kImagePng:
+        {
+            std::unique_ptr<PngWriter> w(new PngWriter());
+            if (!w->create(path, spec, error)) return nullptr;
+            return w;
+        }
+#endif
+#if defined(AO_HAVE_OPENEXR)
+        case kImageExr:
+        {
+            std::unique_ptr<ExrWriter> w(new ExrWriter());
+            if (!w->create(path, spec, error)) return nullptr;
+            return w;
+        }
+#endif
+        default:
+            error = path + ": unsupported image format";
+            return nullptr;
+        }
+    }
+}
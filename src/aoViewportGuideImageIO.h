@@ -0,0 +1,65 @@
+#pragma once
+// aoViewportGuideImageIO.h (v0.3.1)
+// Scanline image reading/writing for the burn-in. Rows stream top to bottom as
+// float RGBA (file code values, 1.0 = max), so a frame never has to be held in
+// memory as a whole. PPM is always available; PNG needs AO_HAVE_PNG and EXR
+// needs AO_HAVE_OPENEXR (see CMakeLists.txt).
+
+#include <memory>
+#include <string>
+
+namespace AoViewportGuide
+{
+    enum ImageFormat
+    {
+        kImageUnknown = 0,
+        kImagePpm,
+        kImagePng,
+        kImageExr,
+    };
+
+    // by extension (.ppm, .png, .exr; case-insensitive)
+    ImageFormat imageFormatFromPath(const std::string& path);
+    ImageFormat imageFormatFromName(const std::string& name); // "ppm", "png", "exr"
+    const char* imageFormatExtension(ImageFormat format);     // ".ppm", ...
+    bool        imageFormatAvailable(ImageFormat format);
+
+    struct ImageSpec
+    {
+        int  width    = 0;
+        int  height   = 0;
+        int  bitDepth = 8;    // 8 or 16 for PPM/PNG, 16 (half) for EXR
+        bool hasAlpha = false;
+    };
+
+    class ImageReader
+    {
+    public:
+        virtual ~ImageReader() = default;
+
+        static std::unique_ptr<ImageReader> open(const std::string& path, std::string& error);
+
+        const ImageSpec& spec() const { return mSpec; }
+
+        // Next `rows` rows into rgba (width * rows * 4 floats); alpha is 1 without an alpha channel.
+        virtual bool readRows(int rows, float* rgba, std::string& error) = 0;
+
+    protected:
+        ImageSpec mSpec;
+    };
+
+    class ImageWriter
+    {
+    public:
+        virtual ~ImageWriter() = default;
+
+        static std::unique_ptr<ImageWriter> create(const std::string& path, ImageFormat format,
+                                                   const ImageSpec& spec, std::string& error);
+
+        // Next `rows` rows from rgba (values are clamped to the format's range where needed).
+        virtual bool writeRows(int rows, const float* rgba, std::string& error) = 0;
+
+        // Flushes and closes; the file is incomplete until this returns true.
+        virtual bool finish(std::string& error) = 0;
+    };
+}
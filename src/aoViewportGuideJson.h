@@ -0,0 +1,134 @@
+#pragma once
+// aoViewportGuideJson.h (v0.3.1)
+// JSON scanning, just enough for the preset and shape files (objects, arrays,
+// strings, numbers, literals). The cursor walks the text in place and never
+// builds a document; callers pull the values they expect.
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace AoViewportGuide
+{
+    struct JsonCursor
+    {
+        const char* p;
+        const char* end;
+
+        void skipWs()
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+        }
+
+        bool take(char c)
+        {
+            skipWs();
+            if (p < end && *p == c) { ++p; return true; }
+            return false;
+        }
+
+        bool peek(char c)
+        {
+            skipWs();
+            return p < end && *p == c;
+        }
+
+        static void appendUtf8(std::string& out, unsigned int cp)
+        {
+            if (cp < 0x80) out += (char)cp;
+            else if (cp < 0x800)
+            {
+                out += (char)(0xC0 | (cp >> 6));
+                out += (char)(0x80 | (cp & 0x3F));
+            }
+            else
+            {
+                out += (char)(0xE0 | (cp >> 12));
+                out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                out += (char)(0x80 | (cp & 0x3F));
+            }
+        }
+
+        bool string(std::string& out)
+        {
+            out.clear();
+            if (!take('"')) return false;
+            while (p < end && *p != '"')
+            {
+                char c = *p++;
+                if (c != '\\') { out += c; continue; }
+                if (p >= end) return false;
+
+                c = *p++;
+                switch (c)
+                {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                {
+                    if (end - p < 4) return false;
+                    unsigned int cp = 0;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const char h = *p++;
+                        cp <<= 4;
+                        if (h >= '0' && h <= '9')      cp |= (unsigned int)(h - '0');
+                        else if (h >= 'a' && h <= 'f') cp |= (unsigned int)(h - 'a' + 10);
+                        else if (h >= 'A' && h <= 'F') cp |= (unsigned int)(h - 'A' + 10);
+                        else return false;
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default: out += c; break; // \" \\ \/
+                }
+            }
+            if (p >= end) return false;
+            ++p;
+            return true;
+        }
+
+        // number or literal, as written
+        bool scalar(std::string& out)
+        {
+            skipWs();
+            const char* start = p;
+            while (p < end && (std::strchr("+-.0123456789eE", *p) || (*p >= 'a' && *p <= 'z'))) ++p;
+            out.assign(start, p);
+            return p > start;
+        }
+
+        bool number(double& out)
+        {
+            std::string text;
+            if (!scalar(text)) return false;
+            char* stop = nullptr;
+            out = std::strtod(text.c_str(), &stop);
+            return stop != text.c_str() && *stop == '\0';
+        }
+
+        bool skipValue()
+        {
+            skipWs();
+            if (p >= end) return false;
+            std::string scratch;
+            if (*p == '"') return string(scratch);
+            if (*p == '{' || *p == '[')
+            {
+                const char close = *p == '{' ? '}' : ']';
+                ++p;
+                if (take(close)) return true;
+                do
+                {
+                    if (close == '}' && (!string(scratch) || !take(':'))) return false;
+                    if (!skipValue()) return false;
+                } while (take(','));
+                return take(close);
+            }
+            return scalar(scratch);
+        }
+    };
+}
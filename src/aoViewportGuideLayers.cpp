@@ -0,0 +1,333 @@
+// aoViewportGuideLayers.cpp (v0.3.1)
+
+#include "aoViewportGuideLayers.h"
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideShapes.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace AoViewportGuide
+{
+    int addGuideLayer(GuideLayerStack& stack, int type)
+    {
+        if (stack.count >= kMaxGuideLayers || type < 0 || type >= kLayerTypeCount)
+            return -1;
+
+        const int i = stack.count++;
+        stack.type[i]       = (uint8_t)type;
+        stack.colorR[i]     = 1.0f;
+        stack.colorG[i]     = 1.0f;
+        stack.colorB[i]     = 1.0f;
+        stack.opacity[i]    = type == kLayerAspectMask ? 1.0f : 0.5f;
+        stack.thickness[i]  = 1.0f;
+        stack.safeAction[i] = 90.0f;
+        stack.safeTitle[i]  = 80.0f;
+        stack.maskRatio[i]  = 2.39f;
+        stack.columns[i]    = 4;
+        stack.rows[i]       = 4;
+        stack.shape[i]      = 0;
+        if (type == kLayerAspectMask)
+        {
+            stack.colorR[i] = 0.0f;
+            stack.colorG[i] = 0.0f;
+            stack.colorB[i] = 0.0f;
+        }
+        return i;
+    }
+
+    void sanitizeGuideLayers(GuideLayerStack& stack)
+    {
+        if (stack.count > kMaxGuideLayers) stack.count = kMaxGuideLayers;
+
+        for (int i = 0; i < stack.count; ++i)
+        {
+            if (stack.type[i] >= kLayerTypeCount) stack.type[i] = kLayerThirds;
+
+            stack.opacity[i]    = clampf(stack.opacity[i], 0.0f, 1.0f);
+            stack.thickness[i]  = clampf(stack.thickness[i], 0.5f, 50.0f);
+            stack.safeAction[i] = clampf(stack.safeAction[i], 0.0f, 100.0f);
+            stack.safeTitle[i]  = clampf(stack.safeTitle[i], 0.0f, 100.0f);
+            stack.maskRatio[i]  = clampf(stack.maskRatio[i], 0.1f, 10.0f);
+
+            if (stack.columns[i] < 1) stack.columns[i] = 1;
+            if (stack.columns[i] > kMaxGridCells) stack.columns[i] = kMaxGridCells;
+            if (stack.rows[i] < 1) stack.rows[i] = 1;
+            if (stack.rows[i] > kMaxGridCells) stack.rows[i] = kMaxGridCells;
+            if (stack.type[i] != kLayerShape) stack.shape[i] = 0;
+        }
+
+        // unused entries stay zero so equal stacks hash equal
+        for (int i = stack.count; i < kMaxGuideLayers; ++i)
+        {
+            stack.colorR[i] = stack.colorG[i] = stack.colorB[i] = 0.0f;
+            stack.opacity[i] = stack.thickness[i] = 0.0f;
+            stack.safeAction[i] = stack.safeTitle[i] = stack.maskRatio[i] = 0.0f;
+            stack.columns[i] = stack.rows[i] = 0;
+            stack.shape[i] = 0;
+            stack.type[i] = 0;
+        }
+        std::memset(stack.reserved, 0, sizeof(stack.reserved));
+    }
+
+    static int layerTypeFromName(const std::string& name)
+    {
+        if (name == "thirds") return kLayerThirds;
+        if (name == "cross")  return kLayerCross;
+        if (name == "circle") return kLayerCircle;
+        if (name == "grid")   return kLayerGrid;
+        if (name == "safe")   return kLayerSafeArea;
+        if (name == "mask")   return kLayerAspectMask;
+        if (name == "shape")  return kLayerShape;
+        return -1;
+    }
+
+    static bool parseLayerFloat(const std::string& v, float& out)
+    {
+        char* end = nullptr;
+        const float f = std::strtof(v.c_str(), &end);
+        if (end == v.c_str() || *end != '\0') return false;
+        out = f;
+        return true;
+    }
+
+    static bool parseLayerCount(const std::string& v, uint16_t& out)
+    {
+        char* end = nullptr;
+        const long n = std::strtol(v.c_str(), &end, 10);
+        if (end == v.c_str() || *end != '\0' || n < 1 || n > kMaxGridCells) return false;
+        out = (uint16_t)n;
+        return true;
+    }
+
+    bool parseGuideLayer(GuideLayerStack& stack, const std::string& spec)
+    {
+        std::istringstream in(spec);
+        std::string typeName;
+        if (!(in >> typeName)) return false;
+
+        GuideLayerStack next = stack;
+        const int i = addGuideLayer(next, layerTypeFromName(typeName));
+        if (i < 0) return false;
+
+        std::string token;
+        while (in >> token)
+        {
+            const size_t eq = token.find('=');
+            if (eq == std::string::npos) return false;
+            const std::string key = token.substr(0, eq);
+            const std::string value = token.substr(eq + 1);
+
+            bool ok = false;
+            if (key == "color")
+            {
+                float r = 0.0f, g = 0.0f, b = 0.0f;
+                char tail = 0;
+                ok = std::sscanf(value.c_str(), "%f,%f,%f%c", &r, &g, &b, &tail) == 3;
+                if (ok) { next.colorR[i] = r; next.colorG[i] = g; next.colorB[i] = b; }
+            }
+            else if (key == "opacity")   ok = parseLayerFloat(value, next.opacity[i]);
+            else if (key == "thickness") ok = parseLayerFloat(value, next.thickness[i]);
+            else if (key == "action")    ok = parseLayerFloat(value, next.safeAction[i]);
+            else if (key == "title")     ok = parseLayerFloat(value, next.safeTitle[i]);
+            else if (key == "ratio")     ok = parseLayerFloat(value, next.maskRatio[i]);
+            else if (key == "columns")   ok = parseLayerCount(value, next.columns[i]);
+            else if (key == "rows")      ok = parseLayerCount(value, next.rows[i]);
+            else if (key == "name")
+            {
+                ok = !value.empty();
+                if (ok) next.shape[i] = guideShapeId(value);
+            }
+            else if (key == "id")
+            {
+                char* end = nullptr;
+                const unsigned long id = std::strtoul(value.c_str(), &end, 0);
+                ok = end != value.c_str() && *end == '\0' && id != 0 && id <= 0xFFFFFFFFul;
+                if (ok) next.shape[i] = (uint32_t)id;
+            }
+            if (!ok) return false;
+        }
+
+        stack = next;
+        return true;
+    }
+
+    std::string formatGuideLayer(const GuideLayerStack& stack, int i)
+    {
+        static const char* kTypeNames[kLayerTypeCount] = { "thirds", "cross", "circle", "grid", "safe", "mask", "shape" };
+
+        // %.9g round-trips a float
+        char buf[512];
+        std::snprintf(buf, sizeof(buf),
+                      "%s color=%.9g,%.9g,%.9g opacity=%.9g thickness=%.9g action=%.9g title=%.9g ratio=%.9g columns=%d rows=%d",
+                      kTypeNames[stack.type[i] < kLayerTypeCount ? (int)stack.type[i] : (int)kLayerThirds],
+                      stack.colorR[i], stack.colorG[i], stack.colorB[i], stack.opacity[i], stack.thickness[i],
+                      stack.safeAction[i], stack.safeTitle[i], stack.maskRatio[i],
+                      (int)stack.columns[i], (int)stack.rows[i]);
+        std::string spec = buf;
+
+        // names with spaces would not survive the split on whitespace
+        if (stack.type[i] == kLayerShape && stack.shape[i] != 0)
+        {
+            const std::string name = guideShapeName(stack.shape[i]);
+            if (!name.empty() && name.find_first_of(" \t\n\r") == std::string::npos)
+                spec += " name=" + name;
+            else
+            {
+                std::snprintf(buf, sizeof(buf), " id=0x%08x", (unsigned int)stack.shape[i]);
+                spec += buf;
+            }
+        }
+        return spec;
+    }
+
+    // ---------------------------------------------------------------------
+
+    static LineBatch& lineGroup(GuideLayerDraw& out, const Rgba& color, float thickness)
+    {
+        for (size_t g = 0; g < out.lineCount; ++g)
+        {
+            GuideLayerDraw::Lines& l = out.lines[g];
+            if (l.thickness == thickness && l.color.r == color.r && l.color.g == color.g &&
+                l.color.b == color.b && l.color.a == color.a)
+                return l.batch;
+        }
+
+        if (out.lineCount == out.lines.size()) out.lines.emplace_back();
+        GuideLayerDraw::Lines& l = out.lines[out.lineCount++];
+        l.color = color;
+        l.thickness = thickness;
+        l.batch.clear();
+        return l.batch;
+    }
+
+    static std::vector<GateRect>& fillGroup(GuideLayerDraw& out, const Rgba& color)
+    {
+        for (size_t g = 0; g < out.fillCount; ++g)
+        {
+            GuideLayerDraw::Fills& f = out.fills[g];
+            if (f.color.r == color.r && f.color.g == color.g && f.color.b == color.b && f.color.a == color.a)
+                return f.rects;
+        }
+
+        if (out.fillCount == out.fills.size()) out.fills.emplace_back();
+        GuideLayerDraw::Fills& f = out.fills[out.fillCount++];
+        f.color = color;
+        f.rects.clear();
+        return f.rects;
+    }
+
+    // every n-th line keeps lines at least minSpacingPx apart
+    static inline int gridStep(double spacingPx, double minSpacingPx)
+    {
+        return spacingPx >= minSpacingPx ? 1 : (int)std::ceil(minSpacingPx / spacingPx);
+    }
+
+    static void appendGrid(const GateRect& gate, int columns, int rows, double minSpacingPx, LineBatch& out)
+    {
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+
+        // interior lines only (the gate border is its own element); an axis whose
+        // cells are under a pixel would just fill the gate, so it is dropped
+        if (w / (double)columns >= 1.0)
+        {
+            const int step = gridStep(w / (double)columns, minSpacingPx);
+            for (int c = step; c < columns; c += step)
+            {
+                const double x = gate.left + w * (double)c / (double)columns;
+                out.addSegment(x, gate.bottom, x, gate.top);
+            }
+        }
+        if (h / (double)rows >= 1.0)
+        {
+            const int step = gridStep(h / (double)rows, minSpacingPx);
+            for (int r = step; r < rows; r += step)
+            {
+                const double y = gate.bottom + h * (double)r / (double)rows;
+                out.addSegment(gate.left, y, gate.right, y);
+            }
+        }
+    }
+
+    static void appendSafeRect(const GateRect& gate, float percent, LineBatch& out)
+    {
+        if (percent <= 0.0f) return;
+
+        const double k  = 0.5 * (1.0 - (double)percent / 100.0);
+        const double dx = (gate.right - gate.left) * k;
+        const double dy = (gate.top - gate.bottom) * k;
+        appendGateBorder(GateRect{ gate.left + dx, gate.bottom + dy, gate.right - dx, gate.top - dy }, out);
+    }
+
+    static void appendAspectMask(const GateRect& gate, float ratio, std::vector<GateRect>& out)
+    {
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+        if (w <= 0.0 || h <= 0.0) return;
+
+        if ((double)ratio > w / h)
+        {
+            // letterbox: bars top and bottom
+            const double bar = 0.5 * (h - w / (double)ratio);
+            out.push_back(GateRect{ gate.left, gate.bottom,     gate.right, gate.bottom + bar });
+            out.push_back(GateRect{ gate.left, gate.top - bar,  gate.right, gate.top });
+        }
+        else if ((double)ratio < w / h)
+        {
+            // pillarbox: bars left and right
+            const double bar = 0.5 * (w - h * (double)ratio);
+            out.push_back(GateRect{ gate.left,         gate.bottom, gate.left + bar, gate.top });
+            out.push_back(GateRect{ gate.right - bar,  gate.bottom, gate.right,      gate.top });
+        }
+    }
+
+    void buildGuideLayerDraw(const GuideLayerStack& stack, const GateRect& gate,
+                             double tolerancePx, GuideLayerDraw& out, double minGridSpacingPx)
+    {
+        out.clear();
+
+        for (int i = 0; i < stack.count && i < kMaxGuideLayers; ++i)
+        {
+            if (stack.opacity[i] <= 0.0001f) continue;
+            const Rgba color{ stack.colorR[i], stack.colorG[i], stack.colorB[i], stack.opacity[i] };
+
+            switch (stack.type[i])
+            {
+            case kLayerThirds:
+                appendThirds(gate, lineGroup(out, color, stack.thickness[i]));
+                break;
+            case kLayerCross:
+                appendCross(gate, lineGroup(out, color, stack.thickness[i]));
+                break;
+            case kLayerCircle:
+                appendCircleGuide(gate, tolerancePx, lineGroup(out, color, stack.thickness[i]));
+                break;
+            case kLayerGrid:
+                appendGrid(gate, stack.columns[i], stack.rows[i], minGridSpacingPx,
+                           lineGroup(out, color, stack.thickness[i]));
+                break;
+            case kLayerSafeArea:
+            {
+                LineBatch& lines = lineGroup(out, color, stack.thickness[i]);
+                appendSafeRect(gate, stack.safeAction[i], lines);
+                appendSafeRect(gate, stack.safeTitle[i], lines);
+                break;
+            }
+            case kLayerAspectMask:
+                appendAspectMask(gate, stack.maskRatio[i], fillGroup(out, color));
+                break;
+            case kLayerShape:
+                if (const std::shared_ptr<const ShapeProgram> shape = guideShapes().find(stack.shape[i]))
+                    appendShape(*shape, gate, tolerancePx, lineGroup(out, color, stack.thickness[i]));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+// aoViewportGuideLayers.h (v0.3.1)
+// Guide layer stack drawn on top of the base guide: grids, safe areas, aspect
+// masks, extra thirds/cross/circle guides and user shapes, each with its own
+// style (no Maya types). The stack is structure-of-arrays with a fixed capacity, so it stays
+// trivially copyable inside the published settings; buildGuideLayerDraw()
+// flattens it into one line batch / one fill list per distinct style.
+
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    enum GuideLayerType
+    {
+        kLayerThirds     = 0,
+        kLayerCross      = 1,
+        kLayerCircle     = 2,
+        kLayerGrid       = 3, // columns x rows cells inside the gate
+        kLayerSafeArea   = 4, // action / title safe rectangles, % of the gate
+        kLayerAspectMask = 5, // bars outside a centred maskRatio area of the gate
+        kLayerShape      = 6, // a shape file of the shape library (aoViewportGuideShapes.h)
+        kLayerTypeCount
+    };
+
+    static constexpr int kMaxGuideLayers = 16;
+    static constexpr int kMaxGridCells   = 256; // per axis
+
+    // Entries [0, count) are used; everything past count stays zero so equal
+    // stacks compare and hash equal. No padding (see PackedSettings).
+    struct GuideLayerStack
+    {
+        float colorR[kMaxGuideLayers];
+        float colorG[kMaxGuideLayers];
+        float colorB[kMaxGuideLayers];
+        float opacity[kMaxGuideLayers];
+        float thickness[kMaxGuideLayers];
+        float safeAction[kMaxGuideLayers]; // safe area: 0 = off
+        float safeTitle[kMaxGuideLayers];  // safe area: 0 = off
+        float maskRatio[kMaxGuideLayers];  // aspect mask: visible width / height
+
+        uint32_t shape[kMaxGuideLayers];   // shape: guideShapeId() of its name
+
+        uint16_t columns[kMaxGuideLayers]; // grid
+        uint16_t rows[kMaxGuideLayers];
+
+        uint8_t type[kMaxGuideLayers];
+        uint8_t count;
+        uint8_t reserved[7];
+    };
+    static_assert(sizeof(GuideLayerStack) == 664, "GuideLayerStack must stay free of padding");
+
+    // Appends a layer with the attribute defaults; returns its index, -1 when full.
+    int addGuideLayer(GuideLayerStack& stack, int type);
+
+    // Clamps values to the attribute ranges and zeroes the unused entries.
+    void sanitizeGuideLayers(GuideLayerStack& stack);
+
+    // Appends a layer from "type key=value ...", e.g. "grid columns=6 rows=4 color=1,1,1
+    // opacity=0.5 thickness=1" or "safe action=90 title=80" or "mask ratio=2.39" or
+    // "shape name=logoSafe" (id=0x... when the name is unknown).
+    bool parseGuideLayer(GuideLayerStack& stack, const std::string& spec);
+
+    // Layer i as a parseGuideLayer() spec with every key, so it parses back bit exact.
+    std::string formatGuideLayer(const GuideLayerStack& stack, int i);
+
+    struct GuideLayerDraw
+    {
+        struct Lines
+        {
+            Rgba      color;     // a = opacity
+            float     thickness = 1.0f;
+            LineBatch batch;
+        };
+
+        struct Fills
+        {
+            Rgba                  color; // a = opacity
+            std::vector<GateRect> rects;
+        };
+
+        // groups [0, lineCount) / [0, fillCount) are valid; the rest keep their capacity
+        std::vector<Lines> lines;
+        std::vector<Fills> fills;
+        size_t lineCount = 0;
+        size_t fillCount = 0;
+
+        void clear() { lineCount = 0; fillCount = 0; }
+    };
+
+    // Flattens the stack for gate. Layers with the same style share one group.
+    // Grid lines are clipped to the gate, and a grid axis whose spacing falls
+    // below a pixel is culled. Grid lines closer than minGridSpacingPx are thinned
+    // to every n-th line (reduced quality), so the kept ones stay on the full grid.
+    // Shape layers draw the guideShapes() program with their id, nothing when
+    // none is loaded.
+    void buildGuideLayerDraw(const GuideLayerStack& stack, const GateRect& gate,
+                             double tolerancePx, GuideLayerDraw& out, double minGridSpacingPx = 1.0);
+}
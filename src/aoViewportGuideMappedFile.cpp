@@ -0,0 +1,119 @@
+// aoViewportGuideMappedFile.cpp (v0.3.1)
+
+#include "aoViewportGuideMappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AoViewportGuide
+{
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path, std::string& error)
+    {
+        close();
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            error = "cannot stat " + path;
+            return false;
+        }
+
+        mFile = file;
+        mOpen = true;
+        if (size.QuadPart == 0) return true;
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            if (mapping) CloseHandle(mapping);
+            close();
+            error = "cannot map " + path;
+            return false;
+        }
+
+        mMapping = mapping;
+        mData = static_cast<const uint8_t*>(view);
+        mSize = (size_t)size.QuadPart;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData)    UnmapViewOfFile(mData);
+        if (mMapping) CloseHandle((HANDLE)mMapping);
+        if (mFile)    CloseHandle((HANDLE)mFile);
+        mData = nullptr;
+        mMapping = nullptr;
+        mFile = nullptr;
+        mSize = 0;
+        mOpen = false;
+    }
+#else
+    bool MappedFile::open(const std::string& path, std::string& error)
+    {
+        close();
+
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            error = "cannot stat " + path;
+            return false;
+        }
+
+        mOpen = true;
+        if (st.st_size > 0)
+        {
+            void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED)
+            {
+                ::close(fd);
+                mOpen = false;
+                error = "cannot map " + path;
+                return false;
+            }
+            mData = static_cast<const uint8_t*>(view);
+            mSize = (size_t)st.st_size;
+        }
+
+        // the mapping keeps the file alive
+        ::close(fd);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData) munmap(const_cast<uint8_t*>(mData), mSize);
+        mData = nullptr;
+        mSize = 0;
+        mOpen = false;
+    }
+#endif
+}
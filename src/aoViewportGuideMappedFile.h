@@ -0,0 +1,38 @@
+#pragma once
+// aoViewportGuideMappedFile.h (v0.3.1)
+// Read-only memory mapping of a whole file (no Maya types). Pages are loaded by
+// the OS on first touch, so opening a large file costs nothing until it is read.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AoViewportGuide
+{
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // An empty file opens with data() == nullptr and size() == 0.
+        bool open(const std::string& path, std::string& error);
+        void close();
+
+        bool           isOpen() const { return mOpen; }
+        const uint8_t* data() const   { return mData; }
+        size_t         size() const   { return mSize; }
+
+    private:
+        const uint8_t* mData = nullptr;
+        size_t         mSize = 0;
+        bool           mOpen = false;
+#ifdef _WIN32
+        void*          mFile = nullptr;    // HANDLE
+        void*          mMapping = nullptr; // HANDLE
+#endif
+    };
+}
@@ -1,128 +1,273 @@
 // aoViewportGuideOverride.cpp (v0.3.1)
 // NOTE: MHUDRenderOperation is NOT used (not available in this SDK)
 
+#include "aoViewportGuideAnnotationDraw.h"
 #include "aoViewportGuideCommon.h"
 #include "aoViewportGuideOverride.h"
 #include "aoViewportGuideSettings.h"
 #include "aoViewportGuideGate.h"
-
+#include "aoViewportGuideHudDraw.h"
+#include "aoViewportGuideField.h"
+#include "aoViewportGuidePipeline.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideStats.h"
+#include "aoViewportGuideTrace.h"
+
+#include <maya/MAnimControl.h>
 #include <maya/MFrameContext.h>
 #include <maya/MUIDrawManager.h>
-#include <maya/MPoint.h>
+#include <maya/MShaderManager.h>
+#include <maya/MStateManager.h>
 
-#include <cmath>
+#include <memory>
+#include <vector>
 
 namespace AoViewportGuide
 {
+    // aoViewportGuideStats / aoViewportGuideTrace slots of the panel being drawn (-1: not recording)
+    static int gStatsSlot = -1;
+    static int gTraceSlot = -1;
+
+    static inline bool profiling()
+    {
+        return gStatsSlot >= 0 || gTraceSlot >= 0;
+    }
+
+    static void recordStage(int stage, uint64_t startNs)
+    {
+        const uint64_t ns = statsNow() - startNs;
+        statsAddTime(gStatsSlot, stage, ns);
+        traceSpan(gTraceSlot, statsStageName(stage), startNs, ns);
+    }
+
+    // Times the enclosing scope; no clock reads unless stats or a trace capture is on.
+    class StageScope
+    {
+    public:
+        explicit StageScope(int stage)
+            : mStage(stage), mStart(profiling() ? statsNow() : 0) {}
+
+        ~StageScope()
+        {
+            if (mStart) recordStage(mStage, mStart);
+        }
+
+        StageScope(const StageScope&) = delete;
+        StageScope& operator=(const StageScope&) = delete;
+
+    private:
+        int      mStage;
+        uint64_t mStart;
+    };
+
+    static SettingsSnapshot snapshotTimed(uint64_t cameraKey)
+    {
+        StageScope scope(kStageSettings);
+        return AoViewportGuideSettings::snapshot(cameraKey);
+    }
+
     class AoViewportGuideSceneRender : public MHWRender::MSceneRender
     {
     public:
         AoViewportGuideSceneRender(const MString& name)
             : MHWRender::MSceneRender(name) {}
 
+        void setSettings(const SettingsData& s) { mSettings = s; }
+
+        // The replace pipeline's only clear; the guide passes after it never clear.
         MHWRender::MClearOperation& clearOperation() override
         {
-            const SettingsData s = AoViewportGuideSettings::read();
+            const SettingsData& s = mSettings;
             if (s.bgEnable)
             {
                 float c[4] = { s.bgColor.r, s.bgColor.g, s.bgColor.b, 1.0f };
                 mClearOperation.setClearGradient(false);
                 mClearOperation.setClearColor(c);
-                mClearOperation.setMask(MHWRender::MClearOperation::kClearAll);
-            }
-            else
-            {
-                mClearOperation.setMask(MHWRender::MClearOperation::kClearAll);
             }
+            mClearOperation.setMask(MHWRender::MClearOperation::kClearAll);
             return mClearOperation;
         }
+
+    private:
+        SettingsData mSettings;
     };
 
-    class AoViewportGuideHUD : public MHWRender::MHUDRender
+    // Full screen pass for kDrawBackendShader (aoViewportGuide.ogsfx).
+    class AoViewportGuideQuadRender : public MHWRender::MQuadRender
     {
     public:
-        bool hasUIDrawables() const override { return true; }
+        AoViewportGuideQuadRender(const MString& name)
+            : MHWRender::MQuadRender(name) {}
 
-        void addUIDrawables(MHWRender::MUIDrawManager& dm,
-                            const MHWRender::MFrameContext& frameContext) override
+        ~AoViewportGuideQuadRender() override
         {
-            const SettingsData s = AoViewportGuideSettings::read();
-            if (!s.enable) return;
+            MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+            const MHWRender::MShaderManager* sm = r ? r->getShaderManager() : nullptr;
+            if (sm && mShader) sm->releaseShader(mShader);
+            if (mBlendState) MHWRender::MStateManager::releaseBlendState(mBlendState);
+        }
 
-            int vpX=0, vpY=0, vpW=0, vpH=0;
-            frameContext.getViewportDimensions(vpX, vpY, vpW, vpH);
-            if (vpW < 10 || vpH < 10) return;
+        // Loads the effect on first use; false when it is not available for the
+        // current draw API (the HUD path draws instead).
+        bool prepare(const GuideFieldParams& params, int vpX, int vpY, int vpW, int vpH)
+        {
+            if (!mShader && !mShaderFailed)
+            {
+                MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+                const MHWRender::MShaderManager* sm = r ? r->getShaderManager() : nullptr;
+                if (sm) mShader = sm->getEffectsFileShader("aoViewportGuide", "Main");
+                mShaderFailed = (mShader == nullptr);
+            }
+            if (!mShader) return false;
+
+            const float viewport[4] = { (float)vpX, (float)vpY, (float)vpW, (float)vpH };
+            const float gate[4] = {
+                (float)params.gate.left,  (float)params.gate.bottom,
+                (float)params.gate.right, (float)params.gate.top
+            };
+            const float line[4]   = { params.lineColor.r,   params.lineColor.g,   params.lineColor.b,   params.lineColor.a };
+            const float border[4] = { params.borderColor.r, params.borderColor.g, params.borderColor.b, params.borderColor.a };
+            const float mask[4]   = { params.maskColor.r,   params.maskColor.g,   params.maskColor.b,   params.maskColor.a };
+
+            mShader->setParameter("gViewport",    viewport);
+            mShader->setParameter("gGate",        gate);
+            mShader->setParameter("gGuideType",   params.guideType);
+            mShader->setParameter("gLineColor",   line);
+            mShader->setParameter("gLineWidth",   params.lineWidth);
+            mShader->setParameter("gBorderColor", border);
+            mShader->setParameter("gBorderWidth", params.borderWidth);
+            mShader->setParameter("gMaskColor",   mask);
+            return true;
+        }
 
-            const GateRect gate = computeGateRect(frameContext, vpX, vpY, vpW, vpH, s.followResolutionGate);
+        const MHWRender::MShaderInstance* shader() override
+        {
+            return mShader;
+        }
 
-            dm.beginDrawable();
+        MHWRender::MClearOperation& clearOperation() override
+        {
+            mClearOperation.setMask(MHWRender::MClearOperation::kClearNone);
+            return mClearOperation;
+        }
 
-            if (s.gateBorderEnable && s.gateBorderOpacity > 0.0001f)
+        const MHWRender::MBlendState* blendStateOverride() override
+        {
+            if (!mBlendState)
             {
-                MColor bc = s.gateBorderColor;
-                bc.a = clampf(s.gateBorderOpacity, 0.0f, 1.0f);
-
-                dm.setColor(bc);
-                dm.setLineWidth(s.gateBorderThickness);
-
-                dm.line2d(MPoint(gate.left,  gate.bottom), MPoint(gate.right, gate.bottom));
-                dm.line2d(MPoint(gate.right, gate.bottom), MPoint(gate.right, gate.top));
-                dm.line2d(MPoint(gate.right, gate.top),    MPoint(gate.left,  gate.top));
-                dm.line2d(MPoint(gate.left,  gate.top),    MPoint(gate.left,  gate.bottom));
+                MHWRender::MBlendStateDesc desc;
+                desc.setDefaults();
+                desc.targetBlends[0].blendEnable           = true;
+                desc.targetBlends[0].sourceBlend           = MHWRender::MBlendState::kSourceAlpha;
+                desc.targetBlends[0].destinationBlend      = MHWRender::MBlendState::kInvSourceAlpha;
+                desc.targetBlends[0].alphaSourceBlend      = MHWRender::MBlendState::kOne;
+                desc.targetBlends[0].alphaDestinationBlend = MHWRender::MBlendState::kInvSourceAlpha;
+                mBlendState = MHWRender::MStateManager::acquireBlendState(desc);
             }
+            return mBlendState;
+        }
 
-            MColor lc = s.lineColor;
-            lc.a = clampf(s.lineOpacity, 0.0f, 1.0f);
-
-            dm.setColor(lc);
-            dm.setLineWidth(s.lineThickness);
+    private:
+        MHWRender::MShaderInstance* mShader = nullptr;
+        bool mShaderFailed = false;
+        const MHWRender::MBlendState* mBlendState = nullptr;
+    };
 
-            const double w = gate.right - gate.left;
-            const double h = gate.top   - gate.bottom;
+    class AoViewportGuideHUD : public MHWRender::MHUDRender
+    {
+    public:
+        bool hasUIDrawables() const override { return true; }
 
-            if (s.guideType == 0)
+        // Makes panelName's state current, creating it on first use; setup() only, so
+        // the draw callback never grows the panel table. The setters below fill it.
+        void beginPanel(const MString& panelName)
+        {
+            mPanel = nullptr;
+            for (const std::unique_ptr<PanelState>& p : mPanels)
             {
-                const double x1 = gate.left + w / 3.0;
-                const double x2 = gate.left + w * 2.0 / 3.0;
-                const double y1 = gate.bottom + h / 3.0;
-                const double y2 = gate.bottom + h * 2.0 / 3.0;
-
-                dm.line2d(MPoint(x1, gate.bottom), MPoint(x1, gate.top));
-                dm.line2d(MPoint(x2, gate.bottom), MPoint(x2, gate.top));
-                dm.line2d(MPoint(gate.left, y1),   MPoint(gate.right, y1));
-                dm.line2d(MPoint(gate.left, y2),   MPoint(gate.right, y2));
+                if (p->panel == panelName) { mPanel = p.get(); break; }
             }
-            else if (s.guideType == 1)
+            if (!mPanel)
             {
-                const double cx = gate.left + w * 0.5;
-                const double cy = gate.bottom + h * 0.5;
-
-                dm.line2d(MPoint(cx, gate.bottom), MPoint(cx, gate.top));
-                dm.line2d(MPoint(gate.left, cy),   MPoint(gate.right, cy));
+                mPanels.push_back(std::make_unique<PanelState>());
+                mPanel = mPanels.back().get();
+                mPanel->panel = panelName;
             }
-            else
-            {
-                const double cx = gate.left + w * 0.5;
-                const double cy = gate.bottom + h * 0.5;
-                const double r  = (w < h ? w : h) * 0.5;
+        }
 
-                const int seg = 96;
-                for (int i = 0; i < seg; ++i)
-                {
-                    const double a0 = (2.0 * 3.141592653589793) * (double)i / (double)seg;
-                    const double a1 = (2.0 * 3.141592653589793) * (double)(i + 1) / (double)seg;
+        // settings of the camera this panel draws, resolved once per frame in setup()
+        void setSnapshot(const SettingsSnapshot& snap) { mPanel->snapshot = snap; }
 
-                    const double x0 = cx + std::cos(a0) * r;
-                    const double y0 = cy + std::sin(a0) * r;
-                    const double x1 = cx + std::cos(a1) * r;
-                    const double y1 = cy + std::sin(a1) * r;
+        // cameraBindingKey() of that camera, for the values trackFrameCamera() published
+        void setCameraKey(uint64_t key) { mPanel->cameraKey = key; }
 
-                    dm.line2d(MPoint(x0, y0), MPoint(x1, y1));
-                }
-            }
+        // this panel's gate, resolved in setup(); false when there is nothing to draw
+        void setGate(bool valid, const GateRect& gate) { mPanel->gateValid = valid; mPanel->gate = gate; }
 
-            dm.endDrawable();
+        // true while the shader pass draws the guides for this panel
+        void setShaderPassActive(bool active) { mPanel->shaderPassActive = active; }
+
+        void addUIDrawables(MHWRender::MUIDrawManager& dm,
+                            const MHWRender::MFrameContext& frameContext) override
+        {
+            if (!mPanel) return;
+            PanelState& panel = *mPanel;
+
+            const SettingsSnapshot& snap = panel.snapshot;
+            const SettingsData& s = snap.data;
+            if (!s.enable || !panel.gateValid) return;
+
+            // the other backends draw the base guide from the subscene override / quad
+            // pass; the layer stack and the annotations are always drawn here
+            const bool drawBase = !(s.drawBackend == kDrawBackendCached ||
+                                    (s.drawBackend == kDrawBackendShader && panel.shaderPassActive));
+            const bool drawGuides = drawBase || s.layers.count > 0;
+            if (!drawGuides && !s.annotations) return;
+
+            const GateRect& gate = panel.gate;
+
+            // tumbling, dragging, playing or scrubbing: the governor may step quality down
+            QualityGovernor& governor = panel.governor;
+            const bool interacting = frameContext.inUserInteraction() || frameContext.userChangingViewContext() ||
+                                     MAnimControl::isPlaying() || MAnimControl::isScrubbing();
+            const int level = governor.beginFrame(s.adaptiveQuality, s.qualityFloor,
+                                                  (double)s.qualityBudget * 1.0e6, interacting);
+
+            const bool timed = s.adaptiveQuality || profiling();
+            const uint64_t start = timed ? statsNow() : 0;
+            unsigned int prims = 0;
+            if (drawGuides)
+                prims += drawGuideOverlay(dm, s, snap.shapeHash, gate, panel.draw, drawBase, level);
+            prims += drawAnnotations(dm, s, panel.cameraKey, gate, panel.annotations);
+            statsAddPrimitives(gStatsSlot, prims);
+            if (!timed) return;
+
+            const uint64_t cost = statsNow() - start;
+            if (profiling()) recordStage(kStageGeometry, start);
+            statsSetQuality(gStatsSlot, level, s.adaptiveQuality ? governor.endFrame(cost) : 0);
         }
+
+    private:
+        // the HUD is shared by all panels; what setup() resolved (settings, camera,
+        // gate), overlay cost and budget, the overlay buffers (the shared geometry
+        // moved to the panel's gate) and the annotation text are per panel
+        struct PanelState
+        {
+            MString             panel;
+            SettingsSnapshot    snapshot;
+            uint64_t            cameraKey = 0;
+            GateRect            gate;
+            bool                gateValid = false;
+            bool                shaderPassActive = false;
+
+            QualityGovernor     governor;
+            HudDrawState        draw;
+            AnnotationDrawState annotations;
+        };
+
+        // heap entries: a panel added by setup() never moves the others
+        std::vector<std::unique_ptr<PanelState>> mPanels;
+        PanelState*                              mPanel = nullptr; // set by beginPanel()
     };
 
     class AoViewportGuideRenderOverride : public MHWRender::MRenderOverride
@@ -132,6 +277,7 @@ namespace AoViewportGuide
             : MHWRender::MRenderOverride(name)
         {
             mScene   = new AoViewportGuideSceneRender("aoViewportGuide_scene");
+            mQuad    = new AoViewportGuideQuadRender("aoViewportGuide_quad");
             mHud     = new AoViewportGuideHUD();
             mPresent = new MHWRender::MPresentTarget("aoViewportGuide_present");
         }
@@ -139,6 +285,7 @@ namespace AoViewportGuide
         ~AoViewportGuideRenderOverride() override
         {
             delete mScene;
+            delete mQuad;
             delete mHud;
             delete mPresent;
         }
@@ -150,42 +297,174 @@ namespace AoViewportGuide
             return MHWRender::kAllDevices;
         }
 
-        MStatus setup(const MString&) override
+        MStatus setup(const MString& destination) override
         {
-            AoViewportGuideSettings::ensureNodeExists();
+            gStatsSlot = statsBeginFrame(destination.asChar());
+            gTraceSlot = traceActive() ? traceBeginFrame(destination.asChar(), MAnimControl::currentTime().value()) : -1;
+
+            // node lifetime is handled by scene callbacks; no DG work here
+            AoViewportGuideSettings::validateNode();
+            mHud->beginPanel(destination);
+
+            // per camera / shot bindings: one table lookup for the whole frame; the
+            // camera's annotation values are re-read here (main thread) when dirty
+            const MHWRender::MFrameContext* ctx = getFrameContext();
+            const uint64_t cameraKey = ctx ? trackFrameCamera(*ctx) : 0;
+            const SettingsSnapshot snap = snapshotTimed(cameraKey);
+            mScene->setSettings(snap.data);
+            mHud->setSnapshot(snap);
+            mHud->setCameraKey(cameraKey);
+
+            // the gate reads the camera and defaultResolution: resolved here, not in the HUD
+            GateRect gate;
+            const bool hasGate = resolveGate(destination, snap.data, gate);
+            mHud->setGate(hasGate, gate);
+
+            const bool quad = hasGate && setupShaderPass(snap.data, gate);
+            mHud->setShaderPassActive(quad);
+
+            PipelineInput in;
+            in.standardPipeline = snap.data.pipeline == kPipelineStandard;
+            in.bgEnable         = snap.data.bgEnable;
+            in.quadPass         = quad;
+            if (in.standardPipeline && fetchStandardOperations())
+            {
+                in.standard      = mStandardKinds;
+                in.standardCount = mStandardCount;
+            }
+            planPipeline(in, mPlan);
+
+            mOpCount = 0;
+            for (int i = 0; i < mPlan.count; ++i)
+            {
+                const PipelineStep& step = mPlan.steps[i];
+                switch (step.guide)
+                {
+                case kGuideOpScene:   addOp(mScene, kStageScene); break;
+                case kGuideOpQuad:    addOp(mQuad, kStageQuad); break;
+                case kGuideOpHud:     addOp(mHud, kStageHud); break; // IMPORTANT: use MHUDRender directly (no MHUDRenderOperation)
+                case kGuideOpPresent: addOp(mPresent, kStagePresent); break;
+                default:
+                    addOp(mOperations[(unsigned int)step.standard],
+                          mStandardKinds[step.standard] == kStandardPresent ? kStagePresent : kStageScene);
+                    break;
+                }
+            }
             return MS::kSuccess;
         }
 
-        MStatus cleanup() override { return MS::kSuccess; }
+        MStatus cleanup() override
+        {
+            statsEndFrame(gStatsSlot);
+            traceEndFrame(gTraceSlot);
+            gStatsSlot = -1;
+            gTraceSlot = -1;
+            return MS::kSuccess;
+        }
 
         bool startOperationIterator() override
         {
             mIndex = 0;
+            mOpStart = 0;
             return true;
         }
 
+        // Maya executes the returned op before asking for the next one, so the time
+        // between renderOperation() and nextRenderOperation() is that op's cost.
         MHWRender::MRenderOperation* renderOperation() override
         {
-            switch (mIndex)
-            {
-            case 0: return mScene;
-            case 1: return mHud;     // IMPORTANT: use MHUDRender directly (no MHUDRenderOperation)
-            case 2: return mPresent;
-            default: return nullptr;
-            }
+            if (mIndex >= mOpCount) return nullptr;
+            if (profiling() && mOpStart == 0) mOpStart = statsNow();
+            return mOps[mIndex];
         }
 
         bool nextRenderOperation() override
         {
+            if (mOpStart != 0 && mIndex < mOpCount)
+                recordStage(mOpStages[mIndex], mOpStart);
+            mOpStart = 0;
+
             ++mIndex;
-            return (mIndex < 3);
+            return (mIndex < mOpCount);
         }
 
     private:
+        void addOp(MHWRender::MRenderOperation* op, int stage)
+        {
+            mOps[mOpCount] = op;
+            mOpStages[mOpCount] = stage;
+            ++mOpCount;
+        }
+
+        // Maya's standard operations (owned by mOperations), fetched once; false when
+        // this Maya version does not provide them
+        bool fetchStandardOperations()
+        {
+            if (!mStandardFetched)
+            {
+                mStandardFetched = true;
+                mStandardCount = 0;
+                if (getStandardViewportOperations() && mOperations.length() <= (unsigned int)kMaxPipelineSteps)
+                {
+                    for (unsigned int i = 0; i < mOperations.length(); ++i)
+                    {
+                        const MHWRender::MRenderOperation* op = mOperations[i];
+                        const MString name = op ? op->name() : MString();
+                        mStandardKinds[i] = name == MHWRender::MRenderOperation::kStandardHUDName     ? kStandardHud
+                                          : name == MHWRender::MRenderOperation::kStandardPresentName ? kStandardPresent
+                                          : kStandardOther;
+                    }
+                    mStandardCount = (int)mOperations.length();
+                }
+            }
+            return mStandardCount > 0;
+        }
+
+        // false when the guides are off or the viewport is too small to draw into
+        bool resolveGate(const MString& destination, const SettingsData& s, GateRect& gate)
+        {
+            if (!s.enable) return false;
+
+            const MHWRender::MFrameContext* ctx = getFrameContext();
+            if (!ctx) return false;
+
+            int vpX=0, vpY=0, vpW=0, vpH=0;
+            ctx->getViewportDimensions(vpX, vpY, vpW, vpH);
+            if (vpW < 10 || vpH < 10) return false;
+
+            StageScope scope(kStageGate);
+            gate = computeGateRectCached(destination, *ctx, vpX, vpY, vpW, vpH, s.followResolutionGate);
+            return true;
+        }
+
+        bool setupShaderPass(const SettingsData& s, const GateRect& gate)
+        {
+            if (s.drawBackend != kDrawBackendShader) return false;
+
+            // no distance function for the spiral; the HUD pass draws the base guide
+            if (s.guideType == kGuideGoldenSpiral) return false;
+
+            int vpX=0, vpY=0, vpW=0, vpH=0;
+            getFrameContext()->getViewportDimensions(vpX, vpY, vpW, vpH);
+            return mQuad->prepare(makeGuideFieldParams(s, gate), vpX, vpY, vpW, vpH);
+        }
+
         int mIndex = 0;
+        int mOpCount = 0;
+        MHWRender::MRenderOperation* mOps[kMaxPipelineSteps] = {};
+        int      mOpStages[kMaxPipelineSteps] = {};
+        uint64_t mOpStart = 0;
+
         AoViewportGuideSceneRender* mScene = nullptr;
+        AoViewportGuideQuadRender*  mQuad = nullptr;
         AoViewportGuideHUD*         mHud = nullptr;
         MHWRender::MPresentTarget*  mPresent = nullptr;
+
+        // pipeline == kPipelineStandard
+        PipelinePlan      mPlan;
+        StandardOperation mStandardKinds[kMaxPipelineSteps] = {};
+        int               mStandardCount = 0;
+        bool              mStandardFetched = false;
     };
 
     MHWRender::MRenderOverride* createOverride()
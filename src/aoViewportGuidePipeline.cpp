@@ -0,0 +1,70 @@
+// aoViewportGuidePipeline.cpp (v0.3.1)
+
+#include "aoViewportGuidePipeline.h"
+
+namespace AoViewportGuide
+{
+    static void addGuide(PipelinePlan& out, GuideOperation op)
+    {
+        PipelineStep& step = out.steps[out.count++];
+        step.guide = op;
+        step.standard = -1;
+    }
+
+    static void addStandard(PipelinePlan& out, int index)
+    {
+        PipelineStep& step = out.steps[out.count++];
+        step.guide = kGuideOpNone;
+        step.standard = (int16_t)index;
+    }
+
+    static void addGuidePasses(PipelinePlan& out, bool quad)
+    {
+        if (quad) addGuide(out, kGuideOpQuad);
+        addGuide(out, kGuideOpHud);
+    }
+
+    void planPipeline(const PipelineInput& in, PipelinePlan& out)
+    {
+        out.count = 0;
+        out.usesStandard = false;
+
+        // the standard list plus the two guide passes must fit
+        const bool standard = in.standardPipeline && !in.bgEnable &&
+                              in.standard && in.standardCount > 0 &&
+                              in.standardCount + 2 <= kMaxPipelineSteps;
+        if (!standard)
+        {
+            addGuide(out, kGuideOpScene);
+            addGuidePasses(out, in.quadPass);
+            addGuide(out, kGuideOpPresent);
+            return;
+        }
+
+        // anchor: Maya's HUD, else its present, else the end of the list
+        int anchor = -1;
+        for (int i = 0; i < in.standardCount && anchor < 0; ++i)
+        {
+            if (in.standard[i] == kStandardHud) anchor = i;
+        }
+        for (int i = 0; i < in.standardCount && anchor < 0; ++i)
+        {
+            if (in.standard[i] == kStandardPresent) anchor = i;
+        }
+
+        bool placed = false;
+        for (int i = 0; i < in.standardCount; ++i)
+        {
+            if (i == anchor)
+            {
+                addGuidePasses(out, in.quadPass);
+                placed = true;
+            }
+            // the guide HUD is an MHUDRender: it draws Maya's HUD too
+            if (in.standard[i] != kStandardHud) addStandard(out, i);
+        }
+        if (!placed) addGuidePasses(out, in.quadPass);
+
+        out.usesStandard = true;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+// aoViewportGuidePipeline.h (v0.3.1)
+// Operation list of the render override (no Maya types). The "replace" pipeline
+// is the override's own scene render (which clears everything), the guide passes
+// and a present. The "standard" pipeline keeps Maya's standard viewport
+// operations and only adds the guide passes, so the scene draws exactly as in the
+// default renderer. The override classifies Maya's operations by name, and
+// planPipeline() decides the order.
+
+#include <cstdint>
+
+namespace AoViewportGuide
+{
+    // what the planner needs to know about one of Maya's standard operations
+    enum StandardOperation : uint8_t
+    {
+        kStandardOther = 0, // background, shadow prepass, opaque, transparent, ...
+        kStandardHud,       // replaced by the guide HUD, which also draws Maya's HUD
+        kStandardPresent,
+    };
+
+    // operations the override owns
+    enum GuideOperation : int8_t
+    {
+        kGuideOpNone = -1,  // a standard operation (PipelineStep::standard)
+        kGuideOpScene = 0,  // own scene render; clears color, depth and stencil
+        kGuideOpQuad,       // full screen guide pass (kDrawBackendShader); never clears
+        kGuideOpHud,        // guide overlay + Maya's HUD; never clears
+        kGuideOpPresent,
+    };
+
+    struct PipelineStep
+    {
+        GuideOperation guide    = kGuideOpNone;
+        int16_t        standard = -1; // index into the standard operations when guide is kGuideOpNone
+    };
+
+    static constexpr int kMaxPipelineSteps = 32;
+
+    struct PipelineInput
+    {
+        bool standardPipeline = false; // settings: pipeline == kPipelineStandard
+        bool bgEnable         = false; // settings: solid background (needs the own scene clear)
+        bool quadPass         = false; // shader backend pass prepared for this frame
+
+        // Maya's standard operations in order; none when they are not available
+        const StandardOperation* standard = nullptr;
+        int                      standardCount = 0;
+    };
+
+    struct PipelinePlan
+    {
+        PipelineStep steps[kMaxPipelineSteps];
+        int          count = 0;
+        bool         usesStandard = false; // false: the replace pipeline was built
+    };
+
+    // The standard pipeline is used when asked for, available and compatible:
+    // a solid background needs the own scene clear, so bgEnable falls back to the
+    // replace pipeline. Guide passes go where Maya's HUD was (before present when
+    // there is no HUD operation, last when there is neither).
+    void planPipeline(const PipelineInput& in, PipelinePlan& out);
+}
@@ -1,14 +1,23 @@
 // aoViewportGuidePlugin.cpp (v0.3.1)
 // Plugin entry points only.
 
+#include "aoViewportGuideAnnotationDraw.h"
 #include "aoViewportGuideCommon.h"
 #include "aoViewportGuideOverride.h"
 #include "aoViewportGuideSettings.h"
+#include "aoViewportGuideGate.h"
+#include "aoViewportGuideSubScene.h"
+#include "aoViewportGuideStatsCmd.h"
+#include "aoViewportGuideTraceCmd.h"
+#include "aoViewportGuideBurnInCmd.h"
+#include "aoViewportGuidePresetCmd.h"
+#include "aoViewportGuideShapesCmd.h"
 
 #include <maya/MFnPlugin.h>
 #include <maya/MGlobal.h>
 #include <maya/MPxNode.h>
 #include <maya/MViewport2Renderer.h>
+#include <maya/MDrawRegistry.h>
 
 namespace
 {
@@ -30,9 +39,75 @@ MStatus initializePlugin(MObject obj)
     );
     if (!stat) return stat;
 
+    stat = plugin.registerNode(
+        "aoViewportGuideDrawNode",
+        AoViewportGuide::AoViewportGuideDrawNode::id,
+        AoViewportGuide::AoViewportGuideDrawNode::creator,
+        AoViewportGuide::AoViewportGuideDrawNode::initialize,
+        MPxNode::kLocatorNode,
+        &AoViewportGuide::AoViewportGuideDrawNode::drawDbClassification
+    );
+    if (!stat) return stat;
+
+    stat = MHWRender::MDrawRegistry::registerSubSceneOverrideCreator(
+        AoViewportGuide::AoViewportGuideDrawNode::drawDbClassification,
+        AoViewportGuide::AoViewportGuideDrawNode::drawRegistrantId,
+        AoViewportGuide::createSubSceneOverride
+    );
+    if (!stat) return stat;
+
+    stat = plugin.registerCommand(
+        AoViewportGuide::AoViewportGuideStatsCmd::commandName,
+        AoViewportGuide::AoViewportGuideStatsCmd::creator,
+        AoViewportGuide::AoViewportGuideStatsCmd::newSyntax
+    );
+    if (!stat) return stat;
+
+    stat = plugin.registerCommand(
+        AoViewportGuide::AoViewportGuideTraceCmd::commandName,
+        AoViewportGuide::AoViewportGuideTraceCmd::creator,
+        AoViewportGuide::AoViewportGuideTraceCmd::newSyntax
+    );
+    if (!stat) return stat;
+
+    stat = plugin.registerCommand(
+        AoViewportGuide::AoViewportGuideBurnInCmd::commandName,
+        AoViewportGuide::AoViewportGuideBurnInCmd::creator,
+        AoViewportGuide::AoViewportGuideBurnInCmd::newSyntax
+    );
+    if (!stat) return stat;
+
+    stat = plugin.registerCommand(
+        AoViewportGuide::AoViewportGuidePresetCmd::commandName,
+        AoViewportGuide::AoViewportGuidePresetCmd::creator,
+        AoViewportGuide::AoViewportGuidePresetCmd::newSyntax
+    );
+    if (!stat) return stat;
+
+    stat = plugin.registerCommand(
+        AoViewportGuide::AoViewportGuideShapesCmd::commandName,
+        AoViewportGuide::AoViewportGuideShapesCmd::creator,
+        AoViewportGuide::AoViewportGuideShapesCmd::newSyntax
+    );
+    if (!stat) return stat;
+
+    AoViewportGuide::AoViewportGuideSettings::installCallbacks();
     AoViewportGuide::AoViewportGuideSettings::ensureNodeExists();
+    AoViewportGuide::installGateCallbacks();
+    AoViewportGuide::installShapeCallbacks();
+
+    AoViewportGuide::ensureDrawNodeExists();
+    AoViewportGuide::installSubSceneCallbacks();
 
     MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+    if (r && r->getShaderManager())
+    {
+        // aoViewportGuide.ogsfx: next to the plugin (build output) or in a module layout
+        const MString loadPath = plugin.loadPath();
+        r->getShaderManager()->addShaderPath(loadPath + "/shaders");
+        r->getShaderManager()->addShaderPath(loadPath + "/../resources/shaders");
+    }
+
     if (r && !gOverride)
     {
         gOverride = AoViewportGuide::createOverride();
@@ -55,6 +130,28 @@ MStatus uninitializePlugin(MObject obj)
         r->deregisterOverride(gOverride);
         AoViewportGuide::destroyOverride(gOverride);
     }
+    AoViewportGuide::releaseAnnotationAtlas();
+
+    AoViewportGuide::removeSubSceneCallbacks();
+    AoViewportGuide::removeShapeCallbacks();
+    AoViewportGuide::removeGateCallbacks();
+    AoViewportGuide::AoViewportGuideSettings::removeCallbacks();
+
+    AoViewportGuide::deleteDrawNodes();
+
+    plugin.deregisterCommand(AoViewportGuide::AoViewportGuideShapesCmd::commandName);
+    plugin.deregisterCommand(AoViewportGuide::AoViewportGuidePresetCmd::commandName);
+    plugin.deregisterCommand(AoViewportGuide::AoViewportGuideBurnInCmd::commandName);
+    plugin.deregisterCommand(AoViewportGuide::AoViewportGuideTraceCmd::commandName);
+    plugin.deregisterCommand(AoViewportGuide::AoViewportGuideStatsCmd::commandName);
+
+    MHWRender::MDrawRegistry::deregisterSubSceneOverrideCreator(
+        AoViewportGuide::AoViewportGuideDrawNode::drawDbClassification,
+        AoViewportGuide::AoViewportGuideDrawNode::drawRegistrantId
+    );
+
+    stat = plugin.deregisterNode(AoViewportGuide::AoViewportGuideDrawNode::id);
+    if (!stat) return stat;
 
     stat = plugin.deregisterNode(AoViewportGuide::AoViewportGuideSettingsNode::id);
     if (!stat) return stat;
@@ -0,0 +1,155 @@
+// aoViewportGuidePresetCmd.cpp (v0.3.1)
+
+#include "aoViewportGuidePresetCmd.h"
+#include "aoViewportGuidePresets.h"
+#include "aoViewportGuideSettings.h"
+
+#include <maya/MArgDatabase.h>
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+
+#include <string>
+
+namespace AoViewportGuide
+{
+    static const char* kLibraryFlag     = "-lib";
+    static const char* kLibraryFlagLong = "-library";
+    static const char* kListFlag        = "-ls";
+    static const char* kListFlagLong    = "-list";
+    static const char* kApplyFlag       = "-a";
+    static const char* kApplyFlagLong   = "-apply";
+    static const char* kSaveFlag        = "-s";
+    static const char* kSaveFlagLong    = "-save";
+    static const char* kCompileFlag     = "-c";
+    static const char* kCompileFlagLong = "-compile";
+
+    const char* AoViewportGuidePresetCmd::commandName = "aoViewportGuidePreset";
+
+    // last -library; the library is opened per call (mapping a current cache is cheap)
+    static std::string gLibraryPath;
+
+    void* AoViewportGuidePresetCmd::creator()
+    {
+        return new AoViewportGuidePresetCmd();
+    }
+
+    MSyntax AoViewportGuidePresetCmd::newSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag(kLibraryFlag, kLibraryFlagLong, MSyntax::kString);
+        syntax.addFlag(kListFlag,    kListFlagLong);
+        syntax.addFlag(kApplyFlag,   kApplyFlagLong,   MSyntax::kString);
+        syntax.addFlag(kSaveFlag,    kSaveFlagLong,    MSyntax::kString);
+        syntax.addFlag(kCompileFlag, kCompileFlagLong);
+        return syntax;
+    }
+
+    // Opens the library, compiling its cache first when it is missing or stale.
+    static bool openLibrary(PresetLibrary& library, std::string& error)
+    {
+        if (!library.open(gLibraryPath, error)) return false;
+        if (library.fromCache() || library.size() == 0) return true;
+
+        std::string compileError;
+        if (!compilePresetCache(gLibraryPath, compileError))
+        {
+            // read-only location: the JSON still works, parsed on demand
+            MPxCommand::displayWarning(MString("[ao_viewport_guide] ") + compileError.c_str());
+            return true;
+        }
+        return library.open(gLibraryPath, error);
+    }
+
+    MStatus AoViewportGuidePresetCmd::doIt(const MArgList& args)
+    {
+        MStatus stat;
+        MArgDatabase db(syntax(), args, &stat);
+        if (!stat) return stat;
+
+        if (db.isFlagSet(kLibraryFlag))
+        {
+            MString path;
+            db.getFlagArgument(kLibraryFlag, 0, path);
+            gLibraryPath = path.asChar();
+        }
+        if (gLibraryPath.empty())
+        {
+            displayError("[ao_viewport_guide] no preset library, pass -library <file>");
+            return MS::kFailure;
+        }
+
+        std::string error;
+
+        if (db.isFlagSet(kSaveFlag))
+        {
+            MString name;
+            db.getFlagArgument(kSaveFlag, 0, name);
+            if (!savePreset(gLibraryPath, name.asChar(), AoViewportGuideSettings::read(), error))
+            {
+                displayError(MString("[ao_viewport_guide] ") + error.c_str());
+                return MS::kFailure;
+            }
+            setResult(name);
+            return MS::kSuccess;
+        }
+
+        if (db.isFlagSet(kCompileFlag))
+        {
+            if (!compilePresetCache(gLibraryPath, error))
+            {
+                displayError(MString("[ao_viewport_guide] ") + error.c_str());
+                return MS::kFailure;
+            }
+            setResult(MString(presetCachePath(gLibraryPath).c_str()));
+            return MS::kSuccess;
+        }
+
+        PresetLibrary library;
+        if (!openLibrary(library, error))
+        {
+            displayError(MString("[ao_viewport_guide] ") + error.c_str());
+            return MS::kFailure;
+        }
+
+        if (db.isFlagSet(kApplyFlag))
+        {
+            MString name;
+            db.getFlagArgument(kApplyFlag, 0, name);
+
+            const int i = library.find(name.asChar());
+            PackedSettings packed;
+            if (i < 0 || !library.settings((size_t)i, packed, error))
+            {
+                displayError(MString("[ao_viewport_guide] ") +
+                             (i < 0 ? MString("no preset ") + name : MString(error.c_str())));
+                return MS::kFailure;
+            }
+
+            if (!AoViewportGuideSettings::queueWrite(unpackSettings(packed), mMod))
+            {
+                displayError("[ao_viewport_guide] no settings node");
+                return MS::kFailure;
+            }
+            mUndoable = true;
+            setResult(name);
+            return redoIt();
+        }
+
+        // -list, also the default
+        MStringArray names;
+        for (size_t i = 0; i < library.size(); ++i)
+            names.append(library.name(i).c_str());
+        setResult(names);
+        return MS::kSuccess;
+    }
+
+    MStatus AoViewportGuidePresetCmd::redoIt()
+    {
+        return AoViewportGuideSettings::commitWrite(mMod);
+    }
+
+    MStatus AoViewportGuidePresetCmd::undoIt()
+    {
+        return AoViewportGuideSettings::commitWrite(mMod, true);
+    }
+}
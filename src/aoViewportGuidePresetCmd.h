@@ -0,0 +1,29 @@
+#pragma once
+#include <maya/MDGModifier.h>
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+
+namespace AoViewportGuide
+{
+    // aoViewportGuidePreset [-library file] [-list] [-apply name] [-save name] [-compile]
+    // Preset library of the active settings node (see aoViewportGuidePresets.h). The
+    // library is remembered after the first -library. -apply is undoable: every
+    // changed attribute goes into one modifier and the guides publish once.
+    class AoViewportGuidePresetCmd : public MPxCommand
+    {
+    public:
+        static const char* commandName;
+
+        static void*   creator();
+        static MSyntax newSyntax();
+
+        MStatus doIt(const MArgList& args) override;
+        MStatus redoIt() override;
+        MStatus undoIt() override;
+        bool isUndoable() const override { return mUndoable; }
+
+    private:
+        MDGModifier mMod;
+        bool        mUndoable = false;
+    };
+}
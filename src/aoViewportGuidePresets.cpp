@@ -0,0 +1,637 @@
+// aoViewportGuidePresets.cpp (v0.3.1)
+
+#include "aoViewportGuidePresets.h"
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideFiles.h"
+#include "aoViewportGuideJson.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace AoViewportGuide
+{
+    // ---------------------------------------------------------------------
+    // cache layout: header, entries, buckets, records, names (little endian,
+    // offsets from the start of the file, every section 8-byte aligned)
+
+    static const char     kCacheMagic[4] = { 'A', 'O', 'G', 'P' };
+    static const uint32_t kCacheVersion  = 4;
+
+    struct PresetCacheHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t bucketCount; // power of two, at least 2 * count
+        uint32_t recordSize;  // sizeof(PackedSettings)
+        uint32_t reserved;
+        uint64_t sourceSize;  // of the JSON the cache was compiled from
+        int64_t  sourceTime;
+        uint64_t entriesOffset;
+        uint64_t bucketsOffset;
+        uint64_t recordsOffset;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+    static_assert(sizeof(PresetCacheHeader) == 80, "PresetCacheHeader must stay free of padding");
+
+    struct PresetCacheEntry
+    {
+        uint64_t nameHash;
+        uint32_t nameOffset; // into the names section
+        uint32_t nameLength;
+    };
+    static_assert(sizeof(PresetCacheEntry) == 16, "PresetCacheEntry must stay free of padding");
+
+    static uint64_t hashName(const char* s, size_t n)
+    {
+        uint64_t h = 0xCBF29CE484222325ull; // FNV-1a
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= (uint8_t)s[i];
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    static inline uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+    std::string presetCachePath(const std::string& jsonPath)
+    {
+        return jsonPath + ".bin";
+    }
+
+    // ---------------------------------------------------------------------
+    // JSON
+
+    namespace
+    {
+        // settings value as setSettingsValue() takes it; arrays of numbers become "a,b,c"
+        bool applyJsonSetting(JsonCursor& c, const std::string& key, SettingsData& s)
+        {
+            std::string value;
+            if (c.peek('['))
+            {
+                c.take('[');
+                if (c.take(']')) return true;
+
+                std::string joined;
+                do
+                {
+                    if (c.peek('"'))
+                    {
+                        if (!c.string(value)) return false;
+                        const std::string name = key == "layers" ? "layer" : key;
+                        if (!setSettingsValue(s, name, value)) return false;
+                    }
+                    else
+                    {
+                        if (!c.scalar(value)) return false;
+                        if (!joined.empty()) joined += ',';
+                        joined += value;
+                    }
+                } while (c.take(','));
+                if (!c.take(']')) return false;
+                return joined.empty() || setSettingsValue(s, key, joined);
+            }
+
+            if (c.peek('"'))
+            {
+                if (!c.string(value)) return false;
+            }
+            else if (!c.scalar(value))
+                return false;
+            return setSettingsValue(s, key, value);
+        }
+
+        bool parsePresetObject(const char* begin, const char* end, SettingsData& s, std::string& error)
+        {
+            JsonCursor c{ begin, end };
+            if (!c.take('{')) { error = "expected a preset object"; return false; }
+            if (c.take('}')) return true;
+
+            std::string key;
+            do
+            {
+                if (!c.string(key) || !c.take(':')) { error = "bad preset object"; return false; }
+                if (key != "settings")
+                {
+                    if (!c.skipValue()) { error = "bad value for " + key; return false; }
+                    continue;
+                }
+
+                if (!c.take('{')) { error = "settings must be an object"; return false; }
+                if (c.take('}')) continue;
+                do
+                {
+                    std::string attr;
+                    if (!c.string(attr) || !c.take(':')) { error = "bad settings object"; return false; }
+                    if (!applyJsonSetting(c, attr, s)) { error = "bad value for " + attr; return false; }
+                } while (c.take(','));
+                if (!c.take('}')) { error = "bad settings object"; return false; }
+            } while (c.take(','));
+
+            if (!c.take('}')) { error = "bad preset object"; return false; }
+            return true;
+        }
+
+        struct PresetSpan
+        {
+            std::string name;
+            size_t      begin;
+            size_t      end;
+        };
+
+        // Names and byte ranges of the presets; their settings are skipped unparsed.
+        bool indexPresets(const char* text, size_t size, std::vector<PresetSpan>& out, std::string& error)
+        {
+            out.clear();
+            JsonCursor c{ text, text + size };
+            c.skipWs();
+            if (c.p == c.end) return true; // empty file: no presets
+
+            if (!c.take('{')) { error = "expected an object"; return false; }
+            if (c.take('}')) return true;
+
+            std::string key;
+            do
+            {
+                if (!c.string(key) || !c.take(':')) { error = "bad top-level object"; return false; }
+                if (key != "presets")
+                {
+                    if (!c.skipValue()) { error = "bad value for " + key; return false; }
+                    continue;
+                }
+
+                if (!c.take('[')) { error = "presets must be an array"; return false; }
+                if (c.take(']')) continue;
+                do
+                {
+                    c.skipWs();
+                    PresetSpan span;
+                    span.begin = (size_t)(c.p - text);
+
+                    if (!c.take('{')) { error = "expected a preset object"; return false; }
+                    if (!c.take('}'))
+                    {
+                        do
+                        {
+                            std::string field;
+                            if (!c.string(field) || !c.take(':')) { error = "bad preset object"; return false; }
+                            if (field == "name")
+                            {
+                                if (!c.string(span.name)) { error = "preset name must be a string"; return false; }
+                            }
+                            else if (!c.skipValue())
+                            {
+                                error = "bad value for " + field;
+                                return false;
+                            }
+                        } while (c.take(','));
+                        if (!c.take('}')) { error = "bad preset object"; return false; }
+                    }
+
+                    span.end = (size_t)(c.p - text);
+                    if (span.name.empty()) { error = "preset without a name"; return false; }
+                    out.push_back(std::move(span));
+                } while (c.take(','));
+                if (!c.take(']')) { error = "bad presets array"; return false; }
+            } while (c.take(','));
+
+            if (!c.take('}')) { error = "bad top-level object"; return false; }
+            return true;
+        }
+
+        void appendJsonString(std::string& out, const std::string& s)
+        {
+            out += '"';
+            for (char ch : s)
+            {
+                switch (ch)
+                {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                case '\r': out += "\\r"; break;
+                default:
+                    if ((unsigned char)ch < 0x20)
+                    {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)(unsigned char)ch);
+                        out += buf;
+                    }
+                    else
+                        out += ch;
+                }
+            }
+            out += '"';
+        }
+    }
+
+    // ---------------------------------------------------------------------
+
+    bool PresetLibrary::open(const std::string& jsonPath, std::string& error)
+    {
+        close();
+        mPath = jsonPath;
+
+        if (openCache(presetCachePath(jsonPath)))
+        {
+            mOpen = true;
+            return true;
+        }
+
+        if (!mJson.open(jsonPath, error)) return false;
+        if (!indexJson(error))
+        {
+            error = jsonPath + ": " + error;
+            close();
+            return false;
+        }
+        mOpen = true;
+        return true;
+    }
+
+    void PresetLibrary::close()
+    {
+        mCache.close();
+        mJson.close();
+        mEntries = nullptr;
+        mBuckets = nullptr;
+        mRecords = nullptr;
+        mNames = nullptr;
+        mCount = 0;
+        mBucketMask = 0;
+        mPresets.clear();
+        mByName.clear();
+        mParsed.clear();
+        mIsParsed.clear();
+        mOpen = false;
+    }
+
+    bool PresetLibrary::openCache(const std::string& cachePath)
+    {
+        uint64_t size = 0;
+        int64_t  time = 0;
+        std::string ignored;
+        if (!fileStamp(mPath, size, time) || !mCache.open(cachePath, ignored))
+            return false;
+
+        // anything unexpected: stale or foreign file, fall back to the JSON
+        const uint8_t* base = mCache.data();
+        const uint64_t fileSize = mCache.size();
+        PresetCacheHeader h;
+        bool ok = fileSize >= sizeof(h);
+        if (ok)
+        {
+            std::memcpy(&h, base, sizeof(h));
+            ok = std::memcmp(h.magic, kCacheMagic, 4) == 0 && h.version == kCacheVersion &&
+                 h.recordSize == sizeof(PackedSettings) && h.sourceSize == size && h.sourceTime == time &&
+                 h.bucketCount >= 2 * (uint64_t)h.count && (h.bucketCount & (h.bucketCount - 1)) == 0 &&
+                 h.entriesOffset + (uint64_t)h.count * sizeof(PresetCacheEntry) <= fileSize &&
+                 h.bucketsOffset + (uint64_t)h.bucketCount * sizeof(uint32_t) <= fileSize &&
+                 h.recordsOffset + (uint64_t)h.count * sizeof(PackedSettings) <= fileSize &&
+                 h.namesOffset + h.namesSize <= fileSize &&
+                 (h.entriesOffset | h.bucketsOffset | h.recordsOffset) % 8 == 0;
+        }
+        if (ok)
+        {
+            mEntries = base + h.entriesOffset;
+            mBuckets = reinterpret_cast<const uint32_t*>(base + h.bucketsOffset);
+            mRecords = base + h.recordsOffset;
+            mNames   = reinterpret_cast<const char*>(base + h.namesOffset);
+            mCount   = h.count;
+            mBucketMask = h.bucketCount - 1;
+
+            for (uint32_t i = 0; i < mCount && ok; ++i)
+            {
+                PresetCacheEntry e;
+                std::memcpy(&e, mEntries + (size_t)i * sizeof(e), sizeof(e));
+                ok = (uint64_t)e.nameOffset + e.nameLength <= h.namesSize;
+            }
+
+            // find() probes until an empty bucket and follows the slots into the entries
+            bool hasEmpty = false;
+            for (uint32_t b = 0; b < h.bucketCount && ok; ++b)
+            {
+                ok = mBuckets[b] <= mCount;
+                hasEmpty = hasEmpty || mBuckets[b] == 0;
+            }
+            ok = ok && hasEmpty;
+        }
+        if (!ok)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool PresetLibrary::indexJson(std::string& error)
+    {
+        std::vector<PresetSpan> spans;
+        if (!indexPresets(reinterpret_cast<const char*>(mJson.data()), mJson.size(), spans, error))
+            return false;
+
+        mPresets.reserve(spans.size());
+        for (PresetSpan& span : spans)
+        {
+            mByName.emplace(span.name, (int)mPresets.size()); // first one wins
+            mPresets.push_back(JsonPreset{ std::move(span.name), span.begin, span.end });
+        }
+        mParsed.resize(mPresets.size());
+        mIsParsed.assign(mPresets.size(), 0);
+        return true;
+    }
+
+    size_t PresetLibrary::size() const
+    {
+        return fromCache() ? mCount : mPresets.size();
+    }
+
+    std::string PresetLibrary::name(size_t i) const
+    {
+        if (i >= size()) return std::string();
+        if (!fromCache()) return mPresets[i].name;
+
+        PresetCacheEntry e;
+        std::memcpy(&e, mEntries + i * sizeof(e), sizeof(e));
+        return std::string(mNames + e.nameOffset, e.nameLength);
+    }
+
+    int PresetLibrary::find(const std::string& name) const
+    {
+        if (!fromCache())
+        {
+            const auto it = mByName.find(name);
+            return it == mByName.end() ? -1 : it->second;
+        }
+        if (mCount == 0) return -1;
+
+        const uint64_t h = hashName(name.data(), name.size());
+        uint32_t b = (uint32_t)h & mBucketMask;
+        for (uint64_t probe = 0; probe <= mBucketMask; ++probe, b = (b + 1) & mBucketMask)
+        {
+            const uint32_t slot = mBuckets[b];
+            if (slot == 0) return -1;
+
+            PresetCacheEntry e;
+            std::memcpy(&e, mEntries + (size_t)(slot - 1) * sizeof(e), sizeof(e));
+            if (e.nameHash == h && e.nameLength == name.size() &&
+                std::memcmp(mNames + e.nameOffset, name.data(), name.size()) == 0)
+                return (int)(slot - 1);
+        }
+        return -1;
+    }
+
+    bool PresetLibrary::settings(size_t i, PackedSettings& out, std::string& error) const
+    {
+        if (i >= size()) { error = "no such preset"; return false; }
+
+        if (fromCache())
+        {
+            // the stamp only covers the JSON: a damaged or foreign cache can hold
+            // values past the attribute ranges (layer counts, enums), so every record
+            // goes through sanitizeSettings() like a parsed one
+            PackedSettings record;
+            std::memcpy(&record, mRecords + i * sizeof(PackedSettings), sizeof(PackedSettings));
+            SettingsData s = unpackSettings(record);
+            sanitizeSettings(s);
+            out = packSettings(s);
+            return true;
+        }
+
+        if (!mIsParsed[i])
+        {
+            const JsonPreset& p = mPresets[i];
+            const char* text = reinterpret_cast<const char*>(mJson.data());
+
+            SettingsData s;
+            if (!parsePresetObject(text + p.begin, text + p.end, s, error))
+            {
+                error = "preset '" + p.name + "': " + error;
+                return false;
+            }
+            sanitizeSettings(s);
+            mParsed[i] = packSettings(s);
+            mIsParsed[i] = 1;
+        }
+        out = mParsed[i];
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+
+    bool compilePresetCache(const std::string& jsonPath, std::string& error)
+    {
+        uint64_t sourceSize = 0;
+        int64_t  sourceTime = 0;
+        if (!fileStamp(jsonPath, sourceSize, sourceTime)) { error = "cannot stat " + jsonPath; return false; }
+
+        MappedFile json;
+        if (!json.open(jsonPath, error)) return false;
+
+        std::vector<PresetSpan> spans;
+        if (!indexPresets(reinterpret_cast<const char*>(json.data()), json.size(), spans, error))
+        {
+            error = jsonPath + ": " + error;
+            return false;
+        }
+
+        // repeated names: only the first one is kept, as PresetLibrary::find() does
+        std::vector<const PresetSpan*> unique;
+        {
+            std::unordered_map<std::string, int> seen;
+            for (const PresetSpan& s : spans)
+            {
+                if (seen.emplace(s.name, 0).second) unique.push_back(&s);
+            }
+        }
+        const uint32_t count = (uint32_t)unique.size();
+
+        uint32_t bucketCount = 8;
+        while (bucketCount < 2 * count) bucketCount *= 2;
+
+        PresetCacheHeader h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, kCacheMagic, 4);
+        h.version     = kCacheVersion;
+        h.count       = count;
+        h.bucketCount = bucketCount;
+        h.recordSize  = sizeof(PackedSettings);
+        h.sourceSize  = sourceSize;
+        h.sourceTime  = sourceTime;
+
+        uint64_t namesSize = 0;
+        for (const PresetSpan* s : unique) namesSize += s->name.size();
+
+        h.entriesOffset = align8(sizeof(h));
+        h.bucketsOffset = align8(h.entriesOffset + (uint64_t)count * sizeof(PresetCacheEntry));
+        h.recordsOffset = align8(h.bucketsOffset + (uint64_t)bucketCount * sizeof(uint32_t));
+        h.namesOffset   = h.recordsOffset + (uint64_t)count * sizeof(PackedSettings);
+        h.namesSize     = namesSize;
+
+        std::vector<uint8_t> file((size_t)(h.namesOffset + namesSize), 0);
+        std::memcpy(file.data(), &h, sizeof(h));
+
+        uint32_t* buckets = reinterpret_cast<uint32_t*>(file.data() + h.bucketsOffset);
+        const char* text = reinterpret_cast<const char*>(json.data());
+        uint32_t nameOffset = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const PresetSpan& span = *unique[i];
+
+            SettingsData s;
+            if (!parsePresetObject(text + span.begin, text + span.end, s, error))
+            {
+                error = jsonPath + ": preset '" + span.name + "': " + error;
+                return false;
+            }
+            sanitizeSettings(s);
+            const PackedSettings packed = packSettings(s);
+            std::memcpy(file.data() + h.recordsOffset + (size_t)i * sizeof(PackedSettings), &packed, sizeof(packed));
+
+            PresetCacheEntry e;
+            e.nameHash   = hashName(span.name.data(), span.name.size());
+            e.nameOffset = nameOffset;
+            e.nameLength = (uint32_t)span.name.size();
+            std::memcpy(file.data() + h.entriesOffset + (size_t)i * sizeof(e), &e, sizeof(e));
+            std::memcpy(file.data() + h.namesOffset + nameOffset, span.name.data(), span.name.size());
+            nameOffset += e.nameLength;
+
+            uint32_t b = (uint32_t)e.nameHash & (bucketCount - 1);
+            while (buckets[b] != 0) b = (b + 1) & (bucketCount - 1);
+            buckets[b] = i + 1;
+        }
+
+        json.close(); // Windows: the JSON may be replaced while mapped otherwise
+        return writeFileAtomic(presetCachePath(jsonPath), file.data(), file.size(), error);
+    }
+
+    std::string formatPresetJson(const std::string& name, const SettingsData& s)
+    {
+        static const char* kGuideNames[] = { "thirds", "cross", "circle", "phi", "spiral" };
+
+        char buf[256];
+        std::string out = "    {\n      \"name\": ";
+        appendJsonString(out, name);
+        out += ",\n      \"settings\": {\n";
+
+        auto boolValue = [&](const char* key, bool v)
+        {
+            std::snprintf(buf, sizeof(buf), "        \"%s\": %s,\n", key, v ? "true" : "false");
+            out += buf;
+        };
+        auto intValue = [&](const char* key, int v)
+        {
+            std::snprintf(buf, sizeof(buf), "        \"%s\": %d,\n", key, v);
+            out += buf;
+        };
+        auto floatValue = [&](const char* key, float v)
+        {
+            std::snprintf(buf, sizeof(buf), "        \"%s\": %.9g,\n", key, v);
+            out += buf;
+        };
+        auto colorValue = [&](const char* key, const Rgba& c)
+        {
+            std::snprintf(buf, sizeof(buf), "        \"%s\": [%.9g, %.9g, %.9g],\n", key, c.r, c.g, c.b);
+            out += buf;
+        };
+
+        boolValue ("enable", s.enable);
+        boolValue ("followResolutionGate", s.followResolutionGate);
+        std::snprintf(buf, sizeof(buf), "        \"guideType\": \"%s\",\n",
+                      kGuideNames[s.guideType >= kGuideThirds && s.guideType <= kGuideGoldenSpiral ? s.guideType : 0]);
+        out += buf;
+        intValue  ("goldenRotation", s.goldenRotation);
+        boolValue ("goldenFlipH", s.goldenFlipH);
+        boolValue ("goldenFlipV", s.goldenFlipV);
+        intValue  ("drawBackend", s.drawBackend);
+        std::snprintf(buf, sizeof(buf), "        \"pipeline\": \"%s\",\n",
+                      s.pipeline == kPipelineStandard ? "standard" : "replace");
+        out += buf;
+        floatValue("lineOpacity", s.lineOpacity);
+        floatValue("lineThickness", s.lineThickness);
+        colorValue("lineColor", s.lineColor);
+        boolValue ("gateBorderEnable", s.gateBorderEnable);
+        floatValue("gateBorderOpacity", s.gateBorderOpacity);
+        floatValue("gateBorderThickness", s.gateBorderThickness);
+        colorValue("gateBorderColor", s.gateBorderColor);
+        boolValue ("maskEnable", s.maskEnable);
+        floatValue("maskOpacity", s.maskOpacity);
+        colorValue("maskColor", s.maskColor);
+        boolValue ("bgEnable", s.bgEnable);
+        colorValue("bgColor", s.bgColor);
+
+        boolValue ("adaptiveQuality", s.adaptiveQuality);
+        floatValue("qualityBudget", s.qualityBudget);
+        intValue  ("qualityFloor", s.qualityFloor);
+
+        std::snprintf(buf, sizeof(buf), "        \"annotations\": \"%s\",\n",
+                      formatAnnotationFields(s.annotations).c_str());
+        out += buf;
+        intValue  ("annotationScale", s.annotationScale);
+        floatValue("annotationOpacity", s.annotationOpacity);
+        colorValue("annotationColor", s.annotationColor);
+
+        out += "        \"layers\": [";
+        for (int i = 0; i < s.layers.count; ++i)
+        {
+            out += i ? ",\n          " : "\n          ";
+            appendJsonString(out, formatGuideLayer(s.layers, i));
+        }
+        out += s.layers.count ? "\n        ]\n" : "]\n";
+        out += "      }\n    }";
+        return out;
+    }
+
+    bool savePreset(const std::string& jsonPath, const std::string& name, const SettingsData& s, std::string& error)
+    {
+        // keep the other presets exactly as written
+        std::string existing;
+        std::vector<PresetSpan> spans;
+        std::error_code ec;
+        if (fs::exists(jsonPath, ec))
+        {
+            MappedFile json;
+            if (!json.open(jsonPath, error)) return false;
+            existing.assign(reinterpret_cast<const char*>(json.data()), json.size());
+            if (!indexPresets(existing.data(), existing.size(), spans, error))
+            {
+                error = jsonPath + ": " + error;
+                return false;
+            }
+        }
+
+        std::string out = "{\n  \"presets\": [\n";
+        bool replaced = false;
+        for (size_t i = 0; i < spans.size(); ++i)
+        {
+            if (i) out += ",\n";
+            if (spans[i].name == name && !replaced)
+            {
+                out += formatPresetJson(name, s);
+                replaced = true;
+            }
+            else
+            {
+                out += "    ";
+                out.append(existing, spans[i].begin, spans[i].end - spans[i].begin);
+            }
+        }
+        if (!replaced)
+        {
+            if (!spans.empty()) out += ",\n";
+            out += formatPresetJson(name, s);
+        }
+        out += "\n  ]\n}\n";
+
+        if (!writeFileAtomic(jsonPath, out.data(), out.size(), error)) return false;
+        return compilePresetCache(jsonPath, error);
+    }
+}
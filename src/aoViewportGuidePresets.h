@@ -0,0 +1,92 @@
+#pragma once
+// aoViewportGuidePresets.h (v0.3.1)
+// Preset libraries (no Maya types). People edit a JSON file:
+//
+//   { "presets": [
+//       { "name": "warm thirds",
+//         "settings": { "guideType": "thirds", "lineColor": [1, 0.8, 0], "lineOpacity": 0.6,
+//                       "layers": ["safe action=90 title=80"] } } ] }
+//
+// "settings" takes any attribute setSettingsValue() knows; missing ones keep their
+// defaults. The plugin reads a compiled cache next to it (presetCachePath()):
+// preset names in an open-addressing hash table and every preset as
+// PackedSettings, memory mapped, so finding a preset reads one record. Without a
+// current cache the JSON is only scanned for names, and a preset's settings are
+// parsed when it is first used.
+
+#include "aoViewportGuideMappedFile.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    class PresetLibrary
+    {
+    public:
+        // Maps the cache when it matches the JSON's size and modification time,
+        // indexes the JSON otherwise.
+        bool open(const std::string& jsonPath, std::string& error);
+        void close();
+
+        bool isOpen() const    { return mOpen; }
+        bool fromCache() const { return mCache.isOpen(); }
+        const std::string& path() const { return mPath; }
+
+        size_t      size() const;
+        std::string name(size_t i) const;
+
+        // Index of the preset called name (the first one when repeated), -1 when none.
+        int find(const std::string& name) const;
+
+        // Not thread safe: JSON presets are parsed and kept on first use.
+        bool settings(size_t i, PackedSettings& out, std::string& error) const;
+
+    private:
+        struct JsonPreset
+        {
+            std::string name;
+            size_t      begin; // byte range of the preset object
+            size_t      end;
+        };
+
+        bool openCache(const std::string& cachePath);
+        bool indexJson(std::string& error);
+
+        std::string mPath;
+        bool        mOpen = false;
+
+        // compiled cache
+        MappedFile     mCache;
+        const uint8_t* mEntries = nullptr;
+        const uint32_t* mBuckets = nullptr;
+        const uint8_t* mRecords = nullptr;
+        const char*    mNames = nullptr;
+        uint32_t       mCount = 0;
+        uint32_t       mBucketMask = 0;
+
+        // JSON
+        MappedFile                           mJson;
+        std::vector<JsonPreset>              mPresets;
+        std::unordered_map<std::string, int> mByName;
+        mutable std::vector<PackedSettings>  mParsed;
+        mutable std::vector<uint8_t>         mIsParsed;
+    };
+
+    // <jsonPath>.bin
+    std::string presetCachePath(const std::string& jsonPath);
+
+    // Parses every preset of the library and writes its cache.
+    bool compilePresetCache(const std::string& jsonPath, std::string& error);
+
+    // Adds preset name, or replaces the one with that name, in the JSON file (created
+    // when missing); the other presets are kept as written. Then refreshes the cache.
+    bool savePreset(const std::string& jsonPath, const std::string& name, const SettingsData& s, std::string& error);
+
+    // The JSON object of one preset, every attribute written out.
+    std::string formatPresetJson(const std::string& name, const SettingsData& s);
+}
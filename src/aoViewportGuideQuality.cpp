@@ -0,0 +1,87 @@
+// aoViewportGuideQuality.cpp (v0.3.1)
+
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideCommon.h"
+
+#include <algorithm>
+
+namespace AoViewportGuide
+{
+    static const QualityLevelParams kLevels[kQualityLevelCount] = {
+        { kCurveTolerancePx,  1.0, 1.0e9f }, // full: the configured widths
+        { 1.0,                6.0, 4.0f },
+        { 2.0,               12.0, 2.0f },
+        { 4.0,               24.0, 1.0f },
+    };
+
+    // step back up after this many frames whose cost would fit the budget one level up
+    static constexpr int    kCalmFramesToRaise = 30;
+    static constexpr double kCostSmoothing     = 0.2;
+
+    const QualityLevelParams& qualityLevelParams(int level)
+    {
+        return kLevels[(std::max)(0, (std::min)(level, (int)kQualityLevelCount - 1))];
+    }
+
+    int QualityGovernor::beginFrame(bool adaptive, int floorLevel, double budgetNs, bool interacting)
+    {
+        const int previous = mLevel;
+        floorLevel = (std::max)(0, (std::min)(floorLevel, (int)kQualityLevelCount - 1));
+
+        if (!adaptive || !interacting)
+        {
+            mLevel = kQualityFull;
+            mCalmFrames = 0;
+        }
+        else if (mCost[mLevel] > budgetNs && mLevel < floorLevel)
+        {
+            ++mLevel;
+            mCalmFrames = 0;
+        }
+        else if (mLevel > floorLevel)
+        {
+            mLevel = floorLevel;
+            mCalmFrames = 0;
+        }
+        else if (mLevel > kQualityFull)
+        {
+            // the level above fits (or was never measured), or this one is far under
+            // budget (what made the level above expensive may be over): try it again
+            const double above = mCost[mLevel - 1];
+            const bool calm = above <= 0.0 || above < 0.8 * budgetNs || mCost[mLevel] < 0.25 * budgetNs;
+            mCalmFrames = calm ? mCalmFrames + 1 : 0;
+            if (mCalmFrames >= kCalmFramesToRaise)
+            {
+                --mLevel;
+                mCalmFrames = 0;
+            }
+        }
+
+        mLevelChanged = mLevel != previous;
+        return mLevel;
+    }
+
+    uint64_t QualityGovernor::endFrame(uint64_t costNs)
+    {
+        if (!mLevelChanged)
+        {
+            double& c = mCost[mLevel];
+            c = c <= 0.0 ? (double)costNs : c + kCostSmoothing * ((double)costNs - c);
+        }
+
+        const double full = mCost[kQualityFull];
+        if (mLevel == kQualityFull || full <= 0.0 || full <= (double)costNs)
+            return 0;
+        return (uint64_t)(full - (double)costNs);
+    }
+
+    double QualityGovernor::levelCost(int level) const
+    {
+        return (level >= 0 && level < kQualityLevelCount) ? mCost[level] : 0.0;
+    }
+
+    void QualityGovernor::reset()
+    {
+        *this = QualityGovernor();
+    }
+}
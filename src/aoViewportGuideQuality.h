@@ -0,0 +1,55 @@
+#pragma once
+// aoViewportGuideQuality.h (v0.3.1)
+// Adaptive overlay quality (no Maya types). While the user tumbles, scrubs or
+// plays back, QualityGovernor watches the overlay cost of recent frames and
+// steps down curve tessellation, grid density and line width, so each frame
+// fits the budget set on the settings node. The first redraw without
+// interaction is back at full quality.
+
+#include <cstdint>
+
+namespace AoViewportGuide
+{
+    enum QualityLevel
+    {
+        kQualityFull   = 0,
+        kQualityHigh   = 1,
+        kQualityMedium = 2,
+        kQualityDraft  = 3,
+        kQualityLevelCount
+    };
+
+    struct QualityLevelParams
+    {
+        double tolerancePx;      // max chord error of curved guides
+        double minGridSpacingPx; // denser grids keep every n-th line
+        float  maxLineWidth;     // wide lines cost fill rate; widths are capped
+    };
+
+    const QualityLevelParams& qualityLevelParams(int level);
+
+    class QualityGovernor
+    {
+    public:
+        // Level for the frame about to be drawn. floorLevel is the lowest quality
+        // allowed; without adaptive or interacting it is always kQualityFull.
+        int beginFrame(bool adaptive, int floorLevel, double budgetNs, bool interacting);
+
+        // Overlay cost of the frame begun last. Returns the time saved against the
+        // recent full quality cost (0 at full quality or before one was measured).
+        uint64_t endFrame(uint64_t costNs);
+
+        int level() const { return mLevel; }
+
+        // mean cost per level (ns), 0 until measured
+        double levelCost(int level) const;
+
+        void reset();
+
+    private:
+        double mCost[kQualityLevelCount] = {};
+        int    mLevel = kQualityFull;
+        int    mCalmFrames = 0;      // frames well under budget at this level
+        bool   mLevelChanged = false; // the frame after a change rebuilds: not a sample
+    };
+}
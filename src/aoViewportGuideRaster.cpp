@@ -0,0 +1,540 @@
+// aoViewportGuideRaster.cpp (v0.3.1)
+// Layer/bounds handling, ISA dispatch, and the scalar + SSE2 kernels.
+// The AVX2 kernels are in aoViewportGuideRasterAvx2.cpp (own compile flags).
+
+#include "aoViewportGuideRaster.h"
+#include "aoViewportGuideRasterKernels.h"
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideSettingsData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AO_RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace AoViewportGuide
+{
+    // ---------------------------------------------------------------------
+    // scalar kernels
+
+    namespace
+    {
+        void blendScalar(float* rgba, const float* cov, int n, const float color[4], float alpha)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                const float k = alpha * cov[i];
+                if (k <= 0.0f) continue;
+                float* d = rgba + (size_t)i * 4;
+                d[0] += (color[0] - d[0]) * k;
+                d[1] += (color[1] - d[1]) * k;
+                d[2] += (color[2] - d[2]) * k;
+                d[3] += (color[3] - d[3]) * k;
+            }
+        }
+
+        const RasterKernels kScalarKernels = {
+            segmentRow<F1>, ringRow<F1>, arcRow<F1>, rectRow<F1>, blendScalar
+        };
+    }
+
+    const RasterKernels* rasterKernelsScalar()
+    {
+        return &kScalarKernels;
+    }
+
+    // ---------------------------------------------------------------------
+    // SSE2 kernels (4 pixels)
+
+#if defined(AO_RASTER_SSE2)
+    namespace
+    {
+        struct F4
+        {
+            static constexpr int N = 4;
+            __m128 v;
+
+            F4() = default;
+            F4(float x) : v(_mm_set1_ps(x)) {}
+            explicit F4(__m128 x) : v(x) {}
+
+            static F4 ramp(float start) { return F4(_mm_add_ps(_mm_set1_ps(start), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f))); }
+            static F4 load(const float* p) { return F4(_mm_loadu_ps(p)); }
+            static void store(float* p, F4 a) { _mm_storeu_ps(p, a.v); }
+
+            friend F4 operator+(F4 a, F4 b) { return F4(_mm_add_ps(a.v, b.v)); }
+            friend F4 operator-(F4 a, F4 b) { return F4(_mm_sub_ps(a.v, b.v)); }
+            friend F4 operator*(F4 a, F4 b) { return F4(_mm_mul_ps(a.v, b.v)); }
+        };
+
+        struct M4
+        {
+            __m128 v;
+        };
+
+        inline F4 vmin(F4 a, F4 b) { return F4(_mm_min_ps(a.v, b.v)); }
+        inline F4 vmax(F4 a, F4 b) { return F4(_mm_max_ps(a.v, b.v)); }
+        inline F4 vsqrt(F4 a) { return F4(_mm_sqrt_ps(a.v)); }
+        inline F4 vabs(F4 a) { return F4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+        inline F4 vclamp01(F4 a) { return vmin(vmax(a, F4(0.0f)), F4(1.0f)); }
+        inline M4 vcmpge(F4 a, F4 b) { return M4{ _mm_cmpge_ps(a.v, b.v) }; }
+        inline M4 vand(M4 a, M4 b) { return M4{ _mm_and_ps(a.v, b.v) }; }
+        inline M4 vor(M4 a, M4 b) { return M4{ _mm_or_ps(a.v, b.v) }; }
+        inline F4 vselect(M4 m, F4 a, F4 b) { return F4(_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))); }
+
+        void blendSse2(float* rgba, const float* cov, int n, const float color[4], float alpha)
+        {
+            const __m128 c = _mm_loadu_ps(color);
+            for (int i = 0; i < n; ++i)
+            {
+                const float k = alpha * cov[i];
+                if (k <= 0.0f) continue;
+                float* p = rgba + (size_t)i * 4;
+                const __m128 d = _mm_loadu_ps(p);
+                _mm_storeu_ps(p, _mm_add_ps(d, _mm_mul_ps(_mm_sub_ps(c, d), _mm_set1_ps(k))));
+            }
+        }
+
+        const RasterKernels kSse2Kernels = {
+            segmentRow<F4>, ringRow<F4>, arcRow<F4>, rectRow<F4>, blendSse2
+        };
+    }
+
+    const RasterKernels* rasterKernelsSse2()
+    {
+        return &kSse2Kernels;
+    }
+#else
+    const RasterKernels* rasterKernelsSse2()
+    {
+        return nullptr;
+    }
+#endif
+
+    // ---------------------------------------------------------------------
+    // dispatch
+
+    static bool cpuHasAvx2()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int regs[4] = {};
+        __cpuid(regs, 1);
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool avx     = (regs[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves XMM/YMM state
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    RasterIsa rasterBestIsa()
+    {
+        static const RasterIsa best = []
+        {
+            if (rasterKernelsAvx2() && cpuHasAvx2()) return kRasterAvx2;
+            if (rasterKernelsSse2()) return kRasterSse2;
+            return kRasterScalar;
+        }();
+        return best;
+    }
+
+    static std::atomic<int> gRasterIsa{ -1 };
+
+    RasterIsa rasterIsa()
+    {
+        int isa = gRasterIsa.load(std::memory_order_relaxed);
+        if (isa < 0)
+        {
+            isa = (int)rasterBestIsa();
+            gRasterIsa.store(isa, std::memory_order_relaxed);
+        }
+        return (RasterIsa)isa;
+    }
+
+    void setRasterIsa(RasterIsa isa)
+    {
+        if (isa > rasterBestIsa()) isa = rasterBestIsa();
+        if (isa == kRasterSse2 && !rasterKernelsSse2()) isa = kRasterScalar;
+        gRasterIsa.store((int)isa, std::memory_order_relaxed);
+    }
+
+    const char* rasterIsaName(RasterIsa isa)
+    {
+        switch (isa)
+        {
+        case kRasterAvx2: return "avx2";
+        case kRasterSse2: return "sse2";
+        default:          return "scalar";
+        }
+    }
+
+    static const RasterKernels& activeKernels()
+    {
+        switch (rasterIsa())
+        {
+        case kRasterAvx2: return *rasterKernelsAvx2();
+        case kRasterSse2: return *rasterKernelsSse2();
+        default:          return *rasterKernelsScalar();
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // GuideRasterizer
+
+    void GuideRasterizer::beginLayer(const RasterTarget& target)
+    {
+        const size_t size = (size_t)(std::max)(0, target.width) * (size_t)(std::max)(0, target.height);
+        if (mCoverage.size() != size || mTarget.width != target.width)
+            mCoverage.assign(size, 0.0f);
+
+        mTarget  = target;
+        mTouched = false;
+        mDirtyX0 = mTarget.width;
+        mDirtyY0 = mTarget.height;
+        mDirtyX1 = 0;
+        mDirtyY1 = 0;
+    }
+
+    bool GuideRasterizer::clipBounds(double left, double bottom, double right, double top,
+                                     int& ix0, int& iy0, int& ix1, int& iy1) const
+    {
+        // pixel i covers [x0 + i, x0 + i + 1); one extra pixel for the AA ramp
+        const double fx0 = std::floor(left) - 1.0 - (double)mTarget.x0;
+        const double fx1 = std::ceil(right) + 1.0 - (double)mTarget.x0;
+        const double fy0 = std::floor(bottom) - 1.0 - (double)mTarget.y0;
+        const double fy1 = std::ceil(top) + 1.0 - (double)mTarget.y0;
+
+        ix0 = (int)(std::max)(0.0, fx0);
+        iy0 = (int)(std::max)(0.0, fy0);
+        ix1 = (int)(std::min)((double)mTarget.width, fx1);
+        iy1 = (int)(std::min)((double)mTarget.height, fy1);
+        return ix0 < ix1 && iy0 < iy1;
+    }
+
+    void GuideRasterizer::markDirty(int ix0, int iy0, int ix1, int iy1)
+    {
+        mTouched = true;
+        mDirtyX0 = (std::min)(mDirtyX0, ix0);
+        mDirtyY0 = (std::min)(mDirtyY0, iy0);
+        mDirtyX1 = (std::max)(mDirtyX1, ix1);
+        mDirtyY1 = (std::max)(mDirtyY1, iy1);
+    }
+
+    void GuideRasterizer::addRect(double left, double bottom, double right, double top)
+    {
+        int ix0, iy0, ix1, iy1;
+        if (!clipBounds(left, bottom, right, top, ix0, iy0, ix1, iy1)) return;
+        markDirty(ix0, iy0, ix1, iy1);
+
+        const RasterKernels& k = activeKernels();
+        const RectShape shape{ (float)(left - mTarget.x0), (float)(right - mTarget.x0) };
+
+        for (int j = iy0; j < iy1; ++j)
+        {
+            const double py = (double)(mTarget.y0 + j) + 0.5;
+            const float rowCov = clampf((float)(std::min)(py + 0.5 - bottom, top - py + 0.5), 0.0f, 1.0f);
+            if (rowCov <= 0.0f) continue;
+            k.rect(coverageRow(j) + ix0, ix1 - ix0, (float)ix0 + 0.5f, rowCov, shape);
+        }
+    }
+
+    // Shapes are passed in target-local coordinates so the float math stays
+    // precise far from the viewport origin.
+    void GuideRasterizer::addSegment(double ax, double ay, double bx, double by, float width)
+    {
+        const double hw = 0.5 * (double)width;
+        int ix0, iy0, ix1, iy1;
+        if (!clipBounds((std::min)(ax, bx) - hw, (std::min)(ay, by) - hw,
+                        (std::max)(ax, bx) + hw, (std::max)(ay, by) + hw, ix0, iy0, ix1, iy1)) return;
+        markDirty(ix0, iy0, ix1, iy1);
+
+        const double dx = bx - ax, dy = by - ay;
+        const double len2 = dx * dx + dy * dy;
+
+        SegmentShape shape;
+        shape.ax = (float)(ax - mTarget.x0);
+        shape.ay = (float)(ay - mTarget.y0);
+        shape.bax = (float)dx;
+        shape.bay = (float)dy;
+        shape.invLen2 = len2 > 0.0 ? (float)(1.0 / len2) : 0.0f;
+        shape.halfWidth = (float)hw;
+
+        const RasterKernels& k = activeKernels();
+        for (int j = iy0; j < iy1; ++j)
+            k.segment(coverageRow(j) + ix0, ix1 - ix0, (float)ix0 + 0.5f, (float)j + 0.5f, shape);
+    }
+
+    // Row spans of a ring: [cx - outer, cx - inner] and [cx + inner, cx + outer],
+    // one span where the row misses the inner radius.
+    template <class Fn>
+    static void forRingSpans(double cx, double cy, double radius, double reach,
+                             int iy0, int iy1, int width, int tx0, int ty0, Fn fn)
+    {
+        const double ro = radius + reach;
+        const double ri = radius - reach;
+
+        for (int j = iy0; j < iy1; ++j)
+        {
+            const double dy = (double)(ty0 + j) + 0.5 - cy;
+            if (std::fabs(dy) > ro) continue;
+
+            const double xo = std::sqrt(ro * ro - dy * dy);
+            const int a0 = (std::max)(0,     (int)std::floor(cx - xo) - tx0);
+            const int a1 = (std::min)(width, (int)std::ceil(cx + xo) - tx0 + 1);
+            if (a0 >= a1) continue;
+
+            if (ri > 0.0 && std::fabs(dy) < ri)
+            {
+                const double xi = std::sqrt(ri * ri - dy * dy);
+                const int b0 = (std::max)(a0, (int)std::ceil(cx - xi) - tx0);
+                const int b1 = (std::min)(a1, (int)std::floor(cx + xi) - tx0);
+                if (b0 < b1)
+                {
+                    if (a0 < b0) fn(j, a0, b0);
+                    if (b1 < a1) fn(j, b1, a1);
+                    continue;
+                }
+            }
+            fn(j, a0, a1);
+        }
+    }
+
+    void GuideRasterizer::addCircle(double cx, double cy, double radius, float width)
+    {
+        const double reach = 0.5 * (double)width + 1.0;
+        int ix0, iy0, ix1, iy1;
+        if (!clipBounds(cx - radius - reach, cy - radius - reach,
+                        cx + radius + reach, cy + radius + reach, ix0, iy0, ix1, iy1)) return;
+        markDirty(ix0, iy0, ix1, iy1);
+
+        const RingShape shape{ (float)(cx - mTarget.x0), (float)(cy - mTarget.y0), (float)radius, 0.5f * width };
+        const RasterKernels& k = activeKernels();
+
+        forRingSpans(cx, cy, radius, reach, iy0, iy1, mTarget.width, mTarget.x0, mTarget.y0,
+                     [&](int j, int a, int b)
+        {
+            k.ring(coverageRow(j) + a, b - a, (float)a + 0.5f, (float)j + 0.5f, shape);
+        });
+    }
+
+    void GuideRasterizer::addArc(double cx, double cy, double radius, double a0, double a1, float width)
+    {
+        static constexpr double kTwoPi = 6.283185307179586;
+
+        double sweep = std::fmod(a1 - a0, kTwoPi);
+        if (sweep < 0.0) sweep += kTwoPi;
+        if (sweep == 0.0 && a1 != a0) sweep = kTwoPi;
+        if (sweep >= kTwoPi - 1e-9)
+        {
+            addCircle(cx, cy, radius, width);
+            return;
+        }
+
+        const double reach = 0.5 * (double)width + 1.0;
+
+        // bounds: end points plus the axis extremes inside the sweep
+        const double e0x = cx + std::cos(a0) * radius, e0y = cy + std::sin(a0) * radius;
+        const double e1x = cx + std::cos(a0 + sweep) * radius, e1y = cy + std::sin(a0 + sweep) * radius;
+        double l = (std::min)(e0x, e1x), r = (std::max)(e0x, e1x);
+        double b = (std::min)(e0y, e1y), t = (std::max)(e0y, e1y);
+        for (int q = 0; q < 4; ++q)
+        {
+            double rel = std::fmod(q * 0.25 * kTwoPi - a0, kTwoPi);
+            if (rel < 0.0) rel += kTwoPi;
+            if (rel > sweep) continue;
+            if (q == 0) r = cx + radius;
+            if (q == 1) t = cy + radius;
+            if (q == 2) l = cx - radius;
+            if (q == 3) b = cy - radius;
+        }
+
+        int ix0, iy0, ix1, iy1;
+        if (!clipBounds(l - reach, b - reach, r + reach, t + reach, ix0, iy0, ix1, iy1)) return;
+        markDirty(ix0, iy0, ix1, iy1);
+
+        ArcShape shape;
+        shape.cx = (float)(cx - mTarget.x0);
+        shape.cy = (float)(cy - mTarget.y0);
+        shape.radius = (float)radius;
+        shape.halfWidth = 0.5f * width;
+        shape.u0x = (float)std::cos(a0);
+        shape.u0y = (float)std::sin(a0);
+        shape.u1x = (float)std::cos(a0 + sweep);
+        shape.u1y = (float)std::sin(a0 + sweep);
+        shape.major = sweep > 0.5 * kTwoPi;
+
+        const RasterKernels& k = activeKernels();
+        forRingSpans(cx, cy, radius, reach, iy0, iy1, mTarget.width, mTarget.x0, mTarget.y0,
+                     [&](int j, int a, int e)
+        {
+            a = (std::max)(a, ix0);
+            e = (std::min)(e, ix1);
+            if (a < e) k.arc(coverageRow(j) + a, e - a, (float)a + 0.5f, (float)j + 0.5f, shape);
+        });
+    }
+
+    void GuideRasterizer::addBitmap(const uint8_t* bits, ptrdiff_t stride, int width, int height,
+                                    int x, int y, int scale)
+    {
+        if (scale < 1) return;
+        const int ix0 = (std::max)(0, x - mTarget.x0);
+        const int iy0 = (std::max)(0, y - mTarget.y0);
+        const int ix1 = (std::min)(mTarget.width,  x + width * scale - mTarget.x0);
+        const int iy1 = (std::min)(mTarget.height, y + height * scale - mTarget.y0);
+        if (ix0 >= ix1 || iy0 >= iy1) return;
+        markDirty(ix0, iy0, ix1, iy1);
+
+        for (int j = iy0; j < iy1; ++j)
+        {
+            const int row = height - 1 - (mTarget.y0 + j - y) / scale;
+            const uint8_t* src = bits + (ptrdiff_t)row * stride;
+            float* cov = coverageRow(j);
+            for (int i = ix0; i < ix1; ++i)
+            {
+                const float c = (float)src[(mTarget.x0 + i - x) / scale] * (1.0f / 255.0f);
+                cov[i] = (std::max)(cov[i], c);
+            }
+        }
+    }
+
+    void GuideRasterizer::endLayer(const Rgba& color)
+    {
+        if (!mTouched) return;
+
+        const RasterKernels& k = activeKernels();
+        const float c[4] = { color.r, color.g, color.b, 1.0f };
+        const float alpha = clampf(color.a, 0.0f, 1.0f);
+        const int n = mDirtyX1 - mDirtyX0;
+
+        for (int j = mDirtyY0; j < mDirtyY1; ++j)
+        {
+            float* cov = coverageRow(j) + mDirtyX0;
+            if (alpha > 0.0f)
+            {
+                float* rgba = mTarget.row0 + (ptrdiff_t)j * mTarget.rowStride + (ptrdiff_t)mDirtyX0 * 4;
+                k.blend(rgba, cov, n, c, alpha);
+            }
+            std::fill(cov, cov + n, 0.0f);
+        }
+        mTouched = false;
+    }
+
+    // ---------------------------------------------------------------------
+
+    void rasterizeGuides(GuideRasterizer& raster, const RasterTarget& target, const GuideFieldParams& p)
+    {
+        const GateRect& g = p.gate;
+
+        if (p.maskColor.a > 0.0f)
+        {
+            static constexpr double kFar = 1.0e5;
+            raster.beginLayer(target);
+            raster.addRect(g.left - kFar, g.bottom - kFar, g.left,         g.top + kFar);
+            raster.addRect(g.right,       g.bottom - kFar, g.right + kFar, g.top + kFar);
+            raster.addRect(g.left,        g.bottom - kFar, g.right,        g.bottom);
+            raster.addRect(g.left,        g.top,           g.right,        g.top + kFar);
+            raster.endLayer(p.maskColor);
+        }
+
+        if (p.borderColor.a > 0.0f)
+        {
+            raster.beginLayer(target);
+            raster.addSegment(g.left,  g.bottom, g.right, g.bottom, p.borderWidth);
+            raster.addSegment(g.right, g.bottom, g.right, g.top,    p.borderWidth);
+            raster.addSegment(g.right, g.top,    g.left,  g.top,    p.borderWidth);
+            raster.addSegment(g.left,  g.top,    g.left,  g.bottom, p.borderWidth);
+            raster.endLayer(p.borderColor);
+        }
+
+        if (p.lineColor.a > 0.0f)
+        {
+            raster.beginLayer(target);
+            if (p.guideType != kGuideCircle)
+            {
+                LineBatch lines;
+                appendGuide(p.guideType, g, kCurveTolerancePx, lines, p.goldenOrientation);
+
+                for (size_t i = 0; i + 1 < lines.indices.size(); i += 2)
+                {
+                    const Point2& a = lines.points[lines.indices[i]];
+                    const Point2& b = lines.points[lines.indices[i + 1]];
+                    raster.addSegment(a.x, a.y, b.x, b.y, p.lineWidth);
+                }
+            }
+            else
+            {
+                const double w = g.right - g.left, h = g.top - g.bottom;
+                raster.addCircle((g.left + g.right) * 0.5, (g.bottom + g.top) * 0.5,
+                                 (std::min)(w, h) * 0.5, p.lineWidth);
+            }
+            raster.endLayer(p.lineColor);
+        }
+    }
+
+    void rasterizeGuideLayers(GuideRasterizer& raster, const RasterTarget& target, const GuideLayerDraw& layers)
+    {
+        for (size_t g = 0; g < layers.fillCount; ++g)
+        {
+            const GuideLayerDraw::Fills& f = layers.fills[g];
+            if (f.color.a <= 0.0f) continue;
+
+            raster.beginLayer(target);
+            for (const GateRect& r : f.rects)
+                raster.addRect(r.left, r.bottom, r.right, r.top);
+            raster.endLayer(f.color);
+        }
+
+        for (size_t g = 0; g < layers.lineCount; ++g)
+        {
+            const GuideLayerDraw::Lines& l = layers.lines[g];
+            if (l.color.a <= 0.0f) continue;
+
+            raster.beginLayer(target);
+            const LineBatch& b = l.batch;
+            for (size_t i = 0; i + 1 < b.indices.size(); i += 2)
+            {
+                const Point2& p0 = b.points[b.indices[i]];
+                const Point2& p1 = b.points[b.indices[i + 1]];
+                raster.addSegment(p0.x, p0.y, p1.x, p1.y, l.thickness);
+            }
+            raster.endLayer(l.color);
+        }
+    }
+
+    void rasterizeAnnotations(GuideRasterizer& raster, const RasterTarget& target,
+                              const AnnotationLayout& layout, const Rgba& color)
+    {
+        if (layout.glyphs.empty() || color.a <= 0.0f) return;
+
+        const GlyphAtlas& atlas = glyphAtlas();
+        const int s = layout.scale;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const int dx = pass == 0 ? s : 0;
+            const int dy = pass == 0 ? -s : 0;
+
+            raster.beginLayer(target);
+            for (const GlyphQuad& g : layout.glyphs)
+            {
+                raster.addBitmap(atlas.coverage + g.v * kGlyphAtlasWidth + g.u, kGlyphAtlasWidth,
+                                 kGlyphWidth, kGlyphHeight, g.x + dx, g.y + dy, s);
+            }
+            raster.endLayer(pass == 0 ? annotationShadowColor(color) : color);
+        }
+    }
+}
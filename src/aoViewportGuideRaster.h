@@ -0,0 +1,90 @@
+#pragma once
+// aoViewportGuideRaster.h (v0.3.1)
+// CPU rasterizer for the guide primitives (no Maya types). Coverage uses the
+// same 1 px anti-aliasing as aoViewportGuideField / the ogsfx shader, and is
+// computed with SSE2/AVX2 kernels where available (scalar otherwise).
+//
+// Primitives are drawn in layers: every primitive of a layer takes the max
+// coverage per pixel, then the layer is blended once with its color, so
+// crossings and joints of one style are not blended twice.
+
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideField.h"
+#include "aoViewportGuideLayers.h"
+#include "aoViewportGuideTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    enum RasterIsa
+    {
+        kRasterScalar = 0,
+        kRasterSse2   = 1,
+        kRasterAvx2   = 2,
+    };
+
+    RasterIsa   rasterBestIsa();          // what this CPU + build supports
+    RasterIsa   rasterIsa();              // active kernels
+    void        setRasterIsa(RasterIsa);  // clamped to rasterBestIsa(); for benchmarks
+    const char* rasterIsaName(RasterIsa isa);
+
+    // Float RGBA (straight alpha) covering viewport pixels [x0, x0 + width) x [y0, y0 + height).
+    // row0 points at row y0; rowStride (in floats, may be negative) steps to row y0 + 1.
+    struct RasterTarget
+    {
+        float*    row0 = nullptr;
+        ptrdiff_t rowStride = 0;
+        int x0 = 0;
+        int y0 = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    class GuideRasterizer
+    {
+    public:
+        void beginLayer(const RasterTarget& target);
+
+        // filled rectangle (viewport coordinates), anti-aliased edges
+        void addRect(double left, double bottom, double right, double top);
+
+        void addSegment(double ax, double ay, double bx, double by, float width);
+        void addCircle(double cx, double cy, double radius, float width);
+
+        // counter-clockwise from a0 to a1 (radians)
+        void addArc(double cx, double cy, double radius, double a0, double a1, float width);
+
+        // Coverage bitmap (bytes, first row at the top) blown up by an integer scale,
+        // its bottom-left corner on pixel (x, y); no anti-aliasing of its own.
+        void addBitmap(const uint8_t* bits, ptrdiff_t stride, int width, int height, int x, int y, int scale);
+
+        // "over" of color (a = opacity) with the accumulated coverage; nothing for a <= 0
+        void endLayer(const Rgba& color);
+
+    private:
+        float* coverageRow(int row) { return mCoverage.data() + (size_t)row * (size_t)mTarget.width; }
+
+        // clipped pixel bounds of a primitive; false when outside the target
+        bool clipBounds(double left, double bottom, double right, double top,
+                        int& ix0, int& iy0, int& ix1, int& iy1) const;
+        void markDirty(int ix0, int iy0, int ix1, int iy1);
+
+        RasterTarget       mTarget;
+        std::vector<float> mCoverage; // width * height, first row = y0; zero outside a layer
+        bool               mTouched = false;
+        int                mDirtyX0 = 0, mDirtyY0 = 0, mDirtyX1 = 0, mDirtyY1 = 0;
+    };
+
+    // Mask, gate border and guide of p into target (same layers as shadeGuidePixel()).
+    void rasterizeGuides(GuideRasterizer& raster, const RasterTarget& target, const GuideFieldParams& p);
+
+    // Layer stack groups (buildGuideLayerDraw()): fills, then lines, one raster layer per style.
+    void rasterizeGuideLayers(GuideRasterizer& raster, const RasterTarget& target, const GuideLayerDraw& layers);
+
+    // Annotation glyphs from glyphAtlas(): the shadow layer, then the text layer.
+    void rasterizeAnnotations(GuideRasterizer& raster, const RasterTarget& target,
+                              const AnnotationLayout& layout, const Rgba& color);
+}
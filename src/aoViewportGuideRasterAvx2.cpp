@@ -0,0 +1,102 @@
+// aoViewportGuideRasterAvx2.cpp (v0.3.1)
+// AVX2 coverage kernels (8 pixels). Built with -mavx2 / /arch:AVX2 and only
+// selected by rasterBestIsa() when the CPU reports AVX2.
+
+#include "aoViewportGuideRasterKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace AoViewportGuide
+{
+    namespace
+    {
+        struct F8
+        {
+            static constexpr int N = 8;
+            __m256 v;
+
+            F8() = default;
+            F8(float x) : v(_mm256_set1_ps(x)) {}
+            explicit F8(__m256 x) : v(x) {}
+
+            static F8 ramp(float start)
+            {
+                return F8(_mm256_add_ps(_mm256_set1_ps(start),
+                                        _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)));
+            }
+            static F8 load(const float* p) { return F8(_mm256_loadu_ps(p)); }
+            static void store(float* p, F8 a) { _mm256_storeu_ps(p, a.v); }
+
+            friend F8 operator+(F8 a, F8 b) { return F8(_mm256_add_ps(a.v, b.v)); }
+            friend F8 operator-(F8 a, F8 b) { return F8(_mm256_sub_ps(a.v, b.v)); }
+            friend F8 operator*(F8 a, F8 b) { return F8(_mm256_mul_ps(a.v, b.v)); }
+        };
+
+        struct M8
+        {
+            __m256 v;
+        };
+
+        inline F8 vmin(F8 a, F8 b) { return F8(_mm256_min_ps(a.v, b.v)); }
+        inline F8 vmax(F8 a, F8 b) { return F8(_mm256_max_ps(a.v, b.v)); }
+        inline F8 vsqrt(F8 a) { return F8(_mm256_sqrt_ps(a.v)); }
+        inline F8 vabs(F8 a) { return F8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)); }
+        inline F8 vclamp01(F8 a) { return vmin(vmax(a, F8(0.0f)), F8(1.0f)); }
+        inline M8 vcmpge(F8 a, F8 b) { return M8{ _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+        inline M8 vand(M8 a, M8 b) { return M8{ _mm256_and_ps(a.v, b.v) }; }
+        inline M8 vor(M8 a, M8 b) { return M8{ _mm256_or_ps(a.v, b.v) }; }
+        inline F8 vselect(M8 m, F8 a, F8 b) { return F8(_mm256_blendv_ps(b.v, a.v, m.v)); }
+
+        // two RGBA pixels per register; k is duplicated across each half
+        void blendAvx2(float* rgba, const float* cov, int n, const float color[4], float alpha)
+        {
+            const __m256 c = _mm256_setr_ps(color[0], color[1], color[2], color[3],
+                                            color[0], color[1], color[2], color[3]);
+            const __m256 a = _mm256_set1_ps(alpha);
+
+            int i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                if (cov[i] <= 0.0f && cov[i + 1] <= 0.0f) continue;
+
+                const __m256 k = _mm256_mul_ps(a, _mm256_setr_ps(cov[i], cov[i], cov[i], cov[i],
+                                                                 cov[i + 1], cov[i + 1], cov[i + 1], cov[i + 1]));
+                float* p = rgba + (size_t)i * 4;
+                const __m256 d = _mm256_loadu_ps(p);
+                _mm256_storeu_ps(p, _mm256_add_ps(d, _mm256_mul_ps(_mm256_sub_ps(c, d), k)));
+            }
+            for (; i < n; ++i)
+            {
+                const float k = alpha * cov[i];
+                if (k <= 0.0f) continue;
+                float* d = rgba + (size_t)i * 4;
+                d[0] += (color[0] - d[0]) * k;
+                d[1] += (color[1] - d[1]) * k;
+                d[2] += (color[2] - d[2]) * k;
+                d[3] += (color[3] - d[3]) * k;
+            }
+        }
+
+        const RasterKernels kAvx2Kernels = {
+            segmentRow<F8>, ringRow<F8>, arcRow<F8>, rectRow<F8>, blendAvx2
+        };
+    }
+
+    const RasterKernels* rasterKernelsAvx2()
+    {
+        return &kAvx2Kernels;
+    }
+}
+
+#else
+
+namespace AoViewportGuide
+{
+    const RasterKernels* rasterKernelsAvx2()
+    {
+        return nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,206 @@
+#pragma once
+// aoViewportGuideRasterKernels.h (v0.3.1)
+// Internal to aoViewportGuideRaster*.cpp. Row coverage kernels written once
+// against a small vector interface V (lanes, broadcast, load/store, math,
+// masks); each ISA translation unit supplies its own V and instantiates them.
+// Everything here has internal linkage so the AVX2 unit (built with -mavx2)
+// cannot leak its instantiations into the baseline code.
+
+#include <cmath>
+#include <cstddef>
+
+namespace AoViewportGuide
+{
+    struct SegmentShape
+    {
+        float ax, ay;
+        float bax, bay; // b - a
+        float invLen2;  // 1 / |b - a|^2, 0 for a point
+        float halfWidth;
+    };
+
+    struct RingShape
+    {
+        float cx, cy;
+        float radius;
+        float halfWidth;
+    };
+
+    struct ArcShape
+    {
+        float cx, cy;
+        float radius;
+        float halfWidth;
+        float u0x, u0y;  // unit start direction
+        float u1x, u1y;  // unit end direction
+        bool  major;     // sweep > pi
+    };
+
+    struct RectShape
+    {
+        float left, right; // x extent; the row's y coverage is passed separately
+    };
+
+    // px0: x of the first pixel center. cov[i] = max(cov[i], coverage)
+    struct RasterKernels
+    {
+        void (*segment)(float* cov, int n, float px0, float py, const SegmentShape& s);
+        void (*ring)(float* cov, int n, float px0, float py, const RingShape& s);
+        void (*arc)(float* cov, int n, float px0, float py, const ArcShape& s);
+        void (*rect)(float* cov, int n, float px0, float rowCoverage, const RectShape& s);
+
+        // rgba[i] = rgba[i] + (color - rgba[i]) * alpha * cov[i], color alpha lane = 1
+        void (*blend)(float* rgba, const float* cov, int n, const float color[4], float alpha);
+    };
+
+    const RasterKernels* rasterKernelsScalar();
+    const RasterKernels* rasterKernelsSse2(); // nullptr when not built
+    const RasterKernels* rasterKernelsAvx2(); // nullptr when not built
+
+    namespace
+    {
+        // 1-lane vector shared by every ISA for row tails (and the scalar kernels)
+        struct F1
+        {
+            static constexpr int N = 1;
+            float v;
+
+            F1() = default;
+            F1(float x) : v(x) {}
+
+            static F1 ramp(float start) { return F1(start); }
+            static F1 load(const float* p) { return F1(*p); }
+            static void store(float* p, F1 a) { *p = a.v; }
+
+            friend F1 operator+(F1 a, F1 b) { return F1(a.v + b.v); }
+            friend F1 operator-(F1 a, F1 b) { return F1(a.v - b.v); }
+            friend F1 operator*(F1 a, F1 b) { return F1(a.v * b.v); }
+        };
+
+        inline F1 vmin(F1 a, F1 b) { return F1(a.v < b.v ? a.v : b.v); }
+        inline F1 vmax(F1 a, F1 b) { return F1(a.v > b.v ? a.v : b.v); }
+        inline F1 vsqrt(F1 a) { return F1(std::sqrt(a.v)); }
+        inline F1 vabs(F1 a) { return F1(a.v < 0.0f ? -a.v : a.v); }
+        inline F1 vclamp01(F1 a) { return vmin(vmax(a, F1(0.0f)), F1(1.0f)); }
+        inline bool vcmpge(F1 a, F1 b) { return a.v >= b.v; }
+        inline bool vand(bool a, bool b) { return a && b; }
+        inline bool vor(bool a, bool b) { return a || b; }
+        inline F1 vselect(bool m, F1 a, F1 b) { return m ? a : b; }
+
+        // coverage of a stroke at distance d: clamp(0.5 * width + 0.5 - d, 0, 1)
+        template <class V>
+        inline V strokeCoverage(V d, V halfWidth)
+        {
+            return vclamp01(halfWidth + V(0.5f) - d);
+        }
+
+        template <class V>
+        inline V segmentCoverage(V px, V py, const SegmentShape& s)
+        {
+            const V pax = px - V(s.ax);
+            const V pay = py - V(s.ay);
+            const V bax(s.bax), bay(s.bay);
+            const V h  = vclamp01((pax * bax + pay * bay) * V(s.invLen2));
+            const V dx = pax - bax * h;
+            const V dy = pay - bay * h;
+            return strokeCoverage(vsqrt(dx * dx + dy * dy), V(s.halfWidth));
+        }
+
+        template <class V>
+        inline V ringCoverage(V px, V py, const RingShape& s)
+        {
+            const V dx = px - V(s.cx);
+            const V dy = py - V(s.cy);
+            const V d  = vabs(vsqrt(dx * dx + dy * dy) - V(s.radius));
+            return strokeCoverage(d, V(s.halfWidth));
+        }
+
+        template <class V>
+        inline V arcCoverage(V px, V py, const ArcShape& s)
+        {
+            const V vx = px - V(s.cx);
+            const V vy = py - V(s.cy);
+
+            // inside the sweep: cross(u0, v) >= 0 and cross(v, u1) >= 0 (or either, past pi)
+            const V c0 = V(s.u0x) * vy - V(s.u0y) * vx;
+            const V c1 = vx * V(s.u1y) - vy * V(s.u1x);
+            const auto in0 = vcmpge(c0, V(0.0f));
+            const auto in1 = vcmpge(c1, V(0.0f));
+            const auto inside = s.major ? vor(in0, in1) : vand(in0, in1);
+
+            const V r(s.radius);
+            const V dRing = vabs(vsqrt(vx * vx + vy * vy) - r);
+
+            const V e0x = vx - V(s.u0x) * r, e0y = vy - V(s.u0y) * r;
+            const V e1x = vx - V(s.u1x) * r, e1y = vy - V(s.u1y) * r;
+            const V dEnd = vsqrt(vmin(e0x * e0x + e0y * e0y, e1x * e1x + e1y * e1y));
+
+            return strokeCoverage(vselect(inside, dRing, dEnd), V(s.halfWidth));
+        }
+
+        template <class V>
+        inline V rectCoverage(V px, const RectShape& s)
+        {
+            const V a = px + V(0.5f) - V(s.left);
+            const V b = V(s.right) - px + V(0.5f);
+            return vclamp01(vmin(a, b));
+        }
+
+        // Runs fn(px) over n pixels, V::N at a time, then the tail one lane at a time.
+        template <class V, class Fn>
+        inline void forRow(float* cov, int n, float px0, Fn fn)
+        {
+            int i = 0;
+            for (; i + V::N <= n; i += V::N)
+            {
+                const V px = V::ramp(px0 + (float)i);
+                V::store(cov + i, vmax(V::load(cov + i), fn(px)));
+            }
+            for (; i < n; ++i)
+            {
+                const F1 px(px0 + (float)i);
+                F1::store(cov + i, vmax(F1::load(cov + i), fn(px)));
+            }
+        }
+
+        template <class V>
+        void segmentRow(float* cov, int n, float px0, float py, const SegmentShape& s)
+        {
+            forRow<V>(cov, n, px0, [&](auto px)
+            {
+                using T = decltype(px);
+                return segmentCoverage(px, T(py), s);
+            });
+        }
+
+        template <class V>
+        void ringRow(float* cov, int n, float px0, float py, const RingShape& s)
+        {
+            forRow<V>(cov, n, px0, [&](auto px)
+            {
+                using T = decltype(px);
+                return ringCoverage(px, T(py), s);
+            });
+        }
+
+        template <class V>
+        void arcRow(float* cov, int n, float px0, float py, const ArcShape& s)
+        {
+            forRow<V>(cov, n, px0, [&](auto px)
+            {
+                using T = decltype(px);
+                return arcCoverage(px, T(py), s);
+            });
+        }
+
+        template <class V>
+        void rectRow(float* cov, int n, float px0, float rowCoverage, const RectShape& s)
+        {
+            forRow<V>(cov, n, px0, [&](auto px)
+            {
+                using T = decltype(px);
+                return rectCoverage(px, s) * T(rowCoverage);
+            });
+        }
+    }
+}
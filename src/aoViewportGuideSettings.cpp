@@ -1,30 +1,174 @@
 // aoViewportGuideSettings.cpp (v0.3.1)
 
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideBindings.h"
 #include "aoViewportGuideCommon.h"
 #include "aoViewportGuideSettings.h"
+#include "aoViewportGuideShapes.h"
+#include "aoViewportGuideTimeline.h"
 
 #include <maya/MPxNode.h>
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnEnumAttribute.h>
+#include <maya/MFnCompoundAttribute.h>
+#include <maya/MFnTypedAttribute.h>
 #include <maya/MFnDependencyNode.h>
-#include <maya/MSelectionList.h>
+#include <maya/MItDependencyNodes.h>
+#include <maya/MDGModifier.h>
 #include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MPlug.h>
-#include <maya/MGlobal.h>
+#include <maya/MNodeMessage.h>
+#include <maya/MDGMessage.h>
+#include <maya/MSceneMessage.h>
+#include <maya/MCallbackIdArray.h>
+#include <maya/MEventMessage.h>
+#include <maya/MSelectionList.h>
+#include <maya/MDagPath.h>
+#include <maya/MAnimControl.h>
+#include <maya/MAnimMessage.h>
+#include <maya/MFnAnimCurve.h>
+#include <maya/MDGContext.h>
+#include <maya/MDGContextGuard.h>
+#include <maya/MObjectArray.h>
+#include <maya/MPlugArray.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace AoViewportGuide
 {
     MTypeId AoViewportGuideSettingsNode::id(0x0013A0F2);
 
+    struct PublishedSettings
+    {
+        PackedSettings packed;
+        uint64_t       hash;
+        uint64_t       shapeHash;
+    };
+
+    // One settings node as the draw callbacks see it. Variant 0 is the default
+    // node; the others are nodes with camera / shot bindings, in name order.
+    struct SettingsVariant
+    {
+        MObjectHandle                     node;
+        SnapshotBuffer<PublishedSettings> buffer;       // written by callbacks, read by draw callbacks
+        PublishedSettings                 last;         // main thread only: last values handed to buffer
+        bool                              hasPublished = false;
+
+        // bakePlayback: values of every frame of the playback range (main thread only)
+        SettingsTimeline                  timeline;
+        bool                              bake = false;
+    };
+
+    // kept up to date by scene / node callbacks
+    static SettingsVariant gVariants[kMaxSettingsVariants];
+    static int gVariantCount = 1;
+
+    // variant of each bound camera at the current time; only read while gBindingsActive
+    static SnapshotBuffer<BindingState> gBindingBuffer;
+    static std::atomic<bool>            gBindingsActive{ false };
+
+    // camera shape -> cameraBindingKey(). hashCode() only buckets: two cameras can
+    // share it, so the handle decides, and keys count up and are never reused.
+    struct CameraKeyEntry
+    {
+        unsigned int  hash = 0;
+        MObjectHandle camera;
+        uint64_t      key = 0;
+    };
+    static std::mutex                  gCameraKeyMutex; // setup(), binding rebuilds and subscene updates
+    static std::vector<CameraKeyEntry> gCameraKeys;
+    static uint64_t                    gNextCameraKey = 1;
+
+    // main thread only: what the bound variants are bound to, and the shot ranges
+    static VariantBindings   gBindings;
+    static ShotIntervalIndex gShotIndex;
+    static size_t            gShotCursor = 0;
+    static BindingState      gLastBindingState;
+
+    // shot nodes named by bindShots; the index follows their frame range edits
+    struct ShotWatch
+    {
+        MObjectHandle shot;
+        MCallbackId   callbackId = 0;
+        uint64_t      id = 0;
+        VariantMask   variants = 0;
+    };
+    static std::vector<ShotWatch> gShotWatches;
+
+    // animCurves driving baked nodes; a key edit re-bakes only the frames it can change
+    struct CurveWatch
+    {
+        MObjectHandle curve;
+        VariantMask   variants = 0;
+        CurveKeys     keys;
+    };
+    static std::vector<CurveWatch> gCurveWatches;
+
+    // idle callback baking frames while any are missing; 0 when all are baked
+    static MCallbackId gBakeIdleId = 0;
+
+    static constexpr int      kMaxBakeFrames    = 20000;
+    static constexpr uint64_t kBakeIdleBudgetNs = 4000000; // per idle event
+    static constexpr uint64_t kBakeAheadBudgetNs = 500000; // per frame while playing
+
+    // one-shot idle callback behind requestPublish(); 0 when none is pending
+    static MCallbackId gIdlePublishId = 0;
+    static bool        gRebuildPending = false;
+
+    // number of incoming connections (animCurves, expressions, ...) over all settings nodes
+    static int gConnectedInputs = 0;
+
+    static MCallbackIdArray gCallbackIds;
+
+    // set while commitWrite() runs a modifier: one publish afterwards instead of one per plug
+    static bool gBatchWrite = false;
+
+    static void publishSettingsNode(const MObject& node);
+    static void invalidateBakedNode(const MObject& node);
+    static void requestRebuild();
+
     class AoViewportGuideSettingsNodeImpl : public MPxNode
     {
     public:
         static void* creator() { return new AoViewportGuideSettingsNodeImpl(); }
         static MStatus initialize();
 
+        ~AoViewportGuideSettingsNodeImpl() override
+        {
+            if (mCallbackIds.length() > 0)
+                MMessage::removeCallbacks(mCallbackIds);
+
+            gConnectedInputs -= mConnectedInputs;
+            AoViewportGuideSettings::requestPublish();
+        }
+
+        void postConstructor() override
+        {
+            MObject self = thisMObject();
+            mCallbackIds.append(MNodeMessage::addAttributeChangedCallback(self, attributeChangedCB, this));
+            mCallbackIds.append(MNodeMessage::addNodeDirtyPlugCallback(self, nodeDirtyPlugCB, this));
+            mCallbackIds.append(MNodeMessage::addNameChangedCallback(self, nameChangedCB, this));
+
+            AoViewportGuideSettings::requestPublish();
+        }
+
         static MObject aEnable;
         static MObject aFollowResolutionGate;
         static MObject aGuideType;
+        static MObject aGoldenRotation;
+        static MObject aGoldenFlipH;
+        static MObject aGoldenFlipV;
+        static MObject aDrawBackend;
+        static MObject aPipeline;
 
         static MObject aLineOpacity;
         static MObject aLineThickness;
@@ -35,13 +179,104 @@ namespace AoViewportGuide
         static MObject aGateBorderThickness;
         static MObject aGateBorderColor;
 
+        static MObject aMaskEnable;
+        static MObject aMaskOpacity;
+        static MObject aMaskColor;
+
         static MObject aBgEnable;
         static MObject aBgColor;
+
+        // guideLayers[]: compound array, one element per layer
+        static MObject aGuideLayers;
+        static MObject aLayerEnable;
+        static MObject aLayerType;
+        static MObject aLayerColumns;
+        static MObject aLayerRows;
+        static MObject aLayerSafeAction;
+        static MObject aLayerSafeTitle;
+        static MObject aLayerMaskRatio;
+        static MObject aLayerColor;
+        static MObject aLayerOpacity;
+        static MObject aLayerThickness;
+        static MObject aLayerShape;
+
+        // HUD overlay quality while interacting
+        static MObject aAdaptiveQuality;
+        static MObject aQualityBudget;
+        static MObject aQualityFloor;
+
+        // text at the gate corners
+        static MObject aAnnotateCamera;
+        static MObject aAnnotateFocalLength;
+        static MObject aAnnotateResolution;
+        static MObject aAnnotateAspect;
+        static MObject aAnnotateFrame;
+        static MObject aAnnotationScale;
+        static MObject aAnnotationOpacity;
+        static MObject aAnnotationColor;
+
+        // camera / shot names or patterns, separated by spaces or commas
+        static MObject aBindCameras;
+        static MObject aBindShots;
+
+        static MObject aBakePlayback;
+
+    private:
+        static void attributeChangedCB(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug&, void* clientData)
+        {
+            auto* node = static_cast<AoViewportGuideSettingsNodeImpl*>(clientData);
+            if (msg & MNodeMessage::kIncomingDirection)
+            {
+                if (msg & MNodeMessage::kConnectionMade)   { ++node->mConnectedInputs; ++gConnectedInputs; }
+                if (msg & MNodeMessage::kConnectionBroken) { --node->mConnectedInputs; --gConnectedInputs; }
+            }
+
+            const MObject attr = plug.attribute();
+            if (attr == aBindCameras || attr == aBindShots || attr == aBakePlayback)
+            {
+                requestRebuild();
+                return;
+            }
+
+            // values are final once set; connections change what the plugs evaluate to
+            const bool connection = (msg & (MNodeMessage::kConnectionMade | MNodeMessage::kConnectionBroken)) != 0;
+            if (connection || (msg & MNodeMessage::kAttributeSet))
+            {
+                if (gBatchWrite && !connection) return;
+
+                // a set value holds on every baked frame; a new input changes what can be baked
+                if (connection) requestRebuild();
+                else            invalidateBakedNode(node->thisMObject());
+                publishSettingsNode(node->thisMObject());
+            }
+            else
+                AoViewportGuideSettings::requestPublish();
+        }
+
+        static void nodeDirtyPlugCB(MObject&, MPlug&, void*)
+        {
+            // reading plugs during dirty propagation would pull evaluation into it
+            AoViewportGuideSettings::requestPublish();
+        }
+
+        static void nameChangedCB(MObject&, const MString&, void*)
+        {
+            // the name takes part in picking the active node
+            AoViewportGuideSettings::resolveNode();
+        }
+
+        MCallbackIdArray mCallbackIds;
+        int mConnectedInputs = 0;
     };
 
     MObject AoViewportGuideSettingsNodeImpl::aEnable;
     MObject AoViewportGuideSettingsNodeImpl::aFollowResolutionGate;
     MObject AoViewportGuideSettingsNodeImpl::aGuideType;
+    MObject AoViewportGuideSettingsNodeImpl::aGoldenRotation;
+    MObject AoViewportGuideSettingsNodeImpl::aGoldenFlipH;
+    MObject AoViewportGuideSettingsNodeImpl::aGoldenFlipV;
+    MObject AoViewportGuideSettingsNodeImpl::aDrawBackend;
+    MObject AoViewportGuideSettingsNodeImpl::aPipeline;
 
     MObject AoViewportGuideSettingsNodeImpl::aLineOpacity;
     MObject AoViewportGuideSettingsNodeImpl::aLineThickness;
@@ -52,9 +287,43 @@ namespace AoViewportGuide
     MObject AoViewportGuideSettingsNodeImpl::aGateBorderThickness;
     MObject AoViewportGuideSettingsNodeImpl::aGateBorderColor;
 
+    MObject AoViewportGuideSettingsNodeImpl::aMaskEnable;
+    MObject AoViewportGuideSettingsNodeImpl::aMaskOpacity;
+    MObject AoViewportGuideSettingsNodeImpl::aMaskColor;
+
     MObject AoViewportGuideSettingsNodeImpl::aBgEnable;
     MObject AoViewportGuideSettingsNodeImpl::aBgColor;
 
+    MObject AoViewportGuideSettingsNodeImpl::aGuideLayers;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerEnable;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerType;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerColumns;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerRows;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerSafeAction;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerSafeTitle;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerMaskRatio;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerColor;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerOpacity;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerThickness;
+    MObject AoViewportGuideSettingsNodeImpl::aLayerShape;
+
+    MObject AoViewportGuideSettingsNodeImpl::aAdaptiveQuality;
+    MObject AoViewportGuideSettingsNodeImpl::aQualityBudget;
+    MObject AoViewportGuideSettingsNodeImpl::aQualityFloor;
+
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotateCamera;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotateFocalLength;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotateResolution;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotateAspect;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotateFrame;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotationScale;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotationOpacity;
+    MObject AoViewportGuideSettingsNodeImpl::aAnnotationColor;
+
+    MObject AoViewportGuideSettingsNodeImpl::aBindCameras;
+    MObject AoViewportGuideSettingsNodeImpl::aBindShots;
+    MObject AoViewportGuideSettingsNodeImpl::aBakePlayback;
+
     MStatus AoViewportGuideSettingsNodeImpl::initialize()
     {
         MStatus s;
@@ -73,9 +342,40 @@ namespace AoViewportGuide
         eAttr.addField("Thirds (3x3)", 0);
         eAttr.addField("Cross", 1);
         eAttr.addField("Circle", 2);
+        eAttr.addField("Phi Grid", kGuidePhiGrid);
+        eAttr.addField("Golden Spiral", kGuideGoldenSpiral);
         eAttr.setKeyable(true); eAttr.setStorable(true); eAttr.setChannelBox(true);
         addAttribute(aGuideType);
 
+        aGoldenRotation = eAttr.create("goldenRotation", "gro", 0, &s);
+        eAttr.addField("0", 0);
+        eAttr.addField("90", 1);
+        eAttr.addField("180", 2);
+        eAttr.addField("270", 3);
+        eAttr.setKeyable(true); eAttr.setStorable(true); eAttr.setChannelBox(true);
+        addAttribute(aGoldenRotation);
+
+        aGoldenFlipH = nAttr.create("goldenFlipH", "gfh", MFnNumericData::kBoolean, false, &s);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aGoldenFlipH);
+
+        aGoldenFlipV = nAttr.create("goldenFlipV", "gfv", MFnNumericData::kBoolean, false, &s);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aGoldenFlipV);
+
+        aDrawBackend = eAttr.create("drawBackend", "dbk", kDrawBackendHud, &s);
+        eAttr.addField("HUD (immediate)", kDrawBackendHud);
+        eAttr.addField("Cached (subscene)", kDrawBackendCached);
+        eAttr.addField("Shader (full screen)", kDrawBackendShader);
+        eAttr.setKeyable(false); eAttr.setStorable(true); eAttr.setChannelBox(true);
+        addAttribute(aDrawBackend);
+
+        aPipeline = eAttr.create("pipeline", "ppl", kPipelineReplace, &s);
+        eAttr.addField("Replace (own scene pass)", kPipelineReplace);
+        eAttr.addField("Standard + guides", kPipelineStandard);
+        eAttr.setKeyable(false); eAttr.setStorable(true); eAttr.setChannelBox(true);
+        addAttribute(aPipeline);
+
         aLineOpacity = nAttr.create("lineOpacity", "lop", MFnNumericData::kFloat, 1.0f, &s);
         nAttr.setMin(0.0f); nAttr.setMax(1.0f);
         nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
@@ -110,6 +410,20 @@ namespace AoViewportGuide
         nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
         addAttribute(aGateBorderColor);
 
+        aMaskEnable = nAttr.create("maskEnable", "mke", MFnNumericData::kBoolean, false, &s);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aMaskEnable);
+
+        aMaskOpacity = nAttr.create("maskOpacity", "mko", MFnNumericData::kFloat, 0.5f, &s);
+        nAttr.setMin(0.0f); nAttr.setMax(1.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aMaskOpacity);
+
+        aMaskColor = nAttr.createColor("maskColor", "mkc", &s);
+        nAttr.setDefault(0.0f, 0.0f, 0.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aMaskColor);
+
         aBgEnable = nAttr.create("bgEnable", "bge", MFnNumericData::kBoolean, false, &s);
         nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
         addAttribute(aBgEnable);
@@ -119,104 +433,1187 @@ namespace AoViewportGuide
         nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
         addAttribute(aBgColor);
 
+        aAdaptiveQuality = nAttr.create("adaptiveQuality", "aqy", MFnNumericData::kBoolean, true, &s);
+        nAttr.setKeyable(false); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aAdaptiveQuality);
+
+        aQualityBudget = nAttr.create("qualityBudget", "qbu", MFnNumericData::kFloat, 0.5f, &s);
+        nAttr.setMin(0.01f); nAttr.setSoftMax(5.0f); nAttr.setMax(100.0f);
+        nAttr.setKeyable(false); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aQualityBudget);
+
+        aQualityFloor = eAttr.create("qualityFloor", "qfl", kQualityDraft, &s);
+        eAttr.addField("Full", kQualityFull);
+        eAttr.addField("High", kQualityHigh);
+        eAttr.addField("Medium", kQualityMedium);
+        eAttr.addField("Draft", kQualityDraft);
+        eAttr.setKeyable(false); eAttr.setStorable(true); eAttr.setChannelBox(true);
+        addAttribute(aQualityFloor);
+
+        const struct { MObject* attr; const char* name; const char* shortName; } annotate[] = {
+            { &aAnnotateCamera,      "annotateCamera",      "atc" },
+            { &aAnnotateFocalLength, "annotateFocalLength", "atf" },
+            { &aAnnotateResolution,  "annotateResolution",  "atr" },
+            { &aAnnotateAspect,      "annotateAspect",      "ata" },
+            { &aAnnotateFrame,       "annotateFrame",       "atfr" },
+        };
+        for (const auto& a : annotate)
+        {
+            *a.attr = nAttr.create(a.name, a.shortName, MFnNumericData::kBoolean, false, &s);
+            nAttr.setKeyable(false); nAttr.setStorable(true); nAttr.setChannelBox(true);
+            addAttribute(*a.attr);
+        }
+
+        aAnnotationScale = nAttr.create("annotationScale", "ats", MFnNumericData::kShort, 2, &s);
+        nAttr.setMin(1); nAttr.setMax(8);
+        nAttr.setKeyable(false); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aAnnotationScale);
+
+        aAnnotationOpacity = nAttr.create("annotationOpacity", "ato", MFnNumericData::kFloat, 0.8f, &s);
+        nAttr.setMin(0.0f); nAttr.setMax(1.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aAnnotationOpacity);
+
+        aAnnotationColor = nAttr.createColor("annotationColor", "atcl", &s);
+        nAttr.setDefault(1.0f, 1.0f, 1.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true); nAttr.setChannelBox(true);
+        addAttribute(aAnnotationColor);
+
+        // layer stack (defaults match addGuideLayer())
+        aLayerEnable = nAttr.create("layerEnable", "lye", MFnNumericData::kBoolean, true, &s);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerType = eAttr.create("layerType", "lyt", kLayerGrid, &s);
+        eAttr.addField("Thirds (3x3)", kLayerThirds);
+        eAttr.addField("Cross", kLayerCross);
+        eAttr.addField("Circle", kLayerCircle);
+        eAttr.addField("Grid", kLayerGrid);
+        eAttr.addField("Safe Area", kLayerSafeArea);
+        eAttr.addField("Aspect Mask", kLayerAspectMask);
+        eAttr.addField("Shape", kLayerShape);
+        eAttr.setKeyable(true); eAttr.setStorable(true);
+
+        aLayerColumns = nAttr.create("layerColumns", "lyc", MFnNumericData::kShort, 4, &s);
+        nAttr.setMin(1); nAttr.setMax(kMaxGridCells);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerRows = nAttr.create("layerRows", "lyr", MFnNumericData::kShort, 4, &s);
+        nAttr.setMin(1); nAttr.setMax(kMaxGridCells);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerSafeAction = nAttr.create("layerSafeAction", "lysa", MFnNumericData::kFloat, 90.0f, &s);
+        nAttr.setMin(0.0f); nAttr.setMax(100.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerSafeTitle = nAttr.create("layerSafeTitle", "lyst", MFnNumericData::kFloat, 80.0f, &s);
+        nAttr.setMin(0.0f); nAttr.setMax(100.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerMaskRatio = nAttr.create("layerMaskRatio", "lymr", MFnNumericData::kFloat, 2.39f, &s);
+        nAttr.setMin(0.1f); nAttr.setMax(10.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerColor = nAttr.createColor("layerColor", "lycl", &s);
+        nAttr.setDefault(1.0f, 1.0f, 1.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerOpacity = nAttr.create("layerOpacity", "lyo", MFnNumericData::kFloat, 0.5f, &s);
+        nAttr.setMin(0.0f); nAttr.setMax(1.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        aLayerThickness = nAttr.create("layerThickness", "lyth", MFnNumericData::kFloat, 1.0f, &s);
+        nAttr.setMin(0.5f); nAttr.setMax(50.0f);
+        nAttr.setKeyable(true); nAttr.setStorable(true);
+
+        // shape layers: name of a shape in the shape library (aoViewportGuideShapes)
+        MFnTypedAttribute tAttr;
+        aLayerShape = tAttr.create("layerShape", "lysh", MFnData::kString, &s);
+        tAttr.setStorable(true);
+
+        MFnCompoundAttribute cAttr;
+        aGuideLayers = cAttr.create("guideLayers", "gly", &s);
+        cAttr.addChild(aLayerEnable);
+        cAttr.addChild(aLayerType);
+        cAttr.addChild(aLayerColumns);
+        cAttr.addChild(aLayerRows);
+        cAttr.addChild(aLayerSafeAction);
+        cAttr.addChild(aLayerSafeTitle);
+        cAttr.addChild(aLayerMaskRatio);
+        cAttr.addChild(aLayerColor);
+        cAttr.addChild(aLayerOpacity);
+        cAttr.addChild(aLayerThickness);
+        cAttr.addChild(aLayerShape);
+        cAttr.setArray(true);
+        cAttr.setUsesArrayDataBuilder(true);
+        cAttr.setStorable(true);
+        addAttribute(aGuideLayers);
+
+        aBindCameras = tAttr.create("bindCameras", "bcm", MFnData::kString, &s);
+        tAttr.setStorable(true);
+        addAttribute(aBindCameras);
+
+        aBindShots = tAttr.create("bindShots", "bsh", MFnData::kString, &s);
+        tAttr.setStorable(true);
+        addAttribute(aBindShots);
+
+        aBakePlayback = nAttr.create("bakePlayback", "bkp", MFnNumericData::kBoolean, false, &s);
+        nAttr.setKeyable(false); nAttr.setStorable(true); nAttr.setChannelBox(false);
+        addAttribute(aBakePlayback);
+
         return MS::kSuccess;
     }
 
-    static bool getNodeByName(const char* name, MObject& outObj)
+    static MString bindingString(const MObject& node, const MObject& attr)
     {
-        MSelectionList sl;
-        if (sl.add(name) != MS::kSuccess) return false;
-        if (sl.getDependNode(0, outObj) != MS::kSuccess) return false;
-        return !outObj.isNull();
+        MPlug p(node, attr);
+        return p.isNull() ? MString() : p.asString();
     }
 
-    bool AoViewportGuideSettings::ensureNodeExists()
+    static bool hasBindings(const MObject& node)
     {
-        MObject obj;
-        if (getNodeByName(kSettingsNodeName, obj))
-            return true;
+        using Impl = AoViewportGuideSettingsNodeImpl;
+        return bindingString(node, Impl::aBindCameras).length() > 0 ||
+               bindingString(node, Impl::aBindShots).length() > 0;
+    }
+
+    // Deterministic pick of the default node when several settings nodes exist:
+    //   1. nodes without camera / shot bindings
+    //   2. the node named kSettingsNodeName
+    //   3. nodes from the current file before referenced ones
+    //   4. lowest name (byte order)
+    static bool isBetterCandidate(const MFnDependencyNode& a, const MFnDependencyNode& b)
+    {
+        const bool aBound = hasBindings(a.object());
+        const bool bBound = hasBindings(b.object());
+        if (aBound != bBound) return !aBound;
+
+        const MString aName = a.name();
+        const MString bName = b.name();
+
+        const bool aExact = (aName == kSettingsNodeName);
+        const bool bExact = (bName == kSettingsNodeName);
+        if (aExact != bExact) return aExact;
 
-        MString cmd;
-        cmd += "if (!`objExists \"";
-        cmd += kSettingsNodeName;
-        cmd += "\"`) {";
-        cmd += "string $n = `createNode ";
-        cmd += kSettingsNodeTypeName;
-        cmd += "`; ";
-        cmd += "rename $n \"";
-        cmd += kSettingsNodeName;
-        cmd += "\"; }";
+        const bool aRef = a.isFromReferencedFile();
+        const bool bRef = b.isFromReferencedFile();
+        if (aRef != bRef) return !aRef;
 
-        return (MGlobal::executeCommand(cmd, false, false) == MS::kSuccess);
+        return std::strcmp(aName.asChar(), bName.asChar()) < 0;
     }
 
-    SettingsData AoViewportGuideSettings::read()
+    static MObject findSettingsNode(const MObject& exclude)
+    {
+        MObject best;
+        MFnDependencyNode bestFn;
+
+        for (MItDependencyNodes it(MFn::kPluginDependNode); !it.isDone(); it.next())
+        {
+            MObject obj = it.thisNode();
+            if (obj == exclude) continue;
+
+            MFnDependencyNode fn(obj);
+            if (fn.typeId() != AoViewportGuideSettingsNode::id) continue;
+
+            if (best.isNull() || isBetterCandidate(fn, bestFn))
+            {
+                best = obj;
+                bestFn.setObject(best);
+            }
+        }
+        return best;
+    }
+
+    static SettingsData readNode(const MObjectHandle& node)
     {
         SettingsData s;
 
-        MObject obj;
-        if (!getNodeByName(kSettingsNodeName, obj))
+        if (!node.isValid())
             return s;
 
-        MFnDependencyNode fn(obj);
+        const MObject obj = node.object();
+
+        using Impl = AoViewportGuideSettingsNodeImpl;
 
-        auto getBool = [&](const char* attr, bool& out)
+        auto getBool = [&](const MObject& attr, bool& out)
         {
-            MPlug p = fn.findPlug(attr, true);
+            MPlug p(obj, attr);
             if (!p.isNull()) out = p.asBool();
         };
-        auto getInt = [&](const char* attr, int& out)
+        auto getInt = [&](const MObject& attr, int& out)
         {
-            MPlug p = fn.findPlug(attr, true);
+            MPlug p(obj, attr);
             if (!p.isNull()) out = p.asInt();
         };
-        auto getFloat = [&](const char* attr, float& out)
+        auto getFloat = [&](const MObject& attr, float& out)
         {
-            MPlug p = fn.findPlug(attr, true);
+            MPlug p(obj, attr);
             if (!p.isNull()) out = p.asFloat();
         };
-        auto getColor = [&](const char* attr, MColor& out)
+        auto getColor = [&](const MObject& attr, Rgba& out)
         {
-            MPlug p = fn.findPlug(attr, true);
+            MPlug p(obj, attr);
             if (!p.isNull() && p.numChildren() >= 3)
             {
-                out = MColor(
+                out = Rgba{
                     p.child(0).asFloat(),
                     p.child(1).asFloat(),
                     p.child(2).asFloat(),
                     1.0f
-                );
+                };
             }
         };
 
-        getBool("enable", s.enable);
-        getBool("followResolutionGate", s.followResolutionGate);
-        getInt ("guideType", s.guideType);
+        getBool(Impl::aEnable, s.enable);
+        getBool(Impl::aFollowResolutionGate, s.followResolutionGate);
+        getInt (Impl::aGuideType, s.guideType);
+        getInt (Impl::aGoldenRotation, s.goldenRotation);
+        getBool(Impl::aGoldenFlipH, s.goldenFlipH);
+        getBool(Impl::aGoldenFlipV, s.goldenFlipV);
+        getInt (Impl::aDrawBackend, s.drawBackend);
+        getInt (Impl::aPipeline, s.pipeline);
+
+        getFloat(Impl::aLineOpacity, s.lineOpacity);
+        getFloat(Impl::aLineThickness, s.lineThickness);
+        getColor(Impl::aLineColor, s.lineColor);
+
+        getBool (Impl::aGateBorderEnable, s.gateBorderEnable);
+        getFloat(Impl::aGateBorderOpacity, s.gateBorderOpacity);
+        getFloat(Impl::aGateBorderThickness, s.gateBorderThickness);
+        getColor(Impl::aGateBorderColor, s.gateBorderColor);
+
+        getBool (Impl::aMaskEnable, s.maskEnable);
+        getFloat(Impl::aMaskOpacity, s.maskOpacity);
+        getColor(Impl::aMaskColor, s.maskColor);
 
-        getFloat("lineOpacity", s.lineOpacity);
-        getFloat("lineThickness", s.lineThickness);
-        getColor("lineColor", s.lineColor);
+        getBool (Impl::aBgEnable, s.bgEnable);
+        getColor(Impl::aBgColor, s.bgColor);
 
-        getBool ("gateBorderEnable", s.gateBorderEnable);
-        getFloat("gateBorderOpacity", s.gateBorderOpacity);
-        getFloat("gateBorderThickness", s.gateBorderThickness);
-        getColor("gateBorderColor", s.gateBorderColor);
+        getBool (Impl::aAdaptiveQuality, s.adaptiveQuality);
+        getFloat(Impl::aQualityBudget, s.qualityBudget);
+        getInt  (Impl::aQualityFloor, s.qualityFloor);
 
-        getBool ("bgEnable", s.bgEnable);
-        getColor("bgColor", s.bgColor);
+        const struct { const MObject* attr; unsigned int bit; } annotate[] = {
+            { &Impl::aAnnotateCamera,      kAnnotateCamera },
+            { &Impl::aAnnotateFocalLength, kAnnotateFocalLength },
+            { &Impl::aAnnotateResolution,  kAnnotateResolution },
+            { &Impl::aAnnotateAspect,      kAnnotateAspect },
+            { &Impl::aAnnotateFrame,       kAnnotateFrame },
+        };
+        for (const auto& a : annotate)
+        {
+            bool on = false;
+            getBool(*a.attr, on);
+            if (on) s.annotations |= a.bit;
+        }
+        getInt  (Impl::aAnnotationScale, s.annotationScale);
+        getFloat(Impl::aAnnotationOpacity, s.annotationOpacity);
+        getColor(Impl::aAnnotationColor, s.annotationColor);
+
+        // enabled guideLayers elements in index order, up to kMaxGuideLayers
+        MPlug layers(obj, Impl::aGuideLayers);
+        const unsigned int n = layers.isNull() ? 0u : layers.numElements();
+        for (unsigned int e = 0; e < n && s.layers.count < kMaxGuideLayers; ++e)
+        {
+            const MPlug layer = layers.elementByPhysicalIndex(e);
+            if (!layer.child(Impl::aLayerEnable).asBool()) continue;
 
-        s.lineOpacity       = clampf(s.lineOpacity, 0.0f, 1.0f);
-        s.gateBorderOpacity = clampf(s.gateBorderOpacity, 0.0f, 1.0f);
+            const int i = addGuideLayer(s.layers, layer.child(Impl::aLayerType).asInt());
+            if (i < 0) continue;
 
-        s.lineThickness       = clampf(s.lineThickness, 0.5f, 50.0f);
-        s.gateBorderThickness = clampf(s.gateBorderThickness, 0.5f, 50.0f);
+            const MPlug color = layer.child(Impl::aLayerColor);
+            s.layers.colorR[i]     = color.child(0).asFloat();
+            s.layers.colorG[i]     = color.child(1).asFloat();
+            s.layers.colorB[i]     = color.child(2).asFloat();
+            s.layers.opacity[i]    = layer.child(Impl::aLayerOpacity).asFloat();
+            s.layers.thickness[i]  = layer.child(Impl::aLayerThickness).asFloat();
+            s.layers.safeAction[i] = layer.child(Impl::aLayerSafeAction).asFloat();
+            s.layers.safeTitle[i]  = layer.child(Impl::aLayerSafeTitle).asFloat();
+            s.layers.maskRatio[i]  = layer.child(Impl::aLayerMaskRatio).asFloat();
+            s.layers.columns[i]    = (uint16_t)(std::max)(1, (int)layer.child(Impl::aLayerColumns).asShort());
+            s.layers.rows[i]       = (uint16_t)(std::max)(1, (int)layer.child(Impl::aLayerRows).asShort());
 
-        if (s.guideType < 0) s.guideType = 0;
-        if (s.guideType > 2) s.guideType = 2;
+            const MString shape = layer.child(Impl::aLayerShape).asString();
+            if (shape.length() > 0) s.layers.shape[i] = guideShapeId(shape.asChar());
+        }
 
+        sanitizeSettings(s);
         return s;
     }
 
+    // baked: hashes of packed when it comes from the timeline
+    static void publishPacked(SettingsVariant& var, const PackedSettings& packed, const TimelineEntry* baked = nullptr)
+    {
+        // time changes and dirty messages often re-read identical values
+        if (var.hasPublished && packed == var.last.packed)
+            return;
+
+        PublishedSettings next;
+        next.packed    = packed;
+        next.hash      = baked ? baked->hash      : hashSettings(packed);
+        next.shapeHash = baked ? baked->shapeHash : hashSettingsShape(packed);
+        var.buffer.publish(next);
+        var.last = next;
+        var.hasPublished = true;
+    }
+
+    static void publishVariant(int v)
+    {
+        SettingsVariant& var = gVariants[v];
+        publishPacked(var, packSettings(readNode(var.node)));
+    }
+
+    static void publishSettingsNode(const MObject& node)
+    {
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            if (gVariants[v].node.isValid() && gVariants[v].node.object() == node)
+                publishVariant(v);
+        }
+    }
+
+    // Resolves the variants for time and publishes them when they changed.
+    static void publishBindings(const MTime& time)
+    {
+        const bool active = gVariantCount > 1;
+        if (active)
+        {
+            BindingState state;
+            const VariantMask shots = gShotIndex.lookup(time.as(MTime::uiUnit()), gShotCursor);
+            buildBindingState(gBindings, shots, state);
+
+            if (!gBindingsActive.load(std::memory_order_relaxed) ||
+                std::memcmp(&state, &gLastBindingState, sizeof(BindingState)) != 0)
+            {
+                gBindingBuffer.publish(state);
+                gLastBindingState = state;
+            }
+        }
+        gBindingsActive.store(active, std::memory_order_release);
+    }
+
+
+    // ---------------------------------------------------------------------
+    // bake for playback
+
+    static bool bakeEnabled(const MObject& node)
+    {
+        MPlug p(node, AoViewportGuideSettingsNodeImpl::aBakePlayback);
+        return !p.isNull() && p.asBool();
+    }
+
+    static SettingsData readNodeAt(const MObjectHandle& node, int frame)
+    {
+        MDGContext ctx(MTime((double)frame, MTime::uiUnit()));
+        MDGContextGuard guard(ctx);
+        return readNode(node);
+    }
+
+    static CurveKeys readCurveKeys(const MObject& curve)
+    {
+        CurveKeys out;
+        MFnAnimCurve fn(curve);
+
+        const unsigned int n = fn.numKeys();
+        out.keys.resize(n);
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            CurveKey& k = out.keys[i];
+            float x = 0.0f, y = 0.0f;
+            k.time  = fn.time(i).as(MTime::uiUnit());
+            k.value = fn.value(i);
+            fn.getTangent(i, x, y, true);
+            k.inX = x;  k.inY = y;
+            fn.getTangent(i, x, y, false);
+            k.outX = x; k.outY = y;
+            k.inType  = (int)fn.inTangentType(i);
+            k.outType = (int)fn.outTangentType(i);
+        }
+        out.preInfinity  = (int)fn.preInfinityType();
+        out.postInfinity = (int)fn.postInfinityType();
+        out.weighted     = fn.isWeighted();
+        return out;
+    }
+
+    // The animCurves driving node. false when anything else drives it (expressions,
+    // constraints, driven keys, layers): those can change without a key edit.
+    static bool collectTimeCurves(const MObject& node, std::vector<MObject>& curves)
+    {
+        MPlugArray plugs;
+        MFnDependencyNode(node).getConnections(plugs);
+
+        for (unsigned int i = 0; i < plugs.length(); ++i)
+        {
+            const MPlug src = plugs[i].source();
+            if (src.isNull()) continue; // outgoing
+
+            const MObject obj = src.node();
+            if (!obj.hasFn(MFn::kAnimCurve)) return false;
+
+            MFnAnimCurve fn(obj);
+            if (fn.isUnitlessInput() || fn.findPlug("input", true).isDestination()) return false;
+            curves.push_back(obj);
+        }
+        return true;
+    }
+
+    static void watchCurve(const MObject& curve, VariantMask bit)
+    {
+        for (CurveWatch& w : gCurveWatches)
+        {
+            if (w.curve.isValid() && w.curve.object() == curve) { w.variants |= bit; return; }
+        }
+
+        CurveWatch w;
+        w.curve    = MObjectHandle(curve);
+        w.variants = bit;
+        w.keys     = readCurveKeys(curve);
+        gCurveWatches.push_back(std::move(w));
+    }
+
+    static int bakeFrame(double t)
+    {
+        return (int)std::floor((std::max)(-1.0e9, (std::min)(t, 1.0e9)));
+    }
+
+    // Bakes missing frames of every baked variant, nearest after the playhead first,
+    // until budgetNs is spent. false when nothing is left to bake.
+    static bool bakeStep(uint64_t budgetNs)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const int playhead = bakeFrame(MAnimControl::currentTime().as(MTime::uiUnit()));
+
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            SettingsVariant& var = gVariants[v];
+            if (!var.bake || !var.node.isValid()) continue;
+
+            int frame = 0;
+            while (var.timeline.nextMissing(playhead, frame))
+            {
+                var.timeline.store(frame, packSettings(readNodeAt(var.node, frame)));
+
+                const auto spent = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                if ((uint64_t)spent >= budgetNs) return true;
+            }
+        }
+        return false;
+    }
+
+    static void bakeIdleCB(void*)
+    {
+        if (bakeStep(kBakeIdleBudgetNs)) return;
+
+        MMessage::removeCallback(gBakeIdleId);
+        gBakeIdleId = 0;
+    }
+
+    static void requestBake()
+    {
+        if (gBakeIdleId != 0) return;
+
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            if (!gVariants[v].bake) continue;
+
+            MStatus stat;
+            gBakeIdleId = MEventMessage::addEventCallback("idle", bakeIdleCB, nullptr, &stat);
+            if (!stat) gBakeIdleId = 0;
+            return;
+        }
+    }
+
+    // Re-reads bakePlayback and the driving curves of every variant; drops all baked frames.
+    static void setupBake()
+    {
+        gCurveWatches.clear();
+
+        const int first = bakeFrame(MAnimControl::minTime().as(MTime::uiUnit()));
+        const int last  = (std::min)(bakeFrame(std::ceil(MAnimControl::maxTime().as(MTime::uiUnit()))),
+                                     first + kMaxBakeFrames - 1);
+
+        for (int v = 0; v < kMaxSettingsVariants; ++v)
+        {
+            SettingsVariant& var = gVariants[v];
+            var.bake = false;
+            var.timeline.clear();
+            if (v >= gVariantCount || !var.node.isValid() || !bakeEnabled(var.node.object())) continue;
+
+            // unanimated nodes have nothing to bake; undrivable ones stay live
+            std::vector<MObject> curves;
+            if (!collectTimeCurves(var.node.object(), curves) || curves.empty()) continue;
+
+            for (const MObject& c : curves)
+                watchCurve(c, VariantMask(1) << v);
+            var.timeline.reset(first, last);
+            var.bake = true;
+        }
+        requestBake();
+    }
+
+    static void invalidateBakedNode(const MObject& node)
+    {
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            SettingsVariant& var = gVariants[v];
+            if (var.bake && var.node.isValid() && var.node.object() == node)
+                var.timeline.invalidateAll();
+        }
+        requestBake();
+    }
+
+    static void animCurveEditedCB(MObjectArray& curves, void*)
+    {
+        bool edited = false;
+        for (unsigned int i = 0; i < curves.length(); ++i)
+        {
+            for (CurveWatch& w : gCurveWatches)
+            {
+                if (!w.curve.isValid() || w.curve.object() != curves[i]) continue;
+
+                CurveKeys keys = readCurveKeys(curves[i]);
+                double lo = 0.0, hi = 0.0;
+                if (changedKeyRange(w.keys, keys, lo, hi))
+                {
+                    for (int v = 0; v < gVariantCount; ++v)
+                    {
+                        if (w.variants & (VariantMask(1) << v))
+                            gVariants[v].timeline.invalidate(bakeFrame(lo), bakeFrame(std::ceil(hi)));
+                    }
+                    edited = true;
+                }
+                w.keys.swap(keys);
+                break;
+            }
+        }
+        if (edited) requestBake();
+    }
+
+    static void playbackRangeChangedCB(void*)
+    {
+        setupBake();
+    }
+
+    // On time change: baked variants publish the frame's entry, the others read the node.
+    static void publishFrame(const MTime& time)
+    {
+        const double t = time.as(MTime::uiUnit());
+        const int frame = bakeFrame(t);
+        const bool whole = (double)frame == t;
+
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            SettingsVariant& var = gVariants[v];
+            const TimelineEntry* baked = (var.bake && whole) ? var.timeline.find(frame) : nullptr;
+            if (baked)
+            {
+                publishPacked(var, baked->packed, baked);
+                continue;
+            }
+
+            const PackedSettings packed = packSettings(readNode(var.node));
+            if (var.bake && whole) var.timeline.store(frame, packed); // read anyway: keep it
+            publishPacked(var, packed);
+        }
+
+        // keep ahead of the playhead while playing
+        if (gBakeIdleId != 0)
+            bakeStep(kBakeAheadBudgetNs);
+    }
+
+    // ---------------------------------------------------------------------
+    // bindings
+
+    static std::vector<std::string> splitBindings(const MString& value)
+    {
+        std::vector<std::string> out;
+        std::string token;
+        for (const char* c = value.asChar(); ; ++c)
+        {
+            if (*c == '\0' || *c == ' ' || *c == ',' || *c == '\t' || *c == '\n')
+            {
+                if (!token.empty()) out.push_back(token);
+                token.clear();
+                if (*c == '\0') break;
+            }
+            else
+                token.push_back(*c);
+        }
+        return out;
+    }
+
+    // names and wildcard patterns, as MSelectionList resolves them
+    static MSelectionList selectBindings(const MString& value)
+    {
+        MSelectionList list;
+        for (const std::string& token : splitBindings(value))
+            list.add(MString(token.c_str())); // no match is not an error here
+        return list;
+    }
+
+    static double shotFrame(const MObject& shot, const char* attr)
+    {
+        MStatus stat;
+        MFnDependencyNode fn(shot);
+        const MPlug p = fn.findPlug(attr, true, &stat);
+        if (!stat) return 0.0;
+
+        const MTime t = p.asMTime(&stat);
+        return stat ? t.as(MTime::uiUnit()) : p.asDouble();
+    }
+
+    static void updateShot(const ShotWatch& w)
+    {
+        if (!w.shot.isValid()) return;
+        const MObject shot = w.shot.object();
+        gShotIndex.setShot(w.id, shotFrame(shot, "startFrame"), shotFrame(shot, "endFrame"), w.variants);
+    }
+
+    static void shotAttributeChangedCB(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug&, void* clientData)
+    {
+        if (!(msg & MNodeMessage::kAttributeSet)) return;
+
+        const MString name = plug.partialName(false, false, false, false, false, true);
+        if (name != "startFrame" && name != "endFrame") return;
+
+        // a trim or slip only re-flattens the span this shot covers
+        const size_t i = (size_t)(uintptr_t)clientData;
+        if (i >= gShotWatches.size()) return;
+        updateShot(gShotWatches[i]);
+        publishBindings(MAnimControl::currentTime());
+    }
+
+    static void clearShotWatches()
+    {
+        for (const ShotWatch& w : gShotWatches)
+        {
+            if (w.callbackId) MMessage::removeCallback(w.callbackId);
+        }
+        gShotWatches.clear();
+        gShotIndex.clear();
+        gShotCursor = 0;
+    }
+
+    static void watchShot(const MObject& shot, VariantMask bit)
+    {
+        for (ShotWatch& w : gShotWatches)
+        {
+            if (w.shot.isValid() && w.shot.object() == shot) { w.variants |= bit; return; }
+        }
+
+        ShotWatch w;
+        w.shot     = MObjectHandle(shot);
+        w.id       = (uint64_t)gShotWatches.size();
+        w.variants = bit;
+
+        MObject obj = shot;
+        w.callbackId = MNodeMessage::addAttributeChangedCallback(obj, shotAttributeChangedCB, (void*)(uintptr_t)w.id);
+        gShotWatches.push_back(w);
+    }
+
+    static void bindVariant(int v, const MObject& node)
+    {
+        using Impl = AoViewportGuideSettingsNodeImpl;
+        const VariantMask bit = VariantMask(1) << v;
+
+        // a node bound to names that match nothing stays bound (it just never applies)
+        const MString cameras = bindingString(node, Impl::aBindCameras);
+        if (cameras.length() > 0)
+        {
+            gBindings.cameraBound |= bit;
+
+            const MSelectionList list = selectBindings(cameras);
+            for (unsigned int i = 0; i < list.length(); ++i)
+            {
+                MDagPath path;
+                if (!list.getDagPath(i, path)) continue;
+                path.extendToShape();
+                if (!path.hasFn(MFn::kCamera)) continue;
+                gBindings.cameras[AoViewportGuideSettings::cameraBindingKey(path)] |= bit;
+            }
+        }
+
+        const MString shots = bindingString(node, Impl::aBindShots);
+        if (shots.length() > 0)
+        {
+            gBindings.shotBound |= bit;
+
+            const MSelectionList list = selectBindings(shots);
+            for (unsigned int i = 0; i < list.length(); ++i)
+            {
+                MObject obj;
+                if (!list.getDependNode(i, obj) || !obj.hasFn(MFn::kShot)) continue;
+                watchShot(obj, bit);
+            }
+        }
+    }
+
+    // Default node first, then every other settings node with bindings (name order);
+    // rebuilds the binding index and publishes everything.
+    static void resolveSettingsNode(const MObject& exclude)
+    {
+        const MObject defaultNode = findSettingsNode(exclude);
+
+        std::vector<std::pair<std::string, MObject>> bound;
+        for (MItDependencyNodes it(MFn::kPluginDependNode); !it.isDone(); it.next())
+        {
+            MObject obj = it.thisNode();
+            if (obj == exclude || obj == defaultNode) continue;
+
+            MFnDependencyNode fn(obj);
+            if (fn.typeId() != AoViewportGuideSettingsNode::id || !hasBindings(obj)) continue;
+            bound.emplace_back(fn.name().asChar(), obj);
+        }
+        std::sort(bound.begin(), bound.end(),
+                  [](const std::pair<std::string, MObject>& a, const std::pair<std::string, MObject>& b)
+                  { return a.first < b.first; });
+
+        clearShotWatches();
+        gBindings.clear();
+
+        auto assign = [](int v, const MObject& obj)
+        {
+            SettingsVariant& var = gVariants[v];
+            const MObjectHandle handle = obj.isNull() ? MObjectHandle() : MObjectHandle(obj);
+            if (var.node.isValid() != handle.isValid() || var.node.object() != handle.object())
+                var.hasPublished = false;
+            var.node = handle;
+        };
+
+        assign(0, defaultNode);
+        int count = 1;
+        for (const auto& b : bound)
+        {
+            if (count == kMaxSettingsVariants) break;
+            assign(count, b.second);
+            bindVariant(count, b.second);
+            ++count;
+        }
+        for (int v = count; v < gVariantCount; ++v)
+            assign(v, MObject::kNullObj);
+        gVariantCount = count;
+
+        for (const ShotWatch& w : gShotWatches)
+            updateShot(w);
+
+        setupBake();
+        AoViewportGuideSettings::publish();
+        publishBindings(MAnimControl::currentTime());
+    }
+
+    bool AoViewportGuideSettings::ensureNodeExists()
+    {
+        resolveSettingsNode(MObject::kNullObj);
+        if (gVariants[0].node.isValid())
+            return true;
+
+        MStatus stat;
+        MDGModifier mod;
+        MObject obj = mod.createNode(AoViewportGuideSettingsNode::id, &stat);
+        if (!stat) return false;
+
+        mod.renameNode(obj, kSettingsNodeName);
+        if (!mod.doIt()) return false;
+
+        resolveSettingsNode(MObject::kNullObj);
+        return gVariants[0].node.isValid();
+    }
+
+    void AoViewportGuideSettings::resolveNode()
+    {
+        resolveSettingsNode(MObject::kNullObj);
+    }
+
+    bool AoViewportGuideSettings::validateNode()
+    {
+        // dropped without a removal message (e.g. undo): bound nodes are re-resolved
+        // on the next idle, the default falls back to defaults right away
+        for (int v = 1; v < gVariantCount; ++v)
+        {
+            if (!gVariants[v].node.isValid()) { requestRebuild(); break; }
+        }
+
+        SettingsVariant& def = gVariants[0];
+        if (def.node.isValid())
+            return true;
+
+        if (!def.node.object().isNull())
+        {
+            def.node = MObjectHandle();
+            publishVariant(0);
+        }
+        return false;
+    }
+
+    SettingsData AoViewportGuideSettings::read()
+    {
+        return readNode(gVariants[0].node);
+    }
+
+    bool AoViewportGuideSettings::queueWrite(const SettingsData& s, MDGModifier& mod)
+    {
+        if (!gVariants[0].node.isValid())
+            return false;
+
+        const MObject obj = gVariants[0].node.object();
+
+        using Impl = AoViewportGuideSettingsNodeImpl;
+
+        // driven plugs (keys, expressions) keep their inputs
+        auto settable = [](const MPlug& p) { return !p.isNull() && !p.isDestination(); };
+        auto setBool = [&](const MPlug& p, bool v)
+        {
+            if (settable(p) && p.asBool() != v) mod.newPlugValueBool(p, v);
+        };
+        auto setInt = [&](const MPlug& p, int v)
+        {
+            if (settable(p) && p.asInt() != v) mod.newPlugValueInt(p, v);
+        };
+        auto setShort = [&](const MPlug& p, int v)
+        {
+            if (settable(p) && p.asShort() != v) mod.newPlugValueShort(p, (short)v);
+        };
+        auto setFloat = [&](const MPlug& p, float v)
+        {
+            if (settable(p) && p.asFloat() != v) mod.newPlugValueFloat(p, v);
+        };
+        auto setString = [&](const MPlug& p, const MString& v)
+        {
+            if (settable(p) && p.asString() != v) mod.newPlugValueString(p, v);
+        };
+        auto setColor = [&](const MPlug& p, float r, float g, float b)
+        {
+            if (!settable(p) || p.numChildren() < 3) return;
+            setFloat(p.child(0), r);
+            setFloat(p.child(1), g);
+            setFloat(p.child(2), b);
+        };
+
+        setBool (MPlug(obj, Impl::aEnable), s.enable);
+        setBool (MPlug(obj, Impl::aFollowResolutionGate), s.followResolutionGate);
+        setInt  (MPlug(obj, Impl::aGuideType), s.guideType);
+        setInt  (MPlug(obj, Impl::aGoldenRotation), s.goldenRotation);
+        setBool (MPlug(obj, Impl::aGoldenFlipH), s.goldenFlipH);
+        setBool (MPlug(obj, Impl::aGoldenFlipV), s.goldenFlipV);
+        setInt  (MPlug(obj, Impl::aDrawBackend), s.drawBackend);
+        setInt  (MPlug(obj, Impl::aPipeline), s.pipeline);
+
+        setFloat(MPlug(obj, Impl::aLineOpacity), s.lineOpacity);
+        setFloat(MPlug(obj, Impl::aLineThickness), s.lineThickness);
+        setColor(MPlug(obj, Impl::aLineColor), s.lineColor.r, s.lineColor.g, s.lineColor.b);
+
+        setBool (MPlug(obj, Impl::aGateBorderEnable), s.gateBorderEnable);
+        setFloat(MPlug(obj, Impl::aGateBorderOpacity), s.gateBorderOpacity);
+        setFloat(MPlug(obj, Impl::aGateBorderThickness), s.gateBorderThickness);
+        setColor(MPlug(obj, Impl::aGateBorderColor), s.gateBorderColor.r, s.gateBorderColor.g, s.gateBorderColor.b);
+
+        setBool (MPlug(obj, Impl::aMaskEnable), s.maskEnable);
+        setFloat(MPlug(obj, Impl::aMaskOpacity), s.maskOpacity);
+        setColor(MPlug(obj, Impl::aMaskColor), s.maskColor.r, s.maskColor.g, s.maskColor.b);
+
+        setBool (MPlug(obj, Impl::aBgEnable), s.bgEnable);
+        setColor(MPlug(obj, Impl::aBgColor), s.bgColor.r, s.bgColor.g, s.bgColor.b);
+
+        setBool (MPlug(obj, Impl::aAdaptiveQuality), s.adaptiveQuality);
+        setFloat(MPlug(obj, Impl::aQualityBudget), s.qualityBudget);
+        setInt  (MPlug(obj, Impl::aQualityFloor), s.qualityFloor);
+
+        setBool (MPlug(obj, Impl::aAnnotateCamera),      (s.annotations & kAnnotateCamera) != 0);
+        setBool (MPlug(obj, Impl::aAnnotateFocalLength), (s.annotations & kAnnotateFocalLength) != 0);
+        setBool (MPlug(obj, Impl::aAnnotateResolution),  (s.annotations & kAnnotateResolution) != 0);
+        setBool (MPlug(obj, Impl::aAnnotateAspect),      (s.annotations & kAnnotateAspect) != 0);
+        setBool (MPlug(obj, Impl::aAnnotateFrame),       (s.annotations & kAnnotateFrame) != 0);
+        setShort(MPlug(obj, Impl::aAnnotationScale), s.annotationScale);
+        setFloat(MPlug(obj, Impl::aAnnotationOpacity), s.annotationOpacity);
+        setColor(MPlug(obj, Impl::aAnnotationColor), s.annotationColor.r, s.annotationColor.g, s.annotationColor.b);
+
+        // layer i goes to element i; any other element is disabled
+        MPlug layers(obj, Impl::aGuideLayers);
+        if (layers.isNull())
+            return true;
+
+        const GuideLayerStack& l = s.layers;
+        for (int i = 0; i < l.count && i < kMaxGuideLayers; ++i)
+        {
+            const MPlug layer = layers.elementByLogicalIndex((unsigned int)i);
+            setBool (layer.child(Impl::aLayerEnable), true);
+            setInt  (layer.child(Impl::aLayerType), l.type[i]);
+            setShort(layer.child(Impl::aLayerColumns), l.columns[i]);
+            setShort(layer.child(Impl::aLayerRows), l.rows[i]);
+            setFloat(layer.child(Impl::aLayerSafeAction), l.safeAction[i]);
+            setFloat(layer.child(Impl::aLayerSafeTitle), l.safeTitle[i]);
+            setFloat(layer.child(Impl::aLayerMaskRatio), l.maskRatio[i]);
+            setColor(layer.child(Impl::aLayerColor), l.colorR[i], l.colorG[i], l.colorB[i]);
+            setFloat(layer.child(Impl::aLayerOpacity), l.opacity[i]);
+            setFloat(layer.child(Impl::aLayerThickness), l.thickness[i]);
+
+            // an id whose name was never seen cannot be written back
+            const std::string shape = l.type[i] == kLayerShape ? guideShapeName(l.shape[i]) : std::string();
+            if (!shape.empty()) setString(layer.child(Impl::aLayerShape), shape.c_str());
+        }
+        for (unsigned int e = 0; e < layers.numElements(); ++e)
+        {
+            const MPlug layer = layers.elementByPhysicalIndex(e);
+            if (layer.logicalIndex() >= (unsigned int)l.count)
+                setBool(layer.child(Impl::aLayerEnable), false);
+        }
+        return true;
+    }
+
+    MStatus AoViewportGuideSettings::commitWrite(MDGModifier& mod, bool undo)
+    {
+        gBatchWrite = true;
+        const MStatus stat = undo ? mod.undoIt() : mod.doIt();
+        gBatchWrite = false;
+
+        for (int v = 0; v < gVariantCount; ++v)
+        {
+            if (gVariants[v].node.isValid())
+                invalidateBakedNode(gVariants[v].node.object());
+        }
+        AoViewportGuideSettings::publish();
+        return stat;
+    }
+
+    static SettingsSnapshot snapshotVariant(int v)
+    {
+        const SnapshotBuffer<PublishedSettings>::Snapshot snap = gVariants[v].buffer.read();
+
+        SettingsSnapshot out;
+        out.variant = v;
+        out.generation = snap.generation;
+        if (snap.generation == 0) return out; // nothing published yet: defaults
+
+        out.data = unpackSettings(snap.data.packed);
+        out.hash = snap.data.hash;
+        out.shapeHash = snap.data.shapeHash;
+        return out;
+    }
+
+    SettingsSnapshot AoViewportGuideSettings::snapshot()
+    {
+        return snapshotVariant(0);
+    }
+
+    SettingsSnapshot AoViewportGuideSettings::snapshot(uint64_t cameraKey)
+    {
+        int v = 0;
+        if (gBindingsActive.load(std::memory_order_acquire))
+            v = resolveSettingsVariant(gBindingBuffer.read().data, cameraKey);
+        return snapshotVariant(v);
+    }
+
+    uint64_t AoViewportGuideSettings::cameraBindingKey(const MDagPath& camera)
+    {
+        // transform and shape paths give the same key
+        MDagPath shape = camera;
+        shape.extendToShape();
+        const MObject node = shape.node();
+        if (node.isNull()) return 0;
+
+        const MObjectHandle handle(node);
+        const unsigned int hash = handle.hashCode();
+
+        std::lock_guard<std::mutex> lock(gCameraKeyMutex);
+        for (const CameraKeyEntry& e : gCameraKeys)
+        {
+            if (e.hash == hash && e.camera.isValid() && e.camera.objectRef() == node)
+                return e.key;
+        }
+
+        // deleted cameras give their slot up; their keys stay retired
+        gCameraKeys.erase(std::remove_if(gCameraKeys.begin(), gCameraKeys.end(),
+                                         [](const CameraKeyEntry& e) { return !e.camera.isValid(); }),
+                          gCameraKeys.end());
+
+        CameraKeyEntry e;
+        e.hash   = hash;
+        e.camera = handle;
+        e.key    = gNextCameraKey++;
+        gCameraKeys.push_back(e);
+        return e.key;
+    }
+
+    void AoViewportGuideSettings::publish()
+    {
+        for (int v = 0; v < gVariantCount; ++v)
+            publishVariant(v);
+    }
+
+    static void idlePublishCB(void*)
+    {
+        // one-shot: several dirty messages in a row cost one read
+        if (gIdlePublishId != 0)
+        {
+            MMessage::removeCallback(gIdlePublishId);
+            gIdlePublishId = 0;
+        }
+
+        if (gRebuildPending)
+        {
+            gRebuildPending = false;
+            resolveSettingsNode(MObject::kNullObj);
+        }
+        else
+            AoViewportGuideSettings::publish();
+    }
+
+    void AoViewportGuideSettings::requestPublish()
+    {
+        if (gIdlePublishId != 0)
+            return;
+
+        MStatus stat;
+        gIdlePublishId = MEventMessage::addEventCallback("idle", idlePublishCB, nullptr, &stat);
+        if (!stat)
+        {
+            gIdlePublishId = 0;
+            idlePublishCB(nullptr);
+        }
+    }
+
+    static void requestRebuild()
+    {
+        gRebuildPending = true;
+        AoViewportGuideSettings::requestPublish();
+    }
+
+    uint64_t AoViewportGuideSettings::cacheHits()
+    {
+        uint64_t n = 0;
+        for (const SettingsVariant& var : gVariants) n += var.buffer.reads();
+        return n;
+    }
+
+    uint64_t AoViewportGuideSettings::cacheLoads()
+    {
+        uint64_t n = 0;
+        for (const SettingsVariant& var : gVariants) n += var.buffer.publishes();
+        return n;
+    }
+
+    void AoViewportGuideSettings::resetCacheCounters()
+    {
+        for (SettingsVariant& var : gVariants) var.buffer.resetCounters();
+    }
+
+    static void timeChangedCB(MTime& time, void*)
+    {
+        // Animated attributes do not always send dirty messages (e.g. under the
+        // Evaluation Manager), so re-publish on time change while anything is connected:
+        // the baked frame with bakePlayback on, otherwise a fresh read. This runs on the
+        // main thread before the viewports draw the new frame.
+        if (gConnectedInputs > 0)
+            publishFrame(time);
+
+        // shot bindings follow the current time (a cursor lookup while playing)
+        if (gShotIndex.shotCount() > 0)
+            publishBindings(time);
+    }
+
+    static void afterNewOrOpenCB(void*)
+    {
+        AoViewportGuideSettings::ensureNodeExists();
+    }
+
+    static void afterImportOrReferenceCB(void*)
+    {
+        AoViewportGuideSettings::resolveNode();
+    }
+
+    static void settingsNodeAddedCB(MObject&, void*)
+    {
+        resolveSettingsNode(MObject::kNullObj);
+    }
+
+    static void settingsNodeRemovedCB(MObject& node, void*)
+    {
+        // the removed node may still be visible to the iterator here
+        resolveSettingsNode(node);
+    }
+
+    static void boundNodeAddedCB(MObject&, void*)
+    {
+        // a new camera or shot may match a binding pattern
+        if (gVariantCount > 1) requestRebuild();
+    }
+
+    static void shotRemovedCB(MObject& node, void*)
+    {
+        for (ShotWatch& w : gShotWatches)
+        {
+            if (!w.shot.isValid() || w.shot.object() != node) continue;
+
+            gShotIndex.removeShot(w.id);
+            if (w.callbackId) MMessage::removeCallback(w.callbackId);
+            w.callbackId = 0;
+            w.shot = MObjectHandle();
+            publishBindings(MAnimControl::currentTime());
+            break;
+        }
+    }
+
+    void AoViewportGuideSettings::installCallbacks()
+    {
+        if (gCallbackIds.length() > 0)
+            return;
+
+        gCallbackIds.append(MDGMessage::addTimeChangeCallback(timeChangedCB, nullptr));
+
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterNew,  afterNewOrOpenCB, nullptr));
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterOpen, afterNewOrOpenCB, nullptr));
+
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterImport,           afterImportOrReferenceCB, nullptr));
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterLoadReference,    afterImportOrReferenceCB, nullptr));
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterUnloadReference,  afterImportOrReferenceCB, nullptr));
+        gCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterRemoveReference,  afterImportOrReferenceCB, nullptr));
+
+        gCallbackIds.append(MDGMessage::addNodeAddedCallback(settingsNodeAddedCB, kSettingsNodeTypeName, nullptr));
+        gCallbackIds.append(MDGMessage::addNodeRemovedCallback(settingsNodeRemovedCB, kSettingsNodeTypeName, nullptr));
+
+        gCallbackIds.append(MDGMessage::addNodeAddedCallback(boundNodeAddedCB, "camera", nullptr));
+        gCallbackIds.append(MDGMessage::addNodeAddedCallback(boundNodeAddedCB, "shot", nullptr));
+        gCallbackIds.append(MDGMessage::addNodeRemovedCallback(shotRemovedCB, "shot", nullptr));
+
+        gCallbackIds.append(MAnimMessage::addAnimCurveEditedCallback(animCurveEditedCB, nullptr));
+        gCallbackIds.append(MEventMessage::addEventCallback("playbackRangeChanged", playbackRangeChangedCB, nullptr));
+        gCallbackIds.append(MEventMessage::addEventCallback("timeUnitChanged", playbackRangeChangedCB, nullptr));
+    }
+
+    void AoViewportGuideSettings::removeCallbacks()
+    {
+        if (gCallbackIds.length() > 0)
+        {
+            MMessage::removeCallbacks(gCallbackIds);
+            gCallbackIds.clear();
+        }
+        if (gIdlePublishId != 0)
+        {
+            MMessage::removeCallback(gIdlePublishId);
+            gIdlePublishId = 0;
+        }
+        gRebuildPending = false;
+        if (gBakeIdleId != 0)
+        {
+            MMessage::removeCallback(gBakeIdleId);
+            gBakeIdleId = 0;
+        }
+
+        clearShotWatches();
+        gCurveWatches.clear();
+        gBindings.clear();
+        gBindingsActive.store(false, std::memory_order_release);
+
+        for (SettingsVariant& var : gVariants)
+        {
+            var.node = MObjectHandle();
+            var.hasPublished = false;
+            var.timeline.clear();
+            var.bake = false;
+        }
+        gVariantCount = 1;
+    }
+
     void* SettingsNodeCreator()
     {
         return AoViewportGuideSettingsNodeImpl::creator();
@@ -1,44 +1,84 @@
 #pragma once
 
-#include <maya/MColor.h>
+#include <maya/MDagPath.h>
+#include <maya/MDGModifier.h>
 #include <maya/MStatus.h>
 #include <maya/MTypeId.h>
 
-namespace AoViewportGuide
-{
-    struct SettingsData
-    {
-        bool   enable = true;
-        bool   followResolutionGate = true;
-
-        // 0: Thirds, 1: Cross, 2: Circle
-        int    guideType = 0;
-
-        float  lineOpacity   = 1.0f;
-        float  lineThickness = 2.0f;
-        MColor lineColor     = MColor(0.0f, 1.0f, 0.0f, 1.0f);
-
-        bool   gateBorderEnable    = true;
-        float  gateBorderOpacity   = 1.0f;
-        float  gateBorderThickness = 2.0f;
-        MColor gateBorderColor     = MColor(1.0f, 1.0f, 1.0f, 1.0f);
+#include <cstdint>
 
-        // background solid clear
-        bool   bgEnable = false;
-        MColor bgColor  = MColor(0.0f, 0.0f, 0.0f, 1.0f);
-    };
+#include "aoViewportGuideSettingsData.h"
+#include "aoViewportGuideSnapshotBuffer.h"
 
+namespace AoViewportGuide
+{
     class AoViewportGuideSettingsNode
     {
     public:
         static MTypeId id;
     };
 
+    struct SettingsSnapshot
+    {
+        SettingsData data;
+        uint64_t     generation = 0; // bumps only when a value changed
+        uint64_t     hash = 0;       // hashSettings(); stable across identical values
+        uint64_t     shapeHash = 0;  // hashSettingsShape(); only changes with the geometry
+        int          variant = 0;    // settings node the values came from (0 = default node)
+    };
+
     class AoViewportGuideSettings
     {
     public:
+        // Picks the active settings node, creating kSettingsNodeName when none exists.
+        // Called on plugin load and after scene new/open; never from the render path.
         static bool ensureNodeExists();
+
+        // Re-picks the default node among existing ones (no creation) and rebuilds the
+        // camera / shot bindings of the others.
+        static void resolveNode();
+
+        // Constant-time check of the cached node handle.
+        static bool validateNode();
+
+        // Reads the node directly (DG access). Prefer snapshot() on the render path.
         static SettingsData read();
+
+        // Last published values; lock-free and DG-free, safe from any draw thread.
+        static SettingsSnapshot snapshot();
+
+        // Same, for the settings node bound to this camera at the current time (see
+        // bindCameras / bindShots). generation and hash are per node: compare the hash.
+        static SettingsSnapshot snapshot(uint64_t cameraKey);
+
+        // Key of a camera (transform or shape path) for snapshot(cameraKey): one per
+        // camera node for the session, never shared or reused; 0 for no camera.
+        static uint64_t cameraBindingKey(const MDagPath& camera);
+
+        // Main thread only: reads the nodes and publishes the result when it differs
+        // from the last published values.
+        static void publish();
+
+        // Queues on mod the default node's plugs whose value differs from s; connected
+        // plugs are left alone and layer elements past s.layers.count are disabled.
+        // False when there is no default node.
+        static bool queueWrite(const SettingsData& s, MDGModifier& mod);
+
+        // Runs (or undoes) a queueWrite() modifier and publishes once, instead of
+        // once per changed attribute.
+        static MStatus commitWrite(MDGModifier& mod, bool undo = false);
+
+        // From dirty notifications, where plugs must not be read: publishes on the next idle.
+        static void requestPublish();
+
+        // snapshot() reads (hits) and publishes (loads), for aoViewportGuideStats
+        static uint64_t cacheHits();
+        static uint64_t cacheLoads();
+        static void resetCacheCounters();
+
+        // scene / node lifetime and time change callbacks
+        static void installCallbacks();
+        static void removeCallbacks();
     };
 
     // for plugin.registerNode
@@ -0,0 +1,268 @@
+// aoViewportGuideSettingsData.cpp (v0.3.1)
+
+#include "aoViewportGuideSettingsData.h"
+#include "aoViewportGuideAnnotations.h"
+#include "aoViewportGuideCommon.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace AoViewportGuide
+{
+    void sanitizeSettings(SettingsData& s)
+    {
+        s.lineOpacity       = clampf(s.lineOpacity, 0.0f, 1.0f);
+        s.gateBorderOpacity = clampf(s.gateBorderOpacity, 0.0f, 1.0f);
+        s.maskOpacity       = clampf(s.maskOpacity, 0.0f, 1.0f);
+
+        s.lineThickness       = clampf(s.lineThickness, 0.5f, 50.0f);
+        s.gateBorderThickness = clampf(s.gateBorderThickness, 0.5f, 50.0f);
+
+        if (s.guideType < kGuideThirds) s.guideType = kGuideThirds;
+        if (s.guideType > kGuideGoldenSpiral) s.guideType = kGuideGoldenSpiral;
+        s.goldenRotation &= 3;
+
+        if (s.drawBackend < kDrawBackendHud || s.drawBackend > kDrawBackendShader)
+            s.drawBackend = kDrawBackendHud;
+        if (s.pipeline != kPipelineStandard)
+            s.pipeline = kPipelineReplace;
+
+        sanitizeGuideLayers(s.layers);
+
+        s.qualityBudget = clampf(s.qualityBudget, 0.01f, 100.0f);
+        s.qualityFloor  = (std::max)((int)kQualityFull, (std::min)(s.qualityFloor, (int)kQualityDraft));
+
+        s.annotations      &= kAnnotateAll;
+        s.annotationScale   = (std::max)(1, (std::min)(s.annotationScale, 8));
+        s.annotationOpacity = clampf(s.annotationOpacity, 0.0f, 1.0f);
+    }
+
+    static bool parseFloat(const std::string& v, float& out)
+    {
+        char* end = nullptr;
+        const float f = std::strtof(v.c_str(), &end);
+        if (end == v.c_str() || *end != '\0') return false;
+        out = f;
+        return true;
+    }
+
+    static bool parseBool(const std::string& v, bool& out)
+    {
+        if (v == "1" || v == "true" || v == "on")   { out = true;  return true; }
+        if (v == "0" || v == "false" || v == "off") { out = false; return true; }
+        return false;
+    }
+
+    static bool parseColor(const std::string& v, Rgba& out)
+    {
+        float r = 0.0f, g = 0.0f, b = 0.0f;
+        char tail = 0;
+        if (std::sscanf(v.c_str(), "%f,%f,%f%c", &r, &g, &b, &tail) != 3) return false;
+        out = Rgba{ r, g, b, 1.0f };
+        return true;
+    }
+
+    static bool parseInt(const std::string& v, int& out)
+    {
+        char* end = nullptr;
+        const long n = std::strtol(v.c_str(), &end, 10);
+        if (end == v.c_str() || *end != '\0') return false;
+        out = (int)n;
+        return true;
+    }
+
+    bool setSettingsValue(SettingsData& s, const std::string& name, const std::string& value)
+    {
+        if (name == "enable")               return parseBool(value, s.enable);
+        if (name == "followResolutionGate") return parseBool(value, s.followResolutionGate);
+        if (name == "guideType")
+        {
+            if (value == "thirds") { s.guideType = kGuideThirds; return true; }
+            if (value == "cross")  { s.guideType = kGuideCross;  return true; }
+            if (value == "circle") { s.guideType = kGuideCircle; return true; }
+            if (value == "phi")    { s.guideType = kGuidePhiGrid; return true; }
+            if (value == "spiral") { s.guideType = kGuideGoldenSpiral; return true; }
+            return parseInt(value, s.guideType);
+        }
+        if (name == "goldenRotation")       return parseInt(value, s.goldenRotation);
+        if (name == "goldenFlipH")          return parseBool(value, s.goldenFlipH);
+        if (name == "goldenFlipV")          return parseBool(value, s.goldenFlipV);
+        if (name == "drawBackend")          return parseInt(value, s.drawBackend);
+        if (name == "pipeline")
+        {
+            if (value == "replace")  { s.pipeline = kPipelineReplace;  return true; }
+            if (value == "standard") { s.pipeline = kPipelineStandard; return true; }
+            return parseInt(value, s.pipeline);
+        }
+        if (name == "lineOpacity")          return parseFloat(value, s.lineOpacity);
+        if (name == "lineThickness")        return parseFloat(value, s.lineThickness);
+        if (name == "lineColor")            return parseColor(value, s.lineColor);
+        if (name == "gateBorderEnable")     return parseBool(value, s.gateBorderEnable);
+        if (name == "gateBorderOpacity")    return parseFloat(value, s.gateBorderOpacity);
+        if (name == "gateBorderThickness")  return parseFloat(value, s.gateBorderThickness);
+        if (name == "gateBorderColor")      return parseColor(value, s.gateBorderColor);
+        if (name == "maskEnable")           return parseBool(value, s.maskEnable);
+        if (name == "maskOpacity")          return parseFloat(value, s.maskOpacity);
+        if (name == "maskColor")            return parseColor(value, s.maskColor);
+        if (name == "bgEnable")             return parseBool(value, s.bgEnable);
+        if (name == "bgColor")              return parseColor(value, s.bgColor);
+        if (name == "layer")                return parseGuideLayer(s.layers, value);
+        if (name == "adaptiveQuality")      return parseBool(value, s.adaptiveQuality);
+        if (name == "qualityBudget")        return parseFloat(value, s.qualityBudget);
+        if (name == "qualityFloor")
+        {
+            if (value == "full")   { s.qualityFloor = kQualityFull;   return true; }
+            if (value == "high")   { s.qualityFloor = kQualityHigh;   return true; }
+            if (value == "medium") { s.qualityFloor = kQualityMedium; return true; }
+            if (value == "draft")  { s.qualityFloor = kQualityDraft;  return true; }
+            return parseInt(value, s.qualityFloor);
+        }
+        if (name == "annotations")          return parseAnnotationFields(value, s.annotations);
+        if (name == "annotationScale")      return parseInt(value, s.annotationScale);
+        if (name == "annotationOpacity")    return parseFloat(value, s.annotationOpacity);
+        if (name == "annotationColor")      return parseColor(value, s.annotationColor);
+        return false;
+    }
+
+    static inline float packFloat(float v)
+    {
+        return v == 0.0f ? 0.0f : v; // -0.0 -> 0.0
+    }
+
+    static inline void packColor(const Rgba& c, float out[3])
+    {
+        out[0] = packFloat(c.r);
+        out[1] = packFloat(c.g);
+        out[2] = packFloat(c.b);
+    }
+
+    static inline Rgba unpackColor(const float in[3])
+    {
+        return Rgba{ in[0], in[1], in[2], 1.0f };
+    }
+
+    PackedSettings packSettings(const SettingsData& s)
+    {
+        PackedSettings p;
+        std::memset(&p, 0, sizeof(p));
+
+        packColor(s.lineColor, p.lineColor);
+        p.lineOpacity         = packFloat(s.lineOpacity);
+        p.lineThickness       = packFloat(s.lineThickness);
+        packColor(s.gateBorderColor, p.gateBorderColor);
+        p.gateBorderOpacity   = packFloat(s.gateBorderOpacity);
+        p.gateBorderThickness = packFloat(s.gateBorderThickness);
+        packColor(s.maskColor, p.maskColor);
+        p.maskOpacity         = packFloat(s.maskOpacity);
+        packColor(s.bgColor, p.bgColor);
+
+        p.flags = (uint8_t)((s.enable               ? PackedSettings::kEnable               : 0) |
+                            (s.followResolutionGate ? PackedSettings::kFollowResolutionGate : 0) |
+                            (s.gateBorderEnable     ? PackedSettings::kGateBorderEnable     : 0) |
+                            (s.maskEnable           ? PackedSettings::kMaskEnable           : 0) |
+                            (s.bgEnable             ? PackedSettings::kBgEnable             : 0) |
+                            (s.pipeline == kPipelineStandard ? PackedSettings::kStandardPipeline : 0) |
+                            (s.adaptiveQuality      ? PackedSettings::kAdaptiveQuality      : 0));
+        p.guideType   = (uint8_t)s.guideType;   // sanitized ranges fit a byte
+        p.drawBackend = (uint8_t)s.drawBackend;
+        p.golden      = (uint8_t)((s.goldenRotation & 3) | (s.goldenFlipH ? 4 : 0) | (s.goldenFlipV ? 8 : 0));
+
+        p.qualityBudget = packFloat(s.qualityBudget);
+        p.qualityFloor  = (uint8_t)s.qualityFloor;
+
+        p.annotations       = (uint8_t)s.annotations;
+        p.annotationScale   = (uint8_t)s.annotationScale;
+        packColor(s.annotationColor, p.annotationColor);
+        p.annotationOpacity = packFloat(s.annotationOpacity);
+
+        p.layers = s.layers;
+        for (int i = 0; i < kMaxGuideLayers; ++i)
+        {
+            p.layers.colorR[i]     = packFloat(p.layers.colorR[i]);
+            p.layers.colorG[i]     = packFloat(p.layers.colorG[i]);
+            p.layers.colorB[i]     = packFloat(p.layers.colorB[i]);
+            p.layers.opacity[i]    = packFloat(p.layers.opacity[i]);
+            p.layers.safeAction[i] = packFloat(p.layers.safeAction[i]);
+            p.layers.safeTitle[i]  = packFloat(p.layers.safeTitle[i]);
+        }
+        return p;
+    }
+
+    SettingsData unpackSettings(const PackedSettings& p)
+    {
+        SettingsData s;
+        s.enable               = (p.flags & PackedSettings::kEnable) != 0;
+        s.followResolutionGate = (p.flags & PackedSettings::kFollowResolutionGate) != 0;
+        s.guideType            = p.guideType;
+        s.drawBackend          = p.drawBackend;
+        s.pipeline             = (p.flags & PackedSettings::kStandardPipeline) ? kPipelineStandard : kPipelineReplace;
+        s.goldenRotation       = p.golden & 3;
+        s.goldenFlipH          = (p.golden & 4) != 0;
+        s.goldenFlipV          = (p.golden & 8) != 0;
+
+        s.lineOpacity   = p.lineOpacity;
+        s.lineThickness = p.lineThickness;
+        s.lineColor     = unpackColor(p.lineColor);
+
+        s.gateBorderEnable    = (p.flags & PackedSettings::kGateBorderEnable) != 0;
+        s.gateBorderOpacity   = p.gateBorderOpacity;
+        s.gateBorderThickness = p.gateBorderThickness;
+        s.gateBorderColor     = unpackColor(p.gateBorderColor);
+
+        s.maskEnable  = (p.flags & PackedSettings::kMaskEnable) != 0;
+        s.maskOpacity = p.maskOpacity;
+        s.maskColor   = unpackColor(p.maskColor);
+
+        s.bgEnable = (p.flags & PackedSettings::kBgEnable) != 0;
+        s.bgColor  = unpackColor(p.bgColor);
+
+        s.layers = p.layers;
+
+        s.adaptiveQuality = (p.flags & PackedSettings::kAdaptiveQuality) != 0;
+        s.qualityBudget   = p.qualityBudget;
+        s.qualityFloor    = p.qualityFloor;
+
+        s.annotations       = p.annotations;
+        s.annotationScale   = p.annotationScale;
+        s.annotationColor   = unpackColor(p.annotationColor);
+        s.annotationOpacity = p.annotationOpacity;
+        return s;
+    }
+
+    uint64_t hashSettings(const PackedSettings& p)
+    {
+        // 64-bit multiply-xorshift over the words (murmur3 finalizer per step)
+        uint64_t words[sizeof(PackedSettings) / sizeof(uint64_t)];
+        std::memcpy(words, &p, sizeof(words));
+
+        uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)sizeof(PackedSettings);
+        for (uint64_t w : words)
+        {
+            h ^= w;
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+        }
+        return h;
+    }
+
+    uint64_t hashSettingsShape(const PackedSettings& p)
+    {
+        PackedSettings shape;
+        std::memset(&shape, 0, sizeof(shape));
+
+        const uint8_t visible = PackedSettings::kGateBorderEnable | PackedSettings::kMaskEnable;
+        shape.flags = p.flags & visible;
+        if (p.gateBorderOpacity <= 0.0001f) shape.flags &= ~PackedSettings::kGateBorderEnable;
+        if (p.maskOpacity <= 0.0001f)       shape.flags &= ~PackedSettings::kMaskEnable;
+
+        shape.guideType = p.guideType;
+        shape.golden    = p.golden;
+        shape.layers    = p.layers;
+        return hashSettings(shape);
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+// aoViewportGuideSettingsData.h (v0.3.1)
+// Plain settings values as read from the aoViewportGuideSettings node (no Maya types).
+
+#include "aoViewportGuideLayers.h"
+#include "aoViewportGuideQuality.h"
+#include "aoViewportGuideTypes.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace AoViewportGuide
+{
+    enum DrawBackend
+    {
+        kDrawBackendHud    = 0, // MUIDrawManager in the override's HUD pass, rebuilt every frame
+        kDrawBackendCached = 1, // persistent vertex/index buffers in a subscene override
+        kDrawBackendShader = 2, // full screen quad, guides evaluated per pixel (aoViewportGuide.ogsfx)
+    };
+
+    enum Pipeline
+    {
+        kPipelineReplace  = 0, // own scene render (clears everything), then the guide passes
+        kPipelineStandard = 1, // Maya's standard operations with only the guide passes added
+    };
+
+    enum GuideType
+    {
+        kGuideThirds       = 0,
+        kGuideCross        = 1,
+        kGuideCircle       = 2,
+        kGuidePhiGrid      = 3, // golden section lines
+        kGuideGoldenSpiral = 4,
+    };
+
+    struct SettingsData
+    {
+        bool  enable = true;
+        bool  followResolutionGate = true;
+
+        // 0: Thirds, 1: Cross, 2: Circle, 3: Phi Grid, 4: Golden Spiral
+        int   guideType = kGuideThirds;
+
+        // golden spiral: quarter turns (0..3), then mirror
+        int   goldenRotation = 0;
+        bool  goldenFlipH    = false;
+        bool  goldenFlipV    = false;
+
+        int   drawBackend = kDrawBackendHud;
+        int   pipeline    = kPipelineReplace;
+
+        float lineOpacity   = 1.0f;
+        float lineThickness = 2.0f;
+        Rgba  lineColor     = Rgba{ 0.0f, 1.0f, 0.0f, 1.0f };
+
+        bool  gateBorderEnable    = true;
+        float gateBorderOpacity   = 1.0f;
+        float gateBorderThickness = 2.0f;
+        Rgba  gateBorderColor     = Rgba{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+        // darkens the viewport outside the gate
+        bool  maskEnable  = false;
+        float maskOpacity = 0.5f;
+        Rgba  maskColor   = Rgba{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+        // background solid clear
+        bool  bgEnable = false;
+        Rgba  bgColor  = Rgba{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+        // enabled entries of the guideLayers array, drawn over the base guide
+        GuideLayerStack layers = {};
+
+        // while interacting, the HUD overlay steps down (at most to qualityFloor)
+        // when it costs more than qualityBudget ms per panel
+        bool  adaptiveQuality = true;
+        float qualityBudget   = 0.5f;
+        int   qualityFloor    = kQualityDraft;
+
+        // text at the gate corners (AnnotationField bits), annotationScale pixels
+        // per font texel
+        unsigned int annotations       = 0;
+        int          annotationScale   = 2;
+        float        annotationOpacity = 0.8f;
+        Rgba         annotationColor   = Rgba{ 1.0f, 1.0f, 1.0f, 1.0f };
+    };
+
+    // Clamps values to the attribute ranges (plugs can be driven past min/max).
+    void sanitizeSettings(SettingsData& s);
+
+    // Sets one value by attribute long name ("lineOpacity", "lineColor", ...), for the
+    // burn-in CLI and settings files. Colors are "r,g,b"; bools accept 0/1/true/false;
+    // guideType also accepts thirds/cross/circle/phi/spiral, pipeline replace/standard,
+    // qualityFloor full/high/medium/draft, annotations parseAnnotationFields();
+    // "layer" appends one layer (parseGuideLayer()).
+    // Returns false for an unknown name or bad value.
+    bool setSettingsValue(SettingsData& s, const std::string& name, const std::string& value);
+
+    // SettingsData without padding: flags in one bit mask, enums in bytes, colors
+    // as rgb (settings colors always have alpha 1). Values are stored bit exact so
+    // pack/unpack round-trips; -0.0 is folded into 0.0 so equal settings hash equal.
+    // Not compact any more: the layer stack is 664 of the 760 bytes, and
+    // hashSettings(), operator== and the snapshot publish go over all of it,
+    // unused (zeroed) layer entries included.
+    struct PackedSettings
+    {
+        enum Flags : uint8_t
+        {
+            kEnable               = 1 << 0,
+            kFollowResolutionGate = 1 << 1,
+            kGateBorderEnable     = 1 << 2,
+            kMaskEnable           = 1 << 3,
+            kBgEnable             = 1 << 4,
+            kStandardPipeline     = 1 << 5,
+            kAdaptiveQuality      = 1 << 6,
+        };
+
+        float lineColor[3];
+        float lineOpacity;
+        float lineThickness;
+        float gateBorderColor[3];
+        float gateBorderOpacity;
+        float gateBorderThickness;
+        float maskColor[3];
+        float maskOpacity;
+        float bgColor[3];
+
+        uint8_t flags;
+        uint8_t guideType;
+        uint8_t drawBackend;
+        uint8_t golden;   // bits 0-1 goldenRotation, bit 2 goldenFlipH, bit 3 goldenFlipV
+
+        GuideLayerStack layers;
+
+        float   qualityBudget;
+        uint8_t qualityFloor;
+        uint8_t annotations;
+        uint8_t annotationScale;
+        uint8_t reserved;
+        float   annotationColor[3];
+        float   annotationOpacity;
+    };
+    static_assert(sizeof(PackedSettings) == 96 + sizeof(GuideLayerStack), "PackedSettings must stay free of padding");
+    static_assert(sizeof(PackedSettings) % sizeof(uint64_t) == 0, "hashSettings() reads whole words");
+
+    PackedSettings packSettings(const SettingsData& s);
+    SettingsData   unpackSettings(const PackedSettings& p);
+
+    // 64-bit content hash of every visual value; equal settings give equal hashes.
+    uint64_t hashSettings(const PackedSettings& p);
+
+    // Hash of only what overlay geometry depends on (guide type and orientation,
+    // which of mask / border are visible, layers). Colors, opacities and line widths
+    // are applied per draw, so animating them keeps this hash.
+    uint64_t hashSettingsShape(const PackedSettings& p);
+
+    inline bool operator==(const PackedSettings& a, const PackedSettings& b)
+    {
+        return std::memcmp(&a, &b, sizeof(PackedSettings)) == 0;
+    }
+    inline bool operator!=(const PackedSettings& a, const PackedSettings& b) { return !(a == b); }
+}
@@ -0,0 +1,878 @@
+// aoViewportGuideShapes.cpp (v0.3.1)
+
+#include "aoViewportGuideShapes.h"
+#include "aoViewportGuideFiles.h"
+#include "aoViewportGuideJson.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <system_error>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace AoViewportGuide
+{
+    // ---------------------------------------------------------------------
+    // cache layout: header, points (float pairs), ops (bytes), name
+
+    static const char     kShapeMagic[4]   = { 'A', 'O', 'G', 'S' };
+    static const uint32_t kShapeVersion    = 1;
+    static const int      kMaxCurveSplits  = 64;
+
+    struct ShapeCacheHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint64_t sourceSize; // of the file the cache was compiled from
+        int64_t  sourceTime;
+        uint32_t opCount;
+        uint32_t pointCount; // floats / 2
+        uint32_t nameLength;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(ShapeCacheHeader) == 40, "ShapeCacheHeader must stay free of padding");
+
+    static const int kOpPoints[kShapeOpCount] = { 1, 1, 2, 3, 0, 1 };
+
+    // Every op known, every point present, and nothing drawn before a move.
+    static bool validOps(const uint8_t* ops, size_t opCount, size_t pointCount)
+    {
+        size_t points = 0;
+        bool current = false;
+        for (size_t i = 0; i < opCount; ++i)
+        {
+            const uint8_t op = ops[i];
+            if (op >= kShapeOpCount) return false;
+            if (op != kShapeMove && op != kShapeExtraction && !current) return false;
+            if (op == kShapeMove) current = true;
+            points += (size_t)kOpPoints[op];
+        }
+        return points == pointCount;
+    }
+
+    // ---------------------------------------------------------------------
+    // compiling
+
+    namespace
+    {
+        struct ShapeWriter
+        {
+            ShapeCode& code;
+
+            void op(ShapeOp o) { code.ops.push_back((uint8_t)o); }
+            void point(double x, double y)
+            {
+                code.points.push_back((float)x);
+                code.points.push_back((float)y);
+            }
+        };
+
+        // SVG path data; whitespace and commas separate numbers
+        struct PathParser
+        {
+            const char* p;
+
+            void skipSeparators()
+            {
+                while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == ',') ++p;
+            }
+
+            bool atNumber()
+            {
+                skipSeparators();
+                return *p && std::strchr("+-.0123456789", *p);
+            }
+
+            bool number(double& out)
+            {
+                if (!atNumber()) return false;
+                char* stop = nullptr;
+                out = std::strtod(p, &stop);
+                if (stop == p || !std::isfinite(out)) return false;
+                p = stop;
+                return true;
+            }
+
+            bool pair(double& x, double& y) { return number(x) && number(y); }
+        };
+
+        bool compilePath(const std::string& d, ShapeWriter& w, std::string& error)
+        {
+            PathParser in{ d.c_str() };
+            double cx = 0.0, cy = 0.0; // current point
+            double sx = 0.0, sy = 0.0; // subpath start
+            double qx = 0.0, qy = 0.0; // last control point, for S / T
+            char   last = 0;           // last command, upper case
+            bool   started = false;
+
+            in.skipSeparators();
+            while (*in.p)
+            {
+                const char cmd = *in.p++;
+                const char upper = (char)std::toupper((unsigned char)cmd);
+                const bool rel = cmd != upper;
+
+                if (upper != 'M' && !started)
+                {
+                    error = "path must start with M";
+                    return false;
+                }
+
+                // commands repeat while numbers follow (an M's extra pairs are lines)
+                bool first = true;
+                do
+                {
+                    const double rx = rel ? cx : 0.0;
+                    const double ry = rel ? cy : 0.0;
+                    double x = 0.0, y = 0.0, x1 = 0.0, y1 = 0.0, x2 = 0.0, y2 = 0.0;
+                    switch (upper)
+                    {
+                    case 'M':
+                        if (!in.pair(x, y)) { error = "bad M"; return false; }
+                        x += rx; y += ry;
+                        if (first) { w.op(kShapeMove); sx = x; sy = y; started = true; }
+                        else         w.op(kShapeLine);
+                        w.point(x, y);
+                        break;
+                    case 'L':
+                        if (!in.pair(x, y)) { error = "bad L"; return false; }
+                        x += rx; y += ry;
+                        w.op(kShapeLine);
+                        w.point(x, y);
+                        break;
+                    case 'H':
+                        if (!in.number(x)) { error = "bad H"; return false; }
+                        x += rx; y = cy;
+                        w.op(kShapeLine);
+                        w.point(x, y);
+                        break;
+                    case 'V':
+                        if (!in.number(y)) { error = "bad V"; return false; }
+                        x = cx; y += ry;
+                        w.op(kShapeLine);
+                        w.point(x, y);
+                        break;
+                    case 'C':
+                    case 'S':
+                        if (upper == 'C')
+                        {
+                            if (!in.pair(x1, y1)) { error = "bad C"; return false; }
+                            x1 += rx; y1 += ry;
+                        }
+                        else
+                        {
+                            // reflection of the last cubic control point
+                            x1 = (last == 'C' || last == 'S') ? 2.0 * cx - qx : cx;
+                            y1 = (last == 'C' || last == 'S') ? 2.0 * cy - qy : cy;
+                        }
+                        if (!in.pair(x2, y2) || !in.pair(x, y)) { error = std::string("bad ") + upper; return false; }
+                        x2 += rx; y2 += ry; x += rx; y += ry;
+                        w.op(kShapeCubic);
+                        w.point(x1, y1);
+                        w.point(x2, y2);
+                        w.point(x, y);
+                        qx = x2; qy = y2;
+                        break;
+                    case 'Q':
+                    case 'T':
+                        if (upper == 'Q')
+                        {
+                            if (!in.pair(x1, y1)) { error = "bad Q"; return false; }
+                            x1 += rx; y1 += ry;
+                        }
+                        else
+                        {
+                            x1 = (last == 'Q' || last == 'T') ? 2.0 * cx - qx : cx;
+                            y1 = (last == 'Q' || last == 'T') ? 2.0 * cy - qy : cy;
+                        }
+                        if (!in.pair(x, y)) { error = std::string("bad ") + upper; return false; }
+                        x += rx; y += ry;
+                        w.op(kShapeQuad);
+                        w.point(x1, y1);
+                        w.point(x, y);
+                        qx = x1; qy = y1;
+                        break;
+                    case 'Z':
+                        w.op(kShapeClose);
+                        x = sx; y = sy;
+                        break;
+                    case 'A':
+                        error = "arcs (A) are not supported; use C or an ellipse";
+                        return false;
+                    default:
+                        error = std::string("unknown path command '") + cmd + "'";
+                        return false;
+                    }
+
+                    cx = x; cy = y;
+                    last = upper == 'M' && !first ? 'L' : upper;
+                    first = false;
+                } while (upper != 'Z' && in.atNumber());
+
+                in.skipSeparators();
+            }
+            return true;
+        }
+
+        // [a, b, c, d] of numbers
+        bool numberArray(JsonCursor& c, double* out, int n, std::string& error)
+        {
+            if (!c.take('[')) { error = "expected an array of numbers"; return false; }
+            for (int i = 0; i < n; ++i)
+            {
+                if ((i > 0 && !c.take(',')) || !c.number(out[i]) || !std::isfinite(out[i]))
+                {
+                    error = "expected " + std::to_string(n) + " numbers";
+                    return false;
+                }
+            }
+            if (!c.take(']')) { error = "expected " + std::to_string(n) + " numbers"; return false; }
+            return true;
+        }
+
+        // Calls item() for every element of an array.
+        template <class F>
+        bool eachItem(JsonCursor& c, const std::string& key, std::string& error, F&& item)
+        {
+            if (!c.take('[')) { error = key + " must be an array"; return false; }
+            if (c.take(']')) return true;
+            do
+            {
+                if (!item()) { error = key + ": " + error; return false; }
+            } while (c.take(','));
+            if (!c.take(']')) { error = "bad " + key + " array"; return false; }
+            return true;
+        }
+    }
+
+    bool compileShape(const char* text, size_t size, ShapeCode& out, std::string& error)
+    {
+        out.name.clear();
+        out.ops.clear();
+        out.points.clear();
+
+        ShapeWriter w{ out };
+        JsonCursor c{ text, text + size };
+        if (!c.take('{')) { error = "expected an object"; return false; }
+        if (c.take('}')) return true;
+
+        std::string key;
+        do
+        {
+            if (!c.string(key) || !c.take(':')) { error = "bad shape object"; return false; }
+
+            bool ok = true;
+            if (key == "name")
+            {
+                if (!c.string(out.name)) { error = "name must be a string"; return false; }
+            }
+            else if (key == "paths")
+            {
+                ok = eachItem(c, key, error, [&]
+                {
+                    std::string d;
+                    if (!c.string(d)) { error = "expected a path string"; return false; }
+                    return compilePath(d, w, error);
+                });
+            }
+            else if (key == "lines")
+            {
+                ok = eachItem(c, key, error, [&]
+                {
+                    double v[4];
+                    if (!numberArray(c, v, 4, error)) return false;
+                    w.op(kShapeMove); w.point(v[0], v[1]);
+                    w.op(kShapeLine); w.point(v[2], v[3]);
+                    return true;
+                });
+            }
+            else if (key == "rects")
+            {
+                ok = eachItem(c, key, error, [&]
+                {
+                    double v[4];
+                    if (!numberArray(c, v, 4, error)) return false;
+                    w.op(kShapeMove); w.point(v[0], v[1]);
+                    w.op(kShapeLine); w.point(v[2], v[1]);
+                    w.op(kShapeLine); w.point(v[2], v[3]);
+                    w.op(kShapeLine); w.point(v[0], v[3]);
+                    w.op(kShapeClose);
+                    return true;
+                });
+            }
+            else if (key == "ellipses")
+            {
+                ok = eachItem(c, key, error, [&]
+                {
+                    double v[4]; // cx, cy, rx, ry
+                    if (!numberArray(c, v, 4, error)) return false;
+
+                    // four cubic quarters
+                    const double k = 0.5522847498307936;
+                    const double x = v[0], y = v[1], rx = v[2], ry = v[3];
+                    w.op(kShapeMove); w.point(x + rx, y);
+                    w.op(kShapeCubic); w.point(x + rx, y + k * ry); w.point(x + k * rx, y + ry); w.point(x, y + ry);
+                    w.op(kShapeCubic); w.point(x - k * rx, y + ry); w.point(x - rx, y + k * ry); w.point(x - rx, y);
+                    w.op(kShapeCubic); w.point(x - rx, y - k * ry); w.point(x - k * rx, y - ry); w.point(x, y - ry);
+                    w.op(kShapeCubic); w.point(x + k * rx, y - ry); w.point(x + rx, y - k * ry); w.point(x + rx, y);
+                    w.op(kShapeClose);
+                    return true;
+                });
+            }
+            else if (key == "extractions")
+            {
+                ok = eachItem(c, key, error, [&]
+                {
+                    double ratio = 0.0;
+                    if (!c.number(ratio) || !(ratio > 0.0) || !std::isfinite(ratio))
+                    {
+                        error = "expected an aspect ratio";
+                        return false;
+                    }
+                    w.op(kShapeExtraction);
+                    w.point(ratio, 0.0);
+                    return true;
+                });
+            }
+            else if (!c.skipValue())
+            {
+                error = "bad value for " + key;
+                return false;
+            }
+            if (!ok) return false;
+        } while (c.take(','));
+
+        if (!c.take('}')) { error = "bad shape object"; return false; }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // names
+
+    namespace
+    {
+        std::mutex&                               nameMutex() { static std::mutex m; return m; }
+        std::unordered_map<uint32_t, std::string>& nameTable() { static std::unordered_map<uint32_t, std::string> t; return t; }
+    }
+
+    uint32_t guideShapeId(const std::string& name)
+    {
+        uint32_t h = 0x811C9DC5u; // FNV-1a
+        for (char ch : name)
+        {
+            h ^= (uint8_t)ch;
+            h *= 0x01000193u;
+        }
+        if (h == 0) h = 1; // 0 means no shape
+
+        std::lock_guard<std::mutex> lock(nameMutex());
+        nameTable().emplace(h, name);
+        return h;
+    }
+
+    std::string guideShapeName(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(nameMutex());
+        const auto it = nameTable().find(id);
+        return it == nameTable().end() ? std::string() : it->second;
+    }
+
+    // ---------------------------------------------------------------------
+    // programs
+
+    std::string shapeCachePath(const std::string& path)
+    {
+        return path + ".bin";
+    }
+
+    bool writeShapeCache(const std::string& cachePath, const ShapeCode& code,
+                         uint64_t sourceSize, int64_t sourceTime, std::string& error)
+    {
+        ShapeCacheHeader h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, kShapeMagic, 4);
+        h.version    = kShapeVersion;
+        h.sourceSize = sourceSize;
+        h.sourceTime = sourceTime;
+        h.opCount    = (uint32_t)code.ops.size();
+        h.pointCount = (uint32_t)(code.points.size() / 2);
+        h.nameLength = (uint32_t)code.name.size();
+
+        std::string file;
+        file.reserve(sizeof(h) + code.points.size() * sizeof(float) + code.ops.size() + code.name.size());
+        file.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        file.append(reinterpret_cast<const char*>(code.points.data()), code.points.size() * sizeof(float));
+        file.append(reinterpret_cast<const char*>(code.ops.data()), code.ops.size());
+        file += code.name;
+        return writeFileAtomic(cachePath, file.data(), file.size(), error);
+    }
+
+    bool ShapeProgram::map(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime)
+    {
+        std::string ignored;
+        if (!mFile.open(cachePath, ignored)) return false;
+
+        // anything unexpected: stale or foreign file, compile again
+        const uint8_t* base = mFile.data();
+        ShapeCacheHeader h;
+        bool ok = mFile.size() >= sizeof(h);
+        if (ok)
+        {
+            std::memcpy(&h, base, sizeof(h));
+            ok = std::memcmp(h.magic, kShapeMagic, 4) == 0 && h.version == kShapeVersion &&
+                 h.sourceSize == sourceSize && h.sourceTime == sourceTime &&
+                 sizeof(h) + (uint64_t)h.pointCount * 2 * sizeof(float) + h.opCount + h.nameLength == mFile.size();
+        }
+        const uint8_t* ops = ok ? base + sizeof(h) + (size_t)h.pointCount * 2 * sizeof(float) : nullptr;
+        if (ok) ok = validOps(ops, h.opCount, h.pointCount);
+        if (!ok)
+        {
+            mFile.close();
+            return false;
+        }
+
+        mPoints     = reinterpret_cast<const float*>(base + sizeof(h));
+        mOps        = ops;
+        mOpCount    = h.opCount;
+        mPointCount = h.pointCount;
+        mName.assign(reinterpret_cast<const char*>(ops + h.opCount), h.nameLength);
+        mId         = guideShapeId(mName);
+        return true;
+    }
+
+    bool ShapeProgram::load(const std::string& path, std::string& error)
+    {
+        uint64_t size = 0;
+        int64_t  time = 0;
+        if (!fileStamp(path, size, time)) { error = "cannot stat " + path; return false; }
+
+        const std::string cachePath = shapeCachePath(path);
+        if (map(cachePath, size, time)) return true;
+
+        MappedFile text;
+        if (!text.open(path, error)) return false;
+
+        ShapeCode code;
+        if (!compileShape(reinterpret_cast<const char*>(text.data()), text.size(), code, error))
+        {
+            error = path + ": " + error;
+            return false;
+        }
+        if (code.name.empty()) code.name = fs::path(path).stem().string();
+
+        std::string ignored;
+        if (writeShapeCache(cachePath, code, size, time, ignored) && map(cachePath, size, time))
+            return true;
+
+        // read-only directory: keep the compiled code in memory
+        mCode       = std::move(code);
+        mOps        = mCode.ops.data();
+        mPoints     = mCode.points.data();
+        mOpCount    = mCode.ops.size();
+        mPointCount = mCode.points.size() / 2;
+        mName       = mCode.name;
+        mId         = guideShapeId(mName);
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // drawing
+
+    // Uniform steps keeping the chord error of a curve with second difference d under tol.
+    static inline int curveSplits(double d, double scale, double tol)
+    {
+        const int n = (int)std::ceil(std::sqrt(d * scale / tol));
+        return (std::max)(1, (std::min)(n, kMaxCurveSplits));
+    }
+
+    static void appendExtraction(const GateRect& gate, double ratio, LineBatch& out)
+    {
+        const double w = gate.right - gate.left;
+        const double h = gate.top   - gate.bottom;
+        if (w <= 0.0 || h <= 0.0 || ratio <= 0.0) return;
+
+        GateRect r = gate;
+        if (ratio > w / h)
+        {
+            const double inset = 0.5 * (h - w / ratio);
+            r.bottom += inset;
+            r.top    -= inset;
+        }
+        else
+        {
+            const double inset = 0.5 * (w - h * ratio);
+            r.left  += inset;
+            r.right -= inset;
+        }
+        appendGateBorder(r, out);
+    }
+
+    void appendShape(const ShapeProgram& shape, const GateRect& gate, double tolerancePx, LineBatch& out)
+    {
+        const double left = gate.left, top = gate.top;
+        const double w = gate.right - gate.left;
+        const double h = gate.top - gate.bottom;
+        const double tol = (std::max)(tolerancePx, 0.01);
+
+        const uint8_t* ops = shape.ops();
+        const float*   pt  = shape.points();
+        uint32_t first = 0, last = 0;
+
+        auto px = [&](int i) { return left + w * (double)pt[2 * i]; };
+        auto py = [&](int i) { return top  - h * (double)pt[2 * i + 1]; };
+        auto lineTo = [&](double x, double y)
+        {
+            const uint32_t b = out.addPoint(x, y);
+            out.indices.push_back(last);
+            out.indices.push_back(b);
+            last = b;
+        };
+
+        for (size_t k = 0; k < shape.opCount(); ++k)
+        {
+            switch (ops[k])
+            {
+            case kShapeMove:
+                first = last = out.addPoint(px(0), py(0));
+                break;
+            case kShapeLine:
+                lineTo(px(0), py(0));
+                break;
+            case kShapeQuad:
+            {
+                const Point2 a = out.points[last];
+                const double bx = px(0), by = py(0), cx = px(1), cy = py(1);
+                const int n = curveSplits(std::hypot(a.x - 2.0 * bx + cx, a.y - 2.0 * by + cy), 0.25, tol);
+                for (int s = 1; s <= n; ++s)
+                {
+                    const double t = (double)s / n, u = 1.0 - t;
+                    lineTo(u * u * a.x + 2.0 * u * t * bx + t * t * cx,
+                           u * u * a.y + 2.0 * u * t * by + t * t * cy);
+                }
+                break;
+            }
+            case kShapeCubic:
+            {
+                const Point2 a = out.points[last];
+                const double bx = px(0), by = py(0), cx = px(1), cy = py(1), dx = px(2), dy = py(2);
+                const double d = (std::max)(std::hypot(a.x - 2.0 * bx + cx, a.y - 2.0 * by + cy),
+                                            std::hypot(bx - 2.0 * cx + dx, by - 2.0 * cy + dy));
+                const int n = curveSplits(d, 0.75, tol);
+                for (int s = 1; s <= n; ++s)
+                {
+                    const double t = (double)s / n, u = 1.0 - t;
+                    const double b0 = u * u * u, b1 = 3.0 * u * u * t, b2 = 3.0 * u * t * t, b3 = t * t * t;
+                    lineTo(b0 * a.x + b1 * bx + b2 * cx + b3 * dx,
+                           b0 * a.y + b1 * by + b2 * cy + b3 * dy);
+                }
+                break;
+            }
+            case kShapeClose:
+                if (last != first)
+                {
+                    out.indices.push_back(last);
+                    out.indices.push_back(first);
+                }
+                last = first;
+                break;
+            case kShapeExtraction:
+                appendExtraction(gate, (double)pt[0], out);
+                break;
+            default:
+                break;
+            }
+            pt += 2 * kOpPoints[ops[k] < kShapeOpCount ? (int)ops[k] : (int)kShapeClose];
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // library
+
+    static bool isShapeFile(const fs::path& p)
+    {
+        return p.extension() == ".json";
+    }
+
+    static std::vector<std::string> splitSearchPath(const std::string& dirs)
+    {
+#ifdef _WIN32
+        const char sep = ';';
+#else
+        const char sep = dirs.find(';') != std::string::npos ? ';' : ':';
+#endif
+        std::vector<std::string> out;
+        size_t begin = 0;
+        while (begin <= dirs.size())
+        {
+            size_t end = dirs.find(sep, begin);
+            if (end == std::string::npos) end = dirs.size();
+            if (end > begin) out.push_back(dirs.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        return out;
+    }
+
+    bool ShapeLibrary::setSearchPath(const std::string& dirs, std::string& error)
+    {
+        const bool wasWatching = watching();
+        stopWatching();
+
+        bool ok = true;
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            const int n = mCount.load(std::memory_order_relaxed);
+            mCount.store(0, std::memory_order_release);
+            for (int i = 0; i < n; ++i)
+            {
+                std::atomic_store(&mSlots[i].program, std::shared_ptr<const ShapeProgram>());
+                mSlots[i].path.clear();
+            }
+
+            mSearchPath = dirs;
+            mDirs = splitSearchPath(dirs);
+
+            // sorted, so the first of two shapes with one name does not depend on the OS
+            std::vector<std::string> files;
+            for (const std::string& dir : mDirs)
+            {
+                std::error_code ec;
+                for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    if (it->is_regular_file(ec) && isShapeFile(it->path()))
+                        files.push_back(it->path().string());
+                }
+            }
+            std::sort(files.begin(), files.end());
+
+            error.clear();
+            for (const std::string& file : files)
+            {
+                std::string fileError;
+                if (!reloadLocked(file, fileError))
+                {
+                    if (!error.empty()) error += '\n';
+                    error += fileError;
+                    ok = false;
+                }
+            }
+            mGeneration.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        if (wasWatching) startWatching();
+        return ok;
+    }
+
+    bool ShapeLibrary::reload(const std::string& path, std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        return reloadLocked(path, error);
+    }
+
+    bool ShapeLibrary::reloadLocked(const std::string& path, std::string& error)
+    {
+        auto program = std::make_shared<ShapeProgram>();
+        const bool loaded = program->load(path, error);
+
+        const int n = mCount.load(std::memory_order_relaxed);
+        int slot = -1;
+        for (int i = 0; i < n && slot < 0; ++i)
+        {
+            if (mSlots[i].path == path) slot = i;
+        }
+
+        // a file that stopped compiling keeps drawing its last good program
+        if (!loaded) return false;
+
+        if (slot < 0)
+        {
+            if (n >= kMaxGuideShapes)
+            {
+                error = "more than " + std::to_string(kMaxGuideShapes) + " shapes; " + path + " skipped";
+                return false;
+            }
+            slot = n;
+            mSlots[slot].path = path;
+            std::atomic_store(&mSlots[slot].program, std::shared_ptr<const ShapeProgram>(std::move(program)));
+            mCount.store(n + 1, std::memory_order_release);
+        }
+        else
+            std::atomic_store(&mSlots[slot].program, std::shared_ptr<const ShapeProgram>(std::move(program)));
+
+        mGeneration.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    void ShapeLibrary::removeLocked(const std::string& path)
+    {
+        const int n = mCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i)
+        {
+            if (mSlots[i].path != path) continue;
+            // the slot stays, so a file saved back later takes it again
+            std::atomic_store(&mSlots[i].program, std::shared_ptr<const ShapeProgram>());
+            mGeneration.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    std::shared_ptr<const ShapeProgram> ShapeLibrary::find(uint32_t id) const
+    {
+        const int n = mCount.load(std::memory_order_acquire);
+        for (int i = 0; i < n; ++i)
+        {
+            std::shared_ptr<const ShapeProgram> p = std::atomic_load(&mSlots[i].program);
+            if (p && p->id() == id) return p;
+        }
+        return nullptr;
+    }
+
+    std::vector<ShapeLibrary::Entry> ShapeLibrary::entries() const
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        std::vector<Entry> out;
+        const int n = mCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i)
+        {
+            const std::shared_ptr<const ShapeProgram> p = std::atomic_load(&mSlots[i].program);
+            if (!p) continue;
+            Entry e;
+            e.path      = mSlots[i].path;
+            e.name      = p->name();
+            e.fromCache = p->fromCache();
+            e.opCount   = p->opCount();
+            out.push_back(std::move(e));
+        }
+        return out;
+    }
+
+    void ShapeLibrary::startWatching()
+    {
+        if (watching()) return;
+        mStop.store(false);
+        mWatcher = std::thread([this] { watch(); });
+    }
+
+    void ShapeLibrary::stopWatching()
+    {
+        if (!watching()) return;
+        mStop.store(true);
+        mWatcher.join();
+    }
+
+    void ShapeLibrary::watch()
+    {
+        std::vector<std::string> dirs;
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            dirs = mDirs;
+        }
+
+#ifdef __linux__
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0)
+        {
+            // editors save in place (close after write) or through a rename
+            std::map<int, std::string> watches;
+            for (const std::string& dir : dirs)
+            {
+                const int wd = inotify_add_watch(fd, dir.c_str(),
+                                                 IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+                if (wd >= 0) watches[wd] = dir;
+            }
+
+            alignas(inotify_event) char buf[4096];
+            while (!mStop.load())
+            {
+                pollfd pfd{ fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 100) <= 0) continue;
+
+                // one batch: each changed file is compiled once
+                std::map<std::string, bool> changed; // path -> still there
+                ssize_t len;
+                while ((len = read(fd, buf, sizeof(buf))) > 0)
+                {
+                    for (char* p = buf; p < buf + len;)
+                    {
+                        const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                        p += sizeof(inotify_event) + ev->len;
+
+                        const auto dir = watches.find(ev->wd);
+                        if (dir == watches.end() || ev->len == 0) continue;
+                        const fs::path file = fs::path(dir->second) / ev->name;
+                        if (!isShapeFile(file)) continue;
+                        changed[file.string()] = (ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0;
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mWriteMutex);
+                for (const auto& c : changed)
+                {
+                    std::string ignored;
+                    if (c.second) reloadLocked(c.first, ignored);
+                    else          removeLocked(c.first);
+                }
+            }
+            close(fd);
+            return;
+        }
+#endif
+
+        // polling: compare sizes and modification times
+        std::map<std::string, std::pair<uint64_t, int64_t>> known;
+        auto scan = [&](std::map<std::string, std::pair<uint64_t, int64_t>>& out)
+        {
+            out.clear();
+            for (const std::string& dir : dirs)
+            {
+                std::error_code ec;
+                for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    uint64_t size = 0;
+                    int64_t  time = 0;
+                    if (isShapeFile(it->path()) && fileStamp(it->path().string(), size, time))
+                        out[it->path().string()] = std::make_pair(size, time);
+                }
+            }
+        };
+        scan(known);
+
+        std::map<std::string, std::pair<uint64_t, int64_t>> now;
+        while (!mStop.load())
+        {
+            for (int i = 0; i < 5 && !mStop.load(); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (mStop.load()) break;
+
+            scan(now);
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            for (const auto& f : now)
+            {
+                const auto k = known.find(f.first);
+                std::string ignored;
+                if (k == known.end() || k->second != f.second) reloadLocked(f.first, ignored);
+            }
+            for (const auto& k : known)
+            {
+                if (!now.count(k.first)) removeLocked(k.first);
+            }
+            known.swap(now);
+        }
+    }
+
+    ShapeLibrary& guideShapes()
+    {
+        static ShapeLibrary library;
+        return library;
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+// aoViewportGuideShapes.h (v0.3.1)
+// User guide shapes (no Maya types). A shape file draws lines in normalized gate
+// space, (0,0) the top-left corner of the gate and (1,1) the bottom-right one:
+//
+//   { "name": "logo safe",
+//     "paths":       ["M 0.04 0.05 H 0.3 V 0.18 H 0.04 Z", "M 0.5 0.4 Q 0.55 0.5 0.5 0.6"],
+//     "rects":       [[0.1, 0.1, 0.9, 0.9]],
+//     "ellipses":    [[0.5, 0.5, 0.02, 0.035]],
+//     "extractions": [2.39, 1.85] }
+//
+// Paths take the SVG commands M L H V C S Q T Z (absolute and relative; no arcs).
+// An extraction is the centred frame of that aspect ratio inside the gate, so it
+// follows the gate's own aspect. A file compiles once into a command buffer
+// (ops plus float points, cached next to it as <file>.bin and memory mapped);
+// drawing only transforms the points to the gate rect and flattens the curves to
+// the pixel tolerance.
+//
+// Layers refer to a shape by the id of its name (guideShapeId()). The library
+// watches its directories (inotify on Linux, polling elsewhere), recompiles just
+// the file that changed on the watcher thread and swaps the new program in;
+// readers keep the program they hold until they drop it.
+
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideMappedFile.h"
+#include "aoViewportGuideTypes.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    enum ShapeOp : uint8_t
+    {
+        kShapeMove       = 0, // 1 point
+        kShapeLine       = 1, // 1 point
+        kShapeQuad       = 2, // control, end
+        kShapeCubic      = 3, // control, control, end
+        kShapeClose      = 4, // back to the last move
+        kShapeExtraction = 5, // 1 point: (ratio, 0)
+        kShapeOpCount
+    };
+
+    // Compiled shape, independent of any gate.
+    struct ShapeCode
+    {
+        std::string          name;
+        std::vector<uint8_t> ops;
+        std::vector<float>   points; // x, y pairs in op order
+    };
+
+    // Parses a shape file. A missing "name" is left empty (the library uses the file stem).
+    bool compileShape(const char* text, size_t size, ShapeCode& out, std::string& error);
+
+    // Non-zero FNV-1a of the name; the name is remembered for guideShapeName().
+    uint32_t    guideShapeId(const std::string& name);
+    // Name a guideShapeId() was computed for, empty when it was never seen.
+    std::string guideShapeName(uint32_t id);
+
+    class ShapeProgram
+    {
+    public:
+        // Maps <path>.bin when it matches the file's size and modification time,
+        // compiles the file and rewrites the cache otherwise (kept in memory when
+        // the cache cannot be written).
+        bool load(const std::string& path, std::string& error);
+
+        const std::string& name() const { return mName; }
+        uint32_t           id() const   { return mId; }
+        bool               fromCache() const { return mFile.isOpen(); }
+
+        size_t         opCount() const    { return mOpCount; }
+        size_t         pointCount() const { return mPointCount; }
+        const uint8_t* ops() const        { return mOps; }
+        const float*   points() const     { return mPoints; }
+
+    private:
+        bool map(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime);
+
+        std::string mName;
+        uint32_t    mId = 0;
+
+        MappedFile     mFile;
+        ShapeCode      mCode; // when not mapped
+        const uint8_t* mOps = nullptr;
+        const float*   mPoints = nullptr;
+        size_t         mOpCount = 0;
+        size_t         mPointCount = 0;
+    };
+
+    // <path>.bin
+    std::string shapeCachePath(const std::string& path);
+
+    // Writes the cache for code compiled from a file of that size and time.
+    bool writeShapeCache(const std::string& cachePath, const ShapeCode& code,
+                         uint64_t sourceSize, int64_t sourceTime, std::string& error);
+
+    // Transforms the program into gate and appends it; curves are split until the
+    // chord error stays under tolerancePx.
+    void appendShape(const ShapeProgram& shape, const GateRect& gate, double tolerancePx, LineBatch& out);
+
+    static constexpr int kMaxGuideShapes = 256;
+
+    class ShapeLibrary
+    {
+    public:
+        ShapeLibrary() = default;
+        ~ShapeLibrary() { stopWatching(); }
+
+        ShapeLibrary(const ShapeLibrary&) = delete;
+        ShapeLibrary& operator=(const ShapeLibrary&) = delete;
+
+        // Loads every *.json of the directories (separated by ';', or ':' off
+        // Windows), replacing the shapes loaded before. Files that fail to
+        // compile are skipped and reported in error; returns false when any did.
+        // Keeps watching when it was.
+        bool setSearchPath(const std::string& dirs, std::string& error);
+        const std::string& searchPath() const { return mSearchPath; }
+
+        // Recompiles one file and swaps it in (a file outside the library is added).
+        bool reload(const std::string& path, std::string& error);
+
+        // Any thread. The first loaded shape with that id, null when none.
+        std::shared_ptr<const ShapeProgram> find(uint32_t id) const;
+
+        // Bumped after every swap, so cached geometry knows to rebuild.
+        uint64_t generation() const { return mGeneration.load(std::memory_order_acquire); }
+
+        struct Entry
+        {
+            std::string path;
+            std::string name;
+            bool        fromCache = false;
+            size_t      opCount = 0;
+        };
+        std::vector<Entry> entries() const;
+
+        // Background thread that reloads changed files and drops deleted ones.
+        void startWatching();
+        void stopWatching();
+        bool watching() const { return mWatcher.joinable(); }
+
+    private:
+        struct Slot
+        {
+            std::string                         path;    // written under mWriteMutex
+            std::shared_ptr<const ShapeProgram> program; // std::atomic_load / store
+        };
+
+        bool reloadLocked(const std::string& path, std::string& error);
+        void removeLocked(const std::string& path);
+        void watch();
+
+        std::string                 mSearchPath;
+        std::vector<std::string>    mDirs;
+        Slot                        mSlots[kMaxGuideShapes];
+        std::atomic<int>            mCount{ 0 };
+        std::atomic<uint64_t>       mGeneration{ 0 };
+        mutable std::mutex          mWriteMutex;
+
+        std::thread       mWatcher;
+        std::atomic<bool> mStop{ false };
+    };
+
+    // The library the plugin and the burn-in draw from.
+    ShapeLibrary& guideShapes();
+}
@@ -0,0 +1,149 @@
+// aoViewportGuideShapesCmd.cpp (v0.3.1)
+
+#include "aoViewportGuideShapesCmd.h"
+#include "aoViewportGuideShapes.h"
+
+#include <maya/M3dView.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MGlobal.h>
+#include <maya/MMessage.h>
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <maya/MTimerMessage.h>
+
+#include <cstdlib>
+#include <string>
+
+namespace AoViewportGuide
+{
+    static const char* kPathFlag       = "-p";
+    static const char* kPathFlagLong   = "-path";
+    static const char* kListFlag       = "-ls";
+    static const char* kListFlagLong   = "-list";
+    static const char* kReloadFlag     = "-r";
+    static const char* kReloadFlagLong = "-reload";
+    static const char* kWatchFlag      = "-w";
+    static const char* kWatchFlagLong  = "-watch";
+
+    static const char* kPathOptionVar  = "aoViewportGuideShapePath";
+
+    const char* AoViewportGuideShapesCmd::commandName = "aoViewportGuideShapes";
+
+    namespace
+    {
+        MCallbackId gRefreshTimer = 0;
+        uint64_t    gSeenGeneration = 0;
+    }
+
+    // The watcher thread cannot touch the UI; the generation it bumps is picked up here.
+    static void refreshTimerCB(float, float, void*)
+    {
+        const uint64_t generation = guideShapes().generation();
+        if (generation == gSeenGeneration) return;
+        gSeenGeneration = generation;
+        M3dView::scheduleRefreshAllViews();
+    }
+
+    static bool loadSearchPath(const std::string& dirs)
+    {
+        std::string error;
+        const bool ok = guideShapes().setSearchPath(dirs, error);
+        if (!ok) MGlobal::displayWarning(MString("[ao_viewport_guide] ") + error.c_str());
+        return ok;
+    }
+
+    void installShapeCallbacks()
+    {
+        std::string dirs;
+        if (const char* env = std::getenv("AO_VIEWPORT_GUIDE_SHAPES"))
+            dirs = env;
+        else
+        {
+            bool exists = false;
+            const MString saved = MGlobal::optionVarStringValue(kPathOptionVar, &exists);
+            if (exists) dirs = saved.asChar();
+        }
+
+        if (!dirs.empty()) loadSearchPath(dirs);
+        guideShapes().startWatching();
+
+        if (!gRefreshTimer)
+        {
+            MStatus s;
+            gRefreshTimer = MTimerMessage::addTimerCallback(0.25f, refreshTimerCB, nullptr, &s);
+            if (!s) gRefreshTimer = 0;
+        }
+    }
+
+    void removeShapeCallbacks()
+    {
+        if (gRefreshTimer)
+        {
+            MMessage::removeCallback(gRefreshTimer);
+            gRefreshTimer = 0;
+        }
+        guideShapes().stopWatching();
+    }
+
+    void* AoViewportGuideShapesCmd::creator()
+    {
+        return new AoViewportGuideShapesCmd();
+    }
+
+    MSyntax AoViewportGuideShapesCmd::newSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag(kPathFlag,   kPathFlagLong,   MSyntax::kString);
+        syntax.addFlag(kListFlag,   kListFlagLong);
+        syntax.addFlag(kReloadFlag, kReloadFlagLong);
+        syntax.addFlag(kWatchFlag,  kWatchFlagLong,  MSyntax::kBoolean);
+        syntax.enableQuery(true);
+        return syntax;
+    }
+
+    MStatus AoViewportGuideShapesCmd::doIt(const MArgList& args)
+    {
+        MStatus stat;
+        MArgDatabase db(syntax(), args, &stat);
+        if (!stat) return stat;
+
+        ShapeLibrary& library = guideShapes();
+
+        if (db.isQuery())
+        {
+            if (db.isFlagSet(kWatchFlag))
+                setResult(library.watching());
+            else
+                setResult(MString(library.searchPath().c_str()));
+            return MS::kSuccess;
+        }
+
+        if (db.isFlagSet(kPathFlag))
+        {
+            MString dirs;
+            db.getFlagArgument(kPathFlag, 0, dirs);
+            MGlobal::setOptionVarValue(kPathOptionVar, dirs);
+            loadSearchPath(dirs.asChar());
+        }
+        else if (db.isFlagSet(kReloadFlag))
+        {
+            // cached programs whose file did not change are only mapped again
+            loadSearchPath(library.searchPath());
+        }
+
+        if (db.isFlagSet(kWatchFlag))
+        {
+            bool on = true;
+            db.getFlagArgument(kWatchFlag, 0, on);
+            if (on) library.startWatching();
+            else    library.stopWatching();
+        }
+
+        // -list, also the default
+        MStringArray shapes;
+        for (const ShapeLibrary::Entry& e : library.entries())
+            shapes.append(MString(e.name.c_str()) + "\t" + e.path.c_str());
+        setResult(shapes);
+        return MS::kSuccess;
+    }
+}
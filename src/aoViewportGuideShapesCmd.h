@@ -0,0 +1,28 @@
+#pragma once
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+
+namespace AoViewportGuide
+{
+    // aoViewportGuideShapes [-path dirs] [-list] [-reload] [-watch bool]
+    // Shape library the shape layers draw from (see aoViewportGuideShapes.h).
+    // -path loads every shape file of the directories and is kept in the
+    // aoViewportGuideShapePath optionVar; -list returns "name<TAB>file" per shape;
+    // -reload compiles the changed files again; -watch turns hot reloading on / off.
+    // Query -path with -q.
+    class AoViewportGuideShapesCmd : public MPxCommand
+    {
+    public:
+        static const char* commandName;
+
+        static void*   creator();
+        static MSyntax newSyntax();
+
+        MStatus doIt(const MArgList& args) override;
+    };
+
+    // Loads $AO_VIEWPORT_GUIDE_SHAPES (or the optionVar) and starts watching; a
+    // timer refreshes the viewports after the watcher swapped a shape in.
+    void installShapeCallbacks();
+    void removeShapeCallbacks();
+}
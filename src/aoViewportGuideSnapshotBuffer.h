@@ -0,0 +1,131 @@
+#pragma once
+// aoViewportGuideSnapshotBuffer.h (v0.3.1)
+// Published snapshot of a trivially copyable value. Writers (Maya callbacks on
+// the main thread) copy a new value into the next slot of a small ring; any
+// number of reader threads (draw callbacks, parallel evaluation) copy the
+// latest one out without locks or DG access. Each slot is a seqlock: a reader
+// only retries when writers lap it by a whole ring during its copy. No Maya
+// types in here, so it can be stress tested outside of Maya.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace AoViewportGuide
+{
+    template <class T, int Slots = 3>
+    class SnapshotBuffer
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SnapshotBuffer needs a trivially copyable T");
+        static_assert(Slots >= 2, "SnapshotBuffer needs at least two slots");
+
+    public:
+        struct Snapshot
+        {
+            T        data{};
+            uint64_t generation = 0; // 0 = nothing published yet (data is T{})
+        };
+
+        SnapshotBuffer()
+        {
+            for (Slot& slot : mSlots) slot.generation.store(0, std::memory_order_relaxed);
+            storeWords(mSlots[0], T{});
+        }
+
+        SnapshotBuffer(const SnapshotBuffer&) = delete;
+        SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+        // Copies value into the next slot and makes it current. Writers are
+        // serialized among themselves; readers are never blocked.
+        uint64_t publish(const T& value)
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+
+            const uint64_t gen = mPublished.load(std::memory_order_relaxed) + 1;
+            Slot& slot = mSlots[gen % Slots];
+
+            slot.generation.store(kWriting, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            storeWords(slot, value);
+            slot.generation.store(gen, std::memory_order_release);
+
+            mPublished.store(gen, std::memory_order_release);
+            mPublishes.fetch_add(1, std::memory_order_relaxed);
+            return gen;
+        }
+
+        // Latest published value; never touches the writer's lock.
+        Snapshot read() const
+        {
+            Snapshot snap;
+            for (;;)
+            {
+                const uint64_t gen = mPublished.load(std::memory_order_acquire);
+                const Slot& slot = mSlots[gen % Slots];
+
+                const uint64_t before = slot.generation.load(std::memory_order_acquire);
+                loadWords(slot, snap.data);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t after = slot.generation.load(std::memory_order_relaxed);
+
+                if (before == gen && after == gen)
+                {
+                    snap.generation = gen;
+                    break;
+                }
+                mRetries.fetch_add(1, std::memory_order_relaxed);
+            }
+            mReads.fetch_add(1, std::memory_order_relaxed);
+            return snap;
+        }
+
+        uint64_t generation() const { return mPublished.load(std::memory_order_acquire); }
+
+        uint64_t publishes() const { return mPublishes.load(std::memory_order_relaxed); }
+        uint64_t reads() const     { return mReads.load(std::memory_order_relaxed); }
+        uint64_t retries() const   { return mRetries.load(std::memory_order_relaxed); }
+        void resetCounters()
+        {
+            mPublishes.store(0, std::memory_order_relaxed);
+            mReads.store(0, std::memory_order_relaxed);
+            mRetries.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr uint64_t kWriting = ~uint64_t(0);
+        static constexpr size_t   kWords   = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        // Words are relaxed atomics so a torn copy is a detected retry, not a data race.
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> generation;
+            std::atomic<uint64_t> words[kWords];
+        };
+
+        static void storeWords(Slot& slot, const T& value)
+        {
+            uint64_t buf[kWords] = {};
+            std::memcpy(buf, &value, sizeof(T));
+            for (size_t i = 0; i < kWords; ++i)
+                slot.words[i].store(buf[i], std::memory_order_relaxed);
+        }
+
+        static void loadWords(const Slot& slot, T& value)
+        {
+            uint64_t buf[kWords];
+            for (size_t i = 0; i < kWords; ++i)
+                buf[i] = slot.words[i].load(std::memory_order_relaxed);
+            std::memcpy(&value, buf, sizeof(T));
+        }
+
+        Slot                              mSlots[Slots];
+        alignas(64) std::atomic<uint64_t> mPublished{ 0 };
+        std::mutex                        mWriteMutex;
+
+        std::atomic<uint64_t>         mPublishes{ 0 };
+        mutable std::atomic<uint64_t> mReads{ 0 };
+        mutable std::atomic<uint64_t> mRetries{ 0 };
+    };
+}
@@ -0,0 +1,282 @@
+// aoViewportGuideStats.cpp (v0.3.1)
+
+#include "aoViewportGuideStats.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace AoViewportGuide
+{
+    struct FrameSample
+    {
+        uint64_t ns[kStageCount] = {};
+        uint32_t primitives = 0;
+        uint32_t quality = 0;   // QualityLevel, 0 = full
+        uint64_t savedNs = 0;
+    };
+
+    // fixed storage: recording never allocates
+    struct PanelStats
+    {
+        char        name[64] = {};
+        FrameSample current;
+        bool        inFrame = false;
+        FrameSample ring[kStatsRingSize];
+        int         head  = 0; // next write
+        int         count = 0;
+    };
+
+    static bool       gStatsEnabled = false;
+    static PanelStats gPanels[kStatsMaxPanels];
+    static int        gPanelCount = 0;
+
+    static const char* kStageNames[kStageCount] = {
+        "scene", "quad", "hud", "present", "settings", "gate", "geometry"
+    };
+
+    const char* statsStageName(int stage)
+    {
+        return (stage >= 0 && stage < kStageCount) ? kStageNames[stage] : "?";
+    }
+
+    void statsSetEnabled(bool enabled)
+    {
+        gStatsEnabled = enabled;
+    }
+
+    bool statsEnabled()
+    {
+        return gStatsEnabled;
+    }
+
+    int statsBeginFrame(const char* panel)
+    {
+        if (!gStatsEnabled || !panel) return -1;
+
+        int slot = -1;
+        for (int i = 0; i < gPanelCount; ++i)
+        {
+            if (std::strncmp(gPanels[i].name, panel, sizeof(gPanels[i].name) - 1) == 0) { slot = i; break; }
+        }
+        if (slot < 0)
+        {
+            if (gPanelCount >= kStatsMaxPanels) return -1;
+            slot = gPanelCount++;
+            std::strncpy(gPanels[slot].name, panel, sizeof(gPanels[slot].name) - 1);
+        }
+
+        PanelStats& p = gPanels[slot];
+        p.current = FrameSample();
+        p.inFrame = true;
+        return slot;
+    }
+
+    void statsAddTime(int slot, int stage, uint64_t ns)
+    {
+        if (slot < 0 || slot >= gPanelCount || stage < 0 || stage >= kStageCount) return;
+        gPanels[slot].current.ns[stage] += ns;
+    }
+
+    void statsAddPrimitives(int slot, uint32_t count)
+    {
+        if (slot < 0 || slot >= gPanelCount) return;
+        gPanels[slot].current.primitives += count;
+    }
+
+    void statsSetQuality(int slot, int level, uint64_t savedNs)
+    {
+        if (slot < 0 || slot >= gPanelCount) return;
+        gPanels[slot].current.quality = (uint32_t)level;
+        gPanels[slot].current.savedNs += savedNs;
+    }
+
+    void statsEndFrame(int slot)
+    {
+        if (slot < 0 || slot >= gPanelCount) return;
+
+        PanelStats& p = gPanels[slot];
+        if (!p.inFrame) return;
+        p.inFrame = false;
+
+        p.ring[p.head] = p.current;
+        p.head = (p.head + 1) % kStatsRingSize;
+        if (p.count < kStatsRingSize) ++p.count;
+    }
+
+    void statsReset()
+    {
+        for (int i = 0; i < gPanelCount; ++i)
+            gPanels[i] = PanelStats();
+        gPanelCount = 0;
+    }
+
+    // ---------------------------------------------------------------------
+    // summaries (query time, may allocate)
+
+    struct StageSummary
+    {
+        double meanUs = 0.0;
+        double p95Us  = 0.0;
+        double maxUs  = 0.0;
+    };
+
+    static StageSummary summarizeStage(const PanelStats& p, int stage)
+    {
+        StageSummary s;
+        if (p.count == 0) return s;
+
+        uint64_t values[kStatsRingSize];
+        uint64_t sum = 0;
+        for (int i = 0; i < p.count; ++i)
+        {
+            values[i] = p.ring[i].ns[stage];
+            sum += values[i];
+        }
+
+        const int k = (p.count * 95 + 99) / 100 - 1;
+        std::nth_element(values, values + k, values + p.count);
+
+        s.meanUs = (double)sum / (double)p.count * 1.0e-3;
+        s.p95Us  = (double)values[k] * 1.0e-3;
+        s.maxUs  = (double)*std::max_element(values, values + p.count) * 1.0e-3;
+        return s;
+    }
+
+    static double meanPrimitives(const PanelStats& p)
+    {
+        if (p.count == 0) return 0.0;
+        uint64_t sum = 0;
+        for (int i = 0; i < p.count; ++i) sum += p.ring[i].primitives;
+        return (double)sum / (double)p.count;
+    }
+
+    struct QualitySummary
+    {
+        double meanLevel = 0.0;
+        double reduced   = 0.0; // fraction of frames below full quality
+        int    lastLevel = 0;
+        double savedUs   = 0.0; // mean per frame
+    };
+
+    static QualitySummary summarizeQuality(const PanelStats& p)
+    {
+        QualitySummary q;
+        if (p.count == 0) return q;
+
+        uint64_t levels = 0, reduced = 0, saved = 0;
+        for (int i = 0; i < p.count; ++i)
+        {
+            levels  += p.ring[i].quality;
+            reduced += p.ring[i].quality != 0;
+            saved   += p.ring[i].savedNs;
+        }
+        q.meanLevel = (double)levels / (double)p.count;
+        q.reduced   = (double)reduced / (double)p.count;
+        q.lastLevel = (int)p.ring[(p.head + kStatsRingSize - 1) % kStatsRingSize].quality;
+        q.savedUs   = (double)saved / (double)p.count * 1.0e-3;
+        return q;
+    }
+
+    static double hitRate(uint64_t hits, uint64_t misses)
+    {
+        const uint64_t total = hits + misses;
+        return total ? (double)hits / (double)total : 0.0;
+    }
+
+    static void appendf(std::string& out, const char* fmt, ...)
+    {
+        char buf[512];
+        va_list args;
+        va_start(args, fmt);
+        const int n = std::vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n > 0) out.append(buf, (size_t)(std::min)(n, (int)sizeof(buf) - 1));
+    }
+
+    std::string statsSummaryText(const StatsCacheCounters& caches)
+    {
+        std::string out;
+        appendf(out, "aoViewportGuideStats: %s, %d panel(s), up to %d frames each (us: mean / p95 / max)\n",
+                gStatsEnabled ? "on" : "off", gPanelCount, kStatsRingSize);
+
+        for (int i = 0; i < gPanelCount; ++i)
+        {
+            const PanelStats& p = gPanels[i];
+            appendf(out, "%s  (%d frames)\n", p.name, p.count);
+            for (int st = 0; st < kStageCount; ++st)
+            {
+                const StageSummary s = summarizeStage(p, st);
+                appendf(out, "  %-10s %9.1f %9.1f %9.1f\n", kStageNames[st], s.meanUs, s.p95Us, s.maxUs);
+            }
+            appendf(out, "  %-10s %9.1f\n", "primitives", meanPrimitives(p));
+
+            const QualitySummary q = summarizeQuality(p);
+            appendf(out, "  %-10s level %d now, %.2f mean, %.1f%% of frames reduced, %.1f us/frame saved\n",
+                    "quality", q.lastLevel, q.meanLevel, 100.0 * q.reduced, q.savedUs);
+        }
+
+        appendf(out, "settings cache: %llu hits, %llu loads (%.1f%%)\n",
+                (unsigned long long)caches.settingsHits, (unsigned long long)caches.settingsLoads,
+                100.0 * hitRate(caches.settingsHits, caches.settingsLoads));
+        appendf(out, "gate cache:     %llu hits, %llu misses (%.1f%%)\n",
+                (unsigned long long)caches.gateHits, (unsigned long long)caches.gateMisses,
+                100.0 * hitRate(caches.gateHits, caches.gateMisses));
+        appendf(out, "geometry cache: %llu hits, %llu misses (%.1f%%), %llu evictions\n",
+                (unsigned long long)caches.geometryHits, (unsigned long long)caches.geometryMisses,
+                100.0 * hitRate(caches.geometryHits, caches.geometryMisses),
+                (unsigned long long)caches.geometryEvictions);
+        return out;
+    }
+
+    static void appendJsonString(std::string& out, const char* s)
+    {
+        out += '"';
+        for (; *s; ++s)
+        {
+            const char c = *s;
+            if (c == '"' || c == '\\') { out += '\\'; out += c; }
+            else if ((unsigned char)c < 0x20) appendf(out, "\\u%04x", (unsigned)c);
+            else out += c;
+        }
+        out += '"';
+    }
+
+    std::string statsSummaryJson(const StatsCacheCounters& caches)
+    {
+        std::string out;
+        appendf(out, "{\"enabled\":%s,\"ringSize\":%d,\"panels\":[", gStatsEnabled ? "true" : "false", kStatsRingSize);
+
+        for (int i = 0; i < gPanelCount; ++i)
+        {
+            const PanelStats& p = gPanels[i];
+            if (i) out += ',';
+            out += "{\"name\":";
+            appendJsonString(out, p.name);
+            appendf(out, ",\"frames\":%d,\"stages\":{", p.count);
+            for (int st = 0; st < kStageCount; ++st)
+            {
+                const StageSummary s = summarizeStage(p, st);
+                appendf(out, "%s\"%s\":{\"meanUs\":%.3f,\"p95Us\":%.3f,\"maxUs\":%.3f}",
+                        st ? "," : "", kStageNames[st], s.meanUs, s.p95Us, s.maxUs);
+            }
+            const QualitySummary q = summarizeQuality(p);
+            appendf(out, "},\"primitivesMean\":%.2f,\"quality\":{\"level\":%d,\"meanLevel\":%.3f,"
+                         "\"reducedFraction\":%.4f,\"savedUsMean\":%.3f}}",
+                    meanPrimitives(p), q.lastLevel, q.meanLevel, q.reduced, q.savedUs);
+        }
+
+        appendf(out, "],\"caches\":{\"settings\":{\"hits\":%llu,\"loads\":%llu,\"hitRate\":%.4f},"
+                     "\"gate\":{\"hits\":%llu,\"misses\":%llu,\"hitRate\":%.4f},"
+                     "\"geometry\":{\"hits\":%llu,\"misses\":%llu,\"hitRate\":%.4f,\"evictions\":%llu}}}",
+                (unsigned long long)caches.settingsHits, (unsigned long long)caches.settingsLoads,
+                hitRate(caches.settingsHits, caches.settingsLoads),
+                (unsigned long long)caches.gateHits, (unsigned long long)caches.gateMisses,
+                hitRate(caches.gateHits, caches.gateMisses),
+                (unsigned long long)caches.geometryHits, (unsigned long long)caches.geometryMisses,
+                hitRate(caches.geometryHits, caches.geometryMisses),
+                (unsigned long long)caches.geometryEvictions);
+        return out;
+    }
+}
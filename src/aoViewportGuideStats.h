@@ -0,0 +1,62 @@
+#pragma once
+// aoViewportGuideStats.h (v0.3.1)
+// Rolling per-panel frame statistics for aoViewportGuideStats (no Maya types).
+// Off by default; while off, every entry point returns after one flag check.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace AoViewportGuide
+{
+    enum StatsStage
+    {
+        kStageScene = 0,  // scene render op (clear + scene draw), or Maya's standard operations
+        kStageQuad,       // shader backend full screen pass
+        kStageHud,        // HUD op: overlay and annotation submission (kStageGeometry) plus Maya's HUD
+        kStagePresent,
+        kStageSettings,   // settings snapshot access, in setup()
+        kStageGate,       // gate rect (cached) lookup, in setup()
+        kStageGeometry,   // guide geometry build + HUD submission
+        kStageCount
+    };
+
+    const char* statsStageName(int stage);
+
+    // cumulative cache counters, sampled when the summary is built
+    struct StatsCacheCounters
+    {
+        uint64_t settingsHits  = 0;
+        uint64_t settingsLoads = 0;
+        uint64_t gateHits      = 0;
+        uint64_t gateMisses    = 0;
+        uint64_t geometryHits      = 0; // shared overlay geometry (GeometryCache)
+        uint64_t geometryMisses    = 0;
+        uint64_t geometryEvictions = 0;
+    };
+
+    static constexpr int kStatsMaxPanels = 32;
+    static constexpr int kStatsRingSize  = 240; // frames kept per panel
+
+    inline uint64_t statsNow()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void statsSetEnabled(bool enabled);
+    bool statsEnabled();
+
+    // Returns the panel slot for this frame, or -1 when disabled (or out of slots).
+    int  statsBeginFrame(const char* panel);
+    void statsAddTime(int slot, int stage, uint64_t ns);
+    void statsAddPrimitives(int slot, uint32_t count);
+    // overlay quality level of the frame (QualityGovernor) and the time it saved
+    void statsSetQuality(int slot, int level, uint64_t savedNs);
+    void statsEndFrame(int slot);
+
+    void statsReset();
+
+    std::string statsSummaryText(const StatsCacheCounters& caches);
+    std::string statsSummaryJson(const StatsCacheCounters& caches);
+}
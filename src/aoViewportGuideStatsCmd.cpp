@@ -0,0 +1,82 @@
+// aoViewportGuideStatsCmd.cpp (v0.3.1)
+
+#include "aoViewportGuideStatsCmd.h"
+#include "aoViewportGuideStats.h"
+#include "aoViewportGuideSettings.h"
+#include "aoViewportGuideGate.h"
+#include "aoViewportGuideGeometryCache.h"
+
+#include <maya/MArgDatabase.h>
+#include <maya/MString.h>
+
+namespace AoViewportGuide
+{
+    static const char* kEnableFlag     = "-e";
+    static const char* kEnableFlagLong = "-enable";
+    static const char* kResetFlag      = "-r";
+    static const char* kResetFlagLong  = "-reset";
+    static const char* kJsonFlag       = "-j";
+    static const char* kJsonFlagLong   = "-json";
+
+    const char* AoViewportGuideStatsCmd::commandName = "aoViewportGuideStats";
+
+    void* AoViewportGuideStatsCmd::creator()
+    {
+        return new AoViewportGuideStatsCmd();
+    }
+
+    MSyntax AoViewportGuideStatsCmd::newSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag(kEnableFlag, kEnableFlagLong, MSyntax::kBoolean);
+        syntax.addFlag(kResetFlag,  kResetFlagLong);
+        syntax.addFlag(kJsonFlag,   kJsonFlagLong);
+        return syntax;
+    }
+
+    static StatsCacheCounters cacheCounters()
+    {
+        StatsCacheCounters c;
+        c.settingsHits  = AoViewportGuideSettings::cacheHits();
+        c.settingsLoads = AoViewportGuideSettings::cacheLoads();
+
+        const GateCacheStats gate = gateCacheStats();
+        c.gateHits   = gate.hits;
+        c.gateMisses = gate.misses;
+
+        const GuideGeometryCacheStats geometry = guideGeometryCacheStats();
+        c.geometryHits      = geometry.hits;
+        c.geometryMisses    = geometry.misses;
+        c.geometryEvictions = geometry.evictions;
+        return c;
+    }
+
+    MStatus AoViewportGuideStatsCmd::doIt(const MArgList& args)
+    {
+        MStatus stat;
+        MArgDatabase db(syntax(), args, &stat);
+        if (!stat) return stat;
+
+        if (db.isFlagSet(kEnableFlag))
+        {
+            bool on = false;
+            db.getFlagArgument(kEnableFlag, 0, on);
+            statsSetEnabled(on);
+        }
+
+        if (db.isFlagSet(kResetFlag))
+        {
+            statsReset();
+            resetGateCacheStats();
+            resetGuideGeometryCacheStats();
+            AoViewportGuideSettings::resetCacheCounters();
+        }
+
+        const StatsCacheCounters caches = cacheCounters();
+        if (db.isFlagSet(kJsonFlag))
+            setResult(MString(statsSummaryJson(caches).c_str()));
+        else
+            setResult(MString(statsSummaryText(caches).c_str()));
+        return MS::kSuccess;
+    }
+}
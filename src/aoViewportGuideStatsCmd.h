@@ -0,0 +1,20 @@
+#pragma once
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+
+namespace AoViewportGuide
+{
+    // aoViewportGuideStats [-enable bool] [-reset] [-json]
+    // Without -json the result is a text table; recording is off until -enable true.
+    class AoViewportGuideStatsCmd : public MPxCommand
+    {
+    public:
+        static const char* commandName;
+
+        static void*   creator();
+        static MSyntax newSyntax();
+
+        MStatus doIt(const MArgList& args) override;
+        bool isUndoable() const override { return false; }
+    };
+}
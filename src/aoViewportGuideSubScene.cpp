@@ -0,0 +1,481 @@
+// aoViewportGuideSubScene.cpp (v0.3.1)
+// Cached draw backend: guide geometry lives in persistent vertex/index buffers
+// owned by render items, and is only rebuilt when the guide type or the gate
+// size changes; other settings changes re-style the shaders (keyed on the
+// settings hash). Geometry is generated in gate-local space; the gate offset,
+// viewport and camera go into the item matrix, so panning/tumbling and
+// switching between panels never re-upload.
+
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuideSubScene.h"
+#include "aoViewportGuideSettings.h"
+#include "aoViewportGuideGate.h"
+#include "aoViewportGuideGeometry.h"
+#include "aoViewportGuideTessellation.h"
+
+#include <maya/MFnDependencyNode.h>
+#include <maya/MDagModifier.h>
+#include <maya/MItDependencyNodes.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MObjectArray.h>
+#include <maya/MFnDagNode.h>
+#include <maya/MPlug.h>
+#include <maya/MMatrix.h>
+#include <maya/MBoundingBox.h>
+#include <maya/MFrameContext.h>
+#include <maya/MViewport2Renderer.h>
+#include <maya/MShaderManager.h>
+#include <maya/MHWGeometry.h>
+#include <maya/MSceneMessage.h>
+#include <maya/MCallbackIdArray.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    MTypeId AoViewportGuideDrawNode::id(0x0013A0F3);
+    MString AoViewportGuideDrawNode::drawDbClassification("drawdb/subscene/aoViewportGuide");
+    MString AoViewportGuideDrawNode::drawRegistrantId("aoViewportGuideSubScene");
+
+    void* AoViewportGuideDrawNode::creator()
+    {
+        return new AoViewportGuideDrawNode();
+    }
+
+    MStatus AoViewportGuideDrawNode::initialize()
+    {
+        return MS::kSuccess;
+    }
+
+    void AoViewportGuideDrawNode::postConstructor()
+    {
+        MFnDependencyNode fn(thisMObject());
+        fn.setDoNotWrite(true);
+
+        MPlug hidden = fn.findPlug("hiddenInOutliner", true);
+        if (!hidden.isNull()) hidden.setBool(true);
+    }
+
+    static MCallbackIdArray gSceneCallbackIds;
+
+    bool ensureDrawNodeExists()
+    {
+        for (MItDependencyNodes it(MFn::kPluginLocatorNode); !it.isDone(); it.next())
+        {
+            MFnDependencyNode fn(it.thisNode());
+            if (fn.typeId() == AoViewportGuideDrawNode::id)
+                return true;
+        }
+
+        MStatus stat;
+        MDagModifier mod;
+        MObject shape = mod.createNode(AoViewportGuideDrawNode::id, MObject::kNullObj, &stat);
+        if (!stat) return false;
+        if (!mod.doIt()) return false;
+
+        // createNode on a shape type also creates its transform; keep that out of the file too
+        MFnDagNode fnShape(shape);
+        MObject xform = fnShape.parent(0);
+        if (!xform.isNull())
+        {
+            MFnDependencyNode fnXform(xform);
+            fnXform.setDoNotWrite(true);
+            MPlug hidden = fnXform.findPlug("hiddenInOutliner", true);
+            if (!hidden.isNull()) hidden.setBool(true);
+
+            MDGModifier rename;
+            rename.renameNode(xform, "aoViewportGuideDraw");
+            rename.doIt();
+        }
+        return true;
+    }
+
+    void deleteDrawNodes()
+    {
+        MObjectArray nodes;
+        for (MItDependencyNodes it(MFn::kPluginLocatorNode); !it.isDone(); it.next())
+        {
+            MFnDependencyNode fn(it.thisNode());
+            if (fn.typeId() == AoViewportGuideDrawNode::id)
+                nodes.append(it.thisNode());
+        }
+        if (nodes.length() == 0)
+            return;
+
+        MDagModifier mod;
+        for (unsigned int i = 0; i < nodes.length(); ++i)
+        {
+            // deleting the transform takes the shape with it
+            MFnDagNode fn(nodes[i]);
+            MObject xform = fn.parent(0);
+            mod.deleteNode(xform.isNull() ? nodes[i] : xform);
+        }
+        mod.doIt();
+    }
+
+    static void afterNewOrOpenCB(void*)
+    {
+        ensureDrawNodeExists();
+    }
+
+    void installSubSceneCallbacks()
+    {
+        if (gSceneCallbackIds.length() > 0)
+            return;
+
+        gSceneCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterNew,  afterNewOrOpenCB, nullptr));
+        gSceneCallbackIds.append(MSceneMessage::addCallback(MSceneMessage::kAfterOpen, afterNewOrOpenCB, nullptr));
+    }
+
+    void removeSubSceneCallbacks()
+    {
+        if (gSceneCallbackIds.length() > 0)
+        {
+            MMessage::removeCallbacks(gSceneCallbackIds);
+            gSceneCallbackIds.clear();
+        }
+    }
+
+    namespace
+    {
+        static const MString kMaskItemName("aoViewportGuide_mask");
+        static const MString kBorderItemName("aoViewportGuide_border");
+        static const MString kGuideItemName("aoViewportGuide_guide");
+
+        // GPU copy of one batch
+        struct GpuMesh
+        {
+            std::unique_ptr<MHWRender::MVertexBuffer> vertices;
+            std::unique_ptr<MHWRender::MIndexBuffer>  indices;
+            MBoundingBox bounds;
+
+            bool empty() const { return !vertices || !indices; }
+
+            void upload(const IndexedBatch& batch)
+            {
+                vertices.reset();
+                indices.reset();
+                if (batch.points.empty() || batch.indices.empty()) return;
+
+                const MHWRender::MVertexBufferDescriptor desc(
+                    "", MHWRender::MGeometry::kPosition, MHWRender::MGeometry::kFloat, 3);
+                vertices.reset(new MHWRender::MVertexBuffer(desc));
+                indices.reset(new MHWRender::MIndexBuffer(MHWRender::MGeometry::kUnsignedInt32));
+
+                const unsigned int n = (unsigned int)batch.points.size();
+                float* p = (float*)vertices->acquire(n, true);
+                double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+                for (unsigned int i = 0; i < n; ++i)
+                {
+                    p[i * 3 + 0] = (float)batch.points[i].x;
+                    p[i * 3 + 1] = (float)batch.points[i].y;
+                    p[i * 3 + 2] = 0.0f;
+                    minX = (std::min)(minX, batch.points[i].x); maxX = (std::max)(maxX, batch.points[i].x);
+                    minY = (std::min)(minY, batch.points[i].y); maxY = (std::max)(maxY, batch.points[i].y);
+                }
+                vertices->commit(p);
+
+                const unsigned int ni = (unsigned int)batch.indices.size();
+                unsigned int* idx = (unsigned int*)indices->acquire(ni, true);
+                for (unsigned int i = 0; i < ni; ++i)
+                    idx[i] = batch.indices[i];
+                indices->commit(idx);
+
+                bounds = MBoundingBox(MPoint(minX, minY, 0.0), MPoint(maxX, maxY, 0.0));
+            }
+        };
+
+        // Geometry for one (guide type, spiral orientation, gate size). Style changes
+        // only re-apply shader parameters, and panels with the same gate size share an entry.
+        struct GpuEntry
+        {
+            int      guideType = -1;
+            int      goldenOrientation = 0;
+            int64_t  gateW = 0; // 1/16 px
+            int64_t  gateH = 0;
+            uint64_t lastUse = 0;
+            GpuMesh  mask;
+            GpuMesh  border;
+            GpuMesh  guide;
+        };
+
+        static constexpr size_t kMaxGpuEntries = 8;
+
+        inline int64_t quantizePx(double v) { return (int64_t)(v * 16.0 + 0.5); }
+    }
+
+    class AoViewportGuideSubSceneOverride : public MHWRender::MPxSubSceneOverride
+    {
+    public:
+        explicit AoViewportGuideSubSceneOverride(const MObject& obj)
+            : MHWRender::MPxSubSceneOverride(obj) {}
+
+        ~AoViewportGuideSubSceneOverride() override
+        {
+            MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+            const MHWRender::MShaderManager* sm = r ? r->getShaderManager() : nullptr;
+            if (sm)
+            {
+                if (mMaskShader)   sm->releaseShader(mMaskShader);
+                if (mBorderShader) sm->releaseShader(mBorderShader);
+                if (mGuideShader)  sm->releaseShader(mGuideShader);
+            }
+        }
+
+        MHWRender::DrawAPI supportedDrawAPIs() const override
+        {
+            return MHWRender::kAllDevices;
+        }
+
+        bool requiresUpdate(const MHWRender::MSubSceneContainer&,
+                            const MHWRender::MFrameContext& frameContext) const override
+        {
+            // Called per viewport draw. update() only re-points the items and sets a
+            // matrix unless the settings or gate size changed, so always accept.
+            return mItemsEnabled || AoViewportGuideSettings::snapshot(frameCameraKey(frameContext)).data.drawBackend == kDrawBackendCached;
+        }
+
+        void update(MHWRender::MSubSceneContainer& container,
+                    const MHWRender::MFrameContext& frameContext) override
+        {
+            const SettingsSnapshot snap = AoViewportGuideSettings::snapshot(frameCameraKey(frameContext));
+            const SettingsData& s = snap.data;
+
+            Items items;
+            if (!acquireItems(container, items))
+                return;
+
+            int vpX=0, vpY=0, vpW=0, vpH=0;
+            frameContext.getViewportDimensions(vpX, vpY, vpW, vpH);
+
+            MString panelName;
+            frameContext.renderingDestination(panelName);
+
+            MHWRender::MFrameContext::RenderOverrideInformation overrideInfo;
+            const bool inOverride = frameContext.getRenderOverrideInformation(overrideInfo) &&
+                                    overrideInfo.overrideName == kOverrideNameInternal;
+
+            if (!inOverride || !s.enable || s.drawBackend != kDrawBackendCached || vpW < 10 || vpH < 10)
+            {
+                setItemsEnabled(items, false, false, false);
+                return;
+            }
+
+            const GateRect gate = computeGateRectCached(panelName, frameContext, vpX, vpY, vpW, vpH, s.followResolutionGate);
+            const double gateW = gate.right - gate.left;
+            const double gateH = gate.top   - gate.bottom;
+
+            GpuEntry& entry = findOrBuildEntry(gateW, gateH, s);
+
+            if (&entry != mBoundEntry)
+            {
+                bindGeometry(*items.mask,   entry.mask);
+                bindGeometry(*items.border, entry.border);
+                bindGeometry(*items.guide,  entry.guide);
+                mBoundEntry = &entry;
+            }
+
+            if (!mStyled || snap.hash != mStyledHash)
+            {
+                applyStyle(mMaskShader,   s.maskColor,       s.maskOpacity,       0.0f);
+                applyStyle(mBorderShader, s.gateBorderColor, s.gateBorderOpacity, s.gateBorderThickness);
+                applyStyle(mGuideShader,  s.lineColor,       s.lineOpacity,       s.lineThickness);
+                mStyledHash = snap.hash;
+                mStyled = true;
+            }
+
+            const MMatrix m = gateToWorld(frameContext, gate, vpX, vpY, vpW, vpH);
+            items.mask->setMatrix(&m);
+            items.border->setMatrix(&m);
+            items.guide->setMatrix(&m);
+
+            const bool showMask   = s.maskEnable && s.maskOpacity > 0.0001f && !entry.mask.empty();
+            const bool showBorder = s.gateBorderEnable && s.gateBorderOpacity > 0.0001f && !entry.border.empty();
+            setItemsEnabled(items, showMask, showBorder, !entry.guide.empty());
+        }
+
+    private:
+        struct Items
+        {
+            MHWRender::MRenderItem* mask   = nullptr;
+            MHWRender::MRenderItem* border = nullptr;
+            MHWRender::MRenderItem* guide  = nullptr;
+        };
+
+        bool acquireItems(MHWRender::MSubSceneContainer& container, Items& items)
+        {
+            items.mask   = container.find(kMaskItemName);
+            items.border = container.find(kBorderItemName);
+            items.guide  = container.find(kGuideItemName);
+            if (items.mask && items.border && items.guide)
+                return true;
+
+            MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+            const MHWRender::MShaderManager* sm = r ? r->getShaderManager() : nullptr;
+            if (!sm) return false;
+
+            if (!mMaskShader)   mMaskShader   = sm->getStockShader(MHWRender::MShaderManager::k3dSolidShader);
+            if (!mBorderShader) mBorderShader = sm->getStockShader(MHWRender::MShaderManager::k3dThickLineShader);
+            if (!mGuideShader)  mGuideShader  = sm->getStockShader(MHWRender::MShaderManager::k3dThickLineShader);
+            if (!mMaskShader || !mBorderShader || !mGuideShader) return false;
+
+            auto makeItem = [&](const MString& name, MHWRender::MShaderInstance* shader,
+                                MHWRender::MGeometry::Primitive primitive)
+            {
+                MHWRender::MRenderItem* item = MHWRender::MRenderItem::Create(
+                    name, MHWRender::MRenderItem::NonMaterialSceneItem, primitive);
+                item->setDrawMode(MHWRender::MGeometry::kAll);
+                item->depthPriority(MHWRender::MRenderItem::sSelectionDepthPriority);
+                item->castsShadows(false);
+                item->receivesShadows(false);
+                item->setExcludedFromPostEffects(true);
+                item->setShader(shader);
+                item->enable(false);
+                container.add(item);
+                return item;
+            };
+
+            if (!items.mask)   items.mask   = makeItem(kMaskItemName,   mMaskShader,   MHWRender::MGeometry::kTriangles);
+            if (!items.border) items.border = makeItem(kBorderItemName, mBorderShader, MHWRender::MGeometry::kLines);
+            if (!items.guide)  items.guide  = makeItem(kGuideItemName,  mGuideShader,  MHWRender::MGeometry::kLines);
+
+            mBoundEntry = nullptr;
+            mStyled = false;
+            return true;
+        }
+
+        GpuEntry& findOrBuildEntry(double gateW, double gateH, const SettingsData& s)
+        {
+            const int64_t qw = quantizePx(gateW);
+            const int64_t qh = quantizePx(gateH);
+            const int orientation = goldenOrientation(s.goldenRotation, s.goldenFlipH, s.goldenFlipV);
+            ++mUseCounter;
+
+            GpuEntry* oldest = nullptr;
+            for (auto& e : mEntries)
+            {
+                if (e->guideType == s.guideType && e->goldenOrientation == orientation &&
+                    e->gateW == qw && e->gateH == qh)
+                {
+                    e->lastUse = mUseCounter;
+                    return *e;
+                }
+                if (!oldest || e->lastUse < oldest->lastUse)
+                    oldest = e.get();
+            }
+
+            GpuEntry* entry = nullptr;
+            if (mEntries.size() < kMaxGpuEntries)
+            {
+                mEntries.emplace_back(new GpuEntry());
+                entry = mEntries.back().get();
+            }
+            else
+            {
+                entry = oldest;
+                if (entry == mBoundEntry) mBoundEntry = nullptr;
+            }
+
+            // shared geometry generation, in gate-local space
+            const GateRect local{ 0.0, 0.0, gateW, gateH };
+
+            mTriangles.clear();
+            appendGateMask(local, mTriangles);
+            entry->mask.upload(mTriangles);
+
+            mLines.clear();
+            appendGateBorder(local, mLines);
+            entry->border.upload(mLines);
+
+            mLines.clear();
+            appendGuide(s.guideType, local, kCurveTolerancePx, mLines, orientation);
+            entry->guide.upload(mLines);
+
+            entry->guideType = s.guideType;
+            entry->goldenOrientation = orientation;
+            entry->gateW = qw;
+            entry->gateH = qh;
+            entry->lastUse = mUseCounter;
+            return *entry;
+        }
+
+        void bindGeometry(MHWRender::MRenderItem& item, const GpuMesh& mesh)
+        {
+            if (mesh.empty()) return;
+
+            MHWRender::MVertexBufferArray vertexBuffers;
+            vertexBuffers.addBuffer("positions", mesh.vertices.get());
+            setGeometryForRenderItem(item, vertexBuffers, *mesh.indices, &mesh.bounds);
+        }
+
+        // thickness <= 0: solid shader (no lineWidth parameter)
+        static void applyStyle(MHWRender::MShaderInstance* shader, const Rgba& color, float opacity, float thickness)
+        {
+            const float a = clampf(opacity, 0.0f, 1.0f);
+            const float c[4] = { color.r, color.g, color.b, a };
+            shader->setParameter("solidColor", c);
+            if (thickness > 0.0f)
+            {
+                const float w[2] = { thickness, thickness };
+                shader->setParameter("lineWidth", w);
+            }
+            shader->setIsTransparent(a < 1.0f);
+        }
+
+        void setItemsEnabled(const Items& items, bool mask, bool border, bool guide)
+        {
+            if (items.mask->isEnabled()   != mask)   items.mask->enable(mask);
+            if (items.border->isEnabled() != border) items.border->enable(border);
+            if (items.guide->isEnabled()  != guide)  items.guide->enable(guide);
+            mItemsEnabled = mask || border || guide;
+        }
+
+        // Maps gate-local pixels onto the near plane of the current view, so the
+        // standard world-view-projection transform lands them back in screen space.
+        static MMatrix gateToWorld(const MHWRender::MFrameContext& frameContext, const GateRect& gate,
+                                   int vpX, int vpY, int vpW, int vpH)
+        {
+            MHWRender::MRenderer* r = MHWRender::MRenderer::theRenderer();
+            const bool dx = r && (r->drawAPI() & MHWRender::kDirectX11) != 0;
+            const double nearZ = dx ? 1.0e-5 : -1.0 + 1.0e-5;
+
+            const double sx = 2.0 / (double)vpW;
+            const double sy = 2.0 / (double)vpH;
+
+            // row-vector convention: p' = p * M
+            MMatrix pixelToNdc;
+            pixelToNdc.matrix[0][0] = sx;  pixelToNdc.matrix[0][1] = 0.0; pixelToNdc.matrix[0][2] = 0.0; pixelToNdc.matrix[0][3] = 0.0;
+            pixelToNdc.matrix[1][0] = 0.0; pixelToNdc.matrix[1][1] = sy;  pixelToNdc.matrix[1][2] = 0.0; pixelToNdc.matrix[1][3] = 0.0;
+            pixelToNdc.matrix[2][0] = 0.0; pixelToNdc.matrix[2][1] = 0.0; pixelToNdc.matrix[2][2] = 0.0; pixelToNdc.matrix[2][3] = 0.0;
+            pixelToNdc.matrix[3][0] = (gate.left   - (double)vpX) * sx - 1.0;
+            pixelToNdc.matrix[3][1] = (gate.bottom - (double)vpY) * sy - 1.0;
+            pixelToNdc.matrix[3][2] = nearZ;
+            pixelToNdc.matrix[3][3] = 1.0;
+
+            const MMatrix viewProj = frameContext.getMatrix(MHWRender::MFrameContext::kViewProjMtx);
+            return pixelToNdc * viewProj.inverse();
+        }
+
+        MHWRender::MShaderInstance* mMaskShader   = nullptr;
+        MHWRender::MShaderInstance* mBorderShader = nullptr;
+        MHWRender::MShaderInstance* mGuideShader  = nullptr;
+
+        std::vector<std::unique_ptr<GpuEntry>> mEntries;
+        GpuEntry* mBoundEntry = nullptr;
+        uint64_t  mUseCounter = 0;
+        uint64_t  mStyledHash = 0; // settings hash the shaders were last styled with
+        bool      mStyled = false;
+        bool      mItemsEnabled = false;
+
+        TriangleBatch mTriangles;
+        LineBatch     mLines;
+    };
+
+    MHWRender::MPxSubSceneOverride* createSubSceneOverride(const MObject& obj)
+    {
+        return new AoViewportGuideSubSceneOverride(obj);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <maya/MPxLocatorNode.h>
+#include <maya/MPxSubSceneOverride.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+namespace AoViewportGuide
+{
+    // Hidden, non-saved locator that carries the cached (subscene) draw backend.
+    class AoViewportGuideDrawNode : public MPxLocatorNode
+    {
+    public:
+        static MTypeId id;
+        static MString drawDbClassification;
+        static MString drawRegistrantId;
+
+        static void*   creator();
+        static MStatus initialize();
+
+        void postConstructor() override;
+        bool isBounded() const override { return false; }
+    };
+
+    MHWRender::MPxSubSceneOverride* createSubSceneOverride(const MObject& obj);
+
+    // Creates the draw node when missing. Called on plugin load and after scene new/open.
+    bool ensureDrawNodeExists();
+
+    // Deletes the draw nodes so the node type can be deregistered on unload.
+    void deleteDrawNodes();
+
+    void installSubSceneCallbacks();
+    void removeSubSceneCallbacks();
+}
@@ -0,0 +1,293 @@
+// aoViewportGuideTessellation.cpp (v0.3.1)
+
+#include "aoViewportGuideTessellation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    static constexpr double kTwoPi = 2.0 * 3.141592653589793;
+
+    namespace
+    {
+        struct UnitCircleTables
+        {
+            // levels stored back to back: 8, 16, 32, ... points
+            Point2 points[(kMinCircleSegments << kCircleLodCount) - kMinCircleSegments];
+            int    offsets[kCircleLodCount];
+
+            UnitCircleTables()
+            {
+                int offset = 0;
+                for (int lod = 0; lod < kCircleLodCount; ++lod)
+                {
+                    const int seg = circleSegmentsForLod(lod);
+                    offsets[lod] = offset;
+                    for (int i = 0; i < seg; ++i)
+                    {
+                        const double a = kTwoPi * (double)i / (double)seg;
+                        points[offset + i] = Point2{ std::cos(a), std::sin(a) };
+                    }
+                    offset += seg;
+                }
+            }
+        };
+
+        const UnitCircleTables& tables()
+        {
+            static const UnitCircleTables t;
+            return t;
+        }
+    }
+
+    int selectCircleLod(double radiusPx, double tolerancePx)
+    {
+        if (!(radiusPx > tolerancePx) || tolerancePx <= 0.0)
+            return 0;
+
+        // sagitta: r * (1 - cos(pi / n)) <= tol
+        const double needed = 3.141592653589793 / std::acos(1.0 - tolerancePx / radiusPx);
+
+        for (int lod = 0; lod < kCircleLodCount; ++lod)
+        {
+            if ((double)circleSegmentsForLod(lod) >= needed)
+                return lod;
+        }
+        return kCircleLodCount - 1;
+    }
+
+    const Point2* unitCircleTable(int lod)
+    {
+        if (lod < 0) lod = 0;
+        if (lod >= kCircleLodCount) lod = kCircleLodCount - 1;
+        return tables().points + tables().offsets[lod];
+    }
+
+    void appendCircle(double cx, double cy, double radius, double tolerancePx, LineBatch& out)
+    {
+        if (radius <= 0.0) return;
+
+        const int lod = selectCircleLod(radius, tolerancePx);
+        const int seg = circleSegmentsForLod(lod);
+        const Point2* unit = unitCircleTable(lod);
+
+        const uint32_t base = (uint32_t)out.points.size();
+        for (int i = 0; i < seg; ++i)
+            out.addPoint(cx + unit[i].x * radius, cy + unit[i].y * radius);
+
+        for (int i = 0; i < seg; ++i)
+        {
+            out.indices.push_back(base + (uint32_t)i);
+            out.indices.push_back(base + (uint32_t)((i + 1) % seg));
+        }
+    }
+
+    void appendArc(double cx, double cy, double radius, double a0, double a1,
+                   double tolerancePx, LineBatch& out)
+    {
+        if (radius <= 0.0 || a0 == a1) return;
+
+        // walk counter-clockwise; clockwise arcs are emitted reversed
+        if (a1 < a0) { const double t = a0; a0 = a1; a1 = t; }
+
+        const int lod = selectCircleLod(radius, tolerancePx);
+        const int seg = circleSegmentsForLod(lod);
+        const Point2* unit = unitCircleTable(lod);
+        const double step = kTwoPi / (double)seg;
+
+        uint32_t prev = out.addPoint(cx + std::cos(a0) * radius, cy + std::sin(a0) * radius);
+
+        // interior vertices come straight from the table
+        const double first = std::floor(a0 / step) + 1.0;
+        for (double k = first; k * step < a1; k += 1.0)
+        {
+            int i = (int)std::fmod(k, (double)seg);
+            if (i < 0) i += seg;
+
+            const uint32_t cur = out.addPoint(cx + unit[i].x * radius, cy + unit[i].y * radius);
+            out.indices.push_back(prev);
+            out.indices.push_back(cur);
+            prev = cur;
+        }
+
+        const uint32_t last = out.addPoint(cx + std::cos(a1) * radius, cy + std::sin(a1) * radius);
+        out.indices.push_back(prev);
+        out.indices.push_back(last);
+    }
+
+    // ---------------------------------------------------------------------
+
+    int goldenOrientation(int rotation, bool flipH, bool flipV)
+    {
+        // a vertical flip is a half turn plus a horizontal flip
+        const int turns = (rotation + (flipV ? 2 : 0)) & 3;
+        return turns | ((flipH != flipV) ? 4 : 0);
+    }
+
+    namespace
+    {
+        static constexpr double kPhi = 1.6180339887498949;
+        static constexpr int    kMaxSpiralArcs   = 48;
+        static constexpr int    kSpiralCacheSize = 8;
+
+        // golden rectangle point (x in [0, phi], y in [0, 1]) -> gate-local pixels
+        inline Point2 orientGolden(double x, double y, int orientation, double w, double h)
+        {
+            double u = x / kPhi, v = y;
+            for (int i = 0; i < (orientation & 3); ++i)
+            {
+                const double t = u;
+                u = 1.0 - v;
+                v = t;
+            }
+            if (orientation & 4) u = 1.0 - u;
+            return Point2{ u * w, v * h };
+        }
+
+        // One polyline in gate-local pixels. The golden rectangle is stretched onto
+        // the gate, so each quarter arc is an ellipse; sampling it at the circle
+        // table angles keeps the chord error under rMax * (1 - cos(pi / n)), which is
+        // what selectCircleLod() bounds.
+        void tessellateGoldenSpiral(double w, double h, int orientation, double tolerancePx,
+                                    std::vector<Point2>& out)
+        {
+            out.clear();
+            if (w <= 0.0 || h <= 0.0) return;
+
+            // pixels per golden-rectangle unit along its x / y axis
+            const bool   turned = (orientation & 1) != 0;
+            const double sx = (turned ? h : w) / kPhi;
+            const double sy = turned ? w : h;
+            const double scale = (std::max)(sx, sy);
+
+            double x0 = 0.0, y0 = 0.0, x1 = kPhi, y1 = 1.0;
+            for (int k = 0; k < kMaxSpiralArcs; ++k)
+            {
+                // cut the square off the left, top, right, bottom in turn; the arc is
+                // centred on the square's corner that touches the remaining rectangle
+                double s, cx, cy;
+                switch (k & 3)
+                {
+                case 0:  s = y1 - y0; cx = x0 + s; cy = y0;     x0 += s; break;
+                case 1:  s = x1 - x0; cx = x0;     cy = y1 - s; y1 -= s; break;
+                case 2:  s = y1 - y0; cx = x1 - s; cy = y1;     x1 -= s; break;
+                default: s = x1 - x0; cx = x1;     cy = y0 + s; y0 += s; break;
+                }
+
+                const double radiusPx = s * scale;
+                if (radiusPx < tolerancePx) break;
+
+                const int lod = selectCircleLod(radiusPx, tolerancePx);
+                const int seg = circleSegmentsForLod(lod);
+                const int quarter = seg / 4;
+                const Point2* unit = unitCircleTable(lod);
+
+                // clockwise from 180, 90, 0, -90 degrees; arcs share their end points
+                const int start = ((2 - (k & 3)) & 3) * quarter;
+                for (int i = out.empty() ? 0 : 1; i <= quarter; ++i)
+                {
+                    const Point2& c = unit[(start - i + seg) % seg];
+                    out.push_back(orientGolden(cx + c.x * s, cy + c.y * s, orientation, w, h));
+                }
+            }
+        }
+
+        struct SpiralCacheEntry
+        {
+            int64_t  gateW = -1; // 1/16 px
+            int64_t  gateH = -1;
+            int      orientation = 0;
+            double   tolerancePx = 0.0;
+            uint64_t lastUse = 0;
+            std::vector<Point2> points;
+        };
+
+        struct SpiralCache
+        {
+            std::mutex       mutex;
+            SpiralCacheEntry entries[kSpiralCacheSize];
+            uint64_t         useCounter = 0;
+            CurveCacheStats  stats;
+        };
+
+        SpiralCache& spiralCache()
+        {
+            static SpiralCache c;
+            return c;
+        }
+
+        inline int64_t quantizePx(double v) { return (int64_t)(v * 16.0 + 0.5); }
+    }
+
+    void appendGoldenSpiral(const GateRect& gate, int orientation, double tolerancePx, LineBatch& out)
+    {
+        const int64_t qw = quantizePx(gate.right - gate.left);
+        const int64_t qh = quantizePx(gate.top - gate.bottom);
+        if (qw <= 0 || qh <= 0) return;
+        orientation &= 7;
+
+        SpiralCache& cache = spiralCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        ++cache.useCounter;
+
+        SpiralCacheEntry* entry = nullptr;
+        SpiralCacheEntry* oldest = &cache.entries[0];
+        for (SpiralCacheEntry& e : cache.entries)
+        {
+            if (e.gateW == qw && e.gateH == qh && e.orientation == orientation && e.tolerancePx == tolerancePx)
+            {
+                entry = &e;
+                break;
+            }
+            if (e.lastUse < oldest->lastUse) oldest = &e;
+        }
+
+        if (entry)
+            ++cache.stats.hits;
+        else
+        {
+            ++cache.stats.misses;
+            entry = oldest;
+            entry->gateW = qw;
+            entry->gateH = qh;
+            entry->orientation = orientation;
+            entry->tolerancePx = tolerancePx;
+            tessellateGoldenSpiral((double)qw / 16.0, (double)qh / 16.0, orientation, tolerancePx, entry->points);
+        }
+        entry->lastUse = cache.useCounter;
+
+        // cached points are gate-local; only the offset changes between panels
+        const std::vector<Point2>& pts = entry->points;
+        if (pts.size() < 2) return;
+
+        const uint32_t base = (uint32_t)out.points.size();
+        for (const Point2& p : pts)
+            out.addPoint(gate.left + p.x, gate.bottom + p.y);
+        for (uint32_t i = 0; i + 1 < (uint32_t)pts.size(); ++i)
+        {
+            out.indices.push_back(base + i);
+            out.indices.push_back(base + i + 1);
+        }
+    }
+
+    CurveCacheStats goldenSpiralCacheStats()
+    {
+        SpiralCache& cache = spiralCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        return cache.stats;
+    }
+
+    void resetGoldenSpiralCache()
+    {
+        SpiralCache& cache = spiralCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        for (SpiralCacheEntry& e : cache.entries)
+            e = SpiralCacheEntry();
+        cache.useCounter = 0;
+        cache.stats = CurveCacheStats();
+    }
+}
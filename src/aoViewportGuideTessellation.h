@@ -0,0 +1,53 @@
+#pragma once
+// aoViewportGuideTessellation.h (v0.3.1)
+// Circle / arc tessellation from precomputed unit-circle tables.
+// The segment count is picked per call from the projected radius and a
+// pixel error tolerance (max distance between the chord and the true arc).
+// Golden spirals are tessellated once per (gate size, orientation, tolerance)
+// into a small LRU cache and only translated to the gate's position.
+
+#include "aoViewportGuideGeometry.h"
+
+#include <cstdint>
+
+namespace AoViewportGuide
+{
+    // LOD level i uses (kMinCircleSegments << i) segments.
+    static constexpr int kCircleLodCount    = 7;
+    static constexpr int kMinCircleSegments = 8;
+
+    inline int circleSegmentsForLod(int lod) { return kMinCircleSegments << lod; }
+
+    // Smallest LOD whose chord error stays under tolerancePx at radiusPx.
+    int selectCircleLod(double radiusPx, double tolerancePx);
+
+    // cos/sin of (2*pi*i/segments), i in [0, segments); built once per level.
+    const Point2* unitCircleTable(int lod);
+
+    // Closed loop of shared vertices (no duplicated end point).
+    void appendCircle(double cx, double cy, double radius, double tolerancePx, LineBatch& out);
+
+    // Open polyline from angle a0 to a1 (radians, counter-clockwise when a1 > a0).
+    void appendArc(double cx, double cy, double radius, double a0, double a1,
+                   double tolerancePx, LineBatch& out);
+
+    // Orientation 0..7: bits 0-1 quarter turns (counter-clockwise), bit 2 mirrors
+    // horizontally after the turn. Rotations happen in gate-normalized space, so a
+    // quarter turn fits a portrait spiral into a landscape gate.
+    int goldenOrientation(int rotation, bool flipH, bool flipV);
+
+    // Golden spiral (quarter arcs through successively smaller golden squares) as
+    // one polyline stretched over the gate; the arcs stop once they are smaller
+    // than tolerancePx. Served from the spiral cache when the gate size (to 1/16 px),
+    // orientation and tolerance match a recent call.
+    void appendGoldenSpiral(const GateRect& gate, int orientation, double tolerancePx, LineBatch& out);
+
+    struct CurveCacheStats
+    {
+        uint64_t hits   = 0;
+        uint64_t misses = 0;
+    };
+
+    CurveCacheStats goldenSpiralCacheStats();
+    void            resetGoldenSpiralCache(); // drops the entries and zeroes the counters
+}
@@ -0,0 +1,102 @@
+// aoViewportGuideThreadPool.cpp (v0.3.1)
+
+#include "aoViewportGuideThreadPool.h"
+
+#include <atomic>
+
+namespace AoViewportGuide
+{
+    struct ThreadPool::Job
+    {
+        const std::function<void(int)>* fn = nullptr;
+        int count = 0;
+        std::atomic<int> next{ 0 };
+        std::atomic<int> done{ 0 };
+
+        std::mutex              doneMutex;
+        std::condition_variable doneCv;
+    };
+
+    ThreadPool::ThreadPool(unsigned int threads)
+    {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+
+        // the caller of parallelFor() works too
+        for (unsigned int i = 1; i < threads; ++i)
+            mWorkers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& t : mWorkers) t.join();
+    }
+
+    void ThreadPool::runIndices(Job& job)
+    {
+        for (;;)
+        {
+            const int i = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= job.count) return;
+
+            (*job.fn)(i);
+
+            if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.count)
+            {
+                std::lock_guard<std::mutex> lock(job.doneMutex);
+                job.doneCv.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        for (;;)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [this] { return mStop || !mQueue.empty(); });
+                if (mStop && mQueue.empty()) return;
+
+                // jobs stay queued while indices remain so several workers can join in
+                while (!mQueue.empty() && mQueue.front()->next.load(std::memory_order_relaxed) >= mQueue.front()->count)
+                    mQueue.pop_front();
+                if (mQueue.empty()) continue;
+
+                job = mQueue.front();
+            }
+            runIndices(*job);
+        }
+    }
+
+    void ThreadPool::parallelFor(int count, const std::function<void(int)>& fn)
+    {
+        if (count <= 0) return;
+        if (count == 1 || mWorkers.empty())
+        {
+            for (int i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->fn    = &fn;
+        job->count = count;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueue.push_back(job);
+        }
+        mWake.notify_all();
+
+        runIndices(*job);
+
+        std::unique_lock<std::mutex> lock(job->doneMutex);
+        job->doneCv.wait(lock, [&] { return job->done.load(std::memory_order_acquire) == job->count; });
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+// aoViewportGuideThreadPool.h (v0.3.1)
+// Small fixed-size pool for the offline (burn-in) paths. No Maya types; never
+// used from the draw path.
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    class ThreadPool
+    {
+    public:
+        // threads = 0: std::thread::hardware_concurrency()
+        explicit ThreadPool(unsigned int threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned int size() const { return (unsigned int)mWorkers.size(); }
+
+        // Runs fn(i) for i in [0, count). The calling thread takes indices too, so
+        // nested calls from inside a task cannot deadlock.
+        void parallelFor(int count, const std::function<void(int)>& fn);
+
+    private:
+        struct Job;
+
+        void workerLoop();
+        static void runIndices(Job& job);
+
+        std::vector<std::thread>         mWorkers;
+        std::deque<std::shared_ptr<Job>> mQueue;
+        std::mutex                       mMutex;
+        std::condition_variable          mWake;
+        bool                             mStop = false;
+    };
+}
@@ -0,0 +1,172 @@
+// aoViewportGuideTimeline.cpp (v0.3.1)
+
+#include "aoViewportGuideTimeline.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace AoViewportGuide
+{
+    void SettingsTimeline::reset(int first, int last)
+    {
+        mFirst = first;
+        mFrames.assign(last >= first ? (size_t)(last - first + 1) : 0, kMissing);
+        mEntries.clear();
+        mByHash.clear();
+        mBaked = 0;
+    }
+
+    const TimelineEntry* SettingsTimeline::find(int frame) const
+    {
+        if (!inRange(frame)) return nullptr;
+        const uint32_t e = mFrames[(size_t)(frame - mFirst)];
+        return e == kMissing ? nullptr : &mEntries[e];
+    }
+
+    void SettingsTimeline::store(int frame, const PackedSettings& packed)
+    {
+        if (!inRange(frame)) return;
+
+        const uint64_t hash = hashSettings(packed);
+        uint32_t e = kMissing;
+
+        const auto found = mByHash.find(hash);
+        if (found != mByHash.end() && mEntries[found->second].packed == packed)
+            e = found->second;
+        else
+        {
+            e = (uint32_t)mEntries.size();
+            mEntries.push_back(TimelineEntry{ packed, hash, hashSettingsShape(packed) });
+            mByHash[hash] = e; // a colliding entry just stops being shared
+        }
+
+        uint32_t& slot = mFrames[(size_t)(frame - mFirst)];
+        if (slot == kMissing) ++mBaked;
+        slot = e;
+    }
+
+    void SettingsTimeline::invalidate(int lo, int hi)
+    {
+        lo = (std::max)(lo, mFirst);
+        hi = (std::min)(hi, last());
+        for (int f = lo; f <= hi; ++f)
+        {
+            uint32_t& slot = mFrames[(size_t)(f - mFirst)];
+            if (slot != kMissing) { slot = kMissing; --mBaked; }
+        }
+
+        // repeated edits would otherwise keep every value ever baked
+        if (mEntries.size() > 64 && mEntries.size() > 2 * mBaked)
+            compact();
+    }
+
+    void SettingsTimeline::compact()
+    {
+        std::vector<uint32_t> remap(mEntries.size(), kMissing);
+        std::vector<TimelineEntry> kept;
+        for (uint32_t& slot : mFrames)
+        {
+            if (slot == kMissing) continue;
+            if (remap[slot] == kMissing)
+            {
+                remap[slot] = (uint32_t)kept.size();
+                kept.push_back(mEntries[slot]);
+            }
+            slot = remap[slot];
+        }
+
+        mEntries.swap(kept);
+        mByHash.clear();
+        for (uint32_t e = 0; e < (uint32_t)mEntries.size(); ++e)
+            mByHash[mEntries[e].hash] = e;
+    }
+
+    bool SettingsTimeline::nextMissing(int from, int& frame) const
+    {
+        const size_t n = mFrames.size();
+        if (mBaked == n) return false;
+
+        const size_t start = inRange(from) ? (size_t)(from - mFirst) : 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t f = (start + i) % n;
+            if (mFrames[f] == kMissing)
+            {
+                frame = mFirst + (int)f;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t SettingsTimeline::memoryBytes() const
+    {
+        return mFrames.capacity() * sizeof(uint32_t) +
+               mEntries.capacity() * sizeof(TimelineEntry) +
+               mByHash.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void*));
+    }
+
+    // ---------------------------------------------------------------------
+
+    static inline bool sameKey(const CurveKey& a, const CurveKey& b)
+    {
+        return a.time == b.time && a.value == b.value &&
+               a.inX == b.inX && a.inY == b.inY && a.outX == b.outX && a.outY == b.outY &&
+               a.inType == b.inType && a.outType == b.outType;
+    }
+
+    // span of the segments on either side of key i
+    static void addKeySpan(const std::vector<CurveKey>& keys, size_t i, double& lo, double& hi)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        lo = (std::min)(lo, i > 0 ? keys[i - 1].time : -inf);
+        hi = (std::max)(hi, i + 1 < keys.size() ? keys[i + 1].time : inf);
+    }
+
+    bool changedKeyRange(const CurveKeys& before, const CurveKeys& after, double& lo, double& hi)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        lo = inf;
+        hi = -inf;
+
+        const std::vector<CurveKey>& a = before.keys;
+        const std::vector<CurveKey>& b = after.keys;
+
+        size_t i = 0, j = 0;
+        while (i < a.size() || j < b.size())
+        {
+            if (i < a.size() && j < b.size() && a[i].time == b[j].time)
+            {
+                if (!sameKey(a[i], b[j]))
+                {
+                    addKeySpan(a, i, lo, hi);
+                    addKeySpan(b, j, lo, hi);
+                }
+                ++i; ++j;
+            }
+            else if (j == b.size() || (i < a.size() && a[i].time < b[j].time))
+                addKeySpan(a, i++, lo, hi);
+            else
+                addKeySpan(b, j++, lo, hi);
+        }
+
+        const bool sameCurve = before.preInfinity == after.preInfinity &&
+                               before.postInfinity == after.postInfinity &&
+                               before.weighted == after.weighted;
+        if (!sameCurve)
+        {
+            lo = -inf;
+            hi = inf;
+            return true;
+        }
+        if (lo > hi)
+            return false;
+
+        if (after.preInfinity != 0 || after.postInfinity != 0)
+        {
+            lo = -inf;
+            hi = inf;
+        }
+        return true;
+    }
+}
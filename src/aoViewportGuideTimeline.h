@@ -0,0 +1,90 @@
+#pragma once
+// aoViewportGuideTimeline.h (v0.3.1)
+// Baked settings for playback (no Maya types). SettingsTimeline keeps the packed
+// settings of every frame of the playback range, so animated settings cost a
+// table lookup per frame instead of a DG evaluation. Frames with equal values
+// share one entry. changedKeyRange() finds the frames a key edit can affect, so
+// only those are baked again.
+
+#include "aoViewportGuideSettingsData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace AoViewportGuide
+{
+    struct TimelineEntry
+    {
+        PackedSettings packed;
+        uint64_t       hash;      // hashSettings()
+        uint64_t       shapeHash; // hashSettingsShape()
+    };
+
+    class SettingsTimeline
+    {
+    public:
+        // Covers whole frames [first, last], nothing baked.
+        void reset(int first, int last);
+        void clear() { reset(0, -1); }
+
+        int  first() const { return mFirst; }
+        int  last() const  { return mFirst + (int)mFrames.size() - 1; }
+        bool inRange(int frame) const { return frame >= mFirst && frame - mFirst < (int)mFrames.size(); }
+
+        // nullptr when frame is out of range or not baked.
+        const TimelineEntry* find(int frame) const;
+
+        // Bakes one frame; equal values reuse an existing entry.
+        void store(int frame, const PackedSettings& packed);
+
+        // Drops frames [lo, hi] (clipped to the range).
+        void invalidate(int lo, int hi);
+        void invalidateAll() { invalidate(mFirst, last()); }
+
+        // First frame at or after from that is not baked, wrapping around at the end
+        // of the range. false when every frame is baked.
+        bool nextMissing(int from, int& frame) const;
+
+        size_t frameCount() const { return mFrames.size(); }
+        size_t bakedCount() const { return mBaked; }
+        size_t entryCount() const { return mEntries.size(); }
+        size_t memoryBytes() const;
+
+    private:
+        static constexpr uint32_t kMissing = 0xFFFFFFFFu;
+
+        // drops entries no frame refers to any more
+        void compact();
+
+        int mFirst = 0;
+        std::vector<uint32_t>      mFrames;  // entry per frame, kMissing when not baked
+        std::vector<TimelineEntry> mEntries;
+        std::unordered_map<uint64_t, uint32_t> mByHash; // hash -> entry
+        size_t mBaked = 0;
+    };
+
+    // One key of a time-to-value curve; tangent types are opaque ids.
+    struct CurveKey
+    {
+        double time;
+        double value;
+        double inX, inY, outX, outY;
+        int    inType, outType;
+    };
+
+    struct CurveKeys
+    {
+        std::vector<CurveKey> keys; // sorted by time
+        int  preInfinity  = 0;      // 0 = constant
+        int  postInfinity = 0;
+        bool weighted     = false;
+    };
+
+    // Times whose value can differ between before and after: from the key before the
+    // first changed key to the key after the last one. A changed first / last key
+    // opens the range to -inf / +inf, as does any change under a non-constant
+    // infinity (cycles repeat every key). false when the curves are identical.
+    bool changedKeyRange(const CurveKeys& before, const CurveKeys& after, double& lo, double& hi);
+}
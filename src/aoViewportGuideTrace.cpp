@@ -0,0 +1,212 @@
+// aoViewportGuideTrace.cpp (v0.3.1)
+
+#include "aoViewportGuideTrace.h"
+#include "aoViewportGuideStats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace AoViewportGuide
+{
+    struct TraceEvent
+    {
+        const char* name;
+        uint64_t    startNs;
+        uint64_t    durationNs;
+        double      frameTime;
+        uint32_t    frame;
+        int32_t     panel;
+    };
+
+    struct TracePanel
+    {
+        char     name[64] = {};
+        uint32_t frame = 0;      // frames seen since traceStart()
+        double   frameTime = 0.0;
+        uint64_t frameStart = 0;
+    };
+
+    static constexpr int kTraceMaxPanels = 32;
+
+    static std::unique_ptr<TraceEvent[]> gEvents;
+    static size_t                gCapacity = 0;
+    static std::atomic<size_t>   gNext{ 0 };
+    static std::atomic<size_t>   gDropped{ 0 };
+    static std::atomic<bool>     gActive{ false };
+    static std::atomic<int>      gInFlight{ 0 };  // recorders between their gActive check and their write
+    static uint64_t              gOriginNs = 0;
+
+    static TracePanel gPanels[kTraceMaxPanels];
+    static int        gPanelCount = 0;
+
+    // Held by a recorder while it touches the buffer or the panel table; traceStop()
+    // clears gActive and then waits for the count to drain before reading them.
+    // Both sides are sequentially consistent, so a recorder that still saw the
+    // capture active is counted before traceStop() looks.
+    struct TraceRecordScope
+    {
+        TraceRecordScope()  { gInFlight.fetch_add(1); }
+        ~TraceRecordScope() { gInFlight.fetch_sub(1); }
+        bool active() const { return gActive.load(); }
+    };
+
+    bool traceStart(size_t capacity)
+    {
+        if (gActive.load()) return false;
+        if (capacity == 0) capacity = kTraceDefaultCapacity;
+
+        if (capacity != gCapacity)
+        {
+            gEvents.reset(new TraceEvent[capacity]);
+            gCapacity = capacity;
+        }
+
+        for (int i = 0; i < gPanelCount; ++i)
+            gPanels[i] = TracePanel();
+        gPanelCount = 0;
+
+        gNext.store(0);
+        gDropped.store(0);
+        gOriginNs = statsNow();
+        gActive.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool traceActive()
+    {
+        return gActive.load(std::memory_order_relaxed);
+    }
+
+    size_t traceSpanCount()
+    {
+        const size_t n = gNext.load();
+        return n < gCapacity ? n : gCapacity;
+    }
+
+    size_t traceDroppedCount()
+    {
+        return gDropped.load();
+    }
+
+    int traceBeginFrame(const char* panel, double frameTime)
+    {
+        if (!traceActive() || !panel) return -1;
+
+        const TraceRecordScope scope;
+        if (!scope.active()) return -1;
+
+        int slot = -1;
+        for (int i = 0; i < gPanelCount; ++i)
+        {
+            if (std::strncmp(gPanels[i].name, panel, sizeof(gPanels[i].name) - 1) == 0) { slot = i; break; }
+        }
+        if (slot < 0)
+        {
+            if (gPanelCount >= kTraceMaxPanels) return -1;
+            slot = gPanelCount++;
+            std::strncpy(gPanels[slot].name, panel, sizeof(gPanels[slot].name) - 1);
+        }
+
+        TracePanel& p = gPanels[slot];
+        ++p.frame;
+        p.frameTime  = frameTime;
+        p.frameStart = statsNow();
+        return slot;
+    }
+
+    void traceEndFrame(int slot)
+    {
+        if (slot < 0 || slot >= gPanelCount) return;
+        const TracePanel& p = gPanels[slot];
+        traceSpan(slot, "frame", p.frameStart, statsNow() - p.frameStart);
+    }
+
+    void traceSpan(int slot, const char* name, uint64_t startNs, uint64_t durationNs)
+    {
+        if (slot < 0 || slot >= gPanelCount || !traceActive()) return;
+
+        const TraceRecordScope scope;
+        if (!scope.active()) return;
+
+        const size_t i = gNext.fetch_add(1, std::memory_order_relaxed);
+        if (i >= gCapacity)
+        {
+            gDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const TracePanel& p = gPanels[slot];
+        gEvents[i] = TraceEvent{ name, startNs, durationNs, p.frameTime, p.frame, slot };
+    }
+
+    static void writeJsonString(std::FILE* f, const char* s)
+    {
+        std::fputc('"', f);
+        for (; *s; ++s)
+        {
+            const char c = *s;
+            if (c == '"' || c == '\\') { std::fputc('\\', f); std::fputc(c, f); }
+            else if ((unsigned char)c < 0x20) std::fprintf(f, "\\u%04x", (unsigned)c);
+            else std::fputc(c, f);
+        }
+        std::fputc('"', f);
+    }
+
+    bool traceStop(const std::string& path, std::string& error)
+    {
+        if (!gActive.load())
+        {
+            error = "no capture in progress";
+            return false;
+        }
+
+        // an unwritable path leaves the capture running, so it can be stopped again
+        // with another file
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f)
+        {
+            error = "cannot write " + path;
+            return false;
+        }
+
+        if (!gActive.exchange(false))
+        {
+            std::fclose(f);
+            error = "no capture in progress";
+            return false;
+        }
+        while (gInFlight.load() != 0)
+            std::this_thread::yield();
+
+        // ts/dur are microseconds; one trace thread per panel
+        std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"aoViewportGuide\"}}");
+        for (int i = 0; i < gPanelCount; ++i)
+        {
+            std::fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", i + 1);
+            writeJsonString(f, gPanels[i].name);
+            std::fprintf(f, "}}");
+        }
+
+        const size_t n = traceSpanCount();
+        for (size_t i = 0; i < n; ++i)
+        {
+            const TraceEvent& e = gEvents[i];
+            const uint64_t rel = e.startNs >= gOriginNs ? e.startNs - gOriginNs : 0;
+            std::fprintf(f,
+                ",\n{\"name\":\"%s\",\"cat\":\"aoViewportGuide\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"time\":%g}}",
+                e.name, e.panel + 1, (double)rel * 1.0e-3, (double)e.durationNs * 1.0e-3,
+                e.frame, e.frameTime);
+        }
+
+        std::fprintf(f, "\n],\"otherData\":{\"spans\":%zu,\"dropped\":%zu}}\n", n, traceDroppedCount());
+
+        const bool ok = (std::fclose(f) == 0);
+        if (!ok) error = "error while writing " + path;
+        return ok;
+    }
+}
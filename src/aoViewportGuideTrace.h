@@ -0,0 +1,37 @@
+#pragma once
+// aoViewportGuideTrace.h (v0.3.1)
+// Span capture for aoViewportGuideTrace, written as Chrome trace-event JSON
+// (chrome://tracing, Perfetto). No Maya types.
+//
+// The span buffer is allocated by traceStart(); recording only claims a slot
+// with an atomic increment and never allocates. Spans past the capacity are
+// counted as dropped.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AoViewportGuide
+{
+    static constexpr size_t kTraceDefaultCapacity = 1u << 18; // spans
+
+    bool traceStart(size_t capacity);
+    bool traceActive();
+
+    // Stops recording and writes the captured spans, after the spans still being
+    // recorded on draw threads have landed. Returns false (with a reason) when
+    // nothing was capturing or the file could not be written; a file that cannot
+    // be opened keeps the capture running.
+    bool traceStop(const std::string& path, std::string& error);
+
+    size_t traceSpanCount();
+    size_t traceDroppedCount();
+
+    // Panel slot (trace thread row) for this frame, or -1 when not capturing.
+    // frameTime is the scene time shown in the span args.
+    int  traceBeginFrame(const char* panel, double frameTime);
+    void traceEndFrame(int slot);
+
+    // name must be a string literal / static string; it is stored by pointer.
+    void traceSpan(int slot, const char* name, uint64_t startNs, uint64_t durationNs);
+}
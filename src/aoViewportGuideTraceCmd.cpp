@@ -0,0 +1,105 @@
+// aoViewportGuideTraceCmd.cpp (v0.3.1)
+
+#include "aoViewportGuideTraceCmd.h"
+#include "aoViewportGuideTrace.h"
+
+#include <maya/MArgDatabase.h>
+#include <maya/MGlobal.h>
+#include <maya/MString.h>
+
+#include <string>
+
+namespace AoViewportGuide
+{
+    static const char* kStartFlag        = "-sta";
+    static const char* kStartFlagLong    = "-start";
+    static const char* kStopFlag         = "-sto";
+    static const char* kStopFlagLong     = "-stop";
+    static const char* kFileFlag         = "-f";
+    static const char* kFileFlagLong     = "-file";
+    static const char* kCapacityFlag     = "-c";
+    static const char* kCapacityFlagLong = "-capacity";
+
+    const char* AoViewportGuideTraceCmd::commandName = "aoViewportGuideTrace";
+
+    // output path given to -start, used by -stop without -file
+    static std::string gTracePath;
+
+    void* AoViewportGuideTraceCmd::creator()
+    {
+        return new AoViewportGuideTraceCmd();
+    }
+
+    MSyntax AoViewportGuideTraceCmd::newSyntax()
+    {
+        MSyntax syntax;
+        syntax.addFlag(kStartFlag,    kStartFlagLong);
+        syntax.addFlag(kStopFlag,     kStopFlagLong);
+        syntax.addFlag(kFileFlag,     kFileFlagLong,     MSyntax::kString);
+        syntax.addFlag(kCapacityFlag, kCapacityFlagLong, MSyntax::kLong);
+        return syntax;
+    }
+
+    static std::string defaultTracePath()
+    {
+        MString dir;
+        if (!MGlobal::executeCommand("internalVar -userTmpDir", dir) || dir.length() == 0)
+            dir = ".";
+        return std::string(dir.asChar()) + "/aoViewportGuide_trace.json";
+    }
+
+    MStatus AoViewportGuideTraceCmd::doIt(const MArgList& args)
+    {
+        MStatus stat;
+        MArgDatabase db(syntax(), args, &stat);
+        if (!stat) return stat;
+
+        MString file;
+        if (db.isFlagSet(kFileFlag))
+            db.getFlagArgument(kFileFlag, 0, file);
+
+        if (db.isFlagSet(kStartFlag))
+        {
+            int capacity = 0;
+            if (db.isFlagSet(kCapacityFlag))
+                db.getFlagArgument(kCapacityFlag, 0, capacity);
+
+            if (!traceStart(capacity > 0 ? (size_t)capacity : kTraceDefaultCapacity))
+            {
+                displayError("[ao_viewport_guide] trace capture is already running");
+                return MS::kFailure;
+            }
+            gTracePath = file.length() > 0 ? std::string(file.asChar()) : defaultTracePath();
+            setResult(true);
+            return MS::kSuccess;
+        }
+
+        if (db.isFlagSet(kStopFlag))
+        {
+            const std::string path = file.length() > 0 ? std::string(file.asChar()) : gTracePath;
+            const size_t spans   = traceSpanCount();
+            const size_t dropped = traceDroppedCount();
+
+            std::string error;
+            if (!traceStop(path, error))
+            {
+                displayError(MString("[ao_viewport_guide] ") + error.c_str());
+                return MS::kFailure;
+            }
+
+            MString msg("[ao_viewport_guide] trace: ");
+            msg += (int)spans;
+            msg += " spans";
+            if (dropped > 0) { msg += ", "; msg += (int)dropped; msg += " dropped (raise -capacity)"; }
+            msg += " -> ";
+            msg += path.c_str();
+            displayInfo(msg);
+
+            setResult(MString(path.c_str()));
+            return MS::kSuccess;
+        }
+
+        setResult(traceActive());
+        return MS::kSuccess;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+
+namespace AoViewportGuide
+{
+    // aoViewportGuideTrace -start [-file path] [-capacity spans]
+    // aoViewportGuideTrace -stop [-file path]
+    // aoViewportGuideTrace            (returns true while capturing)
+    // -stop writes the Chrome trace-event JSON and returns its path.
+    class AoViewportGuideTraceCmd : public MPxCommand
+    {
+    public:
+        static const char* commandName;
+
+        static void*   creator();
+        static MSyntax newSyntax();
+
+        MStatus doIt(const MArgList& args) override;
+        bool isUndoable() const override { return false; }
+    };
+}
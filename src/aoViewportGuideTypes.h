@@ -0,0 +1,30 @@
+#pragma once
+// aoViewportGuideTypes.h (v0.3.1)
+// Plain data shared between the Maya adapter and the Maya-free guide code.
+
+namespace AoViewportGuide
+{
+    struct Point2
+    {
+        double x = 0.0;
+        double y = 0.0;
+    };
+
+    // straight (non-premultiplied) color
+    struct Rgba
+    {
+        float r = 0.0f;
+        float g = 0.0f;
+        float b = 0.0f;
+        float a = 0.0f;
+    };
+
+    // viewport pixels, origin bottom-left
+    struct GateRect
+    {
+        double left   = 0.0;
+        double bottom = 0.0;
+        double right  = 0.0;
+        double top    = 0.0;
+    };
+}
@@ -0,0 +1,233 @@
+// aoViewportGuideBurnInMain.cpp (v0.3.1)
+// ao_guide_burnin: burns the viewport guides into an image sequence (no Maya).
+//
+//   ao_guide_burnin [options] <inputDir> <outputDir>
+//   ao_guide_burnin [options] <inputImage> <outputImage>
+//
+//   --<attribute> <value>  any aoViewportGuideSettings attribute, e.g.
+//                          --guideType circle --lineColor 1,0.8,0 --lineThickness 3
+//   --layer "<type> key=value ..."  appends a guide layer (repeatable), e.g.
+//                          --layer "grid columns=6 rows=4" --layer "safe action=90 title=80"
+//                          --layer "mask ratio=2.39 opacity=1" --layer "shape name=logoSafe"
+//   --shapes <dirs>        shape files for shape layers (see aoViewportGuideShapes.h)
+//   --settings <file>      "attribute = value" lines ('#' comments)
+//   --presets <file> --preset <name>  starts from a preset of a JSON preset library;
+//                          options after it override single attributes
+//   --aspect <w/h>         gate aspect (default: image aspect)
+//   --camera <name> --focalLength <mm>  annotation values (with --annotations ...)
+//   --overscan <value>     default 1
+//   --filmFit <fill|horizontal|vertical|overscan>
+//   --format <ppm|png|exr> output format (default: same as input)
+//   --threads <n>  --frames-in-flight <n>  --band-rows <n>  --tile <px>
+//   --quiet
+
+#include "aoViewportGuideBurnIn.h"
+#include "aoViewportGuideCommon.h"
+#include "aoViewportGuidePresets.h"
+#include "aoViewportGuideShapes.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace AoViewportGuide;
+
+namespace
+{
+    void usage(const char* exe)
+    {
+        std::fprintf(stderr,
+            "usage: %s [options] <inputDir|inputImage> <outputDir|outputImage>\n"
+            "  --<attribute> <value>   aoViewportGuideSettings attribute (guideType, lineColor r,g,b, ...)\n"
+            "  --layer \"<type> k=v ...\" thirds|cross|circle|grid|safe|mask|shape layer (repeatable)\n"
+            "  --shapes <dirs>         shape file directories for shape layers\n"
+            "  --settings <file>       attribute = value lines\n"
+            "  --presets <file> --preset <name>  preset library (JSON) and preset\n"
+            "  --aspect <w/h> --overscan <v> --filmFit <fill|horizontal|vertical|overscan>\n"
+            "  --camera <name> --focalLength <mm>  annotation text (--annotations camera,focal,...)\n"
+            "  --format <ppm|png|exr> --threads <n> --frames-in-flight <n> --band-rows <n> --tile <px>\n"
+            "  --quiet\n", exe);
+    }
+
+    std::string trim(const std::string& s)
+    {
+        const size_t b = s.find_first_not_of(" \t\r");
+        if (b == std::string::npos) return std::string();
+        const size_t e = s.find_last_not_of(" \t\r");
+        return s.substr(b, e - b + 1);
+    }
+
+    bool loadSettingsFile(const std::string& path, SettingsData& s)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            return false;
+        }
+
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line))
+        {
+            ++lineNo;
+            const size_t hash = line.find('#');
+            if (hash != std::string::npos) line.resize(hash);
+            line = trim(line);
+            if (line.empty()) continue;
+
+            const size_t eq = line.find('=');
+            if (eq == std::string::npos ||
+                !setSettingsValue(s, trim(line.substr(0, eq)), trim(line.substr(eq + 1))))
+            {
+                std::fprintf(stderr, "%s:%d: bad setting '%s'\n", path.c_str(), lineNo, line.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool loadPreset(const PresetLibrary& presets, const std::string& name, SettingsData& s)
+    {
+        if (!presets.isOpen())
+        {
+            std::fprintf(stderr, "--preset needs --presets <file> first\n");
+            return false;
+        }
+
+        const int i = presets.find(name);
+        if (i < 0)
+        {
+            std::fprintf(stderr, "%s: no preset '%s'\n", presets.path().c_str(), name.c_str());
+            return false;
+        }
+
+        PackedSettings packed;
+        std::string error;
+        if (!presets.settings((size_t)i, packed, error))
+        {
+            std::fprintf(stderr, "%s: %s\n", presets.path().c_str(), error.c_str());
+            return false;
+        }
+        s = unpackSettings(packed);
+        return true;
+    }
+
+    bool parseFilmFit(const std::string& v, int& out)
+    {
+        if (v == "fill")       { out = kFilmFitFill;       return true; }
+        if (v == "horizontal") { out = kFilmFitHorizontal; return true; }
+        if (v == "vertical")   { out = kFilmFitVertical;   return true; }
+        if (v == "overscan")   { out = kFilmFitOverscan;   return true; }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BurnInOptions opt;
+    PresetLibrary presets;
+    bool quiet = false;
+    std::string positional[2];
+    int positionalCount = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        if (a == "--quiet") { quiet = true; continue; }
+
+        if (a.size() > 2 && a[0] == '-' && a[1] == '-')
+        {
+            if (i + 1 >= argc) { usage(argv[0]); return 2; }
+            const std::string name = a.substr(2);
+            const std::string v = argv[++i];
+
+            bool ok = true;
+            std::string error;
+            if      (name == "settings")         ok = loadSettingsFile(v, opt.settings);
+            else if (name == "presets")
+            {
+                ok = presets.open(v, error);
+                if (!ok) std::fprintf(stderr, "%s\n", error.c_str());
+            }
+            else if (name == "preset")           ok = loadPreset(presets, v, opt.settings);
+            else if (name == "shapes")
+            {
+                ok = guideShapes().setSearchPath(v, error);
+                if (!ok) std::fprintf(stderr, "%s\n", error.c_str());
+            }
+            else if (name == "aspect")           opt.gate.resolutionAspect = std::atof(v.c_str());
+            else if (name == "overscan")         opt.gate.overscan = std::atof(v.c_str());
+            else if (name == "camera")           opt.camera = v;
+            else if (name == "focalLength")      opt.focalLength = std::atof(v.c_str());
+            else if (name == "filmFit")          ok = parseFilmFit(v, opt.gate.filmFit);
+            else if (name == "format")           ok = (opt.outputFormat = imageFormatFromName(v)) != kImageUnknown;
+            else if (name == "threads")          opt.threads = std::atoi(v.c_str());
+            else if (name == "frames-in-flight") opt.framesInFlight = std::atoi(v.c_str());
+            else if (name == "band-rows")        opt.bandRows = std::atoi(v.c_str());
+            else if (name == "tile")             opt.tileWidth = std::atoi(v.c_str());
+            else                                 ok = setSettingsValue(opt.settings, name, v);
+
+            if (!ok)
+            {
+                std::fprintf(stderr, "bad option %s %s\n", a.c_str(), v.c_str());
+                return 2;
+            }
+            continue;
+        }
+
+        if (positionalCount >= 2) { usage(argv[0]); return 2; }
+        positional[positionalCount++] = a;
+    }
+
+    if (positionalCount != 2) { usage(argv[0]); return 2; }
+    sanitizeSettings(opt.settings);
+
+    if (opt.outputFormat != kImageUnknown && !imageFormatAvailable(opt.outputFormat))
+    {
+        std::fprintf(stderr, "output format not available in this build\n");
+        return 2;
+    }
+
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(positional[0], ec))
+    {
+        std::string error;
+        if (!burnInFrame(positional[0], positional[1], opt, error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!quiet)
+    {
+        opt.progress = [](int done, int total)
+        {
+            std::fprintf(stderr, "\r%d / %d", done, total);
+            if (done == total) std::fprintf(stderr, "\n");
+        };
+    }
+
+    const BurnInReport report = burnInDirectory(positional[0], positional[1], opt);
+    for (const std::string& e : report.errors)
+        std::fprintf(stderr, "%s\n", e.c_str());
+
+    if (!quiet)
+    {
+        std::printf("[ao_viewport_guide %s] %d frame(s), %d failed, %.2f s (%.1f fps)\n",
+                    kVersion, report.frames, report.failed, report.seconds,
+                    report.seconds > 0.0 ? (double)(report.frames - report.failed) / report.seconds : 0.0);
+    }
+
+    if (report.frames == 0)
+    {
+        std::fprintf(stderr, "no readable frames in %s\n", positional[0].c_str());
+        return 1;
+    }
+    return report.failed ? 1 : 0;
+}